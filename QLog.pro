@@ -44,6 +44,10 @@ DEFINES += VERSION=\\\"$$VERSION\\\"
 # deprecated API in order to know how to port your code away from it.
 DEFINES += QT_DEPRECATED_WARNINGS QT_MESSAGELOGCONTEXT
 
+# Uncomment to remove the function-entry tracing (FCT_IDENTIFICATION) from the binary.
+# The debug level "Function Calls" does not produce any output in this case.
+#DEFINES += QLOG_DISABLE_FUNCTION_TRACING
+
 # You can also make your code fail to compile if you use deprecated APIs.
 # In order to do so, uncomment the following line.
 # You can also select to disable deprecated APIs only up to a certain version of Qt.
@@ -78,14 +82,20 @@ SOURCES += \
         awards/BandTableAward.cpp \
         core/AlertEvaluator.cpp \
         core/AppGuard.cpp \
+        core/AwardProgress.cpp \
         core/CallbookManager.cpp \
+        core/ClubProgress.cpp \
         core/CredentialStore.cpp \
+        core/DxSpotEnricher.cpp \
         core/FileCompressor.cpp \
         core/FldigiTCPServer.cpp \
         core/LOVDownloader.cpp \
+        core/LOVUpdateScheduler.cpp \
         core/LogDatabase.cpp \
+        core/LogbookSearchIndex.cpp \
         core/LogLocale.cpp \
         core/LogParam.cpp \
+        core/MembershipDirectory.cpp \
         core/MembershipQE.cpp \
         core/Migration.cpp \
         core/NetworkNotification.cpp \
@@ -95,7 +105,12 @@ SOURCES += \
         core/PropConditions.cpp \
         core/QSLPrintLabelRenderer.cpp \
         core/QSLStorage.cpp \
+        core/QSLThumbnailCache.cpp \
+        core/QSLThumbnailService.cpp \
         core/QSOFilterManager.cpp \
+        core/SQLFunctions.cpp \
+        core/StatisticsEngine.cpp \
+        core/StatisticsRollup.cpp \
         core/WsjtxUDPReceiver.cpp \
         core/debug.cpp \
         core/EmergencyFrequency.cpp \
@@ -111,12 +126,17 @@ SOURCES += \
         data/ActivityProfile.cpp \
         data/AntProfile.cpp \
         data/BandPlan.cpp \
+        data/BandmapSpotStore.cpp \
         data/Accents.cpp \
         data/CWKeyProfile.cpp \
         data/CWShortcutProfile.cpp \
         data/Callsign.cpp \
         data/Data.cpp \
         data/DxServerString.cpp \
+        data/DxccPrefixTrie.cpp \
+        data/DxccStatusIndex.cpp \
+        data/DupeIndex.cpp \
+        data/DxSpotStore.cpp \
         data/Gridsquare.cpp \
         data/HostsPortString.cpp \
         data/MainLayoutProfile.cpp \
@@ -127,12 +147,16 @@ SOURCES += \
         data/StationProfile.cpp \
         data/UpdatableSQLRecord.cpp \
         logformat/AdiFormat.cpp \
+        logformat/AdifTokenizer.cpp \
         logformat/AdxFormat.cpp \
         logformat/CabrilloFormat.cpp \
         logformat/CSVFormat.cpp \
+        logformat/ImportDupeQuery.cpp \
         logformat/JsonFormat.cpp \
         logformat/LogFormat.cpp \
+        logformat/LogFormatWorker.cpp \
         logformat/PotaAdiFormat.cpp \
+        logformat/QSLContactIndex.cpp \
         models/AlertTableModel.cpp \
         models/AwardsTableModel.cpp \
         models/DxccTableModel.cpp \
@@ -254,14 +278,20 @@ HEADERS += \
         awards/BandTableAward.h \
         core/AlertEvaluator.h \
         core/AppGuard.h \
+        core/AwardProgress.h \
         core/CallbookManager.h \
+        core/ClubProgress.h \
         core/CredentialStore.h \
+        core/DxSpotEnricher.h \
         core/FileCompressor.h \
         core/FldigiTCPServer.h \
         core/LOVDownloader.h \
+        core/LOVUpdateScheduler.h \
         core/LogDatabase.h \
+        core/LogbookSearchIndex.h \
         core/LogLocale.h \
         core/LogParam.h \
+        core/MembershipDirectory.h \
         core/MembershipQE.h \
         core/Migration.h \
         core/NetworkNotification.h \
@@ -271,8 +301,13 @@ HEADERS += \
         core/PropConditions.h \
         core/QSLPrintLabelRenderer.h \
         core/QSLStorage.h \
+        core/QSLThumbnailCache.h \
+        core/QSLThumbnailService.h \
         core/QSOFilterManager.h \
         core/QuadKeyCache.h \
+        core/SQLFunctions.h \
+        core/StatisticsEngine.h \
+        core/StatisticsRollup.h \
         core/WsjtxUDPReceiver.h \
         core/csv.hpp \
         core/debug.h \
@@ -289,6 +324,7 @@ HEADERS += \
         data/AntProfile.h \
         data/Band.h \
         data/BandPlan.h \
+        data/BandmapSpotStore.h \
         data/CWKeyProfile.h \
         data/CWShortcutProfile.h \
         data/Callsign.h \
@@ -296,6 +332,10 @@ HEADERS += \
         data/DxServerString.h \
         data/DxSpot.h \
         data/Dxcc.h \
+        data/DxccPrefixTrie.h \
+        data/DxccStatusIndex.h \
+        data/DupeIndex.h \
+        data/DxSpotStore.h \
         data/Gridsquare.h \
         data/HostsPortString.h \
         data/MainLayoutProfile.h \
@@ -320,12 +360,16 @@ HEADERS += \
         data/WsjtxLogADIF.h \
         data/WsjtxStatus.h \
         logformat/AdiFormat.h \
+        logformat/AdifTokenizer.h \
         logformat/AdxFormat.h \
         logformat/CabrilloFormat.h \
         logformat/CSVFormat.h \
+        logformat/ImportDupeQuery.h \
         logformat/JsonFormat.h \
         logformat/LogFormat.h \
+        logformat/LogFormatWorker.h \
         logformat/PotaAdiFormat.h \
+        logformat/QSLContactIndex.h \
         models/AlertTableModel.h \
         models/AwardsTableModel.h \
         models/DxccTableModel.h \
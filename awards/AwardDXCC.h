@@ -15,6 +15,7 @@ protected:
     QString additionalWhere(const QString &entity) const override;
     QString clickFilter(const QString &col1Value, const QString &col2Value) const override;
     bool clickUsesCountryName() const override;
+    QString progressColumn() const override { return QStringLiteral("dxcc"); }
 };
 
 #endif // QLOG_AWARDS_AWARDDXCC_H
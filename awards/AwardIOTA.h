@@ -15,6 +15,7 @@ protected:
     QString sqlDetailTable(const QString &entity) const override;
     QString additionalWhere(const QString &entity) const override;
     QString clickFilter(const QString &col1Value, const QString &col2Value) const override;
+    QString progressColumn() const override { return QStringLiteral("iota"); }
 };
 
 #endif // QLOG_AWARDS_AWARDIOTA_H
@@ -13,8 +13,9 @@ protected:
     QString headersColumns(const QString &entity) const override;
     QString sqlDetailTable(const QString &entity) const override;
     QString additionalWhere(const QString &entity) const override;
-    QStringList additionalCTEs(const QString &entity, const QString &contactFilter) const override;
+    QStringList additionalCTEs(const QString &entity, const QString &contactSource) const override;
     QString clickFilter(const QString &col1Value, const QString &col2Value) const override;
+    QString progressColumn() const override { return QStringLiteral("ituz"); }
 };
 
 #endif // QLOG_AWARDS_AWARDITU_H
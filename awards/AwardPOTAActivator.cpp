@@ -23,9 +23,9 @@ QString AwardPOTAActivator::additionalWhere(const QString &) const
     return " AND c.my_pota_ref_str is not NULL ";
 }
 
-QStringList AwardPOTAActivator::additionalCTEs(const QString &, const QString &contactFilter) const
+QStringList AwardPOTAActivator::additionalCTEs(const QString &, const QString &contactSource) const
 {
-    return { generateSplitCTE("my_pota_ref", "my_pota_ref_str", contactFilter) };
+    return { generateSplitCTE("my_pota_ref", "my_pota_ref_str", contactSource) };
 }
 
 QString AwardPOTAActivator::sourceContactsOverride(const QString &) const
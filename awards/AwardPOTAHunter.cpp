@@ -23,9 +23,9 @@ QString AwardPOTAHunter::additionalWhere(const QString &) const
     return " AND c.pota is not NULL ";
 }
 
-QStringList AwardPOTAHunter::additionalCTEs(const QString &, const QString &contactFilter) const
+QStringList AwardPOTAHunter::additionalCTEs(const QString &, const QString &contactSource) const
 {
-    return { generateSplitCTE("pota_ref", "pota", contactFilter) };
+    return { generateSplitCTE("pota_ref", "pota", contactSource) };
 }
 
 QString AwardPOTAHunter::sourceContactsOverride(const QString &) const
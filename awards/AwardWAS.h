@@ -14,6 +14,7 @@ protected:
     QString sqlDetailTable(const QString &entity) const override;
     QString additionalWhere(const QString &entity) const override;
     QString clickFilter(const QString &col1Value, const QString &col2Value) const override;
+    QString progressColumn() const override { return QStringLiteral("state"); }
 };
 
 #endif // QLOG_AWARDS_AWARDWAS_H
@@ -1,6 +1,7 @@
 #include <QHeaderView>
 #include "BandTableAward.h"
 #include "core/debug.h"
+#include "core/AwardProgress.h"
 #include "data/Band.h"
 #include "data/BandPlan.h"
 
@@ -95,17 +96,23 @@ void BandTableAward::updateData(const AwardFilterParams &params)
                     << " MAX(d.'EME') > 0";
 
     const QString &entity = params.entitySelected;
+    const QString progress = progressColumn();
 
-    QString sourceContactsTable = sourceContactsOverride(params.userFilterWhereClause);
+    // the user filter can reference any contacts column therefore
+    // the materialized progress is used only without the user filter
+    const QString contactSource = ( params.userFilterWhereClause.isEmpty()
+                                    && !progress.isEmpty()
+                                    && AwardProgress::isAvailable() )
+                                  ? AwardProgress::sourceSelect(progress)
+                                  : QString("SELECT * FROM contacts WHERE 1=1 %1").arg(params.userFilterWhereClause);
+
+    qCDebug(runtime) << "Award contacts source" << contactSource;
+
+    QString sourceContactsTable = sourceContactsOverride(contactSource);
     if ( sourceContactsTable.isEmpty() )
-    {
-        sourceContactsTable = QString(" source_contacts AS "
-                                      " (SELECT * "
-                                      "  FROM contacts "
-                                      "  WHERE 1=1 %1 ) ").arg(params.userFilterWhereClause);
-    }
+        sourceContactsTable = QString(" source_contacts AS (%1) ").arg(contactSource);
 
-    QStringList addlCTEs = additionalCTEs(entity, params.userFilterWhereClause);
+    QStringList addlCTEs = additionalCTEs(entity, contactSource);
     addlCTEs.append(sourceContactsTable);
 
     QStringList havingConditions;
@@ -250,6 +257,11 @@ bool BandTableAward::clickUsesCountryName() const
     return false;
 }
 
+QString BandTableAward::progressColumn() const
+{
+    return QString();
+}
+
 QString BandTableAward::generateNumberRangeCTE(const QString &name, int min, int max)
 {
     return QString(" %1 AS ("
@@ -272,25 +284,25 @@ QString BandTableAward::generateValuesCTE(const QString &name,
 
 QString BandTableAward::generateSplitCTE(const QString &sourceColumn,
                                           const QString &outputColumn,
-                                          const QString &contactFilter)
+                                          const QString &contactSource)
 {
-    return QString(" split(id, callsign, station_callsign, my_dxcc, band, dxcc, eqsl_qsl_rcvd, lotw_qsl_rcvd, qsl_rcvd, prop_mode, mode, %1, str) AS ("
-                   "   SELECT id, callsign, station_callsign, my_dxcc, band, "
+    return QString(" split(id, my_dxcc, band, dxcc, eqsl_qsl_rcvd, lotw_qsl_rcvd, qsl_rcvd, prop_mode, mode, %1, str) AS ("
+                   "   SELECT id, my_dxcc, band, "
                    "          dxcc, eqsl_qsl_rcvd, lotw_qsl_rcvd, qsl_rcvd, prop_mode, mode, "
                    "          '', %2||',' "
-                   "   FROM contacts WHERE 1=1 %3"
+                   "   FROM (%3) "
                    "   UNION ALL "
-                   "   SELECT id, callsign, station_callsign, my_dxcc, band, "
+                   "   SELECT id, my_dxcc, band, "
                    "          dxcc, eqsl_qsl_rcvd, lotw_qsl_rcvd, qsl_rcvd, prop_mode, mode, "
                    "          substr(str, 0, instr(str, ',')), TRIM(substr(str, instr(str, ',') + 1)) "
                    "   FROM split "
-                   "   WHERE str != '') ").arg(outputColumn, sourceColumn, contactFilter);
+                   "   WHERE str != '') ").arg(outputColumn, sourceColumn, contactSource);
 }
 
 QString BandTableAward::generateSplitSourceContacts(const QString &outputColumn)
 {
     return QString(" source_contacts AS ("
-                   "   SELECT id, callsign, station_callsign, my_dxcc, band, dxcc, eqsl_qsl_rcvd, lotw_qsl_rcvd, qsl_rcvd, prop_mode, mode, %1 "
+                   "   SELECT id, my_dxcc, band, dxcc, eqsl_qsl_rcvd, lotw_qsl_rcvd, qsl_rcvd, prop_mode, mode, %1 "
                    "   FROM split "
                    "   WHERE %1 != '' ) ").arg(outputColumn);
 }
@@ -33,11 +33,15 @@
  * sourceContactsOverride(). Use the static helper methods to build CTEs without
  * writing raw SQL.
  *
+ * Override progressColumn() if the award reference is materialized by
+ * AwardProgress. The award table is then computed from the compact progress
+ * rows instead of the whole contacts table (unless a user filter is applied).
+ *
  * === The generated SQL structure ===
  *
  *   WITH
  *     <additionalCTEs>,                        -- optional, from additionalCTEs()
- *     source_contacts AS (SELECT ... FROM contacts WHERE ...),  -- or sourceContactsOverride()
+ *     source_contacts AS (<contact source>),  -- or sourceContactsOverride()
  *     detail_table AS (
  *       SELECT <headersColumns> col1, col2,
  *              MAX(CASE WHEN band='160m' ... END) as '160m',
@@ -158,23 +162,24 @@ protected:
      *   - generateSplitCTE()        — for POTA (comma-separated references)
      *
      * entity        - the selected DXCC entity ID
-     * contactFilter - the user filter WHERE clause (needed by split CTEs) */
+     * contactSource - the SELECT statement of the contacts (needed by split CTEs) */
     virtual QStringList additionalCTEs(const QString &entity,
-                                       const QString &contactFilter) const;
+                                       const QString &contactSource) const;
 
     /* Override the default source_contacts CTE.
      *
-     * By default, source_contacts is: SELECT * FROM contacts WHERE 1=1 <userFilter>.
+     * By default, source_contacts is the contact source: SELECT * FROM contacts WHERE 1=1 <userFilter>
+     * or the progress rows of the award (see progressColumn()).
      * Override this when the award needs a transformed contact source (e.g. POTA splits
      * comma-separated references into individual rows).
      *
      * Return empty QString() to use the default. Otherwise return a complete CTE definition
      * for "source_contacts AS (...)".
      *
-     * contactFilter - the user filter WHERE clause
+     * contactSource - the SELECT statement of the contacts
      *
      * See generateSplitSourceContacts() — helper for the split pattern. */
-    virtual QString sourceContactsOverride(const QString &contactFilter) const;
+    virtual QString sourceContactsOverride(const QString &contactSource) const;
 
     /* Return a SQL WHERE fragment for logbook filtering on double-click.
      *
@@ -197,6 +202,21 @@ protected:
      * Only DXCC uses this. Default: false. */
     virtual bool clickUsesCountryName() const;
 
+    /* Return the contacts column of the award reference which is materialized
+     * by AwardProgress (one of AwardProgress::referenceColumns).
+     *
+     * If set, source_contacts contains only the columns id, my_dxcc, dxcc, band,
+     * prop_mode, mode, eqsl_qsl_rcvd, lotw_qsl_rcvd, qsl_rcvd and the reference
+     * column when no user filter is applied, so the SQL fragments must not use
+     * other contacts columns. The dxcc column is set only for the references
+     * in AwardProgress::dxccReferenceColumns.
+     * Default: empty - source_contacts reads the contacts table.
+     *
+     * Examples:
+     *   "cqz"        — WAZ
+     *   "gridsquare" — Gridsquare (the first 6 characters are materialized) */
+    virtual QString progressColumn() const;
+
     // ===================================================================
     //  STATIC HELPERS — use these in additionalCTEs() / sourceContactsOverride()
     // ===================================================================
@@ -220,10 +240,10 @@ protected:
      *
      * sourceColumn  - the contacts table column to split (e.g. "pota_ref")
      * outputColumn  - the name for the split output column (e.g. "pota")
-     * contactFilter - the user filter WHERE clause */
+     * contactSource - the SELECT statement of the contacts */
     static QString generateSplitCTE(const QString &sourceColumn,
                                     const QString &outputColumn,
-                                    const QString &contactFilter);
+                                    const QString &contactSource);
 
     /* Generate a source_contacts CTE that reads from the "split" CTE.
      * Companion to generateSplitCTE(). Returns a CTE definition for source_contacts
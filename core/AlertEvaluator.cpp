@@ -22,6 +22,7 @@ void AlertEvaluator::clearRules()
 {
     FCT_IDENTIFICATION;
 
+    matcher.clear();
     qDeleteAll(ruleList);
     ruleList.clear();
 }
@@ -32,17 +33,7 @@ void AlertEvaluator::dxSpot(const DxSpot & spot)
 
     qCDebug(function_parameters) << "DX Spot";
 
-    QStringList matchedRules;
-
-    for ( const AlertRule *rule : static_cast<const QList<AlertRule *>&>(ruleList) )
-    {
-        qCDebug(runtime) << "Processing " << *rule;
-
-        if ( rule->match(spot) )
-        {
-            matchedRules << rule->ruleName;
-        }
-    }
+    const QStringList &matchedRules = matcher.match(spot);
 
     if ( matchedRules.size() > 0 )
     {
@@ -57,16 +48,7 @@ void AlertEvaluator::WSJTXCQSpot(const WsjtxEntry &wsjtx)
 
     qCDebug(function_parameters) << "WSJTX CQ Spot";
 
-    QStringList matchedRules;
-
-    for ( const AlertRule *rule : static_cast<const QList<AlertRule *>&>(ruleList) )
-    {
-        qCDebug(runtime) << "Processing " << *rule;
-        if ( rule->match(wsjtx) )
-        {
-            matchedRules << rule->ruleName;
-        }
-    }
+    const QStringList &matchedRules = matcher.match(wsjtx);
 
     if ( matchedRules.size() > 0 )
     {
@@ -110,6 +92,8 @@ void AlertEvaluator::loadRules()
             qInfo()<< "Cannot get filters names from DB" << ruleStmt.lastError();
         }
     }
+
+    matcher.compile(ruleList);
 }
 
 AlertRule::AlertRule(QObject *parent) :
@@ -420,3 +404,294 @@ AlertRule::operator QString() const
             + "spotterContinent: " + spotterContinent + "; "
             + ")";
 }
+
+const quint64 AlertRuleMatcher::ValueBits::EMPTY_VALUE;
+const quint64 AlertRuleMatcher::ValueBits::UNKNOWN_VALUE;
+const quint64 AlertRuleMatcher::ValueBits::ANY_VALUE;
+
+void AlertRuleMatcher::compile(const QList<AlertRule *> &rules)
+{
+    FCT_IDENTIFICATION;
+
+    clear();
+
+    for ( const AlertRule *rule : rules )
+    {
+        if ( !rule->isValid() || !rule->enabled )
+            continue;
+
+        CompiledRule compiled;
+
+        // DX Spot: an empty value never matches a value list
+        if ( rule->sourceMap & SpotAlert::DXSPOT )
+        {
+            if ( !compileRule(rule, false, compiled) )
+                compiled.fallback = true;
+            addRule(dxSpotRules, rule, compiled);
+        }
+
+        // WSJTX: an empty value matches every value list (the same as AlertRule::match)
+        if ( rule->sourceMap & SpotAlert::WSJTXCQSPOT )
+        {
+            compiled = CompiledRule();
+            if ( !compileRule(rule, true, compiled) )
+                compiled.fallback = true;
+            addRule(wsjtxRules, rule, compiled);
+        }
+    }
+
+    qCDebug(runtime) << "Compiled rules - DX Spot:" << dxSpotRules.rules.size()
+                     << "WSJTX:" << wsjtxRules.rules.size();
+}
+
+void AlertRuleMatcher::clear()
+{
+    FCT_IDENTIFICATION;
+
+    bands.clear();
+    modes.clear();
+    continents.clear();
+    dxSpotRules.clear();
+    wsjtxRules.clear();
+}
+
+QStringList AlertRuleMatcher::match(const DxSpot &spot) const
+{
+    FCT_IDENTIFICATION;
+
+    if ( dxSpotRules.rules.isEmpty() )
+        return QStringList();
+
+    SpotValues values;
+
+    values.band = bands.bit(spot.band);
+    values.mode = modes.bit(spot.modeGroupString);
+    values.dxContinent = continents.bit(spot.dxcc.cont);
+    values.spotterContinent = continents.bit(spot.dxcc_spotter.cont);
+    values.status = spot.status;
+    values.refs = refMap(spot.containsPOTA, spot.containsSOTA, spot.containsIOTA, spot.containsWWFF);
+    values.ituz = spot.dxcc.ituz;
+    values.cqz = spot.dxcc.cqz;
+    values.spotterCountry = spot.dxcc_spotter.dxcc;
+
+    return match(dxSpotRules, spot, spot.dxcc.dxcc, values, spot.callsign, spot.comment);
+}
+
+QStringList AlertRuleMatcher::match(const WsjtxEntry &wsjtx) const
+{
+    FCT_IDENTIFICATION;
+
+    if ( wsjtxRules.rules.isEmpty() )
+        return QStringList();
+
+    SpotValues values;
+
+    values.band = bands.bit(wsjtx.band);
+    values.mode = modes.bit(BandPlan::isFTxMode(wsjtx.decodedMode) ? BandPlan::MODE_GROUP_STRING_FTx
+                                                                   : BandPlan::MODE_GROUP_STRING_DIGITAL);
+    values.dxContinent = continents.bit(wsjtx.dxcc.cont);
+    values.spotterContinent = continents.bit(wsjtx.dxcc_spotter.cont);
+    values.status = wsjtx.status;
+    values.refs = refMap(wsjtx.containsPOTA, wsjtx.containsSOTA, wsjtx.containsIOTA, wsjtx.containsWWFF);
+    values.ituz = wsjtx.dxcc.ituz;
+    values.cqz = wsjtx.dxcc.cqz;
+    values.spotterCountry = wsjtx.dxcc_spotter.dxcc;
+
+    return match(wsjtxRules, wsjtx, wsjtx.dxcc.dxcc, values, wsjtx.callsign, wsjtx.decode.message);
+}
+
+template<typename Entry>
+QStringList AlertRuleMatcher::match(const RuleSet &ruleSet,
+                                    const Entry &entry,
+                                    int dxcc,
+                                    const SpotValues &values,
+                                    const QString &callsign,
+                                    const QString &comment) const
+{
+    static const QVector<int> noRules;
+
+    const auto countryIt = ruleSet.countryRules.constFind(dxcc);
+    const QVector<int> &countryRules = ( countryIt != ruleSet.countryRules.constEnd() ) ? countryIt.value()
+                                                                                        : noRules;
+    const QVector<int> &anyCountryRules = ruleSet.anyCountryRules;
+    QStringList ret;
+    int countryPos = 0;
+    int anyPos = 0;
+
+    // both candidate lists are sorted; merge them to keep the rule order
+    while ( countryPos < countryRules.size() || anyPos < anyCountryRules.size() )
+    {
+        int index;
+
+        if ( anyPos >= anyCountryRules.size()
+             || ( countryPos < countryRules.size() && countryRules.at(countryPos) < anyCountryRules.at(anyPos) ) )
+            index = countryRules.at(countryPos++);
+        else
+            index = anyCountryRules.at(anyPos++);
+
+        const CompiledRule &compiled = ruleSet.rules.at(index);
+
+        if ( compiled.fallback )
+        {
+            if ( compiled.rule->match(entry) )
+                ret << compiled.rule->ruleName;
+            continue;
+        }
+
+        if ( !passed(compiled, values) )
+            continue;
+
+        if ( !compiled.anyMember && !memberMatch(compiled, entry.callsign_member) )
+            continue;
+
+        if ( !compiled.anyCallsign && !compiled.rule->callsignRE.match(callsign).hasMatch() )
+            continue;
+
+        if ( !compiled.anyComment && !compiled.rule->commentRE.match(comment).hasMatch() )
+            continue;
+
+        qCDebug(runtime) << "Rule name:" << compiled.rule->ruleName << "- result true";
+        ret << compiled.rule->ruleName;
+    }
+
+    return ret;
+}
+
+bool AlertRuleMatcher::compileRule(const AlertRule *rule,
+                                   bool emptyValueMatches,
+                                   CompiledRule &compiled)
+{
+    FCT_IDENTIFICATION;
+
+    compiled.rule = rule;
+    compiled.statusMap = rule->dxLogStatusMap;
+    compiled.refMap = refMap(rule->pota, rule->sota, rule->iota, rule->wwff);
+    compiled.ituz = rule->ituz;
+    compiled.cqz = rule->cqz;
+    compiled.spotterCountry = rule->spotterCountry;
+    compiled.anyMember = ( rule->dxMember.size() == 1 && rule->dxMember.front() == QLatin1String("*") );
+    compiled.anyCallsign = matchesAll(rule->callsignRE);
+    compiled.anyComment = matchesAll(rule->commentRE);
+
+    return bands.mask(rule->band, emptyValueMatches, compiled.bandMask)
+           && modes.mask(rule->mode, emptyValueMatches, compiled.modeMask)
+           && continents.mask(rule->dxContinent, emptyValueMatches, compiled.dxContinentMask)
+           && continents.mask(rule->spotterContinent, emptyValueMatches, compiled.spotterContinentMask);
+}
+
+void AlertRuleMatcher::addRule(RuleSet &ruleSet,
+                               const AlertRule *rule,
+                               const CompiledRule &compiled)
+{
+    const int index = ruleSet.rules.size();
+
+    ruleSet.rules.append(compiled);
+
+    if ( rule->dxCountry != 0 )
+        ruleSet.countryRules[rule->dxCountry].append(index);
+    else
+        ruleSet.anyCountryRules.append(index);
+}
+
+bool AlertRuleMatcher::passed(const CompiledRule &compiled, const SpotValues &values)
+{
+    if ( !(compiled.bandMask & values.band)
+         || !(compiled.modeMask & values.mode)
+         || !(compiled.dxContinentMask & values.dxContinent)
+         || !(compiled.spotterContinentMask & values.spotterContinent)
+         || !(compiled.statusMap & values.status) )
+        return false;
+
+    if ( compiled.refMap && !(compiled.refMap & values.refs) )
+        return false;
+
+    if ( compiled.ituz != 0 && compiled.ituz != values.ituz )
+        return false;
+
+    if ( compiled.cqz != 0 && compiled.cqz != values.cqz )
+        return false;
+
+    if ( compiled.spotterCountry != 0 && compiled.spotterCountry != values.spotterCountry )
+        return false;
+
+    return true;
+}
+
+bool AlertRuleMatcher::memberMatch(const CompiledRule &compiled, const QList<ClubInfo> &members)
+{
+    for ( const ClubInfo &member : members )
+    {
+        if ( compiled.rule->dxMemberSet.contains(member.getClubInfo()) )
+            return true;
+    }
+    return false;
+}
+
+int AlertRuleMatcher::refMap(bool pota, bool sota, bool iota, bool wwff)
+{
+    return ( pota ? POTA_REF : 0 )
+           | ( sota ? SOTA_REF : 0 )
+           | ( iota ? IOTA_REF : 0 )
+           | ( wwff ? WWFF_REF : 0 );
+}
+
+bool AlertRuleMatcher::matchesAll(const QRegularExpression &regEx)
+{
+    return regEx.pattern().isEmpty() || regEx.pattern() == QLatin1String(".*");
+}
+
+void AlertRuleMatcher::RuleSet::clear()
+{
+    rules.clear();
+    countryRules.clear();
+    anyCountryRules.clear();
+}
+
+bool AlertRuleMatcher::ValueBits::mask(const QString &ruleValue,
+                                       bool emptyValueMatches,
+                                       quint64 &ret)
+{
+    if ( ruleValue == QLatin1String("*") )
+    {
+        ret = ANY_VALUE;
+        return true;
+    }
+
+    // the rule value has the form |value1|value2...; AlertRule::match searches
+    // for '|' + value therefore the text before the first '|' is not a value
+    const QStringList tokens = ruleValue.split(QLatin1Char('|'));
+
+    ret = ( emptyValueMatches && tokens.size() > 1 ) ? EMPTY_VALUE : 0;
+
+    for ( int i = 1; i < tokens.size(); i++ )
+    {
+        const QString &token = tokens.at(i);
+
+        if ( token.isEmpty() )
+            continue;
+
+        quint64 tokenBit = values.value(token, 0);
+
+        if ( !tokenBit )
+        {
+            // two bits are reserved for the empty and unknown values
+            if ( values.size() >= 62 )
+            {
+                qWarning() << "Alert Rules: too many distinct values; rule is not compiled" << ruleValue;
+                return false;
+            }
+            tokenBit = Q_UINT64_C(1) << (values.size() + 2);
+            values.insert(token, tokenBit);
+        }
+        ret |= tokenBit;
+    }
+    return true;
+}
+
+quint64 AlertRuleMatcher::ValueBits::bit(const QString &value) const
+{
+    if ( value.isEmpty() )
+        return EMPTY_VALUE;
+
+    return values.value(value, UNKNOWN_VALUE);
+}
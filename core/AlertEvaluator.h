@@ -6,6 +6,8 @@
 #include "data/WsjtxEntry.h"
 #include "data/SpotAlert.h"
 #include <QRegularExpression>
+#include <QHash>
+#include <QVector>
 
 class AlertRule : public QObject
 {
@@ -43,6 +45,8 @@ public:
     bool wwff;
 
 private:
+    friend class AlertRuleMatcher;
+
     bool ruleValid;
     QRegularExpression callsignRE;
     QRegularExpression commentRE;
@@ -50,6 +54,111 @@ private:
 
 };
 
+// AlertRuleMatcher is a compiled form of a rule set. The band, mode group
+// and continent conditions are converted to bitmasks and the rules are
+// indexed by DXCC entity. Regular expressions are evaluated only for rules
+// which pass all other conditions. The result is the same as calling
+// AlertRule::match for all rules in the rule order.
+// The compiled rules refer to the AlertRule objects; the matcher has to be
+// cleared or recompiled before the rules are deleted.
+class AlertRuleMatcher
+{
+public:
+    AlertRuleMatcher() {}
+
+    void compile(const QList<AlertRule *> &rules);
+    void clear();
+
+    QStringList match(const DxSpot &spot) const;
+    QStringList match(const WsjtxEntry &wsjtx) const;
+
+    int ruleCount() const { return dxSpotRules.rules.size() + wsjtxRules.rules.size(); }
+
+private:
+    // maps values of one rule field (band, mode group, continent) to bits
+    class ValueBits
+    {
+    public:
+        static const quint64 EMPTY_VALUE = Q_UINT64_C(1);
+        static const quint64 UNKNOWN_VALUE = Q_UINT64_C(1) << 1;
+        static const quint64 ANY_VALUE = ~Q_UINT64_C(0);
+
+        bool mask(const QString &ruleValue, bool emptyValueMatches, quint64 &ret);
+        quint64 bit(const QString &value) const;
+        void clear() { values.clear(); }
+
+    private:
+        QHash<QString, quint64> values;
+    };
+
+    struct CompiledRule
+    {
+        const AlertRule *rule = nullptr;
+        bool fallback = false; // too many distinct values; AlertRule::match is used
+        quint64 bandMask = ValueBits::ANY_VALUE;
+        quint64 modeMask = ValueBits::ANY_VALUE;
+        quint64 dxContinentMask = ValueBits::ANY_VALUE;
+        quint64 spotterContinentMask = ValueBits::ANY_VALUE;
+        int statusMap = 0;
+        int refMap = 0;
+        int ituz = 0;
+        int cqz = 0;
+        int spotterCountry = 0;
+        bool anyMember = true;
+        bool anyCallsign = true;
+        bool anyComment = true;
+    };
+
+    struct RuleSet
+    {
+        QVector<CompiledRule> rules;
+        QHash<int, QVector<int>> countryRules; // dxcc -> rule indexes
+        QVector<int> anyCountryRules;
+
+        void clear();
+    };
+
+    enum RefBits
+    {
+        POTA_REF = 0b1,
+        SOTA_REF = 0b10,
+        IOTA_REF = 0b100,
+        WWFF_REF = 0b1000
+    };
+
+    struct SpotValues
+    {
+        quint64 band;
+        quint64 mode;
+        quint64 dxContinent;
+        quint64 spotterContinent;
+        int status;
+        int refs;
+        int ituz;
+        int cqz;
+        int spotterCountry;
+    };
+
+    bool compileRule(const AlertRule *rule, bool emptyValueMatches, CompiledRule &compiled);
+    static void addRule(RuleSet &ruleSet, const AlertRule *rule, const CompiledRule &compiled);
+
+    template<typename Entry>
+    QStringList match(const RuleSet &ruleSet, const Entry &entry, int dxcc,
+                      const SpotValues &values, const QString &callsign,
+                      const QString &comment) const;
+
+    static bool passed(const CompiledRule &compiled, const SpotValues &values);
+    static bool memberMatch(const CompiledRule &compiled, const QList<ClubInfo> &members);
+    static int refMap(bool pota, bool sota, bool iota, bool wwff);
+    static bool matchesAll(const QRegularExpression &regEx);
+
+    ValueBits bands;
+    ValueBits modes;
+    ValueBits continents;
+    RuleSet dxSpotRules;
+    RuleSet wsjtxRules;
+};
+
 class AlertEvaluator : public QObject
 {
     Q_OBJECT
@@ -69,6 +178,7 @@ signals:
 
 private:
     QList<AlertRule *>ruleList;
+    AlertRuleMatcher matcher;
 };
 
 #endif // QLOG_CORE_ALERTEVALUATOR_H
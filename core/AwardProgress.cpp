@@ -0,0 +1,292 @@
+#include <QSqlQuery>
+#include <QSqlError>
+
+#include "AwardProgress.h"
+#include "core/debug.h"
+
+MODULE_IDENTIFICATION("qlog.core.awardprogress");
+
+// the longest locator which is used by the Gridsquare awards
+#define GRIDSQUARE_MAX_CHARS 6
+
+const QStringList AwardProgress::referenceColumns =
+{
+    "dxcc", "ituz", "cqz", "cont", "state", "cnty", "pfx", "iota",
+    "gridsquare", "sota_ref", "wwff_ref", "pota_ref", "my_pota_ref"
+};
+
+// the references which are evaluated together with the worked DXCC entity;
+// the other references do not keep the entity to have fewer progress rows
+const QStringList AwardProgress::dxccReferenceColumns =
+{
+    "dxcc", "state", "cnty"
+};
+
+const QString AwardProgress::tableName = QStringLiteral("contacts_award_progress");
+
+QAtomicInt AwardProgress::available(0);
+
+bool AwardProgress::setup(const QSqlDatabase &db)
+{
+    FCT_IDENTIFICATION;
+
+    available.storeRelease(0);
+
+    QSqlQuery query(db);
+
+    // the progress must be rebuilt if it is new or if it was not maintained by triggers
+    if ( !query.exec("SELECT COUNT(1) FROM sqlite_master "
+                     "WHERE (type = 'table' AND name = 'contacts_award_progress') "
+                     "      OR (type = 'trigger' AND name IN ('contacts_award_progress_insert', "
+                     "                                        'contacts_award_progress_delete', "
+                     "                                        'contacts_award_progress_update'))")
+         || !query.first() )
+    {
+        qWarning() << "Cannot check the Award Progress" << query.lastError().text();
+        return false;
+    }
+
+    const bool rebuildNeeded = query.value(0).toInt() != 4;
+    const QStringList columns = contactsColumns();
+    QStringList keyChanged;
+
+    for ( const QString &column : columns )
+        keyChanged << QString("old.%1 IS new.%1").arg(column);
+
+    const QStringList stmts =
+    {
+        QLatin1String("CREATE TABLE IF NOT EXISTS contacts_award_progress ("
+                      "  id INTEGER PRIMARY KEY, kind TEXT NOT NULL, ref, "
+                      "  my_dxcc INTEGER, dxcc INTEGER, band TEXT, prop_mode TEXT, mode TEXT, "
+                      "  cnt INTEGER NOT NULL, eqsl_cnt INTEGER NOT NULL, "
+                      "  lotw_cnt INTEGER NOT NULL, qsl_cnt INTEGER NOT NULL)"),
+
+        QLatin1String("CREATE INDEX IF NOT EXISTS contacts_award_progress_key_idx "
+                      "ON contacts_award_progress (kind, ref, my_dxcc, dxcc, band, prop_mode, mode)"),
+
+        QString("CREATE TRIGGER IF NOT EXISTS contacts_award_progress_insert "
+                "AFTER INSERT ON contacts "
+                "BEGIN "
+                "  %1 "
+                "END").arg(addStatements("new")),
+
+        QString("CREATE TRIGGER IF NOT EXISTS contacts_award_progress_delete "
+                "AFTER DELETE ON contacts "
+                "BEGIN "
+                "  %1 "
+                "END").arg(removeStatements("old")),
+
+        // only the award columns; e.g. upload status updates do not touch the progress
+        QString("CREATE TRIGGER IF NOT EXISTS contacts_award_progress_update "
+                "AFTER UPDATE OF %1 ON contacts "
+                "WHEN NOT (%2) "
+                "BEGIN "
+                "  %3 "
+                "  %4 "
+                "END").arg(columns.join(", "),
+                           keyChanged.join(" AND "),
+                           removeStatements("old"),
+                           addStatements("new"))
+    };
+
+    for ( const QString &stmt : stmts )
+    {
+        if ( !query.exec(stmt) )
+        {
+            qWarning() << "Cannot create the Award Progress" << query.lastError().text();
+            return false;
+        }
+    }
+
+    if ( rebuildNeeded )
+        return rebuild(db);
+
+    available.storeRelease(1);
+    return true;
+}
+
+bool AwardProgress::rebuild(const QSqlDatabase &db)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(runtime) << "Rebuilding the Award Progress";
+
+    // the awards read the contacts table until the progress is complete
+    available.storeRelease(0);
+
+    QSqlDatabase database(db);
+    QSqlQuery query(database);
+    const QStringList columns = keyColumns();
+
+    if ( !database.transaction() )
+    {
+        qWarning() << "Cannot start the Award Progress transaction" << database.lastError().text();
+        return false;
+    }
+
+    if ( !query.exec("DELETE FROM contacts_award_progress") )
+    {
+        qWarning() << "Cannot clear the Award Progress" << query.lastError().text();
+        database.rollback();
+        return false;
+    }
+
+    for ( const QString &column : referenceColumns )
+    {
+        const QStringList values = keyValues(column, "c");
+        QStringList namedValues;
+
+        for ( int i = 0; i < columns.size(); i++ )
+            namedValues << QString("%1 AS %2").arg(values.at(i), columns.at(i));
+
+        namedValues << confirmedValue("c.eqsl_qsl_rcvd") + " AS eqsl"
+                    << confirmedValue("c.lotw_qsl_rcvd") + " AS lotw"
+                    << confirmedValue("c.qsl_rcvd") + " AS paper";
+
+        if ( !query.exec(QString("INSERT INTO contacts_award_progress (%1, cnt, eqsl_cnt, lotw_cnt, qsl_cnt) "
+                                 "SELECT %1, COUNT(1), SUM(eqsl), SUM(lotw), SUM(paper) "
+                                 "FROM (SELECT %2 FROM contacts c) "
+                                 "WHERE ref IS NOT NULL "
+                                 "GROUP BY %1").arg(columns.join(", "), namedValues.join(", "))) )
+        {
+            qWarning() << "Cannot rebuild the Award Progress" << column << query.lastError().text();
+            database.rollback();
+            return false;
+        }
+    }
+
+    if ( !database.commit() )
+    {
+        qWarning() << "Cannot commit the Award Progress" << database.lastError().text();
+        database.rollback();
+        return false;
+    }
+
+    available.storeRelease(1);
+    return true;
+}
+
+QString AwardProgress::sourceSelect(const QString &referenceColumn)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << referenceColumn;
+
+    // the dxcc reference is the dxcc column itself
+    const QString reference = ( referenceColumn == QLatin1String("dxcc") ) ? QString()
+                                                                           : QString(", ref AS %1").arg(referenceColumn);
+
+    // a reference is confirmed by a source if at least one of its QSOs is confirmed
+    return QString("SELECT id, my_dxcc, dxcc, band, prop_mode, mode, "
+                   "       CASE WHEN eqsl_cnt > 0 THEN 'Y' END AS eqsl_qsl_rcvd, "
+                   "       CASE WHEN lotw_cnt > 0 THEN 'Y' END AS lotw_qsl_rcvd, "
+                   "       CASE WHEN qsl_cnt > 0 THEN 'Y' END AS qsl_rcvd%1 "
+                   "FROM contacts_award_progress "
+                   "WHERE kind = '%2'").arg(reference, referenceColumn);
+}
+
+// the value of the award reference; the row is an alias (new, old, table alias)
+QString AwardProgress::referenceValue(const QString &column, const QString &row)
+{
+    if ( column == QLatin1String("gridsquare") )
+        return QString("substr(%1.gridsquare, 1, %2)").arg(row).arg(GRIDSQUARE_MAX_CHARS);
+
+    if ( column == QLatin1String("cnty") )
+        return QString("NULLIF(%1.cnty, '')").arg(row);
+
+    return QString("%1.%2").arg(row, column);
+}
+
+QStringList AwardProgress::keyColumns()
+{
+    return { "kind", "ref", "my_dxcc", "dxcc", "band", "prop_mode", "mode" };
+}
+
+QStringList AwardProgress::keyValues(const QString &column, const QString &row)
+{
+    return { QString("'%1'").arg(column),
+             referenceValue(column, row),
+             QString("%1.my_dxcc").arg(row),
+             ( dxccReferenceColumns.contains(column) ) ? QString("%1.dxcc").arg(row) : QString("NULL"),
+             QString("%1.band").arg(row),
+             QString("%1.prop_mode").arg(row),
+             QString("%1.mode").arg(row) };
+}
+
+// only the received confirmations are counted
+QString AwardProgress::confirmedValue(const QString &column)
+{
+    return QString("CASE WHEN %1 = 'Y' THEN 1 ELSE 0 END").arg(column);
+}
+
+// NULL is a valid key value therefore the key is compared by IS
+QString AwardProgress::keyMatch(const QString &column, const QString &row)
+{
+    const QStringList columns = keyColumns();
+    const QStringList values = keyValues(column, row);
+    QStringList ret;
+
+    for ( int i = 0; i < columns.size(); i++ )
+        ret << QString("%1 IS %2").arg(columns.at(i), values.at(i));
+
+    return ret.join(" AND ");
+}
+
+// a QSO without the reference is not a part of the award
+QString AwardProgress::addStatements(const QString &row)
+{
+    QString ret;
+
+    for ( const QString &column : referenceColumns )
+    {
+        const QString match = keyMatch(column, row);
+
+        ret += QString("INSERT INTO contacts_award_progress (%1, cnt, eqsl_cnt, lotw_cnt, qsl_cnt) "
+                       "SELECT %2, 0, 0, 0, 0 WHERE %3 IS NOT NULL "
+                       "                   AND NOT EXISTS (SELECT 1 FROM contacts_award_progress WHERE %4); "
+                       "UPDATE contacts_award_progress SET cnt = cnt + 1, "
+                       "                                   eqsl_cnt = eqsl_cnt + %5, "
+                       "                                   lotw_cnt = lotw_cnt + %6, "
+                       "                                   qsl_cnt = qsl_cnt + %7 "
+                       "WHERE %4; ").arg(keyColumns().join(", "),
+                                         keyValues(column, row).join(", "),
+                                         referenceValue(column, row),
+                                         match,
+                                         confirmedValue(row + ".eqsl_qsl_rcvd"),
+                                         confirmedValue(row + ".lotw_qsl_rcvd"),
+                                         confirmedValue(row + ".qsl_rcvd"));
+    }
+    return ret;
+}
+
+QString AwardProgress::removeStatements(const QString &row)
+{
+    QString ret;
+
+    for ( const QString &column : referenceColumns )
+    {
+        const QString match = keyMatch(column, row);
+
+        ret += QString("UPDATE contacts_award_progress SET cnt = cnt - 1, "
+                       "                                   eqsl_cnt = eqsl_cnt - %2, "
+                       "                                   lotw_cnt = lotw_cnt - %3, "
+                       "                                   qsl_cnt = qsl_cnt - %4 "
+                       "WHERE %1; "
+                       "DELETE FROM contacts_award_progress WHERE cnt <= 0 AND %1; ").arg(match,
+                                                                                        confirmedValue(row + ".eqsl_qsl_rcvd"),
+                                                                                        confirmedValue(row + ".lotw_qsl_rcvd"),
+                                                                                        confirmedValue(row + ".qsl_rcvd"));
+    }
+    return ret;
+}
+
+// contacts columns which affect the progress
+QStringList AwardProgress::contactsColumns()
+{
+    QStringList ret({ "my_dxcc", "dxcc", "band", "prop_mode", "mode",
+                      "eqsl_qsl_rcvd", "lotw_qsl_rcvd", "qsl_rcvd" });
+
+    ret << referenceColumns;
+    ret.removeDuplicates();
+    return ret;
+}
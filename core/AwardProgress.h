@@ -0,0 +1,56 @@
+#ifndef QLOG_CORE_AWARDPROGRESS_H
+#define QLOG_CORE_AWARDPROGRESS_H
+
+#include <QSqlDatabase>
+#include <QStringList>
+#include <QAtomicInt>
+
+// Materialized progress of the band-table awards.
+// The progress table contains one row per award reference (zone, prefix,
+// park, county, ...), my DXCC entity, band, propagation mode and mode
+// together with the number of QSOs and the number of QSOs confirmed
+// by each confirmation source (eQSL, LoTW, paper).
+// The table is kept in sync with the contacts table by triggers therefore
+// the award tables are evaluated over a small number of progress rows
+// instead of the whole log.
+class AwardProgress
+{
+public:
+    // Creates the progress table and its triggers if they do not exist.
+    // It is called after each DB schema migration check.
+    static bool setup(const QSqlDatabase &db = QSqlDatabase::database());
+
+    // Recomputes the progress table from the contacts table.
+    // It can be called from a worker thread with its own DB connection.
+    static bool rebuild(const QSqlDatabase &db = QSqlDatabase::database());
+
+    static bool isAvailable() { return available.loadAcquire() != 0; }
+
+    // contacts columns which are materialized as award references
+    static const QStringList referenceColumns;
+
+    // references which keep also the worked DXCC entity (dxcc column);
+    // the dxcc column is NULL for the other references
+    static const QStringList dxccReferenceColumns;
+
+    static const QString tableName;
+
+    // SELECT statement which returns contacts-like rows of the reference.
+    // The rows have the columns id, my_dxcc, dxcc, band, prop_mode, mode,
+    // eqsl_qsl_rcvd, lotw_qsl_rcvd, qsl_rcvd and the reference column.
+    static QString sourceSelect(const QString &referenceColumn);
+
+private:
+    static QString referenceValue(const QString &column, const QString &row);
+    static QStringList keyColumns();
+    static QStringList keyValues(const QString &column, const QString &row);
+    static QString keyMatch(const QString &column, const QString &row);
+    static QString confirmedValue(const QString &column);
+    static QString addStatements(const QString &row);
+    static QString removeStatements(const QString &row);
+    static QStringList contactsColumns();
+
+    static QAtomicInt available;
+};
+
+#endif // QLOG_CORE_AWARDPROGRESS_H
@@ -0,0 +1,214 @@
+#include <QSqlQuery>
+#include <QSqlError>
+
+#include "ClubProgress.h"
+#include "core/debug.h"
+
+MODULE_IDENTIFICATION("qlog.core.clubprogress");
+
+QAtomicInt ClubProgress::available(0);
+
+bool ClubProgress::setup(const QSqlDatabase &db)
+{
+    FCT_IDENTIFICATION;
+
+    available.storeRelease(0);
+
+    QSqlQuery query(db);
+
+    // the progress must be rebuilt if it is new or if it was not maintained by triggers
+    if ( !query.exec("SELECT COUNT(1) FROM sqlite_master "
+                     "WHERE (type = 'table' AND name = 'contacts_club_progress') "
+                     "      OR (type = 'trigger' AND name IN ('contacts_club_progress_insert', "
+                     "                                        'contacts_club_progress_delete', "
+                     "                                        'contacts_club_progress_update'))")
+         || !query.first() )
+    {
+        qWarning() << "Cannot check the Club Progress" << query.lastError().text();
+        return false;
+    }
+
+    const bool rebuildNeeded = query.value(0).toInt() != 4;
+    const QStringList columns = contactsColumns();
+    QStringList keyChanged;
+
+    for ( const QString &column : columns )
+        keyChanged << QString("old.%1 IS new.%1").arg(column);
+
+    const QStringList stmts =
+    {
+        QLatin1String("CREATE TABLE IF NOT EXISTS contacts_club_progress ("
+                      "  id INTEGER PRIMARY KEY, clubid TEXT NOT NULL, band TEXT, mode TEXT, "
+                      "  cnt INTEGER NOT NULL, eqsl_cnt INTEGER NOT NULL, "
+                      "  lotw_cnt INTEGER NOT NULL, qsl_cnt INTEGER NOT NULL)"),
+
+        QLatin1String("CREATE INDEX IF NOT EXISTS contacts_club_progress_key_idx "
+                      "ON contacts_club_progress (clubid, band, mode)"),
+
+        QString("CREATE TRIGGER IF NOT EXISTS contacts_club_progress_insert "
+                "AFTER INSERT ON contacts "
+                "BEGIN "
+                "  %1 "
+                "END").arg(addStatements("new")),
+
+        QString("CREATE TRIGGER IF NOT EXISTS contacts_club_progress_delete "
+                "AFTER DELETE ON contacts "
+                "BEGIN "
+                "  %1 "
+                "END").arg(removeStatements("old")),
+
+        QString("CREATE TRIGGER IF NOT EXISTS contacts_club_progress_update "
+                "AFTER UPDATE OF %1 ON contacts "
+                "WHEN NOT (%2) "
+                "BEGIN "
+                "  %3 "
+                "  %4 "
+                "END").arg(columns.join(", "),
+                           keyChanged.join(" AND "),
+                           removeStatements("old"),
+                           addStatements("new"))
+    };
+
+    for ( const QString &stmt : stmts )
+    {
+        if ( !query.exec(stmt) )
+        {
+            qWarning() << "Cannot create the Club Progress" << query.lastError().text();
+            return false;
+        }
+    }
+
+    if ( rebuildNeeded )
+        return rebuild(db);
+
+    available.storeRelease(1);
+    return true;
+}
+
+bool ClubProgress::rebuild(const QSqlDatabase &db)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(runtime) << "Rebuilding the Club Progress";
+
+    // the club status reads the contacts table until the progress is complete
+    available.storeRelease(0);
+
+    QSqlDatabase database(db);
+    QSqlQuery query(database);
+
+    if ( !database.transaction() )
+    {
+        qWarning() << "Cannot start the Club Progress transaction" << database.lastError().text();
+        return false;
+    }
+
+    if ( !query.exec("DELETE FROM contacts_club_progress") )
+    {
+        qWarning() << "Cannot clear the Club Progress" << query.lastError().text();
+        database.rollback();
+        return false;
+    }
+
+    // a member can be listed more times in one club; the QSO is counted once per club
+    if ( !query.exec(QString("INSERT INTO contacts_club_progress (clubid, band, mode, cnt, eqsl_cnt, lotw_cnt, qsl_cnt) "
+                             "SELECT con2club.clubid, c.band, c.mode, COUNT(1), SUM(%1), SUM(%2), SUM(%3) "
+                             "FROM contacts c, "
+                             "     (SELECT DISTINCT contactid, clubid FROM contact_clubs_view) con2club "
+                             "WHERE con2club.contactid = c.id "
+                             "GROUP BY con2club.clubid, c.band, c.mode").arg(confirmedValue("c.eqsl_qsl_rcvd"),
+                                                                           confirmedValue("c.lotw_qsl_rcvd"),
+                                                                           confirmedValue("c.qsl_rcvd"))) )
+    {
+        qWarning() << "Cannot rebuild the Club Progress" << query.lastError().text();
+        database.rollback();
+        return false;
+    }
+
+    if ( !database.commit() )
+    {
+        qWarning() << "Cannot commit the Club Progress" << database.lastError().text();
+        database.rollback();
+        return false;
+    }
+
+    available.storeRelease(1);
+    return true;
+}
+
+QString ClubProgress::sourceSelect()
+{
+    FCT_IDENTIFICATION;
+
+    // a slot is confirmed by a source if at least one of its QSOs is confirmed
+    return QLatin1String("SELECT clubid, band, mode, "
+                         "       CASE WHEN eqsl_cnt > 0 THEN 'Y' END AS eqsl_qsl_rcvd, "
+                         "       CASE WHEN lotw_cnt > 0 THEN 'Y' END AS lotw_qsl_rcvd, "
+                         "       CASE WHEN qsl_cnt > 0 THEN 'Y' END AS qsl_rcvd "
+                         "FROM contacts_club_progress");
+}
+
+// the same base callsign as contacts_autovalue.base_callsign (see DBSchemaMigration::createTriggers);
+// the triggers cannot read contacts_autovalue because the order of the triggers is not defined
+QString ClubProgress::baseCallsignValue(const QString &row)
+{
+    return QString("base_callsign(%1.callsign)").arg(row);
+}
+
+QString ClubProgress::clubsOf(const QString &row)
+{
+    return QString("SELECT DISTINCT clubid FROM membership WHERE callsign = %1").arg(baseCallsignValue(row));
+}
+
+// NULL is a valid band or mode therefore the key is compared by IS
+QString ClubProgress::keyMatch(const QString &row)
+{
+    return QString("band IS %1.band AND mode IS %1.mode AND clubid IN (%2)").arg(row, clubsOf(row));
+}
+
+// only the received confirmations are counted
+QString ClubProgress::confirmedValue(const QString &column)
+{
+    return QString("CASE WHEN %1 = 'Y' THEN 1 ELSE 0 END").arg(column);
+}
+
+// a QSO with a callsign which is not a member of any club does not change the progress
+QString ClubProgress::addStatements(const QString &row)
+{
+    return QString("INSERT INTO contacts_club_progress (clubid, band, mode, cnt, eqsl_cnt, lotw_cnt, qsl_cnt) "
+                   "SELECT club.clubid, %1.band, %1.mode, 0, 0, 0, 0 "
+                   "FROM (%2) club "
+                   "WHERE NOT EXISTS (SELECT 1 FROM contacts_club_progress p "
+                   "                  WHERE p.clubid = club.clubid AND p.band IS %1.band AND p.mode IS %1.mode); "
+                   "UPDATE contacts_club_progress SET cnt = cnt + 1, "
+                   "                                  eqsl_cnt = eqsl_cnt + %4, "
+                   "                                  lotw_cnt = lotw_cnt + %5, "
+                   "                                  qsl_cnt = qsl_cnt + %6 "
+                   "WHERE %3; ").arg(row,
+                                     clubsOf(row),
+                                     keyMatch(row),
+                                     confirmedValue(row + ".eqsl_qsl_rcvd"),
+                                     confirmedValue(row + ".lotw_qsl_rcvd"),
+                                     confirmedValue(row + ".qsl_rcvd"));
+}
+
+QString ClubProgress::removeStatements(const QString &row)
+{
+    const QString match = keyMatch(row);
+
+    return QString("UPDATE contacts_club_progress SET cnt = cnt - 1, "
+                   "                                  eqsl_cnt = eqsl_cnt - %2, "
+                   "                                  lotw_cnt = lotw_cnt - %3, "
+                   "                                  qsl_cnt = qsl_cnt - %4 "
+                   "WHERE %1; "
+                   "DELETE FROM contacts_club_progress WHERE cnt <= 0 AND %1; ").arg(match,
+                                                                                   confirmedValue(row + ".eqsl_qsl_rcvd"),
+                                                                                   confirmedValue(row + ".lotw_qsl_rcvd"),
+                                                                                   confirmedValue(row + ".qsl_rcvd"));
+}
+
+// contacts columns which affect the progress
+QStringList ClubProgress::contactsColumns()
+{
+    return { "callsign", "band", "mode", "eqsl_qsl_rcvd", "lotw_qsl_rcvd", "qsl_rcvd" };
+}
@@ -0,0 +1,50 @@
+#ifndef QLOG_CORE_CLUBPROGRESS_H
+#define QLOG_CORE_CLUBPROGRESS_H
+
+#include <QSqlDatabase>
+#include <QStringList>
+#include <QAtomicInt>
+
+// Materialized worked/confirmed state of the member clubs.
+// The progress table contains one row per club, band and mode together
+// with the number of QSOs with the club members and the number of QSOs
+// confirmed by each confirmation source (eQSL, LoTW, paper).
+// The table is kept in sync with the contacts table by triggers and it is
+// rebuilt when the club lists are changed therefore the club status
+// of a callsign is evaluated over a few progress rows instead of all
+// QSOs with all members of its clubs.
+class ClubProgress
+{
+public:
+    // Creates the progress table and its triggers if they do not exist.
+    // It is called after each DB schema migration check.
+    static bool setup(const QSqlDatabase &db = QSqlDatabase::database());
+
+    // Recomputes the progress table from the contacts and membership tables.
+    // It can be called from a worker thread with its own DB connection.
+    static bool rebuild(const QSqlDatabase &db = QSqlDatabase::database());
+
+    // the membership table is being changed; the progress is not used
+    // until it is rebuilt
+    static void invalidate() { available.storeRelease(0); }
+
+    static bool isAvailable() { return available.loadAcquire() != 0; }
+
+    // SELECT statement which returns the club contacts-like rows.
+    // The rows have the columns clubid, band, mode, eqsl_qsl_rcvd,
+    // lotw_qsl_rcvd and qsl_rcvd.
+    static QString sourceSelect();
+
+private:
+    static QString baseCallsignValue(const QString &row);
+    static QString clubsOf(const QString &row);
+    static QString keyMatch(const QString &row);
+    static QString confirmedValue(const QString &column);
+    static QString addStatements(const QString &row);
+    static QString removeStatements(const QString &row);
+    static QStringList contactsColumns();
+
+    static QAtomicInt available;
+};
+
+#endif // QLOG_CORE_CLUBPROGRESS_H
@@ -0,0 +1,416 @@
+#include <QSqlError>
+#include <QElapsedTimer>
+
+#include "DxSpotEnricher.h"
+#include "core/debug.h"
+#include "core/LogDatabase.h"
+#include "core/LogParam.h"
+#include "core/MembershipQE.h"
+#include "core/PotaQE.h"
+#include "data/Data.h"
+#include "data/Callsign.h"
+#include "data/StationProfile.h"
+
+MODULE_IDENTIFICATION("qlog.core.dxspotenricher");
+
+DxSpotEnricher::Context DxSpotEnricher::Context::current()
+{
+    FCT_IDENTIFICATION;
+
+    Context context;
+
+    context.myDXCC = StationProfilesManager::instance()->getCurProfile1().dxcc;
+    context.lotwConfirmed = LogParam::getDxccConfirmedByLotwState();
+    context.paperConfirmed = LogParam::getDxccConfirmedByPaperState();
+    context.eqslConfirmed = LogParam::getDxccConfirmedByEqslState();
+    context.dupeType = LogParam::getContestDupeType();
+    context.contestID = LogParam::getContestID();
+    context.dupeStartTime = LogParam::getContestDupeDate();
+
+    return context;
+}
+
+DxSpotEnricher::DxSpotEnricher(QObject *parent)
+    : QObject{parent},
+      connectionName(QString("dxspotenricher_%1").arg(reinterpret_cast<quintptr>(this))),
+      connectionOpened(false),
+      clubQueryValid(false)
+{
+    FCT_IDENTIFICATION;
+}
+
+DxSpotEnricher::~DxSpotEnricher()
+{
+    FCT_IDENTIFICATION;
+}
+
+void DxSpotEnricher::enrich(QList<DxSpot> spots, DxSpotEnricher::Context context)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << spots.size();
+
+    Statistics statistics;
+    statistics.spots = spots.size();
+
+    if ( !openConnection() )
+    {
+        // the spots are passed without status information - better than nothing
+        emit spotsEnriched(spots, statistics);
+        return;
+    }
+
+    const QSqlDatabase &db = QSqlDatabase::database(connectionName, false);
+    QElapsedTimer stageTimer;
+
+    stageTimer.start();
+    for ( DxSpot &spot : spots )
+        resolveStage(spot, db);
+    statistics.resolveNs = stageTimer.nsecsElapsed();
+
+    stageTimer.restart();
+    for ( DxSpot &spot : spots )
+        statusStage(spot, context, db);
+    statistics.statusNs = stageTimer.nsecsElapsed();
+
+    stageTimer.restart();
+    for ( DxSpot &spot : spots )
+    {
+        wwffRefFromComment(spot);
+        potaRefFromComment(spot);
+        sotaRefFromComment(spot);
+        iotaRefFromComment(spot);
+        splitFreqFromComment(spot);
+    }
+    statistics.referenceNs = stageTimer.nsecsElapsed();
+
+    emit spotsEnriched(spots, statistics);
+}
+
+void DxSpotEnricher::closeConnection()
+{
+    FCT_IDENTIFICATION;
+
+    if ( !connectionOpened )
+        return;
+
+    clubQuery = QSqlQuery();
+    clubQueryValid = false;
+    connectionOpened = false;
+    LogDatabase::closeThreadConnection(connectionName);
+}
+
+bool DxSpotEnricher::openConnection()
+{
+    FCT_IDENTIFICATION;
+
+    if ( connectionOpened )
+        return true;
+
+    if ( !LogDatabase::instance()->openThreadConnection(connectionName) )
+    {
+        qWarning() << "Cannot open DB Connection for DX Spot Enricher";
+        LogDatabase::closeThreadConnection(connectionName);
+        return false;
+    }
+
+    connectionOpened = true;
+    clubQuery = QSqlQuery(QSqlDatabase::database(connectionName, false));
+    clubQueryValid = MembershipQE::prepareClubQuery(clubQuery);
+
+    return true;
+}
+
+void DxSpotEnricher::resolveStage(DxSpot &spot, const QSqlDatabase &db) const
+{
+    FCT_IDENTIFICATION;
+
+    spot.band = BandPlan::freq2Band(spot.freq, db).name;
+    spot.bandPlanMode = modeGroupFromComment(spot.comment);
+
+    if ( spot.bandPlanMode == BandPlan::BAND_MODE_UNKNOWN )
+    {
+        spot.bandPlanMode = BandPlan::freq2BandMode(spot.freq);
+    }
+    if ( spot.bandPlanMode == BandPlan::BAND_MODE_PHONE )
+    {
+        spot.bandPlanMode = (spot.freq < 10.0 ) ? BandPlan::BAND_MODE_LSB
+                                                : BandPlan::BAND_MODE_USB;
+    }
+    spot.modeGroupString = BandPlan::bandMode2BandModeGroupString(spot.bandPlanMode);
+    spot.dxcc = Data::instance()->lookupDxcc(spot.callsign);
+    spot.dxcc_spotter = Data::instance()->lookupDxcc(spot.spotter);
+}
+
+void DxSpotEnricher::statusStage(DxSpot &spot, const Context &context, const QSqlDatabase &db)
+{
+    FCT_IDENTIFICATION;
+
+    spot.status = Data::instance()->dxccStatus(spot.dxcc.dxcc, spot.band, spot.modeGroupString,
+                                               context.myDXCC,
+                                               context.lotwConfirmed,
+                                               context.paperConfirmed,
+                                               context.eqslConfirmed,
+                                               db);
+    if ( clubQueryValid )
+        spot.callsign_member = MembershipQE::query(spot.callsign, clubQuery);
+
+    spot.dupeCount = Data::countDupe(spot.callsign, spot.band, spot.modeGroupString,
+                                     context.dupeType, context.contestID,
+                                     context.dupeStartTime, db);
+}
+
+BandPlan::BandPlanMode DxSpotEnricher::modeGroupFromComment(const QString &comment)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << comment;
+
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 15, 0))
+    const QStringList &tokenizedComment = comment.split(" ", Qt::SkipEmptyParts);
+#else /* Due to ubuntu 20.04 where qt5.12 is present */
+    const QStringList &tokenizedComment = comment.split(" ", QString::SkipEmptyParts);
+#endif
+
+    if ( tokenizedComment.contains("CW", Qt::CaseInsensitive)
+         || tokenizedComment.contains("<CW>", Qt::CaseInsensitive)
+        )
+        return BandPlan::BAND_MODE_CW;
+
+    if ( tokenizedComment.contains("FT8", Qt::CaseInsensitive)
+         || tokenizedComment.contains("<FT8>", Qt::CaseInsensitive)
+        )
+        return BandPlan::BAND_MODE_FT8;
+
+    if ( tokenizedComment.contains("FT4", Qt::CaseInsensitive)
+         || tokenizedComment.contains("<FT4>", Qt::CaseInsensitive)
+       )
+        return BandPlan::BAND_MODE_FT4;
+
+    if ( tokenizedComment.contains("FT2", Qt::CaseInsensitive)
+        || tokenizedComment.contains("<FT2>", Qt::CaseInsensitive )
+       )
+        return BandPlan::BAND_MODE_FT2;
+
+    if ( tokenizedComment.contains("MSK144", Qt::CaseInsensitive) )
+        return BandPlan::BAND_MODE_DIGITAL;
+
+    if ( tokenizedComment.contains("RTTY", Qt::CaseInsensitive) )
+        return BandPlan::BAND_MODE_DIGITAL;
+
+    if ( tokenizedComment.contains("SSTV", Qt::CaseInsensitive) )
+        return BandPlan::BAND_MODE_DIGITAL;
+
+    if ( tokenizedComment.contains("PACKET", Qt::CaseInsensitive) )
+        return BandPlan::BAND_MODE_DIGITAL;
+
+    if ( tokenizedComment.contains("SSB", Qt::CaseInsensitive)
+         || tokenizedComment.contains("<SSB>", Qt::CaseInsensitive)
+        )
+        return BandPlan::BAND_MODE_PHONE;
+
+    if ( tokenizedComment.contains("USB", Qt::CaseInsensitive) )
+        return BandPlan::BAND_MODE_USB;
+
+    if ( tokenizedComment.contains("LSB", Qt::CaseInsensitive) )
+        return BandPlan::BAND_MODE_LSB;
+
+    if ( tokenizedComment.contains("<FM>", Qt::CaseInsensitive) )
+        return BandPlan::BAND_MODE_PHONE;
+
+    return BandPlan::BAND_MODE_UNKNOWN;
+}
+
+QString DxSpotEnricher::refFromComment(const QString &comment,
+                                       bool &flag,
+                                       const QRegularExpression &regEx,
+                                       const QString &refType,
+                                       int justified)
+{
+    FCT_IDENTIFICATION;
+
+    QRegularExpressionMatch stringMatch = regEx.match(comment);
+    QString ref;
+
+    if (stringMatch.hasMatch())
+    {
+        flag = true;
+        ref = stringMatch.captured(1).toUpper() + "-" + stringMatch.captured(2).rightJustified(justified, '0');
+        qCDebug(runtime) << refType << ":" << ref << "in comment:" << comment;
+    }
+
+    return ref;
+}
+
+void DxSpotEnricher::wwffRefFromComment(DxSpot &spot)
+{
+    FCT_IDENTIFICATION;
+
+    static QRegularExpression wwffRegEx(QStringLiteral("(?:^|\\s)([A-Za-z0-9]{1,3}[Ff]{2})[- ]?(\\d{1,4})(?:\\s|$)"),
+                                        QRegularExpression::CaseInsensitiveOption);
+
+    spot.containsWWFF = spot.comment.contains("WWFF", Qt::CaseInsensitive);
+    spot.wwffRef = refFromComment(spot.comment, spot.containsWWFF,
+                                  wwffRegEx, QStringLiteral("WWFF"), 4);
+}
+
+void DxSpotEnricher::potaRefFromComment(DxSpot &spot)
+{
+    FCT_IDENTIFICATION;
+
+    spot.containsPOTA = spot.comment.contains("POTA", Qt::CaseInsensitive);
+
+    if ( spot.dxcc.dxcc == 0 )
+        return;
+
+    QString flagA2Code = Data::instance()->dxccFlag(spot.dxcc.dxcc);
+
+    if ( flagA2Code == "england" || flagA2Code == "scotland"
+         || flagA2Code == "wales")
+        flagA2Code = "GB";
+
+    QRegularExpression potaCountryRE(QString("(?:^|\\s)(%0)-(\\d{1,5})(?:\\s|@|$)").arg(flagA2Code),
+                                     QRegularExpression::CaseInsensitiveOption);
+
+    spot.potaRef = refFromComment(spot.comment, spot.containsPOTA,
+                                  potaCountryRE, QStringLiteral("POTA_alternative"), 4);
+    if ( !spot.containsPOTA )
+    {
+        Callsign dxSpotCallsign(spot.callsign);
+        // If POTA Info is not present in the comment, try to find it using POTAQE
+        const QString &ref = PotaQE::instance()->findReferenceId(dxSpotCallsign, spot.freq).reference;
+        if ( !ref.isEmpty() )
+        {
+            spot.potaRef = ref;
+            spot.containsPOTA = true;
+            qCDebug(runtime) << "Found POTA" << spot.callsign << ref;
+            spot.comment.append(" [+] POTA " + ref);
+        }
+    }
+}
+
+void DxSpotEnricher::sotaRefFromComment(DxSpot &spot)
+{
+    FCT_IDENTIFICATION;
+
+    static QRegularExpression sotaRefRegEx(QStringLiteral("(?:^|\\s)([A-Za-z0-9]{1,3}/[A-Za-z]{2})-?(\\d{1,3})(?:\\s|$)"),
+                                           QRegularExpression::CaseInsensitiveOption);
+
+    spot.containsSOTA = spot.comment.contains("SOTA", Qt::CaseInsensitive);
+
+    if ( spot.comment.contains("FT8", Qt::CaseInsensitive)  // a false detection in case of TNX/FT8 comments
+        || spot.comment.contains("FT4",Qt::CaseInsensitive) )
+        return;
+
+    spot.sotaRef = refFromComment(spot.comment, spot.containsSOTA,
+                                  sotaRefRegEx, QStringLiteral("SOTA"), 3);
+}
+
+void DxSpotEnricher::iotaRefFromComment(DxSpot &spot)
+{
+    FCT_IDENTIFICATION;
+
+    spot.containsIOTA = spot.comment.contains("IOTA", Qt::CaseInsensitive);
+
+    if ( spot.dxcc.cont.isEmpty() )
+        return;
+
+    QRegularExpression iotaRegEx(QString("(?:^|\\s)(%0)[- ]?(\\d{1,3})(?:\\s|$)").arg(spot.dxcc.cont),
+                                 QRegularExpression::CaseInsensitiveOption);
+    spot.iotaRef = refFromComment(spot.comment, spot.containsIOTA,
+                                  iotaRegEx, QStringLiteral("IOTA"), 3);
+}
+
+void DxSpotEnricher::splitFreqFromComment(DxSpot &spot)
+{
+    FCT_IDENTIFICATION;
+
+    if ( spot.comment.isEmpty() || spot.freq <= 0.0 )
+        return;
+
+    // Absolute TX frequency: "QSX 14250", "QSX 14.250", "LISTENING 28510", "LSN 28.510"
+    static QRegularExpression absFreqRx(QStringLiteral("\\b(?:QSX|LISTENING|LSN)\\s+(\\d+\\.?\\d*)\\b"),
+                                        QRegularExpression::CaseInsensitiveOption);
+    QRegularExpressionMatch match = absFreqRx.match(spot.comment);
+    if ( match.hasMatch() )
+    {
+        double freq = match.captured(1).toDouble();
+        if ( freq > 1000.0 )
+            freq = freq / 1000.0; // kHz → MHz
+        if ( freq > 0.0 )
+        {
+            spot.freqTX = freq;
+            qCDebug(runtime) << "Split absolute TX:" << spot.freqTX << "from:" << spot.comment;
+            return;
+        }
+    }
+
+    // Relative offset UP: "UP 5", "UP 5-10", "UP5" (kHz above spot freq)
+    static QRegularExpression upNRx(QStringLiteral("\\bUP\\s*(\\d+(?:\\.\\d+)?)(?:\\s*[-/]\\s*\\d+(?:\\.\\d+)?)?\\b"),
+                                    QRegularExpression::CaseInsensitiveOption);
+    match = upNRx.match(spot.comment);
+    if ( match.hasMatch() )
+    {
+        double offsetKHz = match.captured(1).toDouble();
+        if ( offsetKHz > 0.0 )
+        {
+            spot.freqTX = spot.freq + offsetKHz / 1000.0;
+            qCDebug(runtime) << "Split UP" << offsetKHz << "kHz, TX:" << spot.freqTX;
+            return;
+        }
+    }
+
+    // Relative offset UP reversed: "1 UP", "5 UP", "5UP"
+    static QRegularExpression nUpRx(QStringLiteral("\\b(\\d+(?:\\.\\d+)?)\\s*UP\\b"),
+                                    QRegularExpression::CaseInsensitiveOption);
+    match = nUpRx.match(spot.comment);
+    if ( match.hasMatch() )
+    {
+        double offsetKHz = match.captured(1).toDouble();
+        if ( offsetKHz > 0.0 )
+        {
+            spot.freqTX = spot.freq + offsetKHz / 1000.0;
+            qCDebug(runtime) << "Split" << offsetKHz << "UP kHz, TX:" << spot.freqTX;
+            return;
+        }
+    }
+
+    // Relative offset DOWN: "DN 5", "DOWN 5", "DWN 5"
+    static QRegularExpression dnNRx(QStringLiteral("\\b(?:DN|DOWN|DWN)\\s*(\\d+(?:\\.\\d+)?)\\b"),
+                                    QRegularExpression::CaseInsensitiveOption);
+    match = dnNRx.match(spot.comment);
+    if ( match.hasMatch() )
+    {
+        double offsetKHz = match.captured(1).toDouble();
+        if ( offsetKHz > 0.0 )
+        {
+            spot.freqTX = spot.freq - offsetKHz / 1000.0;
+            qCDebug(runtime) << "Split DOWN" << offsetKHz << "kHz, TX:" << spot.freqTX;
+            return;
+        }
+    }
+
+    // Relative offset DOWN reversed: "5 DN", "5 DOWN"
+    static QRegularExpression nDnRx(QStringLiteral("\\b(\\d+(?:\\.\\d+)?)\\s*(?:DN|DOWN|DWN)\\b"),
+                                    QRegularExpression::CaseInsensitiveOption);
+    match = nDnRx.match(spot.comment);
+    if ( match.hasMatch() )
+    {
+        double offsetKHz = match.captured(1).toDouble();
+        if ( offsetKHz > 0.0 )
+        {
+            spot.freqTX = spot.freq - offsetKHz / 1000.0;
+            qCDebug(runtime) << "Split" << offsetKHz << "DOWN kHz, TX:" << spot.freqTX;
+            return;
+        }
+    }
+
+    // Bare "UP" without number → 1 kHz default offset
+    static QRegularExpression bareUpRx(QStringLiteral("\\bUP\\b"),
+                                       QRegularExpression::CaseInsensitiveOption);
+    if ( bareUpRx.match(spot.comment).hasMatch() )
+    {
+        spot.freqTX = spot.freq + 1.0 / 1000.0;
+        qCDebug(runtime) << "Split bare UP, TX:" << spot.freqTX;
+    }
+}
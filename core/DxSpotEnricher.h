@@ -0,0 +1,78 @@
+#ifndef QLOG_CORE_DXSPOTENRICHER_H
+#define QLOG_CORE_DXSPOTENRICHER_H
+
+#include <QObject>
+#include <QSqlQuery>
+#include <QRegularExpression>
+
+#include "data/DxSpot.h"
+#include "data/BandPlan.h"
+
+// DxSpotEnricher resolves all DB-dependent properties of received DX Spots
+// (band, DXCC, DXCC Status, memberships, dupe count, references).
+// The object is designed to live in its own thread. It uses its own
+// DB connection therefore the GUI thread is not blocked by the SQL queries.
+class DxSpotEnricher : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Settings which are owned by the GUI thread. They are captured
+    // when a batch is dispatched and passed with the batch.
+    struct Context
+    {
+        int myDXCC = 0;
+        bool lotwConfirmed = false;
+        bool paperConfirmed = false;
+        bool eqslConfirmed = false;
+        int dupeType = 0;
+        QString contestID;
+        QDateTime dupeStartTime;
+
+        static Context current();
+    };
+
+    // Stage latencies of one processed batch
+    struct Statistics
+    {
+        int spots = 0;
+        qint64 resolveNs = 0;
+        qint64 statusNs = 0;
+        qint64 referenceNs = 0;
+    };
+
+    explicit DxSpotEnricher(QObject *parent = nullptr);
+    ~DxSpotEnricher();
+
+    static BandPlan::BandPlanMode modeGroupFromComment(const QString &comment);
+    static void wwffRefFromComment(DxSpot &spot);
+    static void potaRefFromComment(DxSpot &spot);
+    static void sotaRefFromComment(DxSpot &spot);
+    static void iotaRefFromComment(DxSpot &spot);
+    static void splitFreqFromComment(DxSpot &spot);
+
+public slots:
+    void enrich(QList<DxSpot> spots, DxSpotEnricher::Context context);
+    void closeConnection();
+
+signals:
+    void spotsEnriched(QList<DxSpot> spots, DxSpotEnricher::Statistics statistics);
+
+private:
+    bool openConnection();
+    void resolveStage(DxSpot &spot, const QSqlDatabase &db) const;
+    void statusStage(DxSpot &spot, const Context &context, const QSqlDatabase &db);
+    static QString refFromComment(const QString &comment, bool &flag,
+                                  const QRegularExpression &regEx,
+                                  const QString &refType, int justified = 0);
+
+    const QString connectionName;
+    bool connectionOpened;
+    QSqlQuery clubQuery;
+    bool clubQueryValid;
+};
+
+Q_DECLARE_METATYPE(DxSpotEnricher::Context)
+Q_DECLARE_METATYPE(DxSpotEnricher::Statistics)
+
+#endif // QLOG_CORE_DXSPOTENRICHER_H
@@ -25,15 +25,17 @@
 
 MODULE_IDENTIFICATION("qlog.core.lovdownloader");
 
-LOVDownloader::LOVDownloader(QObject *parent) :
+LOVDownloader::LOVDownloader(const QString &connectionName, QObject *parent) :
     QObject(parent),
-    currentReply(nullptr),
+    connectionName(connectionName.isEmpty() ? QString(QSqlDatabase::defaultConnection) : connectionName),
     abortRequested(false),
     CTYPrefixSeperatorRe("[\\s;]"),
     CTYPrefixFormatRe("(=?)([A-Z0-9/]+)(?:\\((\\d+)\\))?(?:\\[(\\d+)\\])?$")
 {
     FCT_IDENTIFICATION;
 
+    qCDebug(function_parameters) << connectionName;
+
     nam = new QNetworkAccessManager(this);
     connect(nam, &QNetworkAccessManager::finished,
             this, &LOVDownloader::processReply);
@@ -44,10 +46,12 @@ LOVDownloader::~LOVDownloader()
     FCT_IDENTIFICATION;
 }
 
-void LOVDownloader::update(const SourceType & sourceType, bool force)
+void LOVDownloader::fetch(const SourceType & sourceType, bool force)
 {
     FCT_IDENTIFICATION;
 
+    qCDebug(function_parameters) << sourceType << force;
+
     abortRequested = false;
 
     const SourceDefinition &sourceDef = sourceMapping[sourceType];
@@ -66,12 +70,12 @@ void LOVDownloader::update(const SourceType & sourceType, bool force)
         {
             // nothing to do.
             qCDebug(runtime) << "Not needed to update " << sourceDef.fileName;
-            emit noUpdate();
+            emit noUpdate(sourceType);
             return;
         }
 
         qCDebug(runtime) << "using cached " << sourceDef.fileName << " at" << dir.path();
-        QTimer::singleShot(0, this, [this, sourceDef]() {loadData(sourceDef);});
+        QTimer::singleShot(0, this, [this, sourceType]() {emit fetched(sourceType);});
     }
     else
     {
@@ -80,19 +84,195 @@ void LOVDownloader::update(const SourceType & sourceType, bool force)
     }
 }
 
-void LOVDownloader::abortRequest()
+bool LOVDownloader::import(const SourceType &sourceType)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << sourceType;
+
+    abortRequested = false;
+
+    const SourceDefinition &sourceDef = sourceMapping[sourceType];
+
+    Q_ASSERT(sourceDef.type == sourceType);
+
+    // The staging tables are TEMP tables with the same names as the source tables.
+    // The TEMP tables hide the source tables therefore the parsers fill them without
+    // locking the database; the source tables are locked only while they are replaced.
+    const QStringList &tables = sourceTables(sourceDef);
+    const bool ret = createStagingTables(tables)
+                     && loadData(sourceDef)
+                     && !abortRequested
+                     && replaceFromStagingTables(tables);
+
+    dropStagingTables(tables);
+
+    return ret;
+}
+
+bool LOVDownloader::isSourceFilled(const SourceType &sourceType)
 {
     FCT_IDENTIFICATION;
 
-    if ( currentReply )
+    return isTableFilled(sourceMapping[sourceType].tableName);
+}
+
+QString LOVDownloader::sourceName(const SourceType &sourceType)
+{
+    switch ( sourceType )
     {
-        currentReply->abort();
-        currentReply = nullptr;
+    case CTY:
+        return tr("DXCC Entities");
+    case SATLIST:
+        return tr("Sats Info");
+    case SOTASUMMITS:
+        return tr("SOTA Summits");
+    case WWFFDIRECTORY:
+        return tr("WWFF Records");
+    case IOTALIST:
+        return tr("IOTA Records");
+    case POTADIRECTORY:
+        return tr("POTA Records");
+    case MEMBERSHIPCONTENTLIST:
+        return tr("Membership Directory Records");
+    case CLUBLOGCTY:
+        return tr("Clublog CTY.XML");
+    default:
+        return tr("List of Values");
     }
+}
+
+void LOVDownloader::abortRequest()
+{
+    FCT_IDENTIFICATION;
+
+    // abort() emits finished() and processReply removes the reply from the list
+    const QList<QNetworkReply *> replies = pendingReplies;
+
+    for ( QNetworkReply *reply : replies )
+        reply->abort();
+
     abortRequested = true;
 }
 
-void LOVDownloader::loadData(const LOVDownloader::SourceDefinition &sourceDef)
+QSqlDatabase LOVDownloader::db() const
+{
+    return QSqlDatabase::database(connectionName, false);
+}
+
+QStringList LOVDownloader::sourceTables(const SourceDefinition &sourceDef) const
+{
+    switch ( sourceDef.type )
+    {
+    case CTY:
+        return QStringList{sourceDef.tableName, "dxcc_prefixes_ad1c"};
+    case CLUBLOGCTY:
+        return QStringList{sourceDef.tableName, "dxcc_prefixes_clublog", "dxcc_zone_exceptions_clublog"};
+    default:
+        return QStringList{sourceDef.tableName};
+    }
+}
+
+bool LOVDownloader::createStagingTables(const QStringList &tables)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << tables;
+
+    QSqlQuery query(db());
+
+    for ( const QString &table : tables )
+    {
+        if ( !query.prepare("SELECT sql FROM main.sqlite_master WHERE type = 'table' AND name = :name COLLATE NOCASE") )
+        {
+            qWarning() << "Cannot prepare Select statement - Staging Table" << query.lastError().text();
+            return false;
+        }
+
+        query.bindValue(":name", table);
+
+        if ( !query.exec() || !query.first() )
+        {
+            qWarning() << "Cannot get definition of" << table << query.lastError().text();
+            return false;
+        }
+
+        // SQLite stores the statement normalized - it always starts with CREATE TABLE
+        QString createStatement = query.value(0).toString();
+        const QString createTable("CREATE TABLE");
+
+        if ( !createStatement.startsWith(createTable, Qt::CaseInsensitive) )
+        {
+            qWarning() << "Unexpected definition of" << table << createStatement;
+            return false;
+        }
+
+        createStatement.replace(0, createTable.size(), "CREATE TEMP TABLE");
+
+        if ( !query.exec(QString("DROP TABLE IF EXISTS temp.%1").arg(table))
+             || !query.exec(createStatement) )
+        {
+            qWarning() << "Cannot create Staging Table" << table << query.lastError().text();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool LOVDownloader::replaceFromStagingTables(const QStringList &tables)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << tables;
+
+    QSqlQuery query(db());
+
+    // the write lock is taken at the beginning; a deferred transaction
+    // would fail without waiting when another connection writes at the same time
+    if ( !query.exec("BEGIN IMMEDIATE") )
+    {
+        qWarning() << "Cannot start transaction" << query.lastError().text();
+        return false;
+    }
+
+    for ( const QString &table : tables )
+    {
+        if ( !query.exec(QString("DELETE FROM main.%1").arg(table))
+             || !query.exec(QString("INSERT INTO main.%1 SELECT * FROM temp.%1").arg(table)) )
+        {
+            qWarning() << "Cannot replace" << table << query.lastError().text();
+            db().rollback();
+            return false;
+        }
+    }
+
+    if ( !db().commit() )
+    {
+        qWarning() << "Cannot commit" << tables << db().lastError().text();
+        db().rollback();
+        return false;
+    }
+
+    return true;
+}
+
+void LOVDownloader::dropStagingTables(const QStringList &tables)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << tables;
+
+    QSqlQuery query(db());
+
+    for ( const QString &table : tables )
+    {
+        if ( !query.exec(QString("DROP TABLE IF EXISTS temp.%1").arg(table)) )
+            qWarning() << "Cannot drop Staging Table" << table << query.lastError().text();
+    }
+}
+
+bool LOVDownloader::loadData(const LOVDownloader::SourceDefinition &sourceDef)
 {
     FCT_IDENTIFICATION;
 
@@ -101,7 +281,7 @@ void LOVDownloader::loadData(const LOVDownloader::SourceDefinition &sourceDef)
     if ( ! file.open(QIODevice::ReadOnly) )
     {
         qWarning() << "Cannot open" << dir.filePath(sourceDef.fileName);
-        return;
+        return false;
     }
 
     QByteArray data = file.readAll();
@@ -113,8 +293,7 @@ void LOVDownloader::loadData(const LOVDownloader::SourceDefinition &sourceDef)
     emit processingSize(data.size());
 
     QTextStream stream(data);
-    parseData(sourceDef, stream);
-    emit finished(true);
+    return parseData(sourceDef, stream);
 }
 
 bool LOVDownloader::isTableFilled(const QString &tableName)
@@ -123,8 +302,9 @@ bool LOVDownloader::isTableFilled(const QString &tableName)
 
     qCDebug(function_parameters) << tableName;
 
-    QSqlQuery query(QString("select exists( select 1 from %1)").arg(tableName));
-    int i = query.first() ? query.value(0).toInt() : 0;
+    QSqlQuery query(db());
+    int i = query.exec(QString("select exists( select 1 from %1)").arg(tableName))
+            && query.first() ? query.value(0).toInt() : 0;
 
     qCDebug(runtime) << i;
     return i==1;
@@ -136,7 +316,7 @@ bool LOVDownloader::deleteTable(const QString &tableName)
 
     qCDebug(function_parameters) << tableName;
 
-    QSqlQuery query;
+    QSqlQuery query(db());
     QString queryStatement("delete from %1");
 
     if ( ! query.exec(queryStatement.arg(tableName)) )
@@ -158,18 +338,14 @@ void LOVDownloader::download(const LOVDownloader::SourceDefinition &sourceDef)
     QString rheader = QString("QLog/%1").arg(VERSION);
     request.setRawHeader("User-Agent", rheader.toUtf8());
 
-    if ( currentReply )
-    {
-        qCWarning(runtime) << "processing a new request but the previous one hasn't been completed yet !!!";
-    }
-
-    currentReply = nam->get(request);
-    currentReply->setProperty("sourceType", sourceDef.type);
+    QNetworkReply *reply = nam->get(request);
+    reply->setProperty("sourceType", sourceDef.type);
+    pendingReplies << reply;
 
     qCDebug(runtime) << "Downloading " << sourceDef.fileName << "from " << url.toString();
 }
 
-void LOVDownloader::parseData(const SourceDefinition &sourceDef, QTextStream &data)
+bool LOVDownloader::parseData(const SourceDefinition &sourceDef, QTextStream &data)
 {
     FCT_IDENTIFICATION;
 
@@ -178,57 +354,51 @@ void LOVDownloader::parseData(const SourceDefinition &sourceDef, QTextStream &da
     switch ( sourceDef.type )
     {
     case CTY:
-        parseCTY(sourceDef, data);
-        break;
+        return parseCTY(sourceDef, data);
     case SATLIST:
-        parseSATLIST(sourceDef, data);
-        break;
+        return parseSATLIST(sourceDef, data);
     case SOTASUMMITS:
-        parseSOTASummits(sourceDef, data);
-        break;
+        return parseSOTASummits(sourceDef, data);
     case WWFFDIRECTORY:
-        parseWWFFDirectory(sourceDef, data);
-        break;
+        return parseWWFFDirectory(sourceDef, data);
     case IOTALIST:
-        parseIOTA(sourceDef, data);
-        break;
+        return parseIOTA(sourceDef, data);
     case POTADIRECTORY:
-        parsePOTA(sourceDef, data);
-        break;
+        return parsePOTA(sourceDef, data);
     case MEMBERSHIPCONTENTLIST:
-        parseMembershipContent(sourceDef, data);
-        break;
+        return parseMembershipContent(sourceDef, data);
     case CLUBLOGCTY:
-        parseClubLogCTY(sourceDef, data);
-        break;
+        return parseClubLogCTY(sourceDef, data);
     default:
         qWarning() << "Unssorted type to download" << sourceDef.type << sourceDef.fileName;
     }
+
+    return false;
 }
 
-void LOVDownloader::parseCTY(const SourceDefinition &sourceDef, QTextStream &data)
+bool LOVDownloader::parseCTY(const SourceDefinition &sourceDef, QTextStream &data)
 {
     FCT_IDENTIFICATION;
 
     QRegularExpressionMatch matchExp;
 
-    QSqlDatabase::database().transaction();
+    db().transaction();
 
     if ( ! deleteTable("dxcc_prefixes_ad1c") )
     {
         qCWarning(runtime) << "dxcc_prefixes_ad1c delete failed - rollback";
-        QSqlDatabase::database().rollback();
-        return;
+        db().rollback();
+        return false;
     }
 
     if ( ! deleteTable(sourceDef.tableName) )
     {
         qCWarning(runtime) << sourceDef.tableName << " delete failed - rollback";
-        QSqlDatabase::database().rollback();
-        return;
+        db().rollback();
+        return false;
     }
 
-    QSqlQuery insertEntityQuery;
+    QSqlQuery insertEntityQuery(db());
 
     if ( ! insertEntityQuery.prepare("INSERT INTO dxcc_entities_ad1c (id,"
                                "                        name,"
@@ -253,7 +423,7 @@ void LOVDownloader::parseCTY(const SourceDefinition &sourceDef, QTextStream &dat
         abortRequested = true;
     }
 
-    QSqlQuery insertPrefixesQuery;
+    QSqlQuery insertPrefixesQuery(db());
 
     if ( ! insertPrefixesQuery.prepare("INSERT INTO dxcc_prefixes_ad1c ("
                                "                        prefix,"
@@ -367,30 +537,29 @@ void LOVDownloader::parseCTY(const SourceDefinition &sourceDef, QTextStream &dat
     if ( !abortRequested )
     {
         qCDebug(runtime) << "DXCC update finished:" << count << "entities loaded.";
-        QSqlDatabase::database().commit();
-    }
-    else
-    {
-        //can be a result of abort
-        qCWarning(runtime) << "DXCC update failed - rollback";
-        QSqlDatabase::database().rollback();
+        return db().commit();
     }
+
+    //can be a result of abort
+    qCWarning(runtime) << "DXCC update failed - rollback";
+    db().rollback();
+    return false;
 }
 
-void LOVDownloader::parseSATLIST(const SourceDefinition &sourceDef, QTextStream &data)
+bool LOVDownloader::parseSATLIST(const SourceDefinition &sourceDef, QTextStream &data)
 {
     FCT_IDENTIFICATION;
 
-    QSqlDatabase::database().transaction();
+    db().transaction();
 
     if ( ! deleteTable(sourceDef.tableName) )
     {
         qCWarning(runtime) << "Satlist delete failed - rollback";
-        QSqlDatabase::database().rollback();
-        return;
+        db().rollback();
+        return false;
     }
 
-    QSqlTableModel entityTableModel;
+    QSqlTableModel entityTableModel(nullptr, db());
     entityTableModel.setTable(sourceDef.tableName);
     entityTableModel.setEditStrategy(QSqlTableModel::OnManualSubmit);
     QSqlRecord entityRecord = entityTableModel.record();
@@ -436,15 +605,14 @@ void LOVDownloader::parseSATLIST(const SourceDefinition &sourceDef, QTextStream
     if ( entityTableModel.submitAll()
          && !abortRequested )
     {
-        QSqlDatabase::database().commit();
         qCDebug(runtime) << "Satlist update finished:" << count << "entities loaded.";
+        return db().commit();
     }
-    else
-    {
-        //can be a result of abort
-        qCWarning(runtime) << "Satlist update failed - rollback" << entityTableModel.lastError();
-        QSqlDatabase::database().rollback();
-    }
+
+    //can be a result of abort
+    qCWarning(runtime) << "Satlist update failed - rollback" << entityTableModel.lastError();
+    db().rollback();
+    return false;
 }
 
 bool LOVDownloader::parseCSVGeneric(const SourceDefinition &sourceDef,
@@ -468,20 +636,20 @@ bool LOVDownloader::parseCSVGeneric(const SourceDefinition &sourceDef,
         return false;
     }
 
-    QSqlDatabase::database().transaction();
+    db().transaction();
 
     if ( !deleteTable(sourceDef.tableName) )
     {
         qCWarning(runtime) << "Delete failed - rollback:" << sourceDef.tableName;
-        QSqlDatabase::database().rollback();
+        db().rollback();
         return false;
     }
 
-    QSqlQuery insertQuery;
+    QSqlQuery insertQuery(db());
     if ( !insertQuery.prepare(insertSQL) )
     {
         qWarning() << "Cannot prepare insert statement for" << sourceDef.tableName;
-        QSqlDatabase::database().rollback();
+        db().rollback();
         return false;
     }
 
@@ -493,7 +661,7 @@ bool LOVDownloader::parseCSVGeneric(const SourceDefinition &sourceDef,
         if ( std::find(colNames.begin(), colNames.end(), col.toStdString()) == colNames.end() )
         {
             qWarning() << "Missing column:" << col << "in" << sourceDef.tableName;
-            QSqlDatabase::database().rollback();
+            db().rollback();
             return false;
         }
     }
@@ -566,75 +734,75 @@ bool LOVDownloader::parseCSVGeneric(const SourceDefinition &sourceDef,
 
     if ( !abortRequested )
     {
-        QSqlDatabase::database().commit();
+        db().commit();
         qCDebug(runtime) << sourceDef.tableName << "update finished:" << count << "entities loaded.";
         return true;
     }
 
     qCWarning(runtime) << sourceDef.tableName << "update failed - rollback";
-    QSqlDatabase::database().rollback();
+    db().rollback();
     return false;
 }
 
-void LOVDownloader::parseSOTASummits(const SourceDefinition &sourceDef, QTextStream &data)
+bool LOVDownloader::parseSOTASummits(const SourceDefinition &sourceDef, QTextStream &data)
 {
     FCT_IDENTIFICATION;
 
     csv::CSVFormat format;
     format.delimiter(',').quote('"').header_row(1);
 
-    parseCSVGeneric(sourceDef, data,
-                    "INSERT INTO sota_summits(summit_code, association_name, region_name, summit_name,"
-                    "  altm, altft, gridref1, gridref2, longitude, latitude, points, bonus_points,"
-                    "  valid_from, valid_to) VALUES (?,?,?,?,?,?,?,?,?,?,?,?,?,?)",
-                    {"SummitCode", "AssociationName", "RegionName", "SummitName",
-                     "AltM", "AltFt", "GridRef1", "GridRef2",
-                     "Longitude", "Latitude", "Points", "BonusPoints",
-                     "ValidFrom", "ValidTo"},
-                    format,
-                    "SOTA Summits List");   // preValidateContains
+    return parseCSVGeneric(sourceDef, data,
+                           "INSERT INTO sota_summits(summit_code, association_name, region_name, summit_name,"
+                           "  altm, altft, gridref1, gridref2, longitude, latitude, points, bonus_points,"
+                           "  valid_from, valid_to) VALUES (?,?,?,?,?,?,?,?,?,?,?,?,?,?)",
+                           {"SummitCode", "AssociationName", "RegionName", "SummitName",
+                            "AltM", "AltFt", "GridRef1", "GridRef2",
+                            "Longitude", "Latitude", "Points", "BonusPoints",
+                            "ValidFrom", "ValidTo"},
+                           format,
+                           "SOTA Summits List");   // preValidateContains
 }
 
-void LOVDownloader::parseWWFFDirectory(const SourceDefinition &sourceDef, QTextStream &data)
+bool LOVDownloader::parseWWFFDirectory(const SourceDefinition &sourceDef, QTextStream &data)
 {
     FCT_IDENTIFICATION;
 
     csv::CSVFormat format;
     format.delimiter(',').quote('"').trim({' '});
 
-    parseCSVGeneric(sourceDef, data,
-                    "INSERT INTO wwff_directory(reference, status, name, program, dxcc, state,"
-                    "  county, continent, iota, iaruLocator, latitude, longitude, iucncat,"
-                    "  valid_from, valid_to) VALUES (?,?,?,?,?,?,?,?,?,?,?,?,?,?,?)",
-                    {"reference", "status", "name", "program", "dxcc", "state",
-                     "county", "continent", "iota", "iaruLocator", "latitude", "longitude",
-                     "IUCNcat", "validFrom", "validTo"},
-                    format);
+    return parseCSVGeneric(sourceDef, data,
+                           "INSERT INTO wwff_directory(reference, status, name, program, dxcc, state,"
+                           "  county, continent, iota, iaruLocator, latitude, longitude, iucncat,"
+                           "  valid_from, valid_to) VALUES (?,?,?,?,?,?,?,?,?,?,?,?,?,?,?)",
+                           {"reference", "status", "name", "program", "dxcc", "state",
+                            "county", "continent", "iota", "iaruLocator", "latitude", "longitude",
+                            "IUCNcat", "validFrom", "validTo"},
+                           format);
 }
 
 
-void LOVDownloader::parseIOTA(const SourceDefinition &sourceDef, QTextStream &data)
+bool LOVDownloader::parseIOTA(const SourceDefinition &sourceDef, QTextStream &data)
 {
     FCT_IDENTIFICATION;
 
-    QSqlQuery insertQuery;
+    QSqlQuery insertQuery(db());
     if ( ! insertQuery.prepare("INSERT INTO IOTA(iotaid,"
                              "                 islandname)"
                              " VALUES (?, ?)") )
     {
         qWarning() << "cannot prepare Insert statement";
         abortRequested = true;
-        return;
+        return false;
     }
 
-    QSqlDatabase::database().transaction();
+    db().transaction();
 
     if ( ! deleteTable(sourceDef.tableName) )
     {
         qCWarning(runtime) << "IOTA List delete failed - rollback";
         abortRequested = true;
-        QSqlDatabase::database().rollback();
-        return;
+        db().rollback();
+        return false;
     }
 
     unsigned int count = 0;
@@ -687,45 +855,44 @@ void LOVDownloader::parseIOTA(const SourceDefinition &sourceDef, QTextStream &da
 
     if ( !abortRequested )
     {
-        QSqlDatabase::database().commit();
         qCDebug(runtime) << "IOTA update finished:" << count << "entities loaded.";
+        return db().commit();
     }
-    else
-    {
-        qCWarning(runtime) << "IOTA update failed - rollback";
-        QSqlDatabase::database().rollback();
-    }
+
+    qCWarning(runtime) << "IOTA update failed - rollback";
+    db().rollback();
+    return false;
 }
 
-void LOVDownloader::parsePOTA(const SourceDefinition &sourceDef, QTextStream &data)
+bool LOVDownloader::parsePOTA(const SourceDefinition &sourceDef, QTextStream &data)
 {
     FCT_IDENTIFICATION;
 
     csv::CSVFormat format;
     format.delimiter(',').quote('"');
 
-    parseCSVGeneric(sourceDef, data,
-                    "INSERT INTO POTA_DIRECTORY(reference, name, active, entityID,"
-                    "  locationDesc, latitude, longitude, grid) VALUES (?,?,?,?,?,?,?,?)",
-                    {"reference", "name", "active", "entityId",
-                     "locationDesc", "latitude", "longitude", "grid"},
-                    format);
+    return parseCSVGeneric(sourceDef, data,
+                           "INSERT INTO POTA_DIRECTORY(reference, name, active, entityID,"
+                           "  locationDesc, latitude, longitude, grid) VALUES (?,?,?,?,?,?,?,?)",
+                           {"reference", "name", "active", "entityId",
+                            "locationDesc", "latitude", "longitude", "grid"},
+                           format);
 }
 
-void LOVDownloader::parseMembershipContent(const SourceDefinition &sourceDef, QTextStream &data)
+bool LOVDownloader::parseMembershipContent(const SourceDefinition &sourceDef, QTextStream &data)
 {
     FCT_IDENTIFICATION;
 
-    QSqlDatabase::database().transaction();
+    db().transaction();
 
     if ( ! deleteTable(sourceDef.tableName) )
     {
         qCWarning(runtime) << "Membership Directory delete failed - rollback";
-        QSqlDatabase::database().rollback();
-        return;
+        db().rollback();
+        return false;
     }
 
-    QSqlTableModel entityTableModel;
+    QSqlTableModel entityTableModel(nullptr, db());
     entityTableModel.setTable(sourceDef.tableName);
     entityTableModel.setEditStrategy(QSqlTableModel::OnManualSubmit);
     QSqlRecord entityRecord = entityTableModel.record();
@@ -768,34 +935,33 @@ void LOVDownloader::parseMembershipContent(const SourceDefinition &sourceDef, QT
     if ( entityTableModel.submitAll()
          && !abortRequested )
     {
-        QSqlDatabase::database().commit();
         qCDebug(runtime) << "Membership Directory update finished:" << count << "entities loaded.";
-    }
-    else
-    {
-        //can be a result of abort
-        qCWarning(runtime) << "Membership Directory update failed - rollback" << entityTableModel.lastError();
-        QSqlDatabase::database().rollback();
+        return db().commit();
     }
 
+    //can be a result of abort
+    qCWarning(runtime) << "Membership Directory update failed - rollback" << entityTableModel.lastError();
+    db().rollback();
+    return false;
+
 }
 
-void LOVDownloader::parseClubLogCTY(const SourceDefinition &sourceDef, QTextStream &data)
+bool LOVDownloader::parseClubLogCTY(const SourceDefinition &sourceDef, QTextStream &data)
 {
     FCT_IDENTIFICATION;
 
-    if (sourceDef.type != CLUBLOGCTY) return;
+    if (sourceDef.type != CLUBLOGCTY) return false;
 
     // Read whole text (it’s XML); QXmlStreamReader can also take QIODevice, but we
     // already have a QTextStream here.
     QXmlStreamReader xml(data.readAll());
 
     // Clean all five tables inside one transaction
-    QSqlDatabase::database().transaction();
+    db().transaction();
     auto rollback = [&]()
     {
         qCWarning(runtime) << "ClubLog CTY import failed - rollback";
-        QSqlDatabase::database().rollback();
+        db().rollback();
     };
 
     if ( !deleteTable("dxcc_zone_exceptions_clublog")
@@ -803,31 +969,31 @@ void LOVDownloader::parseClubLogCTY(const SourceDefinition &sourceDef, QTextStre
         || !deleteTable("dxcc_entities_clublog"))
     {
         rollback();
-        return;
+        return false;
     }
 
-    QSqlQuery insEntity, insPrefix,insZone;
+    QSqlQuery insEntity(db()), insPrefix(db()), insZone(db());
 
     // prepared statements
     if (!insEntity.prepare(
                 "INSERT INTO dxcc_entities_clublog(id, name, prefix, deleted, cqz, ituz, cont, lon, lat, start, \"end\")"
                 "VALUES(:id, :name, :prefix, :deleted, :cqz, :ituz, :cont, :lon, :lat, :start, :end)"))
     {
-        qWarning() << insEntity.lastError(); rollback(); return;
+        qWarning() << insEntity.lastError(); rollback(); return false;
     }
 
     if (!insPrefix.prepare(
                 "INSERT INTO dxcc_prefixes_clublog(prefix, exact, dxcc, cqz, cont, lon, lat, start, \"end\")"
                 "VALUES(:prefix, :exact, :dxcc, :cqz, :cont, :lon, :lat, :start, :end)"))
     {
-        qWarning() << insPrefix.lastError(); rollback(); return;
+        qWarning() << insPrefix.lastError(); rollback(); return false;
     }
 
     if (!insZone.prepare(
                 "INSERT INTO dxcc_zone_exceptions_clublog(record, call, cqz, start, \"end\")"
                 "VALUES(:record, :call, :cqz, :start, :end)"))
     {
-        qWarning() << insZone.lastError(); rollback(); return;
+        qWarning() << insZone.lastError(); rollback(); return false;
     }
 
     auto readText = [&](QXmlStreamReader &x)->QString { return x.readElementText().trimmed(); };
@@ -839,7 +1005,7 @@ void LOVDownloader::parseClubLogCTY(const SourceDefinition &sourceDef, QTextStre
     if (xml.atEnd())
     {
         qWarning() << "ClubLog: <clublog> not found";
-        rollback(); return;
+        rollback(); return false;
     }
 
     quint32 readOp = 0;
@@ -917,7 +1083,7 @@ void LOVDownloader::parseClubLogCTY(const SourceDefinition &sourceDef, QTextStre
                     insEntity.bindValue(":start", start.isEmpty()? QVariant() : start);
                     insEntity.bindValue(":end",   end.isEmpty()?   QVariant() : end);
 
-                    if (!insEntity.exec()) { qWarning() << insEntity.lastError(); rollback(); return; }
+                    if (!insEntity.exec()) { qWarning() << insEntity.lastError(); rollback(); return false; }
                 }
             }
         }
@@ -975,7 +1141,7 @@ void LOVDownloader::parseClubLogCTY(const SourceDefinition &sourceDef, QTextStre
                     {
                         qWarning() << insPrefix.lastError();
                         rollback();
-                        return;
+                        return false;
                     }
                 }
             }
@@ -1017,7 +1183,7 @@ void LOVDownloader::parseClubLogCTY(const SourceDefinition &sourceDef, QTextStre
                     {
                         qWarning() << insZone.lastError();
                         rollback();
-                        return;
+                        return false;
                     }
                 }
             }
@@ -1032,18 +1198,18 @@ void LOVDownloader::parseClubLogCTY(const SourceDefinition &sourceDef, QTextStre
     {
         qWarning() << "ClubLog XML error:" << xml.errorString();
         rollback();
-        return;
+        return false;
     }
 
-    QSqlDatabase::database().commit();
     qCDebug(runtime) << "ClubLog CTY import finished.";
+    return db().commit();
 }
 
 void LOVDownloader::processReply(QNetworkReply *reply)
 {
     FCT_IDENTIFICATION;
 
-    currentReply = nullptr;
+    pendingReplies.removeAll(reply);
 
     QByteArray data = reply->readAll();
     uint sourceTypeNum = reply->property("sourceType").toUInt();
@@ -1080,7 +1246,7 @@ void LOVDownloader::processReply(QNetworkReply *reply)
         reply->deleteLater();
 
         LogParam::setLOVParam(sourceDef.lastTimeConfigName, QDateTime::currentDateTimeUtc().date());
-        loadData(sourceDef);
+        emit fetched(sourceType);
     }
     else
     {
@@ -1088,6 +1254,6 @@ void LOVDownloader::processReply(QNetworkReply *reply)
         qCDebug(runtime) << "Failed to download " << sourceDef.fileName;
 
         reply->deleteLater();
-        emit finished(false);
+        emit fetchFailed(sourceType);
     }
 }
@@ -4,6 +4,7 @@
 #include <QObject>
 #include <QNetworkAccessManager>
 #include <QRegularExpression>
+#include <QSqlDatabase>
 #include "service/clublog/ClubLog.h"
 
 namespace csv
@@ -30,9 +31,25 @@ public:
     };
 
 public:
-    LOVDownloader(QObject *parent = nullptr);
+    // connectionName is the DB connection which is used by the import;
+    // an empty name means the default connection
+    explicit LOVDownloader(const QString &connectionName = QString(),
+                           QObject *parent = nullptr);
     ~LOVDownloader();
-    void update(const SourceType &, bool force = false);
+
+    // Checks the source and downloads it if it is too old or missing.
+    // Emits fetched() when the file is ready to import, noUpdate() when the file
+    // is fresh and the table is filled and fetchFailed() when the download fails.
+    // Several sources can be fetched at once.
+    void fetch(const SourceType &, bool force = false);
+
+    // Imports the fetched file. The file is parsed into staging tables and the
+    // source tables are replaced in one short transaction.
+    // It is called from the thread which owns the DB connection.
+    bool import(const SourceType &);
+
+    bool isSourceFilled(const SourceType &);
+    static QString sourceName(const SourceType &);
 
 public slots:
     void abortRequest();
@@ -40,8 +57,9 @@ public slots:
 signals:
     void processingSize(qint64);
     void progress(qint64 count);
-    void finished(bool result);
-    void noUpdate();
+    void fetched(LOVDownloader::SourceType);
+    void fetchFailed(LOVDownloader::SourceType);
+    void noUpdate(LOVDownloader::SourceType);
 
 private:
     class SourceDefinition
@@ -120,26 +138,33 @@ private:
     };
 
 
+    QString connectionName;
     QNetworkAccessManager* nam;
-    QNetworkReply *currentReply;
+    QList<QNetworkReply *> pendingReplies;
     bool abortRequested;
     QRegularExpression CTYPrefixSeperatorRe;
     QRegularExpression CTYPrefixFormatRe;
 
 private:
+    QSqlDatabase db() const;
+    QStringList sourceTables(const SourceDefinition &) const;
+    bool createStagingTables(const QStringList &tables);
+    bool replaceFromStagingTables(const QStringList &tables);
+    void dropStagingTables(const QStringList &tables);
+    bool loadData(const LOVDownloader::SourceDefinition &);
     bool isTableFilled(const QString &);
     bool deleteTable(const QString &);
     void download(const SourceDefinition &);
-    void parseData(const LOVDownloader::SourceDefinition &,
+    bool parseData(const LOVDownloader::SourceDefinition &,
                    QTextStream &);
-    void parseCTY(const SourceDefinition &sourceDef, QTextStream& data);
-    void parseSATLIST(const SourceDefinition &sourceDef, QTextStream& data);
-    void parseSOTASummits(const SourceDefinition &sourceDef, QTextStream& data);
-    void parseWWFFDirectory(const SourceDefinition &sourceDef, QTextStream& data);
-    void parseIOTA(const SourceDefinition &sourceDef, QTextStream& data);
-    void parsePOTA(const SourceDefinition &sourceDef, QTextStream& data);
-    void parseMembershipContent(const SourceDefinition &sourceDef, QTextStream& data);
-    void parseClubLogCTY(const SourceDefinition &sourceDef, QTextStream &data);
+    bool parseCTY(const SourceDefinition &sourceDef, QTextStream& data);
+    bool parseSATLIST(const SourceDefinition &sourceDef, QTextStream& data);
+    bool parseSOTASummits(const SourceDefinition &sourceDef, QTextStream& data);
+    bool parseWWFFDirectory(const SourceDefinition &sourceDef, QTextStream& data);
+    bool parseIOTA(const SourceDefinition &sourceDef, QTextStream& data);
+    bool parsePOTA(const SourceDefinition &sourceDef, QTextStream& data);
+    bool parseMembershipContent(const SourceDefinition &sourceDef, QTextStream& data);
+    bool parseClubLogCTY(const SourceDefinition &sourceDef, QTextStream &data);
     bool parseCSVGeneric(const SourceDefinition &sourceDef,
                          QTextStream &data,
                          const QString &insertSQL,
@@ -148,7 +173,6 @@ private:
                          const QString &preValidateContains = QString());
 private slots:
     void processReply(QNetworkReply*);
-    void loadData(const LOVDownloader::SourceDefinition &);
 
 };
 
@@ -0,0 +1,211 @@
+#include <QThread>
+#include <QSharedPointer>
+
+#include "LOVUpdateScheduler.h"
+#include "core/LogDatabase.h"
+#include "core/MembershipQE.h"
+#include "data/Data.h"
+#include "core/debug.h"
+
+MODULE_IDENTIFICATION("qlog.core.lovupdatescheduler");
+
+LOVUpdateScheduler::LOVUpdateScheduler(QObject *parent) :
+    QObject(parent)
+{
+    FCT_IDENTIFICATION;
+
+    connect(&downloader, &LOVDownloader::fetched,
+            this, &LOVUpdateScheduler::importSource);
+    connect(&downloader, &LOVDownloader::noUpdate,
+            this, &LOVUpdateScheduler::sourceNotUpdated);
+    connect(&downloader, &LOVDownloader::fetchFailed,
+            this, &LOVUpdateScheduler::sourceFetchFailed);
+}
+
+LOVUpdateScheduler::~LOVUpdateScheduler()
+{
+    FCT_IDENTIFICATION;
+
+    // the application is closing - the running imports are rolled back
+    for ( const SourceState &state : qAsConst(pendingSources) )
+    {
+        if ( state.thread )
+            state.thread->requestInterruption();
+    }
+
+    for ( const SourceState &state : qAsConst(pendingSources) )
+    {
+        if ( state.thread )
+        {
+            state.thread->wait();
+            delete state.thread;
+        }
+    }
+}
+
+void LOVUpdateScheduler::start(bool force)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << force;
+
+    // the ClubLog parser reads the DXCC names in the worker thread;
+    // Data must be created in the main thread
+    Data::instance();
+
+    const QList<LOVDownloader::SourceType> sources =
+    {
+        LOVDownloader::CTY,
+        LOVDownloader::CLUBLOGCTY,
+        LOVDownloader::SATLIST,
+        LOVDownloader::SOTASUMMITS,
+        LOVDownloader::WWFFDIRECTORY,
+        LOVDownloader::IOTALIST,
+        LOVDownloader::POTADIRECTORY,
+        LOVDownloader::MEMBERSHIPCONTENTLIST
+    };
+
+    totalTimer.start();
+
+    // all sources are registered first - fetch() can finish a source immediately
+    for ( const LOVDownloader::SourceType sourceType : sources )
+    {
+        SourceState &state = pendingSources[sourceType];
+        state.timer.start();
+        state.empty = !downloader.isSourceFilled(sourceType);
+    }
+
+    for ( const LOVDownloader::SourceType sourceType : sources )
+        downloader.fetch(sourceType, force);
+}
+
+QList<LOVDownloader::SourceType> LOVUpdateScheduler::pendingEmptySources() const
+{
+    FCT_IDENTIFICATION;
+
+    QList<LOVDownloader::SourceType> ret;
+
+    for ( auto it = pendingSources.constBegin(); it != pendingSources.constEnd(); ++it )
+    {
+        if ( it.value().empty )
+            ret << it.key();
+    }
+
+    return ret;
+}
+
+void LOVUpdateScheduler::importSource(LOVDownloader::SourceType sourceType)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << sourceType;
+
+    const auto it = pendingSources.find(sourceType);
+
+    if ( it == pendingSources.end() || it.value().thread )
+        return;
+
+    it.value().fetchTime = it.value().timer.elapsed();
+
+    const QSharedPointer<bool> imported(new bool(false));
+
+    QThread *thread = QThread::create([sourceType, imported]()
+    {
+        const QString connectionName = QString("lov_update_%1").arg(static_cast<int>(sourceType));
+
+        if ( LogDatabase::instance()->openThreadConnection(connectionName) )
+        {
+            LOVDownloader importer(connectionName);
+
+            // the parsers report the progress regularly - it is the place where
+            // the import is stopped when the application is closing
+            QObject::connect(&importer, &LOVDownloader::progress, &importer, [&importer]()
+            {
+                if ( QThread::currentThread()->isInterruptionRequested() )
+                    importer.abortRequest();
+            }, Qt::DirectConnection);
+
+            *imported = importer.import(sourceType);
+        }
+        else
+            qWarning() << "Cannot open DB Connection for the LOV update" << sourceType;
+
+        LogDatabase::closeThreadConnection(connectionName);
+    });
+
+    it.value().thread = thread;
+
+    connect(thread, &QThread::finished, this, [this, sourceType, imported]()
+    {
+        // the prefix tries are built from the main DB connection
+        if ( *imported && sourceType == LOVDownloader::CTY )
+            Data::instance()->reloadAD1CPrefixTrie();
+        else if ( *imported && sourceType == LOVDownloader::CLUBLOGCTY )
+            Data::instance()->reloadClublogPrefixTrie();
+        // the club list downloads were planned from the previous directory
+        else if ( *imported && sourceType == LOVDownloader::MEMBERSHIPCONTENTLIST )
+            MembershipQE::instance()->updateLists();
+
+        sourceDone(sourceType, *imported);
+    });
+
+    thread->start();
+}
+
+void LOVUpdateScheduler::sourceNotUpdated(LOVDownloader::SourceType sourceType)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << sourceType;
+
+    sourceDone(sourceType, true);
+}
+
+void LOVUpdateScheduler::sourceFetchFailed(LOVDownloader::SourceType sourceType)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << sourceType;
+
+    qWarning() << "Cannot download" << LOVDownloader::sourceName(sourceType);
+    sourceDone(sourceType, false);
+}
+
+void LOVUpdateScheduler::sourceDone(LOVDownloader::SourceType sourceType, bool result)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << sourceType << result;
+
+    const auto it = pendingSources.find(sourceType);
+
+    if ( it == pendingSources.end() )
+        return;
+
+    const SourceState &state = it.value();
+    const qint64 totalTime = state.timer.elapsed();
+
+    if ( state.thread )
+    {
+        state.thread->deleteLater();
+        qCInfo(runtime) << "LOV" << LOVDownloader::sourceName(sourceType)
+                        << (result ? "updated" : "failed")
+                        << "- fetch:" << state.fetchTime << "ms,"
+                        << "import:" << totalTime - state.fetchTime << "ms,"
+                        << "total:" << totalTime << "ms";
+    }
+    else
+        qCInfo(runtime) << "LOV" << LOVDownloader::sourceName(sourceType)
+                        << (result ? "is up to date" : "failed")
+                        << "- total:" << totalTime << "ms";
+
+    pendingSources.erase(it);
+
+    emit sourceFinished(sourceType, result);
+
+    if ( pendingSources.isEmpty() )
+    {
+        qCInfo(runtime) << "LOV update finished in" << totalTimer.elapsed() << "ms";
+        emit finished();
+    }
+}
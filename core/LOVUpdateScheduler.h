@@ -0,0 +1,57 @@
+#ifndef QLOG_CORE_LOVUPDATESCHEDULER_H
+#define QLOG_CORE_LOVUPDATESCHEDULER_H
+
+#include <QObject>
+#include <QMap>
+#include <QElapsedTimer>
+#include "core/LOVDownloader.h"
+
+class QThread;
+
+// Updates the Lists of Values in the background.
+// All sources are downloaded at once and every fetched source is imported
+// in its own worker thread with its own DB connection. The import replaces
+// the source tables in one short transaction therefore the application
+// works with the previous content until the new one is ready.
+class LOVUpdateScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LOVUpdateScheduler(QObject *parent = nullptr);
+    ~LOVUpdateScheduler();
+
+    void start(bool force = false);
+
+    // running sources without any content (typically the first start);
+    // the caller can wait for them
+    QList<LOVDownloader::SourceType> pendingEmptySources() const;
+
+signals:
+    void sourceFinished(LOVDownloader::SourceType sourceType, bool result);
+    void finished();
+
+private slots:
+    void importSource(LOVDownloader::SourceType sourceType);
+    void sourceNotUpdated(LOVDownloader::SourceType sourceType);
+    void sourceFetchFailed(LOVDownloader::SourceType sourceType);
+
+private:
+    struct SourceState
+    {
+        SourceState() : fetchTime(0), empty(false), thread(nullptr) {}
+
+        QElapsedTimer timer;
+        qint64 fetchTime;
+        bool empty;
+        QThread *thread;
+    };
+
+    void sourceDone(LOVDownloader::SourceType sourceType, bool result);
+
+    LOVDownloader downloader;   // fetches the sources in the main thread
+    QMap<LOVDownloader::SourceType, SourceState> pendingSources;
+    QElapsedTimer totalTimer;
+};
+
+#endif // QLOG_CORE_LOVUPDATESCHEDULER_H
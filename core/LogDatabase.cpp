@@ -16,6 +16,7 @@
 #include "core/LogParam.h"
 #include "core/CredentialStore.h"
 #include "core/PlatformParameterManager.h"
+#include "core/SQLFunctions.h"
 
 MODULE_IDENTIFICATION("qlog.core.logdatabase");
 
@@ -57,11 +58,11 @@ bool LogDatabase::hadPasswordImportWarning() const
     return passwordImportWarning;
 }
 
-bool LogDatabase::createSQLFunctions()
+bool LogDatabase::createSQLFunctions(const QSqlDatabase &db)
 {
     FCT_IDENTIFICATION;
 
-    QVariant v = QSqlDatabase::database().driver()->handle();
+    QVariant v = db.driver()->handle();
 
     if ( !v.isValid()
          || qstrcmp(v.typeName(), "sqlite3*") != 0 )
@@ -122,6 +123,13 @@ bool LogDatabase::createSQLFunctions()
                                 return QString::localeAwareCompare(left, right); // controlled by LC_COLLATE
                              });
 
+    // the functions used by the triggers
+    if ( !SQLFunctions::registerFunctions(db_handle) )
+    {
+        qCritical() << "Cannot define native SQLite functions";
+        return false;
+    }
+
     return true;
 }
 
@@ -264,6 +272,46 @@ bool LogDatabase::openDatabase()
     return createSQLFunctions();
 }
 
+bool LogDatabase::openThreadConnection(const QString &connectionName)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << connectionName;
+
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+    db.setDatabaseName(dbFilename());
+    db.setConnectOptions("QSQLITE_ENABLE_REGEXP;QSQLITE_BUSY_TIMEOUT=5000");
+
+    if ( !db.open() )
+    {
+        qCritical() << db.lastError();
+        return false;
+    }
+
+    QSqlQuery query(db);
+    if ( !query.exec("PRAGMA foreign_keys = ON") )
+    {
+        qCritical() << "Cannot set PRAGMA foreign_keys";
+        return false;
+    }
+
+    return createSQLFunctions(db);
+}
+
+void LogDatabase::closeThreadConnection(const QString &connectionName)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << connectionName;
+
+    {
+        QSqlDatabase db = QSqlDatabase::database(connectionName, false);
+        db.close();
+    }
+
+    QSqlDatabase::removeDatabase(connectionName);
+}
+
 bool LogDatabase::schemaVersionUpgrade(bool force)
 {
     FCT_IDENTIFICATION;
@@ -3,6 +3,7 @@
 
 #include <QString>
 #include <QDir>
+#include <QSqlDatabase>
 
 struct DatabaseInfo
 {
@@ -53,7 +54,12 @@ public:
     bool atomicCopy(const QString &filename);
     bool openDatabase();
     bool schemaVersionUpgrade(bool force = false);
-    bool createSQLFunctions();
+    bool createSQLFunctions(const QSqlDatabase &db = QSqlDatabase::database());
+
+    // Open an additional connection to the log for a worker thread.
+    // The connection must be used and closed only in the calling thread.
+    bool openThreadConnection(const QString &connectionName);
+    static void closeThreadConnection(const QString &connectionName);
 
 private:
     LogDatabase();
@@ -1092,6 +1092,16 @@ void LogParam::setExportColumnSet(const QString &paramName, const QSet<int> &set
     setParam("exportadi/" + paramName, valueList);
 }
 
+int LogParam::getImportBatchSize(int defaultValue)
+{
+    return getParam("importadi/batchsize", defaultValue).toInt();
+}
+
+void LogParam::setImportBatchSize(int size)
+{
+    setParam("importadi/batchsize", size);
+}
+
 QByteArray LogParam::getLogbookState()
 {
     return QByteArray::fromBase64(getParam("logbook/maintablestate").toByteArray());
@@ -329,6 +329,12 @@ public:
     static QSet<int> getExportColumnSet(const QString &paramName, const QSet<int> &defaultValue);
     static void setExportColumnSet(const QString &paramName, const QSet<int> &set);
 
+    /**************
+     * Import ADIF
+     **************/
+    static int getImportBatchSize(int defaultValue);
+    static void setImportBatchSize(int size);
+
     /*****************
      * Logbook dialog
      *****************/
@@ -0,0 +1,175 @@
+#include <QSqlQuery>
+#include <QSqlError>
+
+#include "LogbookSearchIndex.h"
+#include "core/debug.h"
+
+MODULE_IDENTIFICATION("qlog.core.logbooksearchindex");
+
+const QStringList LogbookSearchIndex::indexedColumns =
+{
+    "callsign", "gridsquare", "pota_ref", "sota_ref", "wwff_ref", "sig_intl", "iota",
+    "name", "name_intl", "qth", "qth_intl", "comment", "comment_intl", "notes", "notes_intl"
+};
+
+const int LogbookSearchIndex::MIN_INDEXED_LENGTH;
+
+bool LogbookSearchIndex::available = false;
+
+bool LogbookSearchIndex::setup(const QSqlDatabase &db)
+{
+    FCT_IDENTIFICATION;
+
+    available = false;
+
+    if ( !isTrigramSupported(db) )
+    {
+        // the triggers would fail for every QSO insert/update
+        // if the DB was indexed by a newer SQLite library
+        qCDebug(runtime) << "FTS5 trigram is not supported - using LIKE search";
+        return dropTriggers(db);
+    }
+
+    QSqlQuery query(db);
+
+    // the index must be rebuilt if it is new or if it was not maintained
+    // by triggers (e.g. the DB was opened by an older SQLite library)
+    if ( !query.exec("SELECT COUNT(1) FROM sqlite_master "
+                     "WHERE (type = 'table' AND name = 'contacts_search') "
+                     "      OR (type = 'trigger' AND name IN ('contacts_search_insert', "
+                     "                                        'contacts_search_delete', "
+                     "                                        'contacts_search_update'))")
+         || !query.first() )
+    {
+        qWarning() << "Cannot check the Logbook Search Index" << query.lastError().text();
+        return false;
+    }
+
+    const bool rebuildNeeded = query.value(0).toInt() != 4;
+    const QString columns = indexedColumns.join(", ");
+    const QString newColumns = "new." + indexedColumns.join(", new.");
+    const QString oldColumns = "old." + indexedColumns.join(", old.");
+
+    const QStringList stmts =
+    {
+        QString("CREATE VIRTUAL TABLE IF NOT EXISTS contacts_search "
+                "USING fts5(%1, content='contacts', content_rowid='id', tokenize='trigram')").arg(columns),
+
+        QString("CREATE TRIGGER IF NOT EXISTS contacts_search_insert "
+                "AFTER INSERT ON contacts "
+                "BEGIN "
+                "  INSERT INTO contacts_search (rowid, %1) VALUES (new.id, %2); "
+                "END").arg(columns, newColumns),
+
+        QString("CREATE TRIGGER IF NOT EXISTS contacts_search_delete "
+                "AFTER DELETE ON contacts "
+                "BEGIN "
+                "  INSERT INTO contacts_search (contacts_search, rowid, %1) VALUES ('delete', old.id, %2); "
+                "END").arg(columns, oldColumns),
+
+        // only the indexed columns; upload status updates do not touch the index
+        QString("CREATE TRIGGER IF NOT EXISTS contacts_search_update "
+                "AFTER UPDATE OF %1 ON contacts "
+                "BEGIN "
+                "  INSERT INTO contacts_search (contacts_search, rowid, %1) VALUES ('delete', old.id, %2); "
+                "  INSERT INTO contacts_search (rowid, %1) VALUES (new.id, %3); "
+                "END").arg(columns, oldColumns, newColumns)
+    };
+
+    for ( const QString &stmt : stmts )
+    {
+        if ( !query.exec(stmt) )
+        {
+            qWarning() << "Cannot create the Logbook Search Index" << query.lastError().text();
+            return false;
+        }
+    }
+
+    if ( rebuildNeeded )
+    {
+        qCDebug(runtime) << "Rebuilding the Logbook Search Index";
+
+        if ( !query.exec("INSERT INTO contacts_search (contacts_search) VALUES ('rebuild')") )
+        {
+            qWarning() << "Cannot rebuild the Logbook Search Index" << query.lastError().text();
+            return false;
+        }
+    }
+
+    available = true;
+    return true;
+}
+
+QString LogbookSearchIndex::whereClause(const QStringList &columns,
+                                        const QString &searchText)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << columns << searchText;
+
+    if ( !available || searchText.size() < MIN_INDEXED_LENGTH )
+        return likeClause(columns, searchText);
+
+    for ( const QString &column : columns )
+    {
+        if ( !indexedColumns.contains(column) )
+            return likeClause(columns, searchText);
+    }
+
+    // the search text is one FTS5 phrase; the trigram tokenizer matches
+    // the phrase as a case-insensitive substring
+    QString phrase(searchText);
+    phrase.replace('"', "\"\"");
+
+    QString match = QString("{%1} : \"%2\"").arg(columns.join(' '), phrase);
+    match.replace('\'', "''");
+
+    return QString("id IN (SELECT rowid FROM contacts_search WHERE contacts_search MATCH '%1')").arg(match);
+}
+
+bool LogbookSearchIndex::isTrigramSupported(const QSqlDatabase &db)
+{
+    FCT_IDENTIFICATION;
+
+    QSqlQuery query(db);
+
+    if ( !query.exec("CREATE VIRTUAL TABLE temp.contacts_search_probe USING fts5(x, tokenize='trigram')") )
+        return false;
+
+    query.exec("DROP TABLE temp.contacts_search_probe");
+    return true;
+}
+
+bool LogbookSearchIndex::dropTriggers(const QSqlDatabase &db)
+{
+    FCT_IDENTIFICATION;
+
+    QSqlQuery query(db);
+
+    if ( !query.exec("DROP TRIGGER IF EXISTS contacts_search_insert")
+         || !query.exec("DROP TRIGGER IF EXISTS contacts_search_delete")
+         || !query.exec("DROP TRIGGER IF EXISTS contacts_search_update") )
+    {
+        qWarning() << "Cannot drop the Logbook Search Index triggers" << query.lastError().text();
+        return false;
+    }
+
+    return true;
+}
+
+QString LogbookSearchIndex::likeClause(const QStringList &columns,
+                                       const QString &searchText)
+{
+    FCT_IDENTIFICATION;
+
+    QString text(searchText);
+    text.replace('\'', "''");
+
+    QStringList predicates;
+
+    for ( const QString &column : columns )
+        predicates << QString("%1 LIKE '%%2%'").arg(column, text);
+
+    return ( predicates.size() == 1 ) ? predicates.first()
+                                      : QString("(%1)").arg(predicates.join(" OR "));
+}
@@ -0,0 +1,42 @@
+#ifndef QLOG_CORE_LOGBOOKSEARCHINDEX_H
+#define QLOG_CORE_LOGBOOKSEARCHINDEX_H
+
+#include <QSqlDatabase>
+#include <QStringList>
+
+// Substring search index over the text columns of the logbook.
+// The index is an FTS5 external-content table with the trigram tokenizer
+// kept in sync with the contacts table by triggers. A trigram query
+// matches the same rows as LIKE '%text%' but it does not scan the whole table.
+// If the SQLite library does not provide FTS5 trigram (SQLite < 3.34) or
+// the search text is shorter than a trigram, LIKE predicates are generated.
+class LogbookSearchIndex
+{
+public:
+    // Creates the index and its triggers if they do not exist.
+    // It is called after each DB schema migration check.
+    static bool setup(const QSqlDatabase &db = QSqlDatabase::database());
+
+    static bool isAvailable() { return available; }
+
+    // Returns a WHERE predicate for contacts selecting rows which
+    // contain searchText in at least one of the columns.
+    static QString whereClause(const QStringList &columns,
+                               const QString &searchText);
+
+    // All columns which are present in the index
+    static const QStringList indexedColumns;
+
+    // Trigram tokenizer does not match shorter texts
+    static const int MIN_INDEXED_LENGTH = 3;
+
+private:
+    static bool isTrigramSupported(const QSqlDatabase &db);
+    static bool dropTriggers(const QSqlDatabase &db);
+    static QString likeClause(const QStringList &columns,
+                              const QString &searchText);
+
+    static bool available;
+};
+
+#endif // QLOG_CORE_LOGBOOKSEARCHINDEX_H
@@ -0,0 +1,172 @@
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QMutexLocker>
+
+#include "MembershipDirectory.h"
+#include "core/debug.h"
+
+MODULE_IDENTIFICATION("qlog.core.membershipdirectory");
+
+// 10 bits per callsign and 4 probes give about 1% false positives
+#define BLOOM_BITS_PER_CALLSIGN 10
+#define BLOOM_PROBES 4
+
+QMutex MembershipDirectory::currentLock;
+QSharedPointer<const MembershipDirectory> MembershipDirectory::currentDirectory;
+
+QSharedPointer<const MembershipDirectory> MembershipDirectory::load(const QSqlDatabase &db)
+{
+    FCT_IDENTIFICATION;
+
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+
+    if ( !query.exec("SELECT DISTINCT callsign, member_id, valid_from, valid_to, clubid "
+                     "FROM membership "
+                     "ORDER BY callsign, clubid") )
+    {
+        qWarning() << "Cannot load Membership Directory" << query.lastError().text();
+        return QSharedPointer<const MembershipDirectory>();
+    }
+
+    QSharedPointer<MembershipDirectory> directory(new MembershipDirectory);
+    QHash<QString, QString> clubIDs;   // all members of a club share one club ID string
+    QString currentCallsign;
+    int currentFirst = 0;
+
+    while ( query.next() )
+    {
+        const QString callsign = query.value(0).toString();
+        const QString clubID = query.value(4).toString();
+
+        if ( directory->memberList.isEmpty() || callsign != currentCallsign )
+        {
+            if ( !directory->memberList.isEmpty() )
+                directory->ranges.insert(currentCallsign,
+                                         qMakePair(currentFirst, directory->memberList.size() - currentFirst));
+            currentCallsign = callsign;
+            currentFirst = directory->memberList.size();
+        }
+
+        QHash<QString, QString>::const_iterator club = clubIDs.constFind(clubID);
+
+        if ( club == clubIDs.constEnd() )
+            club = clubIDs.insert(clubID, clubID);
+
+        Member member;
+        member.clubID = club.value();
+        member.memberID = query.value(1).toString();
+        member.validFrom = QDate::fromString(query.value(2).toString(), "yyyyMMdd");
+        member.validTo = QDate::fromString(query.value(3).toString(), "yyyyMMdd");
+        directory->memberList << member;
+    }
+
+    if ( !directory->memberList.isEmpty() )
+        directory->ranges.insert(currentCallsign,
+                                 qMakePair(currentFirst, directory->memberList.size() - currentFirst));
+
+    directory->memberList.squeeze();
+    directory->buildBloomFilter();
+
+    qCDebug(runtime) << "Loaded" << directory->callsignCount() << "callsigns,"
+                     << directory->memberCount() << "memberships";
+
+    return directory;
+}
+
+QSharedPointer<const MembershipDirectory> MembershipDirectory::current()
+{
+    QMutexLocker locker(&currentLock);
+    return currentDirectory;
+}
+
+void MembershipDirectory::setCurrent(const QSharedPointer<const MembershipDirectory> &directory)
+{
+    FCT_IDENTIFICATION;
+
+    // the previous snapshot is released when its last reader finishes
+    QMutexLocker locker(&currentLock);
+    currentDirectory = directory;
+}
+
+QVector<MembershipDirectory::Member> MembershipDirectory::members(const QString &callsign) const
+{
+    if ( !mightContain(callsign) )
+        return QVector<Member>();
+
+    const QHash<QString, QPair<int, int>>::const_iterator range = ranges.constFind(callsign);
+
+    if ( range == ranges.constEnd() )
+        return QVector<Member>();
+
+    return memberList.mid(range.value().first, range.value().second);
+}
+
+bool MembershipDirectory::mightContain(const QString &callsign) const
+{
+    if ( bloomBits.isEmpty() )
+        return false;
+
+    const quint32 hash = bloomHash(callsign);
+    const quint32 step = bloomStep(hash);
+
+    for ( quint32 i = 0; i < BLOOM_PROBES; i++ )
+    {
+        const quint32 bit = (hash + i * step) & bloomMask;
+
+        if ( !(bloomBits.at(bit >> 6) & (Q_UINT64_C(1) << (bit & 63))) )
+            return false;
+    }
+
+    return true;
+}
+
+void MembershipDirectory::buildBloomFilter()
+{
+    FCT_IDENTIFICATION;
+
+    bloomBits.clear();
+    bloomMask = 0;
+
+    if ( ranges.isEmpty() )
+        return;
+
+    // power of two - the bit index is masked
+    const qint64 requestedBits = static_cast<qint64>(ranges.size()) * BLOOM_BITS_PER_CALLSIGN;
+    qint64 bits = 64;
+
+    while ( bits < requestedBits && bits < (Q_INT64_C(1) << 31) )
+        bits <<= 1;
+
+    bloomBits.fill(0, static_cast<int>(bits / 64));
+    bloomMask = static_cast<quint32>(bits - 1);
+
+    for ( QHash<QString, QPair<int, int>>::const_iterator it = ranges.constBegin(); it != ranges.constEnd(); ++it )
+    {
+        const quint32 hash = bloomHash(it.key());
+        const quint32 step = bloomStep(hash);
+
+        for ( quint32 i = 0; i < BLOOM_PROBES; i++ )
+        {
+            const quint32 bit = (hash + i * step) & bloomMask;
+            bloomBits[bit >> 6] |= Q_UINT64_C(1) << (bit & 63);
+        }
+    }
+}
+
+quint32 MembershipDirectory::bloomHash(const QString &callsign)
+{
+    return static_cast<quint32>(qHash(callsign));
+}
+
+// the probes are derived from one hash (double hashing); the step is
+// a mixed hash (MurmurHash3 finalizer) and it is odd to visit different bits
+quint32 MembershipDirectory::bloomStep(quint32 hash)
+{
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bU;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35U;
+    hash ^= hash >> 16;
+    return hash | 1;
+}
@@ -0,0 +1,66 @@
+#ifndef QLOG_CORE_MEMBERSHIPDIRECTORY_H
+#define QLOG_CORE_MEMBERSHIPDIRECTORY_H
+
+#include <QString>
+#include <QDate>
+#include <QHash>
+#include <QPair>
+#include <QVector>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QSqlDatabase>
+
+// In-memory snapshot of the membership table.
+// The members are kept in an array sorted by callsign and club; a hash
+// maps a callsign to its range in the array. Most of the queried callsigns
+// are not members of any club therefore a Bloom filter answers them
+// without touching the hash.
+// A snapshot is immutable - a new snapshot is loaded when the club lists
+// are changed and it replaces the current one atomically. The snapshot
+// can be used from any thread.
+class MembershipDirectory
+{
+public:
+    struct Member
+    {
+        QString clubID;
+        QString memberID;
+        QDate validFrom;
+        QDate validTo;
+    };
+
+    // Loads the snapshot from the membership table.
+    // Returns a null pointer if the table cannot be read.
+    static QSharedPointer<const MembershipDirectory> load(const QSqlDatabase &db = QSqlDatabase::database());
+
+    // the snapshot which is used by the membership queries; null if it is not loaded yet
+    static QSharedPointer<const MembershipDirectory> current();
+    static void setCurrent(const QSharedPointer<const MembershipDirectory> &directory);
+
+    // Memberships of the callsign ordered by club ID.
+    // The callsign must be in the form which is stored in the membership table.
+    QVector<Member> members(const QString &callsign) const;
+
+    // false means that the callsign is not a member of any club
+    bool mightContain(const QString &callsign) const;
+
+    int callsignCount() const { return ranges.size(); }
+    int memberCount() const { return memberList.size(); }
+
+private:
+    MembershipDirectory() : bloomMask(0) {}
+
+    void buildBloomFilter();
+    static quint32 bloomHash(const QString &callsign);
+    static quint32 bloomStep(quint32 hash);
+
+    QVector<Member> memberList;
+    QHash<QString, QPair<int, int>> ranges;  // callsign -> (first member, count)
+    QVector<quint64> bloomBits;
+    quint32 bloomMask;
+
+    static QMutex currentLock;
+    static QSharedPointer<const MembershipDirectory> currentDirectory;
+};
+
+#endif // QLOG_CORE_MEMBERSHIPDIRECTORY_H
@@ -13,6 +13,8 @@
 #include "MembershipQE.h"
 #include "core/debug.h"
 #include "core/LogDatabase.h"
+#include "core/MembershipDirectory.h"
+#include "core/ClubProgress.h"
 #include "data/Callsign.h"
 #include "LogParam.h"
 
@@ -62,7 +64,10 @@ const QString& ClubInfo::getClubInfo() const
 MembershipQE::MembershipQE(QObject *parent)
     : QObject{parent},
       idClubQueryValid(false),
-      nam(new QNetworkAccessManager(this))
+      nam(new QNetworkAccessManager(this)),
+      directoryThread(nullptr),
+      directoryReloadPending(false),
+      updateListsPending(false)
 {
     FCT_IDENTIFICATION;
 
@@ -74,7 +79,7 @@ MembershipQE::MembershipQE(QObject *parent)
     connect(nam.data(), &QNetworkAccessManager::finished, this, &MembershipQE::onFinishedListDownload);
 
     // prepare SQL query to increase Club query function performance
-    idClubQueryValid = clubQuery.prepare("SELECT DISTINCT callsign, member_id, valid_from, valid_to, clubid FROM membership WHERE callsign = :callsign ORDER BY clubid");
+    idClubQueryValid = prepareClubQuery(clubQuery);
 }
 
 MembershipQE::~MembershipQE()
@@ -83,6 +88,9 @@ MembershipQE::~MembershipQE()
 
     statusQueryThread.quit();
     statusQueryThread.wait();
+
+    if ( directoryThread )
+        directoryThread->wait();
 }
 
 // this function is called when async club status returns a result
@@ -133,33 +141,65 @@ QList<ClubInfo> MembershipQE::query(const QString &in_callsign)
 
     QList<ClubInfo> ret;
 
-    if ( !idClubQueryValid )
+    // the membership directory does not need the prepared query
+    if ( !idClubQueryValid && !MembershipDirectory::current() )
     {
         qCDebug(runtime) << "Query is not prepared";
         return ret;
     }
 
-    Callsign qCall(in_callsign);
+    return query(in_callsign, clubQuery);
+}
+
+bool MembershipQE::prepareClubQuery(QSqlQuery &query)
+{
+    FCT_IDENTIFICATION;
+
+    return query.prepare("SELECT DISTINCT callsign, member_id, valid_from, valid_to, clubid FROM membership WHERE callsign = :callsign ORDER BY clubid");
+}
 
-    clubQuery.bindValue(":callsign",( qCall.isValid() ) ? qCall.getBase() : in_callsign.toUpper());
+QList<ClubInfo> MembershipQE::query(const QString &in_callsign, QSqlQuery &preparedQuery)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << in_callsign;
+
+    QList<ClubInfo> ret;
+
+    const Callsign qCall(in_callsign);
+    const QString callsign = ( qCall.isValid() ) ? qCall.getBase() : in_callsign.toUpper();
+    const QSharedPointer<const MembershipDirectory> directory = MembershipDirectory::current();
 
-    if ( ! clubQuery.exec() )
+    // the membership table is queried only until the directory is loaded
+    if ( directory )
     {
-        qCDebug(runtime) << "Cannot query callsign clubs "<< clubQuery.lastError().text();
+        const QVector<MembershipDirectory::Member> members = directory->members(callsign);
+
+        for ( const MembershipDirectory::Member &member : members )
+            ret << ClubInfo(in_callsign, member.memberID, member.validFrom, member.validTo, member.clubID);
+
+        return ret;
+    }
+
+    preparedQuery.bindValue(":callsign", callsign);
+
+    if ( ! preparedQuery.exec() )
+    {
+        qCDebug(runtime) << "Cannot query callsign clubs "<< preparedQuery.lastError().text();
         return ret;
     }
 
-    while ( clubQuery.next() )
+    while ( preparedQuery.next() )
     {
-        QString callsign = clubQuery.value(0).toString();
-        QString memberid = clubQuery.value(1).toString();
-        QDate validFrom = QDate::fromString(clubQuery.value(2).toString(), "yyyyMMdd");
-        QDate validTo = QDate::fromString(clubQuery.value(3).toString(), "yyyyMMdd");
-        QString clubid = clubQuery.value(4).toString();
+        QString callsign = preparedQuery.value(0).toString();
+        QString memberid = preparedQuery.value(1).toString();
+        QDate validFrom = QDate::fromString(preparedQuery.value(2).toString(), "yyyyMMdd");
+        QDate validTo = QDate::fromString(preparedQuery.value(3).toString(), "yyyyMMdd");
+        QString clubid = preparedQuery.value(4).toString();
 
         qCDebug(runtime) << "Found membership record" << callsign << memberid << validFrom << validTo << clubid;
 
-        ret << ClubInfo(in_callsign, memberid, validTo, validTo, clubid);
+        ret << ClubInfo(in_callsign, memberid, validFrom, validTo, clubid);
     }
 
     qCDebug(runtime) << "Done";
@@ -194,11 +234,17 @@ void MembershipQE::updateLists()
 
     if ( updatePlan.size() > 0 )
     {
-        qWarning() << "Member Club lists are still downloaded. Aborting this update request.";
+        // the running plan can be based on an old directory or settings
+        qCDebug(runtime) << "Member Club lists are still downloaded. The update is postponed.";
+        updateListsPending = true;
+        return;
     }
 
     QStringList enabledLists = getEnabledClubLists();
 
+    // the club status does not use the club progress until the lists are downloaded
+    ClubProgress::invalidate();
+
     if ( !removeDisabled(enabledLists) )
     {
         QMessageBox::warning(nullptr, QMessageBox::tr("QLog Warning"),
@@ -285,7 +331,18 @@ void MembershipQE::startPlannedDownload()
     FCT_IDENTIFICATION;
 
     if ( updatePlan.size() == 0 )
+    {
+        if ( updateListsPending )
+        {
+            updateListsPending = false;
+            updateLists();
+            return;
+        }
+
+        // all lists are updated - the queries can use them
+        reloadDirectory();
         return;
+    }
 
     qCDebug(runtime) << "Remaining downloads" << updatePlan.size() << updatePlan;
 
@@ -299,6 +356,51 @@ void MembershipQE::startPlannedDownload()
     reply->setProperty("clubid", nextDownload.first);
 }
 
+void MembershipQE::reloadDirectory()
+{
+    FCT_IDENTIFICATION;
+
+    if ( directoryThread )
+    {
+        // the running load may not see the latest changes
+        directoryReloadPending = true;
+        return;
+    }
+
+    directoryReloadPending = false;
+
+    // the current directory is used until the new one is loaded
+    directoryThread = QThread::create([]()
+    {
+        const QString connectionName(QStringLiteral("membership_directory"));
+
+        if ( LogDatabase::instance()->openThreadConnection(connectionName) )
+        {
+            const QSharedPointer<const MembershipDirectory> directory = MembershipDirectory::load(QSqlDatabase::database(connectionName, false));
+
+            if ( directory )
+                MembershipDirectory::setCurrent(directory);
+
+            ClubProgress::rebuild(QSqlDatabase::database(connectionName, false));
+        }
+        else
+            qWarning() << "Cannot open DB Connection for the Membership Directory";
+
+        LogDatabase::closeThreadConnection(connectionName);
+    });
+
+    connect(directoryThread, &QThread::finished, this, [this]()
+    {
+        directoryThread->deleteLater();
+        directoryThread = nullptr;
+
+        if ( directoryReloadPending )
+            reloadDirectory();
+    });
+
+    directoryThread->start();
+}
+
 void MembershipQE::onFinishedListDownload(QNetworkReply *reply)
 {
     FCT_IDENTIFICATION;
@@ -533,23 +635,39 @@ void ClubStatusQuery::getClubStatus(const QString &in_callsign,
     if ( eqslConfirmed )
         dxccConfirmedByCond << QLatin1String("c.eqsl_qsl_rcvd = 'Y'");
 
-    if ( ! query.exec(QString("SELECT DISTINCT clubid, NULL band, NULL mode, "
-                              "        NULL confirmed, NULL current_mode, member_id "
-                              "FROM membership  WHERE callsign = '%1' "
-                              "UNION ALL "
-                              "SELECT DISTINCT clubid, c.band, o.dxcc mode, "
-                              "                CASE WHEN (%2) THEN 1 ELSE 0 END confirmed, "
-                              "               (SELECT modes.dxcc FROM modes WHERE modes.name = '%3' LIMIT 1) current_mode, "
-                              "               NULL member_id "
-                              "FROM contacts c, "
-                              "    contact_clubs_view con2club, "
-                              "    modes o "
-                              "WHERE con2club.contactid = c.id "
-                              "AND o.name = c.mode "
-                              "AND con2club.clubid in (SELECT clubid FROM membership a WHERE a.callsign = '%4') order by 1, 3, 2, 4").arg(callModified,
-                                                                                                                                          dxccConfirmedByCond.join(" OR "),
-                                                                                                                                          in_mode,
-                                                                                                                                          callModified)))
+    // the club QSOs are read from the club progress if it is maintained
+    const QString clubContacts = ( ClubProgress::isAvailable() )
+                                 ? ClubProgress::sourceSelect()
+                                 : QLatin1String("SELECT con2club.clubid, c.band, c.mode, "
+                                                 "       c.eqsl_qsl_rcvd, c.lotw_qsl_rcvd, c.qsl_rcvd "
+                                                 "FROM contacts c, "
+                                                 "     contact_clubs_view con2club "
+                                                 "WHERE con2club.contactid = c.id");
+
+    if ( ! query.prepare(QString("SELECT DISTINCT clubid, NULL band, NULL mode, "
+                                 "        NULL confirmed, NULL current_mode, member_id "
+                                 "FROM membership  WHERE callsign = ? "
+                                 "UNION ALL "
+                                 "SELECT DISTINCT c.clubid, c.band, o.dxcc mode, "
+                                 "                CASE WHEN (%1) THEN 1 ELSE 0 END confirmed, "
+                                 "               (SELECT modes.dxcc FROM modes WHERE modes.name = ? LIMIT 1) current_mode, "
+                                 "               NULL member_id "
+                                 "FROM (%2) c, "
+                                 "    modes o "
+                                 "WHERE o.name = c.mode "
+                                 "AND c.clubid in (SELECT clubid FROM membership a WHERE a.callsign = ?) order by 1, 3, 2, 4").arg(dxccConfirmedByCond.join(" OR "),
+                                                                                                                                  clubContacts)) )
+    {
+       qCWarning(runtime) << "Cannot prepare club status query" << query.lastError().text();
+       emit status(in_callsign, QMap<QString, ClubInfo>());
+       return;
+    }
+
+    query.addBindValue(callModified);
+    query.addBindValue(in_mode);
+    query.addBindValue(callModified);
+
+    if ( ! query.exec() )
     {
        qCWarning(runtime) << "Cannot Get club status" << query.lastError().text();
        emit status(in_callsign, QMap<QString, ClubInfo>());
@@ -99,8 +99,15 @@ public:
     static QStringList getEnabledClubLists();
 
     // return only list of clubs where callsign is a member.
+    // The query uses the in-memory Membership Directory once it is loaded
+    // after the club lists update; the SQL query is used until then.
     QList<ClubInfo> query(const QString &in_callsign);
 
+    // the same as query but over a caller's prepared query - it allows
+    // to call it from threads with their own DB connection
+    static bool prepareClubQuery(QSqlQuery &query);
+    static QList<ClubInfo> query(const QString &in_callsign, QSqlQuery &preparedQuery);
+
     // return Status for each club
     // Membership status details can take a long time (depend on the number of records in the log and membership lists)
     // therefore qlog runs this query in an isolated thread (do not block the main thread). The result is returned via clubStatusResult signal - if exists
@@ -127,6 +134,7 @@ private:
     bool removeDisabled(const QStringList &enabledLists);
     bool planDownloads(const QStringList &enabledLists);
     void startPlannedDownload();
+    void reloadDirectory();
     bool importData(const QString &clubid, const QByteArray &data);
     void removeClubsFromEnabledClubLists(const QList<QPair<QString, QString>> &toRemove);
 
@@ -134,6 +142,9 @@ private:
     bool idClubQueryValid;
     QList<QPair<QString, QString>> updatePlan;
     QScopedPointer<QNetworkAccessManager> nam;
+    QThread *directoryThread;
+    bool directoryReloadPending;
+    bool updateListsPending;
 };
 
 #endif // QLOG_CORE_MEMBERSHIPQE_H
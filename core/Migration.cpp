@@ -1,4 +1,5 @@
 #include <QProgressDialog>
+#include <QCoreApplication>
 #include <QMessageBox>
 #include <QtSql>
 #include <QDebug>
@@ -8,11 +9,17 @@
 #include "data/Data.h"
 #include "LogParam.h"
 #include "LOVDownloader.h"
+#include "core/LOVUpdateScheduler.h"
 #include "service/clublog/ClubLog.h"
 #include "service/hrdlog/HRDLog.h"
 #include "logformat/AdxFormat.h"
 #include "ui/DxWidget.h"
 #include "core/LogDatabase.h"
+#include "core/QSLStorage.h"
+#include "core/AwardProgress.h"
+#include "core/ClubProgress.h"
+#include "core/LogbookSearchIndex.h"
+#include "core/StatisticsRollup.h"
 
 MODULE_IDENTIFICATION("qlog.core.migration");
 
@@ -28,6 +35,10 @@ bool DBSchemaMigration::run(bool force)
 
     if (currentVersion == latestVersion) {
         qCDebug(runtime) << "Database schema already up to date";
+        LogbookSearchIndex::setup();
+        StatisticsRollup::setup();
+        AwardProgress::setup();
+        ClubProgress::setup();
         updateExternalResource(force);
         // temporarily added to create a trigger without calling db migration
         //refreshUploadStatusTrigger();
@@ -78,6 +89,14 @@ bool DBSchemaMigration::run(bool force)
         return false;
     }
 
+    // the search index, the statistics rollup, the award and club progress are optional;
+    // the logbook search falls back to LIKE, the statistics, the awards and the club status
+    // to the contacts table
+    LogbookSearchIndex::setup();
+    StatisticsRollup::setup();
+    AwardProgress::setup();
+    ClubProgress::setup();
+
     progress.close();
 
     updateExternalResource(force);
@@ -329,6 +348,12 @@ bool DBSchemaMigration::functionMigration(int version)
     case 35:
         ret = removeSettings2DB();
         break;
+    case 40:
+        ret = qslCardsToRawBlob();
+        break;
+    case 41:
+        ret = createTriggers();
+        break;
     default:
         ret = true;
     }
@@ -351,90 +376,68 @@ bool DBSchemaMigration::updateExternalResource(bool force)
 {
     FCT_IDENTIFICATION;
 
-    LOVDownloader downloader;
-
-    QProgressDialog progress;
-
-    connect(&downloader, &LOVDownloader::processingSize,
-            &progress, &QProgressDialog::setMaximum);
-    connect(&downloader, &LOVDownloader::progress,
-            &progress, &QProgressDialog::setValue);
-    connect(&downloader, &LOVDownloader::finished,
-            &progress, &QProgressDialog::done);
-    connect(&downloader, &LOVDownloader::noUpdate,
-            &progress, &QProgressDialog::cancel);
-    connect(&progress, &QProgressDialog::canceled,
-            &downloader, &LOVDownloader::abortRequest);
-
-    updateExternalResourceProgress(progress, downloader, LOVDownloader::CTY, "(1/8)", force);
-    updateExternalResourceProgress(progress, downloader, LOVDownloader::CLUBLOGCTY, "2/8", force);
-    updateExternalResourceProgress(progress, downloader, LOVDownloader::SATLIST, "(3/8)", force);
-    updateExternalResourceProgress(progress, downloader, LOVDownloader::SOTASUMMITS, "(4/8)", force);
-    updateExternalResourceProgress(progress, downloader, LOVDownloader::WWFFDIRECTORY, "(5/8)", force);
-    updateExternalResourceProgress(progress, downloader, LOVDownloader::IOTALIST, "(6/8)", force);
-    updateExternalResourceProgress(progress, downloader, LOVDownloader::POTADIRECTORY, "(7/8)", force);
-    updateExternalResourceProgress(progress, downloader, LOVDownloader::MEMBERSHIPCONTENTLIST, "(8/8)", force);
+    // the scheduler outlives the migration - the lists are updated
+    // in the background and the application starts with the previous content
+    LOVUpdateScheduler *scheduler = new LOVUpdateScheduler(QCoreApplication::instance());
 
-    return true;
-}
+    connect(scheduler, &LOVUpdateScheduler::finished,
+            scheduler, &QObject::deleteLater);
 
-void DBSchemaMigration::updateExternalResourceProgress(QProgressDialog& progress,
-                                               LOVDownloader& downloader,
-                                               const LOVDownloader::SourceType & sourceType,
-                                               const QString &counter,
-                                               bool force)
-{
-    FCT_IDENTIFICATION;
+    scheduler->start(force);
+
+    // only the lists without any content (the first start) are waited for
+    const QList<LOVDownloader::SourceType> emptySources = scheduler->pendingEmptySources();
 
-    QString stringInfo;
+    if ( emptySources.isEmpty() )
+        return true;
+
+    QList<LOVDownloader::SourceType> remainingSources = emptySources;
+    QStringList failedSources;
+
+    QProgressDialog progress(QString(), tr("Run in Background"), 0, emptySources.size());
 
-    progress.reset();
-    switch ( sourceType )
+    auto updateLabel = [&]()
     {
-    case LOVDownloader::SourceType::CTY:
-        stringInfo = tr("DXCC Entities");
-        break;
-    case LOVDownloader::SourceType::SATLIST:
-        stringInfo = tr("Sats Info");
-        break;
-    case LOVDownloader::SourceType::SOTASUMMITS:
-        stringInfo = tr("SOTA Summits");
-        break;
-    case LOVDownloader::SourceType::WWFFDIRECTORY:
-        stringInfo = tr("WWFF Records");
-        break;
-    case LOVDownloader::SourceType::IOTALIST:
-        stringInfo = tr("IOTA Records");
-        break;
-    case LOVDownloader::SourceType::POTADIRECTORY:
-        stringInfo = tr("POTA Records");
-        break;
-    case LOVDownloader::SourceType::MEMBERSHIPCONTENTLIST:
-        stringInfo = tr("Membership Directory Records");
-        break;
-    case LOVDownloader::SourceType::CLUBLOGCTY:
-        stringInfo = tr("Clublog CTY.XML");
-        break;
-    default:
-        stringInfo = tr("List of Values");
-    }
+        QStringList names;
+
+        for ( const LOVDownloader::SourceType sourceType : qAsConst(remainingSources) )
+            names << LOVDownloader::sourceName(sourceType);
+
+        progress.setLabelText(tr("Updating ") + names.join(", ") + " ...");
+    };
+
+    connect(scheduler, &LOVUpdateScheduler::sourceFinished, &progress,
+            [&](LOVDownloader::SourceType sourceType, bool result)
+    {
+        if ( !remainingSources.removeOne(sourceType) )
+            return;
 
+        if ( !result )
+            failedSources << LOVDownloader::sourceName(sourceType);
+
+        progress.setValue(emptySources.size() - remainingSources.size());
+
+        if ( remainingSources.isEmpty() )
+            progress.done(QDialog::Accepted);
+        else
+            updateLabel();
+    });
+
+    updateLabel();
     progress.setWindowFlags(Qt::Dialog | Qt::WindowStaysOnTopHint);
-    progress.setLabelText(tr("Updating ") + stringInfo + " " + counter +" ...");
-    progress.setMinimum(0);
+    progress.setAutoClose(false);
+    progress.setAutoReset(false);
     progress.setModal(true);
-    progress.show();
-
-    downloader.update(sourceType, force);
+    progress.exec();
 
     if ( progress.wasCanceled() )
-        qCDebug(runtime) << "Update was canceled";
-    else
-    {
-        if ( !progress.exec() )
-            QMessageBox::warning(nullptr, QMessageBox::tr("QLog Warning"),
-                                 stringInfo + tr(" Update Failed"));
-    }
+        qCDebug(runtime) << "The rest of the update runs in the background";
+
+    if ( !failedSources.isEmpty() )
+        QMessageBox::warning(nullptr, QMessageBox::tr("QLog Warning"),
+                             failedSources.join(", ") + tr(" Update Failed"));
+
+    return true;
 }
 
 /* Fixing error when QLog stored UTF characters to non-Intl field of ADIF (contact) table */
@@ -594,13 +597,7 @@ bool DBSchemaMigration::createTriggers()
                               "WHEN OLD.callsign <> NEW.callsign "
                               "BEGIN "
                               "  INSERT OR REPLACE INTO contacts_autovalue (contactid, base_callsign) "
-                              "  VALUES (NEW.id, (WITH tokenizedCallsign(word, csv) AS ( SELECT '', NEW.callsign||'/' "
-                              "                                                     UNION ALL "
-                              "                                                     SELECT substr(csv, 0, instr(csv, '/')), substr(csv, instr(csv, '/') + 1) "
-                              "                                                     FROM tokenizedCallsign "
-                              "                                                     WHERE csv != '' ) "
-                              "                   SELECT word FROM tokenizedCallsign "
-                              "                   WHERE word != '' AND word REGEXP '^([A-Z][0-9]|[A-Z]{1,2}|[0-9][A-Z])([0-9]|[0-9]+)([A-Z]+)$' LIMIT 1));"
+                              "  VALUES (NEW.id, base_callsign(NEW.callsign)); "
                               "END;")))
     {
         qWarning() << "Cannot create trigger update_callsign_contacts_autovalue " << query.lastError().text();
@@ -612,13 +609,7 @@ bool DBSchemaMigration::createTriggers()
                               "FOR EACH ROW "
                               "BEGIN "
                               "  INSERT OR REPLACE INTO contacts_autovalue (contactid, base_callsign) "
-                              "  VALUES (NEW.id, (WITH tokenizedCallsign(word, csv) AS ( SELECT '', NEW.callsign||'/' "
-                              "                                                UNION ALL "
-                              "                                                SELECT substr(csv, 0, instr(csv, '/')), substr(csv, instr(csv, '/') + 1) "
-                              "                                                FROM tokenizedCallsign "
-                              "                                                WHERE csv != '' ) "
-                              "                   SELECT word FROM tokenizedCallsign "
-                              "                   WHERE word != '' and word REGEXP '^([A-Z][0-9]|[A-Z]{1,2}|[0-9][A-Z])([0-9]|[0-9]+)([A-Z]+)$' LIMIT 1)); "
+                              "  VALUES (NEW.id, base_callsign(NEW.callsign)); "
                               "END;")))
     {
         qWarning() << "Cannot create trigger update_callsign_contacts_autovalue " << query.lastError().text();
@@ -688,6 +679,53 @@ bool DBSchemaMigration::importQSLCards2DB()
     return true;
 }
 
+bool DBSchemaMigration::qslCardsToRawBlob()
+{
+    FCT_IDENTIFICATION;
+
+    // QSL cards were stored as base64 text; they are stored as raw BLOBs together
+    // with the content hash which is a part of the QSL thumbnail cache key
+    QSqlQuery query;
+    QSqlQuery update;
+
+    query.setForwardOnly(true);
+
+    if ( !query.prepare("SELECT rowid, data FROM contacts_qsl_cards") )
+    {
+        qWarning()<< " Cannot prepare a migration script - qslCardsToRawBlob 1" << query.lastError();
+        return false;
+    }
+
+    if ( !update.prepare("UPDATE contacts_qsl_cards SET data = :data, data_hash = :data_hash WHERE rowid = :rowid") )
+    {
+        qWarning()<< " Cannot prepare a migration script - qslCardsToRawBlob 2" << update.lastError();
+        return false;
+    }
+
+    if ( !query.exec() )
+    {
+        qWarning()<< " Cannot execute a migration script - qslCardsToRawBlob" << query.lastError();
+        return false;
+    }
+
+    while ( query.next() )
+    {
+        const QByteArray blob = QByteArray::fromBase64(query.value(1).toByteArray());
+
+        update.bindValue(":data", blob);
+        update.bindValue(":data_hash", QSLStorage::dataHash(blob));
+        update.bindValue(":rowid", query.value(0));
+
+        if ( !update.exec() )
+        {
+            qWarning() << "Cannot convert QSL" << query.value(0) << update.lastError();
+            return false;
+        }
+    }
+
+    return true;
+}
+
 bool DBSchemaMigration::fillCQITUZStationProfiles()
 {
     FCT_IDENTIFICATION;
@@ -1,9 +1,9 @@
 #ifndef QLOG_CORE_MIGRATION_H
 #define QLOG_CORE_MIGRATION_H
 
-#include "core/LOVDownloader.h"
+#include <QObject>
 
-class QProgressDialog;
+class QSqlQuery;
 
 class DBSchemaMigration : public QObject
 {
@@ -14,7 +14,7 @@ public:
     bool run(bool force = false);
     static bool backupAllQSOsToADX(bool force = false);
 
-    static constexpr int latestVersion = 38;
+    static constexpr int latestVersion = 41;
 
 private:
     bool functionMigration(int version);
@@ -24,16 +24,12 @@ private:
     bool runSqlFile(QString filename);
     int tableRows(const QString &name);
     bool updateExternalResource(bool force = false);
-    void updateExternalResourceProgress(QProgressDialog&,
-                                        LOVDownloader&,
-                                        const LOVDownloader::SourceType & sourceType,
-                                        const QString &counter,
-                                        bool force = false);
     bool fixIntlFields();
     bool insertUUID();
     bool fillMyDXCC();
     bool createTriggers();
     bool importQSLCards2DB();
+    bool qslCardsToRawBlob();
     bool fillCQITUZStationProfiles();
     bool resetConfigs();
     bool profiles2DB();
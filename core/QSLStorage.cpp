@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <QCryptographicHash>
 #include <QDir>
 #include <QSet>
 #include <QSqlQuery>
@@ -23,8 +24,8 @@ bool QSLStorage::add(const QSLObject &qslObject)
                                  << qslObject.getQSLName();
     QSqlQuery insert;
 
-    if ( !insert.prepare("REPLACE INTO contacts_qsl_cards (contactid, source, name, data) "
-                         " VALUES (:contactid, :source, :name, :data)" ) )
+    if ( !insert.prepare("REPLACE INTO contacts_qsl_cards (contactid, source, name, data, data_hash) "
+                         " VALUES (:contactid, :source, :name, :data, :data_hash)" ) )
     {
         qCDebug(runtime) << " Cannot prepare INSERT for PaperQSL " << insert.lastError();
         return false;
@@ -33,7 +34,8 @@ bool QSLStorage::add(const QSLObject &qslObject)
     insert.bindValue(":contactid", qslObject.getQSOID());
     insert.bindValue(":source", qslObject.getSource());
     insert.bindValue(":name", qslObject.getQSLName());
-    insert.bindValue(":data", qslObject.getBLOB(QSLObject::BASE64FORM));
+    insert.bindValue(":data", qslObject.getBLOB());
+    insert.bindValue(":data_hash", dataHash(qslObject.getBLOB()));
 
     if ( !insert.exec() )
     {
@@ -130,7 +132,7 @@ QSLObject QSLStorage::getQSL(const QSqlRecord &qso,
         query.bindValue(":qsl_name", qslName);
 
         if ( query.exec() && query.next() )
-            return QSLObject(qso, source, qslName, query.value(0).toByteArray(), QSLObject::BASE64FORM);
+            return QSLObject(qso, source, qslName, query.value(0).toByteArray(), QSLObject::RAWBYTES);
     }
 
     return QSLObject (qso, source, qslName, QByteArray(), QSLObject::RAWBYTES);
@@ -215,6 +217,7 @@ static QList<QSLGalleryItem> executeGalleryQuery(QSqlQuery &query)
             item.startTime = query.value(4).toDateTime();
             item.country = query.value(5).toString();
             item.favorite = query.value(6).toBool();
+            item.dataHash = query.value(7).toString();
             ret << item;
         }
     }
@@ -388,13 +391,14 @@ QList<QSLGalleryItem> QSLStorage::getGalleryItemsByContinent(const QString &cont
     return ret;
 }
 
-QByteArray QSLStorage::getQSLData(qulonglong contactId, int source, const QString &name) const
+QByteArray QSLStorage::getQSLData(qulonglong contactId, int source, const QString &name,
+                                  const QSqlDatabase &db) const
 {
     FCT_IDENTIFICATION;
 
     qCDebug(function_parameters) << contactId << source << name;
 
-    QSqlQuery query;
+    QSqlQuery query(db);
 
     if ( !query.prepare("SELECT data FROM contacts_qsl_cards "
                         "WHERE contactid = :contactid AND source = :source AND name = :name "
@@ -409,12 +413,19 @@ QByteArray QSLStorage::getQSLData(qulonglong contactId, int source, const QStrin
     query.bindValue(":name", name);
 
     if ( query.exec() && query.next() )
-        return QByteArray::fromBase64(query.value(0).toByteArray());
+        return query.value(0).toByteArray();
 
     qCDebug(runtime) << "QSL data not found" << query.lastError();
     return QByteArray();
 }
 
+QString QSLStorage::dataHash(const QByteArray &data)
+{
+    FCT_IDENTIFICATION;
+
+    return QString::fromLatin1(QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex());
+}
+
 QList<QSLGalleryItem> QSLStorage::getGalleryItemsFavorite() const
 {
     FCT_IDENTIFICATION;
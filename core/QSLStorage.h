@@ -7,6 +7,7 @@
 #include <QList>
 #include <QMap>
 #include <QDateTime>
+#include <QSqlDatabase>
 
 class QSLObject
 {
@@ -64,6 +65,7 @@ struct QSLGalleryItem
     QDateTime startTime;
     QString country;
     bool favorite = false;
+    QString dataHash;
 };
 
 class QSLStorage : public QObject
@@ -103,14 +105,18 @@ public:
     QList<QSLGalleryItem> getGalleryItemsByMode(const QString &mode) const;
     QList<QSLGalleryItem> getGalleryItemsByContinent(const QString &continent) const;
 
-    QByteArray getQSLData(qulonglong contactId, int source, const QString &name) const;
+    QByteArray getQSLData(qulonglong contactId, int source, const QString &name,
+                          const QSqlDatabase &db = QSqlDatabase::database()) const;
+
+    // hash of the QSL content which is stored together with the QSL
+    static QString dataHash(const QByteArray &data);
 
     bool setFavorite(qulonglong contactId, QSLObject::SourceType source, const QString &name, bool favorite);
     bool isFavorite(qulonglong contactId, QSLObject::SourceType source, const QString &name) const;
 
 private:
     const QString galleryBaseSQL=
-        "SELECT q.contactid, q.source, q.name, c.callsign, c.start_time, translate_to_locale(c.country), q.favorite "
+        "SELECT q.contactid, q.source, q.name, c.callsign, c.start_time, translate_to_locale(c.country), q.favorite, q.data_hash "
         "FROM contacts_qsl_cards q "
         "JOIN contacts c ON q.contactid = c.id ";
 
@@ -0,0 +1,138 @@
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QImageReader>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include "QSLThumbnailCache.h"
+#include "core/debug.h"
+
+MODULE_IDENTIFICATION("qlog.core.qslthumbnailcache");
+
+const QSize QSLThumbnailCache::thumbnailSize(150, 112);
+
+QSLThumbnailCache::QSLThumbnailCache(const QString &cacheDir) :
+    cacheDir(cacheDir)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << cacheDir;
+}
+
+QString QSLThumbnailCache::defaultCacheDir()
+{
+    FCT_IDENTIFICATION;
+
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).filePath("qslthumbnails");
+}
+
+QString QSLThumbnailCache::key(qulonglong contactId,
+                               int source,
+                               const QString &name,
+                               const QString &dataHash)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << contactId << source << name << dataHash;
+
+    // the content is unknown - the thumbnail cannot be cached
+    if ( dataHash.isEmpty() )
+        return QString();
+
+    // the name is an arbitrary file name therefore the key is hashed to get a valid file name
+    const QString id = QString("%1/%2/%3/%4").arg(contactId).arg(source).arg(name, dataHash);
+    return QString::fromLatin1(QCryptographicHash::hash(id.toUtf8(), QCryptographicHash::Sha1).toHex());
+}
+
+QImage QSLThumbnailCache::load(const QString &key) const
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << key;
+
+    QImage ret;
+
+    if ( key.isEmpty() )
+        return ret;
+
+    if ( !ret.load(filePath(key), "PNG") )
+        qCDebug(runtime) << "Thumbnail is not cached" << key;
+
+    return ret;
+}
+
+bool QSLThumbnailCache::store(const QString &key, const QImage &thumbnail) const
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << key;
+
+    if ( key.isEmpty() || thumbnail.isNull() )
+        return false;
+
+    if ( !QDir().mkpath(cacheDir) )
+    {
+        qWarning() << "Cannot create the thumbnail cache directory" << cacheDir;
+        return false;
+    }
+
+    // the file is replaced atomically - another thread can read it at the same time
+    QSaveFile file(filePath(key));
+
+    if ( !file.open(QIODevice::WriteOnly)
+         || !thumbnail.save(&file, "PNG")
+         || !file.commit() )
+    {
+        qWarning() << "Cannot store the thumbnail" << file.fileName() << file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+QImage QSLThumbnailCache::createThumbnail(const QByteArray &data)
+{
+    FCT_IDENTIFICATION;
+
+    QBuffer buffer;
+    buffer.setData(data);
+
+    if ( !buffer.open(QIODevice::ReadOnly) )
+        return QImage();
+
+    QImageReader reader(&buffer);
+
+    if ( !reader.canRead() )
+    {
+        qCDebug(runtime) << "QSL is not an image";
+        return QImage();
+    }
+
+    // JPEG can be decoded directly to a reduced size which is much faster
+    // than to decode the full resolution image and to scale it down
+    const QSize imageSize = reader.size();
+
+    if ( imageSize.isValid() )
+        reader.setScaledSize(imageSize.scaled(thumbnailSize, Qt::KeepAspectRatio));
+
+    QImage ret = reader.read();
+
+    if ( ret.isNull() )
+    {
+        qCDebug(runtime) << "Cannot decode QSL" << reader.errorString();
+        return ret;
+    }
+
+    // the image size is not known before it is decoded
+    if ( ret.width() > thumbnailSize.width() || ret.height() > thumbnailSize.height()
+         || !imageSize.isValid() )
+        ret = ret.scaled(thumbnailSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+
+    return ret;
+}
+
+QString QSLThumbnailCache::filePath(const QString &key) const
+{
+    return QDir(cacheDir).filePath(key + ".png");
+}
@@ -0,0 +1,41 @@
+#ifndef QLOG_CORE_QSLTHUMBNAILCACHE_H
+#define QLOG_CORE_QSLTHUMBNAILCACHE_H
+
+#include <QImage>
+#include <QSize>
+#include <QString>
+
+// On-disk cache of the QSL card thumbnails.
+// A thumbnail is identified by the QSL card (contact ID, source, name)
+// and by the hash of the QSL card content; a replaced QSL card therefore
+// gets a new thumbnail and the stale one is never returned.
+// All methods are thread-safe.
+class QSLThumbnailCache
+{
+public:
+    explicit QSLThumbnailCache(const QString &cacheDir = defaultCacheDir());
+
+    static QString defaultCacheDir();
+
+    static QString key(qulonglong contactId,
+                       int source,
+                       const QString &name,
+                       const QString &dataHash);
+
+    // Returns a null image if the thumbnail is not cached
+    QImage load(const QString &key) const;
+    bool store(const QString &key, const QImage &thumbnail) const;
+
+    // Decodes the QSL card directly to the thumbnail size.
+    // Returns a null image if the QSL card is not an image.
+    static QImage createThumbnail(const QByteArray &data);
+
+    static const QSize thumbnailSize;
+
+private:
+    QString filePath(const QString &key) const;
+
+    const QString cacheDir;
+};
+
+#endif // QLOG_CORE_QSLTHUMBNAILCACHE_H
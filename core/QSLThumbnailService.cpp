@@ -0,0 +1,157 @@
+#include <QRunnable>
+#include <QSqlDatabase>
+
+#include "QSLThumbnailService.h"
+#include "core/QSLStorage.h"
+#include "core/LogDatabase.h"
+#include "core/debug.h"
+
+MODULE_IDENTIFICATION("qlog.core.qslthumbnailservice");
+
+class QSLThumbnailService::Task : public QRunnable
+{
+public:
+    Task(QSLThumbnailService *service,
+         int requestID,
+         const QSLThumbnailService::Request &request,
+         int generation) :
+        service(service),
+        requestID(requestID),
+        request(request),
+        generation(generation)
+    {}
+
+    void run() override
+    {
+        service->generate(requestID, request, generation);
+    }
+
+private:
+    QSLThumbnailService *service;
+    const int requestID;
+    const QSLThumbnailService::Request request;
+    const int generation;
+};
+
+// DB connection of one pool thread; it is closed when the thread exits
+class QSLThumbnailService::ThreadConnection
+{
+public:
+    explicit ThreadConnection(const QString &name) :
+        name(name)
+    {}
+
+    ~ThreadConnection()
+    {
+        LogDatabase::closeThreadConnection(name);
+    }
+
+    const QString name;
+};
+
+QSLThumbnailService::QSLThumbnailService(QObject *parent) :
+    QObject(parent),
+    latestGeneration(0),
+    lastConnectionID(0),
+    lastRequestID(0)
+{
+    FCT_IDENTIFICATION;
+}
+
+QSLThumbnailService::~QSLThumbnailService()
+{
+    FCT_IDENTIFICATION;
+
+    // the tasks use this object - they must be finished before it is destroyed
+    cancel();
+    pool.waitForDone();
+}
+
+int QSLThumbnailService::request(const Request &request)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << request.contactId << request.source << request.name;
+
+    const int requestID = ++lastRequestID;
+    pool.start(new Task(this, requestID, request, latestGeneration.loadAcquire()));
+    return requestID;
+}
+
+void QSLThumbnailService::cancel()
+{
+    FCT_IDENTIFICATION;
+
+    latestGeneration.fetchAndAddOrdered(1);
+    pool.clear();
+}
+
+// pool thread
+void QSLThumbnailService::generate(int requestID, const Request &request, int generation)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << requestID << request.contactId << request.source << request.name;
+
+    if ( isSuperseded(generation) )
+        return;
+
+    const QString key = QSLThumbnailCache::key(request.contactId, request.source,
+                                               request.name, request.dataHash);
+    QImage thumbnail = cache.load(key);
+
+    if ( thumbnail.isNull() )
+    {
+        const QByteArray data = readData(request);
+
+        if ( isSuperseded(generation) )
+            return;
+
+        // an unreadable QSL is reported as a null thumbnail - the gallery
+        // must not wait for it
+        if ( !data.isEmpty() )
+            thumbnail = QSLThumbnailCache::createThumbnail(data);
+
+        // non-image QSLs have a generic icon which is not cached
+        if ( !thumbnail.isNull() )
+            cache.store(key, thumbnail);
+    }
+
+    // the signal is emitted from the thread of the service
+    QMetaObject::invokeMethod(this, [this, requestID, thumbnail, generation]()
+    {
+        if ( !isSuperseded(generation) )
+            emit thumbnailReady(requestID, thumbnail);
+    }, Qt::QueuedConnection);
+}
+
+// pool thread
+QByteArray QSLThumbnailService::readData(const Request &request)
+{
+    FCT_IDENTIFICATION;
+
+    // the connection is opened once per pool thread - opening it
+    // for every thumbnail is more expensive than reading the QSL
+    if ( !connections.hasLocalData() )
+    {
+        const QString connectionName = QString("qslthumbnail_%1").arg(lastConnectionID.fetchAndAddOrdered(1));
+
+        if ( !LogDatabase::instance()->openThreadConnection(connectionName) )
+        {
+            qWarning() << "Cannot open DB Connection for QSL Thumbnails";
+            LogDatabase::closeThreadConnection(connectionName);
+            return QByteArray();
+        }
+
+        connections.setLocalData(new ThreadConnection(connectionName));
+    }
+
+    QSLStorage storage;
+    return storage.getQSLData(request.contactId, request.source, request.name,
+                              QSqlDatabase::database(connections.localData()->name, false));
+}
+
+bool QSLThumbnailService::isSuperseded(int generation) const
+{
+    return generation != latestGeneration.loadAcquire();
+}
@@ -0,0 +1,63 @@
+#ifndef QLOG_CORE_QSLTHUMBNAILSERVICE_H
+#define QLOG_CORE_QSLTHUMBNAILSERVICE_H
+
+#include <QObject>
+#include <QImage>
+#include <QThreadPool>
+#include <QAtomicInt>
+#include <QThreadStorage>
+
+#include "core/QSLThumbnailCache.h"
+
+// Generates the thumbnails of the QSL Gallery.
+// Each request is processed by a thread pool task - the task returns the
+// cached thumbnail or it reads the QSL card over the DB connection of its
+// pool thread, decodes, scales and caches it. The thumbnails are reported by
+// thumbnailReady() in the order in which they are completed.
+// cancel() drops all pending requests; thumbnails of the requests which
+// are already running are not reported.
+class QSLThumbnailService : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Request
+    {
+        qulonglong contactId = 0;
+        int source = 0;
+        QString name;
+        QString dataHash;
+    };
+
+    explicit QSLThumbnailService(QObject *parent = nullptr);
+    ~QSLThumbnailService();
+
+    // Called from the GUI thread. Returns the request ID which is
+    // used by the thumbnailReady signal.
+    int request(const Request &request);
+    void cancel();
+
+signals:
+    // a null thumbnail means that the QSL card is not an image
+    // or it cannot be read
+    void thumbnailReady(int requestID, QImage thumbnail);
+
+private:
+    class Task;
+    class ThreadConnection;
+
+    void generate(int requestID, const Request &request, int generation);
+    QByteArray readData(const Request &request);
+    bool isSuperseded(int generation) const;
+
+    QSLThumbnailCache cache;
+    // must be declared before the pool - the pool threads close
+    // their connections when they exit
+    QThreadStorage<ThreadConnection *> connections;
+    QThreadPool pool;
+    QAtomicInt latestGeneration;
+    QAtomicInt lastConnectionID;
+    int lastRequestID;
+};
+
+#endif // QLOG_CORE_QSLTHUMBNAILSERVICE_H
@@ -0,0 +1,131 @@
+#include <sqlite3.h>
+
+#include "SQLFunctions.h"
+#include "core/debug.h"
+
+MODULE_IDENTIFICATION("qlog.core.sqlfunctions");
+
+#define IS_LETTER(c) ((c) >= 'A' && (c) <= 'Z')
+#define IS_DIGIT(c) ((c) >= '0' && (c) <= '9')
+
+bool SQLFunctions::registerFunctions(sqlite3 *handle)
+{
+    FCT_IDENTIFICATION;
+
+    if ( !handle )
+        return false;
+
+    const int rc = sqlite3_create_function(handle,
+                                           "base_callsign",
+                                           1,
+                                           SQLITE_UTF8 | SQLITE_DETERMINISTIC,
+                                           nullptr,
+                                           [](sqlite3_context *ctx, int argc, sqlite3_value **argv) {
+                                               if ( argc != 1 )
+                                               {
+                                                   sqlite3_result_error(ctx, "Invalid arguments", -1);
+                                                   return;
+                                               }
+
+                                               if ( sqlite3_value_type(argv[0]) == SQLITE_NULL )
+                                               {
+                                                   sqlite3_result_null(ctx);
+                                                   return;
+                                               }
+
+                                               const char *callsign = reinterpret_cast<const char*>(sqlite3_value_text(argv[0]));
+                                               const int length = sqlite3_value_bytes(argv[0]);
+                                               int start = 0;
+                                               int baseLength = 0;
+
+                                               if ( callsign && findBaseCallsign(callsign, length, &start, &baseLength) )
+                                                   sqlite3_result_text(ctx, callsign + start, baseLength, SQLITE_TRANSIENT);
+                                               else
+                                                   sqlite3_result_null(ctx);
+                                           }, nullptr, nullptr);
+
+    if ( rc != SQLITE_OK )
+    {
+        qWarning() << "Cannot create SQL function base_callsign" << sqlite3_errmsg(handle);
+        return false;
+    }
+
+    return true;
+}
+
+QString SQLFunctions::baseCallsign(const QString &callsign)
+{
+    const QByteArray utf8 = callsign.toUtf8();
+    int start = 0;
+    int baseLength = 0;
+
+    if ( !findBaseCallsign(utf8.constData(), utf8.size(), &start, &baseLength) )
+        return QString();
+
+    return QString::fromUtf8(utf8.constData() + start, baseLength);
+}
+
+// The callsign is split by '/' and the first part which matches
+// ^([A-Z][0-9]|[A-Z]{1,2}|[0-9][A-Z])([0-9]|[0-9]+)([A-Z]+)$ is the base callsign.
+// It replaces the recursive tokenizedCallsign CTE with REGEXP which was
+// evaluated by the contacts_autovalue triggers for each QSO.
+bool SQLFunctions::findBaseCallsign(const char *callsign, int length, int *start, int *baseLength)
+{
+    int tokenStart = 0;
+
+    for ( int i = 0; i <= length; i++ )
+    {
+        if ( i < length && callsign[i] != '/' )
+            continue;
+
+        if ( isBaseCallsign(callsign + tokenStart, i - tokenStart) )
+        {
+            *start = tokenStart;
+            *baseLength = i - tokenStart;
+            return true;
+        }
+        tokenStart = i + 1;
+    }
+
+    return false;
+}
+
+// The pattern is equivalent to [A-Z]{1,2}[0-9]+[A-Z]+ or [0-9][A-Z][0-9]+[A-Z]+
+bool SQLFunctions::isBaseCallsign(const char *token, int length)
+{
+    // the regular expression $ matches also before the final newline
+    if ( length > 0 && token[length - 1] == '\n' )
+        length--;
+
+    int i = 0;
+
+    if ( length > 0 && IS_DIGIT(token[0]) )
+    {
+        if ( length < 2 || !IS_LETTER(token[1]) )
+            return false;
+        i = 2;
+    }
+    else
+    {
+        while ( i < length && i < 2 && IS_LETTER(token[i]) )
+            i++;
+
+        if ( i == 0 )
+            return false;
+    }
+
+    const int digitsStart = i;
+
+    while ( i < length && IS_DIGIT(token[i]) )
+        i++;
+
+    if ( i == digitsStart )
+        return false;
+
+    const int lettersStart = i;
+
+    while ( i < length && IS_LETTER(token[i]) )
+        i++;
+
+    return i > lettersStart && i == length;
+}
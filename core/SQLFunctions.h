@@ -0,0 +1,29 @@
+#ifndef QLOG_CORE_SQLFUNCTIONS_H
+#define QLOG_CORE_SQLFUNCTIONS_H
+
+#include <QString>
+
+struct sqlite3;
+
+// Native SQL functions of the log database.
+// The functions are deterministic and they are used by the triggers
+// therefore they must be registered on every connection which changes
+// the contacts table.
+//
+// base_callsign(callsign) - the first part of the callsign split by '/'
+//                           which looks like a base callsign (e.g. OK1ABC
+//                           for SV9/OK1ABC/P); NULL if there is no such part
+class SQLFunctions
+{
+public:
+    static bool registerFunctions(sqlite3 *handle);
+
+    // the same value as base_callsign() in SQL; null if there is no base callsign
+    static QString baseCallsign(const QString &callsign);
+
+private:
+    static bool findBaseCallsign(const char *callsign, int length, int *start, int *baseLength);
+    static bool isBaseCallsign(const char *token, int length);
+};
+
+#endif // QLOG_CORE_SQLFUNCTIONS_H
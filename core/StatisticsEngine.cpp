@@ -0,0 +1,168 @@
+#include <sqlite3.h>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QSqlRecord>
+#include <QSqlDriver>
+
+#include "StatisticsEngine.h"
+#include "core/debug.h"
+#include "core/LogDatabase.h"
+
+MODULE_IDENTIFICATION("qlog.core.statisticsengine");
+
+// number of SQLite VM instructions between two cancellation checks
+#define PROGRESS_HANDLER_PERIOD 10000
+
+StatisticsEngine::StatisticsEngine(QObject *parent)
+    : QObject{parent},
+      connectionName(QString("statisticsengine_%1").arg(reinterpret_cast<quintptr>(this))),
+      connectionOpened(false),
+      latestGeneration(0),
+      runningGeneration(0)
+{
+    FCT_IDENTIFICATION;
+}
+
+StatisticsEngine::~StatisticsEngine()
+{
+    FCT_IDENTIFICATION;
+}
+
+int StatisticsEngine::submit(const QStringList &statements)
+{
+    FCT_IDENTIFICATION;
+
+    // the previous requests are superseded from now
+    const int generation = latestGeneration.fetchAndAddOrdered(1) + 1;
+
+    qCDebug(runtime) << "Submitting statistics request" << generation;
+
+    QMetaObject::invokeMethod(this, "execute", Qt::QueuedConnection,
+                              Q_ARG(int, generation),
+                              Q_ARG(QStringList, statements));
+    return generation;
+}
+
+void StatisticsEngine::cancel()
+{
+    FCT_IDENTIFICATION;
+
+    latestGeneration.fetchAndAddOrdered(1);
+}
+
+void StatisticsEngine::execute(int generation, const QStringList &statements)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << generation << statements;
+
+    // a newer request is already in the queue
+    if ( isSuperseded(generation) )
+    {
+        qCDebug(runtime) << "Skipping superseded request" << generation;
+        return;
+    }
+
+    if ( !openConnection() )
+        return;
+
+    Result result;
+    result.generation = generation;
+    runningGeneration = generation;
+
+    for ( const QString &stmt : statements )
+    {
+        Rows rows;
+        QSqlQuery query(QSqlDatabase::database(connectionName, false));
+
+        query.setForwardOnly(true);
+
+        if ( !query.exec(stmt) )
+        {
+            // the interrupted statement fails too
+            if ( isSuperseded(generation) )
+            {
+                qCDebug(runtime) << "Request interrupted" << generation;
+                return;
+            }
+            qWarning() << "Cannot execute the statistics query" << query.lastError().text();
+        }
+
+        const int columns = query.record().count();
+
+        while ( query.next() )
+        {
+            QVariantList row;
+
+            row.reserve(columns);
+            for ( int i = 0; i < columns; i++ )
+                row << query.value(i);
+            rows << row;
+        }
+
+        if ( isSuperseded(generation) )
+        {
+            qCDebug(runtime) << "Request interrupted" << generation;
+            return;
+        }
+
+        result.tables << rows;
+    }
+
+    emit finished(result);
+}
+
+void StatisticsEngine::closeConnection()
+{
+    FCT_IDENTIFICATION;
+
+    if ( !connectionOpened )
+        return;
+
+    connectionOpened = false;
+    LogDatabase::closeThreadConnection(connectionName);
+}
+
+bool StatisticsEngine::openConnection()
+{
+    FCT_IDENTIFICATION;
+
+    if ( connectionOpened )
+        return true;
+
+    if ( !LogDatabase::instance()->openThreadConnection(connectionName) )
+    {
+        qWarning() << "Cannot open DB Connection for Statistics";
+        LogDatabase::closeThreadConnection(connectionName);
+        return false;
+    }
+
+    // the handler interrupts the running statement when the request is superseded
+    const QVariant handle = QSqlDatabase::database(connectionName, false).driver()->handle();
+
+    if ( handle.isValid() && qstrcmp(handle.typeName(), "sqlite3*") == 0 )
+    {
+        sqlite3 *dbHandle = *static_cast<sqlite3 * const *>(handle.data());
+
+        if ( dbHandle )
+            sqlite3_progress_handler(dbHandle, PROGRESS_HANDLER_PERIOD, &StatisticsEngine::progressHandler, this);
+    }
+    else
+        qCDebug(runtime) << "Cannot get SQLite driver handle - queries are not interruptible";
+
+    connectionOpened = true;
+    return true;
+}
+
+bool StatisticsEngine::isSuperseded(int generation) const
+{
+    return generation != latestGeneration.loadAcquire();
+}
+
+int StatisticsEngine::progressHandler(void *engine)
+{
+    const StatisticsEngine *self = static_cast<const StatisticsEngine *>(engine);
+
+    // non-zero interrupts the statement
+    return self->isSuperseded(self->runningGeneration) ? 1 : 0;
+}
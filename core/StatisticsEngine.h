@@ -0,0 +1,58 @@
+#ifndef QLOG_CORE_STATISTICSENGINE_H
+#define QLOG_CORE_STATISTICSENGINE_H
+
+#include <QObject>
+#include <QStringList>
+#include <QVariantList>
+#include <QAtomicInt>
+
+// Executes the statistics queries on its own DB connection.
+// The object lives in a worker thread; requests are posted by submit()
+// from the GUI thread. Each request gets a generation number - a request
+// which is superseded by a newer one is interrupted (also in the middle
+// of the SQLite statement) and its result is not emitted.
+class StatisticsEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    typedef QList<QVariantList> Rows;
+
+    struct Result
+    {
+        int generation = 0;
+        QList<Rows> tables;     // one table per statement
+    };
+
+    explicit StatisticsEngine(QObject *parent = nullptr);
+    ~StatisticsEngine();
+
+    // Called from the GUI thread. Returns the generation of the request.
+    int submit(const QStringList &statements);
+
+    // Cancels all submitted requests
+    void cancel();
+
+public slots:
+    void closeConnection();
+
+signals:
+    void finished(StatisticsEngine::Result result);
+
+private slots:
+    void execute(int generation, const QStringList &statements);
+
+private:
+    bool openConnection();
+    bool isSuperseded(int generation) const;
+    static int progressHandler(void *engine);
+
+    const QString connectionName;
+    bool connectionOpened;
+    QAtomicInt latestGeneration;
+    int runningGeneration;          // worker thread only
+};
+
+Q_DECLARE_METATYPE(StatisticsEngine::Result)
+
+#endif // QLOG_CORE_STATISTICSENGINE_H
@@ -0,0 +1,166 @@
+#include <QSqlQuery>
+#include <QSqlError>
+
+#include "StatisticsRollup.h"
+#include "core/debug.h"
+
+MODULE_IDENTIFICATION("qlog.core.statisticsrollup");
+
+const QStringList StatisticsRollup::groupColumns =
+{
+    "station_callsign", "my_gridsquare", "my_rig", "my_antenna",
+    "band", "mode", "prop_mode", "cont", "dxcc"
+};
+
+const QString StatisticsRollup::tableName = QStringLiteral("contacts_rollup");
+
+bool StatisticsRollup::available = false;
+
+bool StatisticsRollup::setup(const QSqlDatabase &db)
+{
+    FCT_IDENTIFICATION;
+
+    available = false;
+
+    QSqlQuery query(db);
+
+    // the rollup must be rebuilt if it is new or if it was not maintained by triggers
+    if ( !query.exec("SELECT COUNT(1) FROM sqlite_master "
+                     "WHERE (type = 'table' AND name = 'contacts_rollup') "
+                     "      OR (type = 'trigger' AND name IN ('contacts_rollup_insert', "
+                     "                                        'contacts_rollup_delete', "
+                     "                                        'contacts_rollup_update'))")
+         || !query.first() )
+    {
+        qWarning() << "Cannot check the Statistics Rollup" << query.lastError().text();
+        return false;
+    }
+
+    const bool rebuildNeeded = query.value(0).toInt() != 4;
+    const QStringList oldValues = keyValues("old");
+    const QStringList newValues = keyValues("new");
+    QStringList keyChanged;
+
+    for ( int i = 0; i < oldValues.size(); i++ )
+        keyChanged << QString("%1 IS %2").arg(oldValues.at(i), newValues.at(i));
+
+    const QStringList stmts =
+    {
+        QLatin1String("CREATE TABLE IF NOT EXISTS contacts_rollup ("
+                      "  day TEXT, station_callsign TEXT, my_gridsquare TEXT, my_rig TEXT, my_antenna TEXT, "
+                      "  band TEXT, mode TEXT, prop_mode TEXT, cont TEXT, dxcc INTEGER, "
+                      "  confirmed INTEGER, cnt INTEGER NOT NULL)"),
+
+        QLatin1String("CREATE INDEX IF NOT EXISTS contacts_rollup_key_idx "
+                      "ON contacts_rollup (day, band, mode, dxcc)"),
+
+        QString("CREATE TRIGGER IF NOT EXISTS contacts_rollup_insert "
+                "AFTER INSERT ON contacts "
+                "BEGIN "
+                "  %1 "
+                "END").arg(addStatement("new")),
+
+        QString("CREATE TRIGGER IF NOT EXISTS contacts_rollup_delete "
+                "AFTER DELETE ON contacts "
+                "BEGIN "
+                "  %1 "
+                "END").arg(removeStatement("old")),
+
+        // only the rollup columns; e.g. upload status updates do not touch the rollup
+        QString("CREATE TRIGGER IF NOT EXISTS contacts_rollup_update "
+                "AFTER UPDATE OF start_time, %1, eqsl_qsl_rcvd, lotw_qsl_rcvd, qsl_rcvd ON contacts "
+                "WHEN NOT (%2) "
+                "BEGIN "
+                "  %3 "
+                "  %4 "
+                "END").arg(groupColumns.join(", "),
+                           keyChanged.join(" AND "),
+                           removeStatement("old"),
+                           addStatement("new"))
+    };
+
+    for ( const QString &stmt : stmts )
+    {
+        if ( !query.exec(stmt) )
+        {
+            qWarning() << "Cannot create the Statistics Rollup" << query.lastError().text();
+            return false;
+        }
+    }
+
+    if ( rebuildNeeded )
+    {
+        qCDebug(runtime) << "Rebuilding the Statistics Rollup";
+
+        const QStringList columns = keyColumns();
+        const QStringList values = keyValues("c");
+        QStringList namedValues;
+
+        for ( int i = 0; i < columns.size(); i++ )
+            namedValues << QString("%1 AS %2").arg(values.at(i), columns.at(i));
+
+        if ( !query.exec("DELETE FROM contacts_rollup")
+             || !query.exec(QString("INSERT INTO contacts_rollup (%1, cnt) "
+                                    "SELECT %1, COUNT(1) "
+                                    "FROM (SELECT %2 FROM contacts c) "
+                                    "GROUP BY %1").arg(columns.join(", "), namedValues.join(", "))) )
+        {
+            qWarning() << "Cannot rebuild the Statistics Rollup" << query.lastError().text();
+            return false;
+        }
+    }
+
+    available = true;
+    return true;
+}
+
+QStringList StatisticsRollup::keyColumns()
+{
+    return QStringList("day") << groupColumns << "confirmed";
+}
+
+// the rollup key of a contacts row; the row is an alias (new, old, table alias)
+QStringList StatisticsRollup::keyValues(const QString &row)
+{
+    QStringList ret(QString("date(%1.start_time)").arg(row));
+
+    for ( const QString &column : groupColumns )
+        ret << QString("%1.%2").arg(row, column);
+
+    ret << QString("CASE WHEN (%1.eqsl_qsl_rcvd = 'Y' OR %1.lotw_qsl_rcvd = 'Y' OR %1.qsl_rcvd = 'Y') "
+                   "THEN 1 ELSE 0 END").arg(row);
+
+    return ret;
+}
+
+// NULL is a valid key value therefore the key is compared by IS
+QString StatisticsRollup::keyMatch(const QString &row)
+{
+    const QStringList columns = keyColumns();
+    const QStringList values = keyValues(row);
+    QStringList ret;
+
+    for ( int i = 0; i < columns.size(); i++ )
+        ret << QString("%1 IS %2").arg(columns.at(i), values.at(i));
+
+    return ret.join(" AND ");
+}
+
+QString StatisticsRollup::addStatement(const QString &row)
+{
+    const QString match = keyMatch(row);
+
+    return QString("INSERT INTO contacts_rollup (%1, cnt) "
+                   "SELECT %2, 0 WHERE NOT EXISTS (SELECT 1 FROM contacts_rollup WHERE %3); "
+                   "UPDATE contacts_rollup SET cnt = cnt + 1 WHERE %3;").arg(keyColumns().join(", "),
+                                                                             keyValues(row).join(", "),
+                                                                             match);
+}
+
+QString StatisticsRollup::removeStatement(const QString &row)
+{
+    const QString match = keyMatch(row);
+
+    return QString("UPDATE contacts_rollup SET cnt = cnt - 1 WHERE %1; "
+                   "DELETE FROM contacts_rollup WHERE cnt <= 0 AND %1;").arg(match);
+}
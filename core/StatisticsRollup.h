@@ -0,0 +1,38 @@
+#ifndef QLOG_CORE_STATISTICSROLLUP_H
+#define QLOG_CORE_STATISTICSROLLUP_H
+
+#include <QSqlDatabase>
+#include <QStringList>
+
+// Pre-aggregated QSO counts for the statistics.
+// The rollup table contains one row per QSO day and the combination of
+// the columns which are used by the statistics filters and charts.
+// The table is kept in sync with the contacts table by triggers therefore
+// it is maintained incrementally for each QSO insert, update and delete
+// including the imports. Common charts aggregate the rollup instead
+// of the whole contacts table.
+class StatisticsRollup
+{
+public:
+    // Creates the rollup table and its triggers if they do not exist.
+    // It is called after each DB schema migration check.
+    static bool setup(const QSqlDatabase &db = QSqlDatabase::database());
+
+    static bool isAvailable() { return available; }
+
+    // contacts columns which are present in the rollup with the same name
+    static const QStringList groupColumns;
+
+    static const QString tableName;
+
+private:
+    static QStringList keyColumns();
+    static QStringList keyValues(const QString &row);
+    static QString keyMatch(const QString &row);
+    static QString addStatement(const QString &row);
+    static QString removeStatement(const QString &row);
+
+    static bool available;
+};
+
+#endif // QLOG_CORE_STATISTICSROLLUP_H
@@ -7,16 +7,20 @@
 Q_DECLARE_LOGGING_CATEGORY(logGraphics)
 Q_DECLARE_LOGGING_CATEGORY(logPlugin)
 
-#define MODULE_IDENTIFICATION(m) static const char *mod_name = m; \
-                                 static const QLoggingCategory function_parameters(m".function.parameters"); \
+// Module categories are static objects - they are created once per translation unit
+// and registered in the Qt logging registry. A disabled category therefore costs
+// only one flag check on the hot path.
+#define MODULE_IDENTIFICATION(m) static const QLoggingCategory function_parameters(m".function.parameters"); \
                                  static const QLoggingCategory runtime(m".runtime"); \
-
-#define FCT_IDENTIFICATION QString logging_cat(mod_name); \
-                           logging_cat.append(".function.entered"); \
-                           QByteArray logging_cat_latin1 = logging_cat.toLatin1(); \
-                           const char* category_name = logging_cat_latin1.isEmpty() ? "default_category" : logging_cat_latin1.constData(); \
-                           QLoggingCategory log_category(category_name); \
-                           qCDebug(log_category)<<"***"
+                                 static const QLoggingCategory function_entered(m".function.entered");
+
+// Function-entry tracing can be removed completely at compile time
+// by defining QLOG_DISABLE_FUNCTION_TRACING (see QLog.pro)
+#ifdef QLOG_DISABLE_FUNCTION_TRACING
+#define FCT_IDENTIFICATION do {} while (0)
+#else
+#define FCT_IDENTIFICATION qCDebug(function_entered) << "***"
+#endif
 
 typedef enum debug_level
 {
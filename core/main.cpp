@@ -22,6 +22,8 @@
 #include "core/zonedetect.h"
 #include "ui/SplashScreen.h"
 #include "core/MembershipQE.h"
+#include "core/DxSpotEnricher.h"
+#include "core/StatisticsEngine.h"
 #include "service/kstchat/KSTChat.h"
 #include "data/Data.h"
 #include "service/GenericCallbook.h"
@@ -380,6 +382,10 @@ int main(int argc, char* argv[])
     qRegisterMetaTypeStreamOperators<QSet<int>>("QSet<int>");
 #endif
     qRegisterMetaType<DxSpot>();
+    qRegisterMetaType<QList<DxSpot>>();
+    qRegisterMetaType<DxSpotEnricher::Context>();
+    qRegisterMetaType<DxSpotEnricher::Statistics>();
+    qRegisterMetaType<StatisticsEngine::Result>();
     qRegisterMetaType<BandPlan::BandPlanMode>();
     qRegisterMetaType<SpotAlert>();
     qRegisterMetaType<Rig::Status>();
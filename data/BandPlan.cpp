@@ -1,5 +1,7 @@
 #include <QSqlQuery>
 #include <QSqlError>
+#include <QMutex>
+#include <algorithm>
 
 #include "BandPlan.h"
 #include "core/debug.h"
@@ -254,88 +256,127 @@ const QString BandPlan::freq2ExpectedMode(const double freq, QString &submode)
     return bandPlanMode2ExpectedMode(freq2BandMode(freq), submode);
 }
 
-const Band BandPlan::freq2Band(double freq)
+// Immutable copy of the bands and modes tables. It is loaded with
+// the first lookup and replaced when BandPlan::invalidateCache is called.
+// A load which failed is never cached - the next lookup tries it again.
+struct BandPlanTables
 {
-    FCT_IDENTIFICATION;
-
-    qCDebug(function_parameters) << freq;
+    QVector<Band> bands;       // sorted by start freq
+    QVector<double> maxEnd;    // max end freq of bands[0..i] - overlapping bands
+    QHash<QString, int> bandNames;
+    QHash<QString, QString> modeGroups;
+};
 
-    QSqlQuery query;
+static QSharedPointer<const BandPlanTables> bandPlanTables;
+static QMutex bandPlanTablesLock;
 
-    if ( ! query.prepare("SELECT name, start_freq, end_freq, sat_designator "
-                         "FROM bands "
-                         "WHERE :freq BETWEEN start_freq AND end_freq") )
-    {
-        qWarning() << "Cannot prepare Select statement";
-        return Band();
-    }
+static QSharedPointer<const BandPlanTables> loadBandPlanTables(const QSqlDatabase &db)
+{
+    FCT_IDENTIFICATION;
 
-    query.bindValue(0, freq);
+    QSharedPointer<BandPlanTables> tables(new BandPlanTables());
+    QSqlQuery query(db);
 
-    if ( ! query.exec() )
+    if ( ! query.exec("SELECT name, start_freq, end_freq, sat_designator "
+                      "FROM bands "
+                      "ORDER BY start_freq") )
     {
         qWarning() << "Cannot execute select statement" << query.lastError();
-        return Band();
+        return QSharedPointer<const BandPlanTables>();
     }
 
-    if ( query.next() )
+    while ( query.next() )
     {
         Band band;
         band.name = query.value(0).toString();
         band.start = query.value(1).toDouble();
         band.end = query.value(2).toDouble();
         band.satDesignator  = query.value(3).toString();
-        return band;
+
+        tables->maxEnd.append(( tables->maxEnd.isEmpty() ) ? band.end
+                                                           : qMax(tables->maxEnd.last(), band.end));
+        tables->bandNames.insert(band.name, tables->bands.size());
+        tables->bands.append(band);
     }
 
-    return Band();
+    if ( ! query.exec("SELECT name, dxcc FROM modes") )
+    {
+        qWarning() << "Cannot execute select statement" << query.lastError();
+        return QSharedPointer<const BandPlanTables>();
+    }
+
+    while ( query.next() )
+        tables->modeGroups.insert(query.value(0).toString(), query.value(1).toString());
+
+    qCDebug(runtime) << "Band Plan tables loaded; bands:" << tables->bands.size()
+                     << "modes:" << tables->modeGroups.size();
+
+    return tables;
 }
 
-const Band BandPlan::bandName2Band(const QString &name)
+static QSharedPointer<const BandPlanTables> getBandPlanTables(const QSqlDatabase &db)
 {
-    FCT_IDENTIFICATION;
+    QMutexLocker locker(&bandPlanTablesLock);
 
-    qCDebug(function_parameters) << name;
+    if ( bandPlanTables )
+        return bandPlanTables;
 
-    QSqlQuery query;
+    const QSharedPointer<const BandPlanTables> tables = loadBandPlanTables(db);
 
-    if ( ! query.prepare("SELECT name, start_freq, end_freq, sat_designator "
-                       "FROM bands "
-                       "WHERE name = :name LIMIT 1") )
-    {
-        qWarning() << "Cannot prepare Select statement";
-        return Band();
-    }
+    if ( !tables )
+        return QSharedPointer<const BandPlanTables>(new BandPlanTables());
 
-    query.bindValue(0, name.toLower());
+    bandPlanTables = tables;
+    return bandPlanTables;
+}
 
-    if ( ! query.exec() )
-    {
-        qWarning() << "Cannot execute select statement" << query.lastError();
-        return Band();
-    }
+const Band BandPlan::freq2Band(double freq, const QSqlDatabase &db)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << freq;
+
+    const QSharedPointer<const BandPlanTables> tables = getBandPlanTables(db);
+    const QVector<Band> &bands = tables->bands;
 
-    if ( query.next() )
+    // the last band which starts at or below the freq
+    int i = std::upper_bound(bands.cbegin(), bands.cend(), freq,
+                             [](double value, const Band &band)
+                             {
+                                 return value < band.start;
+                             }) - bands.cbegin() - 1;
+
+    // bands are not expected to overlap but the table is user-editable
+    for ( ; i >= 0 && tables->maxEnd.at(i) >= freq; --i )
     {
-        Band band;
-        band.name = query.value(0).toString();
-        band.start = query.value(1).toDouble();
-        band.end = query.value(2).toDouble();
-        band.satDesignator  = query.value(3).toString();
-        return band;
+        if ( freq <= bands.at(i).end )
+            return bands.at(i);
     }
 
     return Band();
 }
 
+const Band BandPlan::bandName2Band(const QString &name, const QSqlDatabase &db)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << name;
+
+    const QSharedPointer<const BandPlanTables> tables = getBandPlanTables(db);
+    const int index = tables->bandNames.value(name.toLower(), -1);
+
+    return ( index < 0 ) ? Band() : tables->bands.at(index);
+}
+
 const QList<Band> BandPlan::bandsList(const bool onlyDXCCBands,
-                                      const bool onlyEnabled)
+                                      const bool onlyEnabled,
+                                      const QSqlDatabase &db)
 {
     FCT_IDENTIFICATION;
 
     qCDebug(function_parameters) << onlyDXCCBands << onlyEnabled;
 
-    QSqlQuery query;
+    QSqlQuery query(db);
     QList<Band> ret;
 
     QString stmt(QLatin1String("SELECT name, start_freq, end_freq, sat_designator "
@@ -392,7 +433,7 @@ const QList<Band> BandPlan::bandsList(const bool onlyDXCCBands,
     return ret;
 }
 
-const QString BandPlan::modeToDXCCModeGroup(const QString &mode)
+const QString BandPlan::modeToDXCCModeGroup(const QString &mode, const QSqlDatabase &db)
 {
     FCT_IDENTIFICATION;
 
@@ -400,35 +441,27 @@ const QString BandPlan::modeToDXCCModeGroup(const QString &mode)
 
     if ( mode.isEmpty() ) return QString();
 
-    QSqlQuery query;
-
-    if ( !query.prepare("SELECT modes.dxcc "
-                        "FROM modes "
-                        "WHERE modes.name = :mode LIMIT 1"))
-    {
-        qWarning() << "Cannot prepare Select statement";
-        return QString();
-    }
+    return getBandPlanTables(db)->modeGroups.value(mode);
+}
 
-    query.bindValue(0, mode);
+void BandPlan::invalidateCache()
+{
+    FCT_IDENTIFICATION;
 
-    if ( query.exec() )
-    {
-        QString ret;
-        query.next();
-        ret = query.value(0).toString();
-        return ret;
-    }
+    // the new tables are loaded here, from the GUI thread connection - the worker
+    // threads keep using the previous tables until they are swapped
+    const QSharedPointer<const BandPlanTables> tables = loadBandPlanTables(QSqlDatabase::database());
 
-    return QString();
+    QMutexLocker locker(&bandPlanTablesLock);
+    bandPlanTables = tables;
 }
 
-const QString BandPlan::modeToModeGroup(const QString &mode)
+const QString BandPlan::modeToModeGroup(const QString &mode, const QSqlDatabase &db)
 {
     FCT_IDENTIFICATION;
 
     return isFTxMode(mode) ? BandPlan::MODE_GROUP_STRING_FTx
-                           : BandPlan::modeToDXCCModeGroup(mode);
+                           : BandPlan::modeToDXCCModeGroup(mode, db);
 }
 
 bool BandPlan::isFTxMode(const QString &mode)
@@ -2,6 +2,7 @@
 #define QLOG_DATA_BANDPLAN_H
 
 #include <QtCore>
+#include <QSqlDatabase>
 #include "Band.h"
 
 class BandPlan
@@ -33,12 +34,20 @@ public:
                                                    QString &submode);
     static const QString freq2ExpectedMode(const double freq,
                                      QString &submode);
-    static const Band freq2Band(double freq);
-    static const Band bandName2Band(const QString& name);
+    static const Band freq2Band(double freq,
+                                const QSqlDatabase &db = QSqlDatabase::database());
+    static const Band bandName2Band(const QString& name,
+                                    const QSqlDatabase &db = QSqlDatabase::database());
     static const QList<Band> bandsList(const bool onlyDXCCBands = false,
-                                       const bool onlyEnabled = false);
-    static const QString modeToDXCCModeGroup(const QString &mode);
-    static const QString modeToModeGroup(const QString &mode);
+                                       const bool onlyEnabled = false,
+                                       const QSqlDatabase &db = QSqlDatabase::database());
+    static const QString modeToDXCCModeGroup(const QString &mode,
+                                             const QSqlDatabase &db = QSqlDatabase::database());
+    static const QString modeToModeGroup(const QString &mode,
+                                         const QSqlDatabase &db = QSqlDatabase::database());
+    // bands and modes tables are cached; call it in the GUI thread
+    // when these tables are changed
+    static void invalidateCache();
     static bool isFTxMode(const QString &mode);
     static bool isFTxBandMode(BandPlanMode mode);
     BandPlan();
@@ -0,0 +1,144 @@
+#include "BandmapSpotStore.h"
+#include "core/debug.h"
+
+MODULE_IDENTIFICATION("qlog.data.bandmapspotstore");
+
+constexpr double BandmapSpotStore::DUPLICATE_FREQ_TOLERANCE;
+
+// BandmapWidget::spots is constructed during the static initialization where
+// the logging categories of other files may not exist yet - no FCT_IDENTIFICATION
+BandmapSpotStore::BandmapSpotStore()
+{
+}
+
+void BandmapSpotStore::insert(const DxSpot &spot)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << spot.freq << spot.callsign;
+
+    // the spot replaces the previous spots of the callsign around its frequency
+    // and the spot on the same frequency
+    auto it = spots.lowerBound(spot.freq - DUPLICATE_FREQ_TOLERANCE);
+    const auto upper = spots.upperBound(spot.freq + DUPLICATE_FREQ_TOLERANCE);
+
+    while ( it != upper )
+    {
+        if ( it.key() == spot.freq
+             || it.value().callsign.compare(spot.callsign, Qt::CaseInsensitive) == 0 )
+            it = erase(it);
+        else
+            ++it;
+    }
+
+    spots.insert(spot.freq, spot);
+    timeIndex.insert(spot.dateTime.toMSecsSinceEpoch(), spot.freq);
+    callsignIndex.insert(spot.callsign, spot.freq);
+    entityIndex.insert(spot.dxcc.dxcc, spot.freq);
+}
+
+void BandmapSpotStore::removeRange(double fromFreq, double toFreq)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << fromFreq << toFreq;
+
+    auto it = spots.lowerBound(fromFreq);
+    const auto end = spots.upperBound(toFreq);
+
+    while ( it != end )
+        it = erase(it);
+}
+
+int BandmapSpotStore::removeOlderThan(const QDateTime &time)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << time;
+
+    const qint64 timeMSecs = time.toMSecsSinceEpoch();
+    int removed = 0;
+
+    // the oldest spots are at the beginning of the time index
+    while ( !timeIndex.isEmpty() && timeIndex.firstKey() <= timeMSecs )
+    {
+        auto it = spots.find(timeIndex.first());
+
+        if ( it == spots.end() )
+        {
+            // must not happen - the indexes are maintained with the spots
+            qWarning() << "Bandmap spot index is not consistent" << timeIndex.first();
+            timeIndex.erase(timeIndex.begin());
+            continue;
+        }
+
+        erase(it);
+        removed++;
+    }
+
+    return removed;
+}
+
+void BandmapSpotStore::clear()
+{
+    FCT_IDENTIFICATION;
+
+    spots.clear();
+    timeIndex.clear();
+    callsignIndex.clear();
+    entityIndex.clear();
+}
+
+void BandmapSpotStore::updateAll(const std::function<void(DxSpot &)> &updater)
+{
+    FCT_IDENTIFICATION;
+
+    for ( auto it = spots.begin(); it != spots.end(); ++it )
+        updater(it.value());
+}
+
+void BandmapSpotStore::updateCallsign(const QString &callsign,
+                                      const std::function<void(DxSpot &)> &updater)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << callsign;
+
+    updateFreqs(callsignIndex.values(callsign), updater);
+}
+
+void BandmapSpotStore::updateEntity(qint32 dxcc, const std::function<void(DxSpot &)> &updater)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << dxcc;
+
+    updateFreqs(entityIndex.values(dxcc), updater);
+}
+
+QMap<double, DxSpot>::iterator BandmapSpotStore::erase(QMap<double, DxSpot>::iterator it)
+{
+    const DxSpot &spot = it.value();
+
+    auto timeIt = timeIndex.find(spot.dateTime.toMSecsSinceEpoch(), spot.freq);
+
+    if ( timeIt != timeIndex.end() )
+        timeIndex.erase(timeIt);
+
+    callsignIndex.remove(spot.callsign, spot.freq);
+    entityIndex.remove(spot.dxcc.dxcc, spot.freq);
+
+    return spots.erase(it);
+}
+
+void BandmapSpotStore::updateFreqs(const QList<double> &freqs,
+                                   const std::function<void(DxSpot &)> &updater)
+{
+    for ( double freq : freqs )
+    {
+        auto it = spots.find(freq);
+
+        if ( it != spots.end() )
+            updater(it.value());
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef QLOG_DATA_BANDMAPSPOTSTORE_H
+#define QLOG_DATA_BANDMAPSPOTSTORE_H
+
+#include <functional>
+#include <QMap>
+#include <QMultiMap>
+#include <QMultiHash>
+
+#include "data/DxSpot.h"
+
+// Spots displayed by the bandmaps. Spots are ordered by frequency; one spot
+// per frequency. The store also keeps secondary indexes by spot time,
+// callsign and DXCC entity therefore the spot aging removes only the expired
+// spots and a QSO change visits only the spots of the affected callsign or entity.
+// The store is shared by all bandmap widgets. It is not thread-safe;
+// it is accessed from the GUI thread only.
+class BandmapSpotStore
+{
+public:
+    typedef QMap<double, DxSpot>::const_iterator const_iterator;
+
+    // spots of the same callsign closer than this tolerance are replaced (MHz)
+    static constexpr double DUPLICATE_FREQ_TOLERANCE = 0.005;
+
+    BandmapSpotStore();
+
+    void insert(const DxSpot &spot);
+    void removeRange(double fromFreq, double toFreq);
+    int removeOlderThan(const QDateTime &time);
+    void clear();
+
+    int size() const { return spots.size(); }
+    DxSpot value(double freq) const { return spots.value(freq); }
+    const_iterator constFind(double freq) const { return spots.constFind(freq); }
+    const_iterator lowerBound(double freq) const { return spots.lowerBound(freq); }
+    const_iterator upperBound(double freq) const { return spots.upperBound(freq); }
+    const_iterator cbegin() const { return spots.cbegin(); }
+    const_iterator cend() const { return spots.cend(); }
+
+    // The updater must not change the callsign, DXCC entity, time and frequency
+    // of the spot because they are the index keys.
+    void updateAll(const std::function<void(DxSpot &)> &updater);
+    void updateCallsign(const QString &callsign, const std::function<void(DxSpot &)> &updater);
+    void updateEntity(qint32 dxcc, const std::function<void(DxSpot &)> &updater);
+
+private:
+    QMap<double, DxSpot>::iterator erase(QMap<double, DxSpot>::iterator it);
+    void updateFreqs(const QList<double> &freqs, const std::function<void(DxSpot &)> &updater);
+
+    QMap<double, DxSpot> spots;
+    QMultiMap<qint64, double> timeIndex;        // spot time [ms] -> freq
+    QMultiHash<QString, double> callsignIndex;  // callsign -> freq
+    QMultiHash<qint32, double> entityIndex;     // dxcc -> freq
+};
+
+#endif // QLOG_DATA_BANDMAPSPOTSTORE_H
@@ -1,44 +1,194 @@
+#include <algorithm>
+
 #include "Callsign.h"
 #include "core/debug.h"
 
 MODULE_IDENTIFICATION("qlog.core.callsign");
 
-Callsign::Callsign(const QString &callsign,
-                   QObject *parent)
-    : QObject{parent},
-      fullCallsign(callsign.toUpper()),
-      valid(false)
+// the callsign is upper-cased before it is parsed therefore only ASCII
+// upper-case letters and digits are the callsign characters
+static inline bool isCallsignLetter(const QChar &c)
+{
+    return c >= QLatin1Char('A') && c <= QLatin1Char('Z');
+}
+
+static inline bool isCallsignDigit(const QChar &c)
+{
+    return c >= QLatin1Char('0') && c <= QLatin1Char('9');
+}
+
+static inline bool isCallsignAlnum(const QChar &c)
+{
+    return isCallsignLetter(c) || isCallsignDigit(c);
+}
+
+Callsign::Callsign() :
+    hostPrefixLength(0),
+    baseStart(0),
+    basePrefixLength(0),
+    basePrefixNumberLength(0),
+    baseLength(0),
+    suffixStart(0),
+    suffixLength(0),
+    valid(false)
+{
+}
+
+Callsign::Callsign(const QString &callsign) :
+    fullCallsign(callsign.toUpper()),
+    hostPrefixLength(0),
+    baseStart(0),
+    basePrefixLength(0),
+    basePrefixNumberLength(0),
+    baseLength(0),
+    suffixStart(0),
+    suffixLength(0),
+    valid(false)
 {
     FCT_IDENTIFICATION;
 
-    QRegularExpression callsignRE = callsignRegEx();
-    QRegularExpressionMatch match = callsignRE.match(fullCallsign);
+    // The scanner follows the backtracking order of callsignRegExString():
+    // a host prefix is used only if the rest of the callsign is a valid
+    // base callsign; otherwise the base callsign starts at the beginning.
+    const int length = fullCallsign.size();
+    int hostEnd = 0;
+
+    while ( hostEnd < length && isCallsignAlnum(fullCallsign.at(hostEnd)) )
+        hostEnd++;
 
-    if ( match.hasMatch() )
+    if ( hostEnd > 0
+         && hostEnd < length
+         && fullCallsign.at(hostEnd) == QLatin1Char('/')
+         && parseBase(hostEnd + 1) )
     {
-        //it is a valid callsign
-        valid = true;
-        hostPrefixWithDelimiter = match.captured(1);
-        hostPrefix              = match.captured(2);
-        base                    = match.captured(3);
-        basePrefix              = match.captured(4);
-        basePrefixNumber        = match.captured(5);
-        suffixWithDelimiter     = match.captured(7);
-        suffix                  = match.captured(8);
-
-        qCDebug(runtime) << hostPrefix << base << suffix;
+        hostPrefixLength = hostEnd;
     }
-    else
+    else if ( !parseBase(0) )
     {
         //it is an invalid callsign
         fullCallsign = QString();
+        return;
     }
+
+    //it is a valid callsign
+    valid = true;
+    parseSuffix();
+
+    qCDebug(runtime) << getHostPrefix() << getBase() << getSuffix();
+}
+
+// ([A-Z][0-9]|[A-Z]{1,2}|[0-9][A-Z])([0-9]|[0-9]+)([A-Z]+)
+bool Callsign::parseBase(int start)
+{
+    const int length = fullCallsign.size();
+    const bool firstLetter = start < length && isCallsignLetter(fullCallsign.at(start));
+    const bool firstDigit = start < length && isCallsignDigit(fullCallsign.at(start));
+    const bool secondLetter = start + 1 < length && isCallsignLetter(fullCallsign.at(start + 1));
+    const bool secondDigit = start + 1 < length && isCallsignDigit(fullCallsign.at(start + 1));
+
+    // the prefix alternatives are tried in the order of the regular expression
+    if ( firstLetter && secondDigit && parseNumberAndLetters(start, 2) )
+        return true;
+
+    if ( firstLetter && secondLetter && parseNumberAndLetters(start, 2) )
+        return true;
+
+    if ( firstLetter && parseNumberAndLetters(start, 1) )
+        return true;
+
+    return firstDigit && secondLetter && parseNumberAndLetters(start, 2);
+}
+
+// the greedy number is followed by at least one letter
+bool Callsign::parseNumberAndLetters(int start, int prefixLength)
+{
+    const int length = fullCallsign.size();
+    const int numberStart = start + prefixLength;
+    int numberEnd = numberStart;
+
+    while ( numberEnd < length && isCallsignDigit(fullCallsign.at(numberEnd)) )
+        numberEnd++;
+
+    int baseEnd = numberEnd;
+
+    while ( baseEnd < length && isCallsignLetter(fullCallsign.at(baseEnd)) )
+        baseEnd++;
+
+    if ( numberEnd == numberStart || baseEnd == numberEnd )
+        return false;
+
+    baseStart = start;
+    basePrefixLength = prefixLength;
+    basePrefixNumberLength = numberEnd - numberStart;
+    baseLength = baseEnd - start;
+    return true;
+}
+
+// ([\/]([A-Z0-9]+))?
+void Callsign::parseSuffix()
+{
+    const int length = fullCallsign.size();
+    const int delimiter = baseStart + baseLength;
+
+    if ( delimiter + 1 >= length
+         || fullCallsign.at(delimiter) != QLatin1Char('/')
+         || !isCallsignAlnum(fullCallsign.at(delimiter + 1)) )
+        return;
+
+    suffixStart = delimiter + 1;
+    suffixLength = 1;
+
+    while ( suffixStart + suffixLength < length
+            && isCallsignAlnum(fullCallsign.at(suffixStart + suffixLength)) )
+        suffixLength++;
+}
+
+// the same result as QString::toInt() of the suffix
+bool Callsign::isSuffixNumber() const
+{
+    if ( suffixLength == 0 )
+        return false;
+
+    for ( int i = suffixStart; i < suffixStart + suffixLength; i++ )
+    {
+        if ( !isCallsignDigit(fullCallsign.at(i)) )
+            return false;
+    }
+
+    // a long number does not have to fit into int
+    if ( suffixLength < 10 )
+        return true;
+
+    bool isNumber = false;
+    (void)getSuffix().toInt(&isNumber);
+    return isNumber;
+}
+
+bool Callsign::isSecondarySpecialSuffix() const
+{
+    for ( const QString &specialSuffix : secondarySpecialSuffixes )
+    {
+        if ( specialSuffix.size() == suffixLength
+             && std::equal(specialSuffix.constBegin(), specialSuffix.constEnd(),
+                           fullCallsign.constBegin() + suffixStart) )
+            return true;
+    }
+    return false;
+}
+
+// prefix and number are adjacent in the callsign
+QString Callsign::basePrefixWithNumber() const
+{
+    return fullCallsign.mid(baseStart, basePrefixLength + basePrefixNumberLength);
 }
 
 const QRegularExpression Callsign::callsignRegEx()
 {
     FCT_IDENTIFICATION;
-    return QRegularExpression(callsignRegExString(), QRegularExpression::CaseInsensitiveOption);
+
+    // the expression is compiled only once - the copies share it
+    static const QRegularExpression callsignRE(callsignRegExString(), QRegularExpression::CaseInsensitiveOption);
+    return callsignRE;
 }
 
 const QString Callsign::callsignRegExString()
@@ -58,49 +208,49 @@ const QString Callsign::getHostPrefix() const
 {
     FCT_IDENTIFICATION;
 
-    return hostPrefix;
+    return fullCallsign.left(hostPrefixLength);
 }
 
 const QString Callsign::getHostPrefixWithDelimiter() const
 {
     FCT_IDENTIFICATION;
 
-    return hostPrefixWithDelimiter;
+    return ( hostPrefixLength > 0 ) ? fullCallsign.left(hostPrefixLength + 1) : QString();
 }
 
 const QString Callsign::getBase() const
 {
     FCT_IDENTIFICATION;
 
-    return base;
+    return fullCallsign.mid(baseStart, baseLength);
 }
 
 const QString Callsign::getBasePrefix() const
 {
     FCT_IDENTIFICATION;
 
-    return basePrefix;
+    return fullCallsign.mid(baseStart, basePrefixLength);
 }
 
 const QString Callsign::getBasePrefixNumber() const
 {
     FCT_IDENTIFICATION;
 
-    return basePrefixNumber;
+    return fullCallsign.mid(baseStart + basePrefixLength, basePrefixNumberLength);
 }
 
 const QString Callsign::getSuffix() const
 {
     FCT_IDENTIFICATION;
 
-    return suffix;
+    return fullCallsign.mid(suffixStart, suffixLength);
 }
 
 const QString Callsign::getSuffixWithDelimiter() const
 {
     FCT_IDENTIFICATION;
 
-    return suffixWithDelimiter;
+    return ( suffixLength > 0 ) ? fullCallsign.mid(suffixStart - 1, suffixLength + 1) : QString();
 }
 
 const QString Callsign::getWPXPrefix() const
@@ -120,39 +270,35 @@ const QString Callsign::getWPXPrefix() const
     /*********************
      * ONLY BASE CALLSIGN
      *********************/
-    if ( getBase() != QString()
-         && getHostPrefix() == QString()
-         && getSuffix() == QString() )
+    if ( hostPrefixLength == 0 && suffixLength == 0 )
     {
         // only callsign
         // return callsign prefix + prefix number
         // OL80ABC -> OL80
         // OK1ABC -> OK1
-        return getBasePrefix() + getBasePrefixNumber();
+        return basePrefixWithNumber();
     }
 
     /*********************
      * HOST PREFIX PRESENT
      *********************/
-    if ( getHostPrefix() != QString() )
+    if ( hostPrefixLength > 0 )
     {
         // callsign has a Host prefix SP/OK1XXX
         // we do not look at the suffix and assign automatically HostPrefix + '0'
 
-        if ( getHostPrefix().back().isDigit() )
+        if ( isCallsignDigit(fullCallsign.at(hostPrefixLength - 1)) )
             return getHostPrefix();
 
-        return getHostPrefix() + QString("0");
+        return getHostPrefix() + QLatin1Char('0');
     }
 
     /****************
      * SUFFIX PRESENT
      ****************/
-    if ( getSuffix().length() == 1) // some countries add single numbers as suffix to designate a call area, e.g. /4
+    if ( suffixLength == 1 ) // some countries add single numbers as suffix to designate a call area, e.g. /4
     {
-        bool isNumber = false;
-        (void)suffix.toInt(&isNumber);
-        if ( isNumber )
+        if ( isSuffixNumber() )
         {
             // callsign suffix is a number
             // VE7ABC/2 -> VE2
@@ -161,38 +307,35 @@ const QString Callsign::getWPXPrefix() const
 
         // callsign suffix is not a number
         // OK1ABC/P -> OK1
-        return getBasePrefix() + getBasePrefixNumber();
+        return basePrefixWithNumber();
     }
 
     /***************************
      * SUFFIX PRESENT LENGTH > 1
      ***************************/
-    if ( secondarySpecialSuffixes.contains(getSuffix()) )
+    if ( isSecondarySpecialSuffix() )
     {
         // QRP, MM etc.
         // OK1ABC/AM -> OK1
-        return getBasePrefix() + getBasePrefixNumber();
+        return basePrefixWithNumber();
     }
 
     // valid prefix should contain a number in the last position - check it
     // and prefix is not just a number
     // N8ABC/KH9 -> KH9
 
-    bool isNumber = false;
-    (void)getSuffix().toInt(&isNumber);
-
-    if ( isNumber )
+    if ( isSuffixNumber() )
     {
         // suffix contains 2 and more numbers - ignore it
-        return getBasePrefix() + getBasePrefixNumber();
+        return basePrefixWithNumber();
     }
 
     // suffix is combination letters and digits and last position is a number
-    if ( getSuffix().back().isDigit() )
+    if ( isCallsignDigit(fullCallsign.at(suffixStart + suffixLength - 1)) )
         return getSuffix();
 
     // prefix does not contain a number - add "0"
-    return getSuffix() + QString("0");
+    return getSuffix() + QLatin1Char('0');
 }
 
 bool Callsign::isValid() const
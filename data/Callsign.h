@@ -1,15 +1,19 @@
 #ifndef QLOG_DATA_CALLSIGN_H
 #define QLOG_DATA_CALLSIGN_H
 
-#include <QObject>
+#include <QString>
+#include <QStringList>
 #include <QRegularExpression>
 
-class Callsign : public QObject
+// Callsign parser. The callsign is split by a hand-written scanner which
+// follows callsignRegExString() exactly; only the positions of the callsign
+// parts are stored and the parts are extracted on demand.
+// The class is a lightweight copyable value type.
+class Callsign
 {
-    Q_OBJECT
 public:
-    explicit Callsign(const QString &callsign,
-                      QObject *parent = nullptr);
+    Callsign();
+    explicit Callsign(const QString &callsign);
     static const QRegularExpression callsignRegEx();
     static const QString callsignRegExString();
     static const QStringList secondarySpecialSuffixes;
@@ -26,14 +30,21 @@ public:
     bool isValid() const;
 
 private:
+    bool parseBase(int start);
+    bool parseNumberAndLetters(int start, int prefixLength);
+    void parseSuffix();
+    bool isSuffixNumber() const;
+    bool isSecondarySpecialSuffix() const;
+    QString basePrefixWithNumber() const;
+
     QString fullCallsign;
-    QString hostPrefix;
-    QString hostPrefixWithDelimiter;
-    QString base;
-    QString basePrefix;
-    QString basePrefixNumber;
-    QString suffix;
-    QString suffixWithDelimiter;
+    int hostPrefixLength;
+    int baseStart;
+    int basePrefixLength;
+    int basePrefixNumberLength;
+    int baseLength;
+    int suffixStart;
+    int suffixLength;
     bool valid;
 };
 
@@ -3,6 +3,7 @@
 #include <QSqlError>
 #include <QCompleter>
 #include <QColor>
+#include <QTimer>
 #include "Data.h"
 #include "data/Callsign.h"
 #include "core/debug.h"
@@ -14,8 +15,7 @@ MODULE_IDENTIFICATION("qlog.data.data");
 
 Data::Data(QObject *parent) :
    QObject(parent),
-   zd(nullptr),
-   isDXCCQueryValid(false)
+   zd(nullptr)
 {
     FCT_IDENTIFICATION;
 
@@ -29,76 +29,9 @@ Data::Data(QObject *parent) :
     loadWWFF();
     loadPOTA();
     loadTZ();
+    reloadDXCCStatusIndex();
 
 
-    // dxcc_prefixes_ad1c.exact DESC, dxcc_prefixes_ad1c.prefix DESC
-    // is used because it prefers an exact-match record over a partial-match records
-    isDXCCQueryValid = queryDXCC.prepare(
-                "SELECT "
-                "    dxcc_entities_ad1c.id, "
-                "    dxcc_entities_ad1c.name, "
-                "    dxcc_entities_ad1c.prefix, "
-                "    dxcc_entities_ad1c.cont, "
-                "    CASE "
-                "        WHEN (dxcc_prefixes_ad1c.cqz != 0) "
-                "        THEN dxcc_prefixes_ad1c.cqz "
-                "        ELSE dxcc_entities_ad1c.cqz "
-                "    END AS cqz, "
-                "    CASE "
-                "        WHEN (dxcc_prefixes_ad1c.ituz != 0) "
-                "        THEN dxcc_prefixes_ad1c.ituz "
-                "        ELSE dxcc_entities_ad1c.ituz "
-                "    END AS ituz , "
-                "    dxcc_entities_ad1c.lat, "
-                "    dxcc_entities_ad1c.lon, "
-                "    dxcc_entities_ad1c.tz, "
-                "    dxcc_prefixes_ad1c.exact "
-                "FROM dxcc_prefixes_ad1c "
-                "INNER JOIN dxcc_entities_ad1c ON (dxcc_prefixes_ad1c.dxcc = dxcc_entities_ad1c.id) "
-                "WHERE (dxcc_prefixes_ad1c.prefix = :callsign and dxcc_prefixes_ad1c.exact = true) "
-                "    OR (dxcc_prefixes_ad1c.exact = false and :callsign LIKE dxcc_prefixes_ad1c.prefix || '%') "
-                "ORDER BY dxcc_prefixes_ad1c.exact DESC, dxcc_prefixes_ad1c.prefix DESC "
-                "LIMIT 1 "
-                );
-
-    isDXCCClublogQueryValid = queryDXCCClublog.prepare(
-                "SELECT e.id, "
-                "      e.name, "
-                "      e.prefix, "
-                "      e.cont, "
-                "      COALESCE(z.cqz, "
-                "               CASE  WHEN (p.cqz != 0) THEN p.cqz ELSE e.cqz END) AS cqz, "
-                "      CASE WHEN z.cqz IS NOT NULL THEN NULL "
-                "           WHEN (p.ituz != 0) THEN p.ituz "
-                "           ELSE e.ituz END AS ituz, "
-                "      e.lat, "
-                "      e.lon, "
-                "      p.exact "
-                " FROM dxcc_prefixes_clublog p"
-                "   INNER JOIN dxcc_entities_clublog e ON (p.dxcc = e.id) "
-                "   LEFT JOIN dxcc_zone_exceptions_clublog z ON ( z.call = :exactcall AND :dxccdate BETWEEN COALESCE(z.start, '0001-01-01 00:00:00') "
-                "                                                                                    AND COALESCE(z.end, '9999-12-31 23:59:59')) "
-                " WHERE ((p.prefix = :exactcall and p.exact = 1) "
-                "     OR (p.exact = 0 and :modifiedcall LIKE p.prefix || '%')) "
-                "    AND :dxccdate BETWEEN COALESCE(p.start, '0001-01-01 00:00:00') "
-                "                          AND COALESCE(p.end, '9999-12-31 23:59:59') "
-                " ORDER BY p.exact DESC, p.prefix DESC LIMIT 1"
-                );
-
-    isDXCCIDAD1CQueryValid = queryDXCCIDAD1C.prepare(
-                " SELECT dxcc_entities_ad1c.id, dxcc_entities_ad1c.name, dxcc_entities_ad1c.prefix, dxcc_entities_ad1c.cont, "
-                "        dxcc_entities_ad1c.cqz, dxcc_entities_ad1c.ituz, dxcc_entities_ad1c.lat, dxcc_entities_ad1c.lon, dxcc_entities_ad1c.tz "
-                " FROM dxcc_entities_ad1c "
-                " WHERE dxcc_entities_ad1c.id = :dxccid"
-                );
-
-    isDXCCIDClublogQueryValid = queryDXCCIDClublog.prepare(
-                " SELECT c.id, c.name, c.prefix, c.cont, "
-                "        c.cqz, c.ituz, c.lat, c.lon "
-                " FROM dxcc_entities_clublog c "
-                " WHERE c.id = :dxccid"
-                );
-
     isSOTAQueryValid = querySOTA.prepare(
                 "SELECT summit_code,"
                 "       association_name,"
@@ -162,129 +95,34 @@ Data::~Data()
     }
 }
 
-#define RETCODE(a)  \
-    dxccStatusCache.insert(dxcc, myDXCC, band, mode, new DxccStatus(a)); \
-    return ((a));
-
-DxccStatus Data::dxccStatus(int dxcc, const QString &band, const QString &mode)
+DxccStatus Data::dxccStatus(int dxcc, const QString &band, const QString &mode,
+                            const QSqlDatabase &db)
 {
     FCT_IDENTIFICATION;
 
-    qCDebug(function_parameters) << dxcc << " " << band << " " << mode;
-
-    const int myDXCC = StationProfilesManager::instance()->getCurProfile1().dxcc;
-
-    DxccStatus *statusFromCache = dxccStatusCache.value(dxcc, myDXCC, band, mode);
-
-    if ( statusFromCache )
-        return *statusFromCache;
-
-    // FTx modes (FT8, FT4, FT2) are stored in contacts with modes.dxcc = 'DIGITAL',
-    // so we use DIGITAL as the effective mode group when querying for FTx.
-    const QString modeForQuery = ( mode == BandPlan::MODE_GROUP_STRING_FTx )
-                                 ? BandPlan::MODE_GROUP_STRING_DIGITAL
-                                 : mode;
-
-    QString sql_mode(":mode");
-
-    if ( modeForQuery != BandPlan::MODE_GROUP_STRING_CW
-         && modeForQuery != BandPlan::MODE_GROUP_STRING_PHONE
-         && modeForQuery != BandPlan::MODE_GROUP_STRING_DIGITAL )
-    {
-        sql_mode = "(SELECT modes.dxcc FROM modes WHERE modes.name = :mode LIMIT 1) ";
-    }
-
-
-    QStringList dxccConfirmedByCond(QLatin1String("0=1")); // if no option is selected then always false
-
-    if ( LogParam::getDxccConfirmedByLotwState() )
-        dxccConfirmedByCond << QLatin1String("all_dxcc_qsos.lotw_qsl_rcvd = 'Y'");
-
-    if ( LogParam::getDxccConfirmedByPaperState() )
-        dxccConfirmedByCond << QLatin1String("all_dxcc_qsos.qsl_rcvd = 'Y'");
-
-    if ( LogParam::getDxccConfirmedByEqslState() )
-        dxccConfirmedByCond << QLatin1String("all_dxcc_qsos.eqsl_qsl_rcvd = 'Y'");
-
-    QSqlQuery query;
-    QString sqlStatement = QString("WITH all_dxcc_qsos AS (SELECT DISTINCT contacts.mode, contacts.band, "
-                                         "                                       contacts.qsl_rcvd, contacts.lotw_qsl_rcvd, contacts.eqsl_qsl_rcvd "
-                                         "                       FROM contacts "
-                                         "                       WHERE dxcc = :dxcc %1) "
-                                         "  SELECT (SELECT 1 FROM all_dxcc_qsos LIMIT 1) as entity,"
-                                         "         (SELECT 1 FROM all_dxcc_qsos WHERE band = :band LIMIT 1) as band, "
-                                         "         (SELECT 1 FROM all_dxcc_qsos INNER JOIN modes ON (modes.name = all_dxcc_qsos.mode) "
-                                         "          WHERE modes.dxcc = %2 LIMIT 1) as mode, "
-                                         "         (SELECT 1 FROM all_dxcc_qsos INNER JOIN modes ON (modes.name = all_dxcc_qsos.mode) "
-                                         "          WHERE modes.dxcc = %3 AND all_dxcc_qsos.band = :band LIMIT 1) as slot, "
-                                         "         (SELECT 1 FROM all_dxcc_qsos INNER JOIN modes ON (modes.name = all_dxcc_qsos.mode) "
-                                         "          WHERE modes.dxcc = %4 AND all_dxcc_qsos.band = :band "
-                                         "                AND (%5) LIMIT 1) as confirmed")
-                                         .arg(( myDXCC != 0 ) ? QString(" AND my_dxcc = %1").arg(myDXCC)
-                                                                    : "",
-                                              sql_mode,
-                                              sql_mode,
-                                              sql_mode,
-                                              dxccConfirmedByCond.join(" OR "));
-
-    if ( ! query.prepare(sqlStatement) )
-    {
-        qWarning() << "Cannot prepare Select statement";
-        return DxccStatus::UnknownStatus;
-    }
-
-    query.bindValue(":dxcc", dxcc);
-    query.bindValue(":band", band);
-    query.bindValue(":mode", modeForQuery);
-
-    if ( ! query.exec() )
-    {
-        qWarning() << "Cannot execute Select statement" << query.lastError();
-        return DxccStatus::UnknownStatus;
-    }
-
-    if ( query.next() )
-    {
-        if ( query.value(0).toString().isEmpty() )
-        {
-            RETCODE(DxccStatus::NewEntity);
-        }
+    return dxccStatus(dxcc, band, mode,
+                      StationProfilesManager::instance()->getCurProfile1().dxcc,
+                      LogParam::getDxccConfirmedByLotwState(),
+                      LogParam::getDxccConfirmedByPaperState(),
+                      LogParam::getDxccConfirmedByEqslState(),
+                      db);
+}
 
-        if ( query.value(1).toString().isEmpty() )
-        {
-            if ( query.value(2).toString().isEmpty() )
-            {
-                RETCODE(DxccStatus::NewBandMode);
-            }
-            else
-            {
-                RETCODE(DxccStatus::NewBand);
-            }
-        }
+DxccStatus Data::dxccStatus(int dxcc, const QString &band, const QString &mode,
+                            int myDXCC, bool lotwConfirmed, bool paperConfirmed,
+                            bool eqslConfirmed, const QSqlDatabase &db)
+{
+    FCT_IDENTIFICATION;
 
-        if ( query.value(2).toString().isEmpty() )
-        {
-            RETCODE(DxccStatus::NewMode);
-        }
+    qCDebug(function_parameters) << dxcc << " " << band << " " << mode << myDXCC;
 
-        if ( query.value(3).toString().isEmpty() )
-        {
-            RETCODE(DxccStatus::NewSlot);
-        }
+    const QString &modeGroup = dxccModeGroup(mode, db);
 
-        if ( query.value(4).toString().isEmpty() )
-        {
-            RETCODE(DxccStatus::Worked);
-        }
-        else
-        {
-            RETCODE(DxccStatus::Confirmed);
-        }
-    }
+    QMutexLocker locker(&dxccStatusIndexLock);
 
-    RETCODE(DxccStatus::UnknownStatus);
+    return dxccStatusIndex.status(dxcc, myDXCC, band, modeGroup,
+                                  lotwConfirmed, paperConfirmed, eqslConfirmed);
 }
-#undef RETCODE
 
 QStringList Data::contestList()
 {
@@ -707,28 +545,124 @@ QStringList Data::sigIDList()
     return sigLOV;
 }
 
-void Data::invalidateDXCCStatusCache(const QSqlRecord &record)
+void Data::addContactToDXCCStatusIndex(const QSqlRecord &record)
 {
     FCT_IDENTIFICATION;
 
-    dxccStatusCache.invalidate(record.value("dxcc").toInt(), StationProfilesManager::instance()->getCurProfile1().dxcc);
+    const QString &modeGroup = BandPlan::modeToDXCCModeGroup(record.value("mode").toString());
+
+    QMutexLocker locker(&dxccStatusIndexLock);
+
+    dxccStatusIndex.addContact(record.value("dxcc").toInt(),
+                               record.value("my_dxcc").toInt(),
+                               record.value("band").toString(),
+                               modeGroup,
+                               record.value("qsl_rcvd").toString() == QLatin1String("Y"),
+                               record.value("lotw_qsl_rcvd").toString() == QLatin1String("Y"),
+                               record.value("eqsl_qsl_rcvd").toString() == QLatin1String("Y"));
 }
 
-void Data::invalidateSetOfDXCCStatusCache(const QSet<uint> &entities)
+void Data::refreshDXCCStatusIndex(const QSet<uint> &entities)
 {
     FCT_IDENTIFICATION;
 
-    int myDXCC = StationProfilesManager::instance()->getCurProfile1().dxcc;
+    if ( entities.isEmpty() )
+        return;
+
+    QStringList entityList;
+
+    for ( uint entity : entities )
+        entityList << QString::number(entity);
+
+    QSqlQuery query;
+    query.setForwardOnly(true);
+
+    if ( ! query.exec(dxccStatusIndexStatement(QString("WHERE c.dxcc IN (%1)").arg(entityList.join(",")))) )
+    {
+        qWarning() << "Cannot execute Select statement" << query.lastError();
+        return;
+    }
+
+    QMutexLocker locker(&dxccStatusIndexLock);
 
     for ( uint entity : entities )
-       dxccStatusCache.invalidate(entity, myDXCC);
+        dxccStatusIndex.removeEntity(entity);
+
+    addContactsToDXCCStatusIndex(query);
+}
+
+void Data::prepareDXCCStatusIndexUpdate(const QSqlRecord &record)
+{
+    FCT_IDENTIFICATION;
+
+    // the signal is emitted before the contact is updated - the old DXCC
+    // is still in DB. Both old and new entities are refreshed when the update
+    // is finished.
+    pendingDXCCStatusIndexRefresh << record.value("dxcc").toUInt();
+
+    QSqlQuery query;
+
+    if ( query.prepare("SELECT dxcc FROM contacts WHERE id = :id") )
+    {
+        query.bindValue(":id", record.value("id"));
+
+        if ( query.exec() && query.next() )
+            pendingDXCCStatusIndexRefresh << query.value(0).toUInt();
+    }
+
+    QTimer::singleShot(0, this, [this]()
+    {
+        const QSet<uint> entities = pendingDXCCStatusIndexRefresh;
+        pendingDXCCStatusIndexRefresh.clear();
+        refreshDXCCStatusIndex(entities);
+    });
 }
 
-void Data::clearDXCCStatusCache()
+void Data::reloadDXCCStatusIndex()
 {
     FCT_IDENTIFICATION;
 
-    dxccStatusCache.clear();
+    QSqlQuery query;
+    query.setForwardOnly(true);
+
+    if ( ! query.exec(dxccStatusIndexStatement(QString())) )
+    {
+        qWarning() << "Cannot execute Select statement" << query.lastError();
+        return;
+    }
+
+    QMutexLocker locker(&dxccStatusIndexLock);
+
+    dxccStatusIndex.clear();
+    addContactsToDXCCStatusIndex(query);
+
+    qCDebug(runtime) << "DXCC Status Index loaded; entities:" << dxccStatusIndex.entityCount();
+}
+
+QString Data::dxccStatusIndexStatement(const QString &whereClause)
+{
+    FCT_IDENTIFICATION;
+
+    return QString("SELECT DISTINCT c.dxcc, c.my_dxcc, c.band, m.dxcc, "
+                   "       c.qsl_rcvd = 'Y', c.lotw_qsl_rcvd = 'Y', c.eqsl_qsl_rcvd = 'Y' "
+                   "FROM contacts c "
+                   "LEFT OUTER JOIN modes m ON (m.name = c.mode) %1").arg(whereClause);
+}
+
+void Data::addContactsToDXCCStatusIndex(QSqlQuery &query)
+{
+    FCT_IDENTIFICATION;
+
+    while ( query.next() )
+    {
+        dxccStatusIndex.addContact(query.value(0).toInt(),
+                                   query.value(1).toInt(),
+                                   query.value(2).toString(),
+                                   query.value(3).toString(),
+                                   query.value(4).toBool(),
+                                   query.value(5).toBool(),
+                                   query.value(6).toBool());
+    }
 }
 
 qulonglong Data::countDupe(const QString &callsign,
@@ -737,14 +671,27 @@ qulonglong Data::countDupe(const QString &callsign,
 {
     FCT_IDENTIFICATION;
 
+    return countDupe(callsign, band, mode,
+                     LogParam::getContestDupeType(),
+                     LogParam::getContestID(),
+                     LogParam::getContestDupeDate(),
+                     QSqlDatabase::database());
+}
+
+qulonglong Data::countDupe(const QString &callsign,
+                           const QString &band,
+                           const QString &mode,
+                           int dupeType,
+                           const QString &contestID,
+                           const QDateTime &dupeStartTime,
+                           const QSqlDatabase &db)
+{
+    FCT_IDENTIFICATION;
+
     qCDebug(function_parameters) << callsign
                                  << band
                                  << mode;
 
-    int dupeType = LogParam::getContestDupeType();
-    const QString &contestID = LogParam::getContestID();
-    const QDateTime &dupeStartTime = LogParam::getContestDupeDate();
-
     qCDebug(runtime) << dupeType <<  dupeStartTime << contestID;
 
     if ( contestID.isEmpty()
@@ -752,59 +699,144 @@ qulonglong Data::countDupe(const QString &callsign,
          || !dupeStartTime.isValid() )
         return false;
 
-    QStringList whereClause =
-    {
-        "callsign = :callsign",
-        "contest_id = :contestid"
-    };
+    Data *data = Data::instance();
+    const QString &modeGroup = dxccModeGroup(mode, db);
 
-    if ( dupeType >= DupeType::ALL_BANDS )
-        whereClause << QLatin1String("datetime(start_time) >= datetime(:date)");
+    QMutexLocker locker(&data->dupeIndexLock);
 
-    if ( dupeType >= DupeType::EACH_BAND)
-        whereClause << QLatin1String("band = :band");
+    // the index contains only contacts of one contest - reload it when
+    // the contest is changed or the index has been invalidated
+    if ( data->dupeIndexContestID != contestID
+         && !data->loadDupeIndex(contestID, db) )
+        return false;
 
-    // FTx modes are stored with modes.dxcc = 'DIGITAL', so map FTx to DIGITAL.
-    const QString modeForQuery = ( mode == BandPlan::MODE_GROUP_STRING_FTx )
-                                 ? BandPlan::MODE_GROUP_STRING_DIGITAL
-                                 : mode;
+    return data->dupeIndex.count(callsign, band, modeGroup, dupeStartTime,
+                                 dupeType >= DupeType::EACH_BAND,
+                                 dupeType >= DupeType::EACH_BAND_MODE);
+}
 
-    if ( dupeType >= DupeType::EACH_BAND_MODE )
-    {
-        QString sql_mode = (modeForQuery != BandPlan::MODE_GROUP_STRING_CW &&
-                            modeForQuery != BandPlan::MODE_GROUP_STRING_PHONE &&
-                            modeForQuery != BandPlan::MODE_GROUP_STRING_DIGITAL)
-                            ? "(SELECT modes.dxcc FROM modes WHERE modes.name = :mode LIMIT 1)"
-                            : ":mode";
-        whereClause << QString("m.dxcc = %1").arg(sql_mode);
-    }
+QString Data::dxccModeGroup(const QString &mode, const QSqlDatabase &db)
+{
+    FCT_IDENTIFICATION;
 
-    QString queryString("SELECT COUNT(1) "
-                        "FROM contacts c "
-                        "INNER JOIN modes m ON (m.name = c.mode) "
-                        "WHERE %1 ");
+    // FTx modes (FT8, FT4, FT2) are stored in contacts with modes.dxcc = 'DIGITAL',
+    // so we use DIGITAL as the effective mode group for FTx.
+    if ( mode == BandPlan::MODE_GROUP_STRING_FTx )
+        return BandPlan::MODE_GROUP_STRING_DIGITAL;
 
-    QSqlQuery query;
+    if ( mode == BandPlan::MODE_GROUP_STRING_CW
+         || mode == BandPlan::MODE_GROUP_STRING_PHONE
+         || mode == BandPlan::MODE_GROUP_STRING_DIGITAL )
+        return mode;
+
+    return BandPlan::modeToDXCCModeGroup(mode, db);
+}
+
+bool Data::loadDupeIndex(const QString &contestID, const QSqlDatabase &db)
+{
+    FCT_IDENTIFICATION;
 
-    if ( ! query.prepare(queryString.arg(whereClause.join(" AND "))))
+    qCDebug(function_parameters) << contestID;
+
+    dupeIndex.clear();
+    dupeIndexContestID.clear();
+
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+
+    if ( ! query.prepare("SELECT c.callsign, c.band, m.dxcc, c.start_time "
+                         "FROM contacts c "
+                         "INNER JOIN modes m ON (m.name = c.mode) "
+                         "WHERE c.contest_id = :contestid") )
     {
-        qWarning() << "Cannot prepare Select statement" << queryString.arg(whereClause.join(" AND "));
+        qWarning() << "Cannot prepare Select statement" << query.lastError();
         return false;
     }
 
-    query.bindValue(":callsign", callsign);
-    query.bindValue(":date", dupeStartTime);
-    query.bindValue(":band", band);
-    query.bindValue(":mode", modeForQuery);
     query.bindValue(":contestid", contestID);
 
     if ( ! query.exec() )
     {
-        qWarning() << "Cannot execute Select statement" << query.lastError() << query.lastQuery();
+        qWarning() << "Cannot execute Select statement" << query.lastError();
         return false;
     }
 
-    return (query.first()) ? query.value(0).toULongLong() : 0ULL;
+    while ( query.next() )
+    {
+        dupeIndex.addContact(query.value(0).toString(),
+                             query.value(1).toString(),
+                             query.value(2).toString(),
+                             query.value(3).toDateTime());
+    }
+
+    dupeIndexContestID = contestID;
+
+    qCDebug(runtime) << "Dupe Index loaded; contacts:" << dupeIndex.size();
+
+    return true;
+}
+
+void Data::addContactToDupeIndex(const QSqlRecord &record)
+{
+    FCT_IDENTIFICATION;
+
+    const QString &modeGroup = dxccModeGroup(record.value("mode").toString());
+
+    // contacts without DXCC mode group are not counted (see loadDupeIndex)
+    if ( modeGroup.isEmpty() )
+        return;
+
+    QMutexLocker locker(&dupeIndexLock);
+
+    if ( dupeIndexContestID.isEmpty()
+         || record.value("contest_id").toString() != dupeIndexContestID )
+        return;
+
+    dupeIndex.addContact(record.value("callsign").toString(),
+                         record.value("band").toString(),
+                         modeGroup,
+                         record.value("start_time").toDateTime());
+}
+
+void Data::removeContactFromDupeIndex(const QSqlRecord &record)
+{
+    FCT_IDENTIFICATION;
+
+    const QString &modeGroup = dxccModeGroup(record.value("mode").toString());
+
+    if ( modeGroup.isEmpty() )
+        return;
+
+    QMutexLocker locker(&dupeIndexLock);
+
+    if ( dupeIndexContestID.isEmpty()
+         || record.value("contest_id").toString() != dupeIndexContestID )
+        return;
+
+    dupeIndex.removeContact(record.value("callsign").toString(),
+                            record.value("band").toString(),
+                            modeGroup,
+                            record.value("start_time").toDateTime());
+}
+
+void Data::prepareDupeIndexUpdate(const QSqlRecord &)
+{
+    FCT_IDENTIFICATION;
+
+    // the signal is emitted before the contact is updated - the index is
+    // invalidated when the update is finished
+    QTimer::singleShot(0, this, &Data::invalidateDupeIndex);
+}
+
+void Data::invalidateDupeIndex()
+{
+    FCT_IDENTIFICATION;
+
+    QMutexLocker locker(&dupeIndexLock);
+
+    // the index is reloaded with the next dupe query
+    dupeIndex.clear();
+    dupeIndexContestID.clear();
 }
 
 QString Data::safeQueryString(const QUrlQuery &query)
@@ -1069,99 +1101,58 @@ DxccEntity Data::lookupDxcc(const QString &callsign)
 DxccEntity Data::lookupDxccAD1C(const QString &callsign)
 {
     FCT_IDENTIFICATION;
-    static QCache<QString, DxccEntity> localCache(1000);
 
     qCDebug(function_parameters) << callsign;
 
     if ( callsign.isEmpty())
         return  DxccEntity();
 
-    DxccEntity dxccRet;
-    DxccEntity *dxccCached = localCache.object(callsign);
-
-    if ( dxccCached )
-    {
-        dxccRet = *dxccCached;
-    }
-    else
-    {
-        if ( ! isDXCCQueryValid )
-        {
-            qWarning() << "Cannot prepare Select statement";
-            return DxccEntity();
-        }
+    const QSharedPointer<const DxccPrefixTrie> trie = ad1cTrie();
 
-        QString lookupPrefix = callsign; // use the callsign with optional prefix as default to find the dxcc
-        const Callsign parsedCallsign(callsign); // use Callsign to split the callsign into its parts
+    QString lookupPrefix = callsign; // use the callsign with optional prefix as default to find the dxcc
+    const Callsign parsedCallsign(callsign); // use Callsign to split the callsign into its parts
 
-        if ( parsedCallsign.isValid() )
+    if ( parsedCallsign.isValid() )
+    {
+        QString suffix = parsedCallsign.getSuffix();
+        if ( suffix.length() == 1 ) // some countries add single numbers as suffix to designate a call area, e.g. /4
         {
-            QString suffix = parsedCallsign.getSuffix();
-            if ( suffix.length() == 1 ) // some countries add single numbers as suffix to designate a call area, e.g. /4
-            {
-                bool isNumber = false;
-                (void)suffix.toInt(&isNumber);
-                if ( isNumber )
-                {
-                    lookupPrefix = parsedCallsign.getBasePrefix() + suffix; // use the call prefix and the number from the suffix to find the dxcc
-                }
-            }
-            else if ( suffix.length() > 1
-                      && !parsedCallsign.secondarySpecialSuffixes.contains(suffix) ) // if there is more than one character and it is not one of the special suffixes, we definitely have a call prefix as suffix
+            bool isNumber = false;
+            (void)suffix.toInt(&isNumber);
+            if ( isNumber )
             {
-                lookupPrefix = suffix;
+                lookupPrefix = parsedCallsign.getBasePrefix() + suffix; // use the call prefix and the number from the suffix to find the dxcc
             }
         }
-
-        queryDXCC.bindValue(":callsign", lookupPrefix);
-
-        if ( ! queryDXCC.exec() )
+        else if ( suffix.length() > 1
+                  && !parsedCallsign.secondarySpecialSuffixes.contains(suffix) ) // if there is more than one character and it is not one of the special suffixes, we definitely have a call prefix as suffix
         {
-            qWarning() << "Cannot execute Select statement" << queryDXCC.lastError() << queryDXCC.lastQuery();
-            return DxccEntity();
+            lookupPrefix = suffix;
         }
+    }
 
-        if ( queryDXCC.next() )
-        {
-            dxccRet.dxcc = queryDXCC.value(0).toInt();
-            dxccRet.country = queryDXCC.value(1).toString();
-            dxccRet.prefix = queryDXCC.value(2).toString();
-            dxccRet.cont = queryDXCC.value(3).toString();
-            dxccRet.cqz = queryDXCC.value(4).toInt();
-            dxccRet.ituz = queryDXCC.value(5).toInt();
-            dxccRet.latlon[0] = queryDXCC.value(6).toDouble();
-            dxccRet.latlon[1] = queryDXCC.value(7).toDouble();
-            dxccRet.tz = queryDXCC.value(8).toFloat();
-            bool isExactMatch = queryDXCC.value(9).toBool();
-            dxccRet.flag = dxccFlag(dxccRet.dxcc);
-
-            if ( !isExactMatch )
-            {
-                // find the exceptions to the exceptions
-                if (  dxccRet.prefix == "KG4" && parsedCallsign.getBase().size() != 5 )
-                {
-                    //only KG4AA - KG4ZZ are US Navy in Guantanamo Bay. Other KG4s are USA
-                    dxccRet = lookupDxccID(291); // USA
-
-                    //do not overwrite the original prefix
-                    dxccRet.prefix = "KG4";
-                }
-            }
+    // an exact-match record is preferred over a partial-match records
+    const DxccPrefixTrie::Entry *exactEntry = trie->exactMatch(lookupPrefix, 0);
+    const DxccPrefixTrie::Entry *entry = ( exactEntry ) ? exactEntry
+                                                        : trie->longestPrefixMatch(lookupPrefix, 0);
 
-            dxccCached = new DxccEntity;
+    if ( !entry )
+        return trieEntity2DxccEntity(*trie, 0);
 
-            if ( dxccCached )
-            {
-                *dxccCached = dxccRet;
-                localCache.insert(callsign, dxccCached);
-            }
-        }
-        else
+    DxccEntity dxccRet = trieEntity2DxccEntity(*trie, entry->dxcc);
+    dxccRet.cqz = entry->cqz;
+    dxccRet.ituz = entry->ituz;
+
+    if ( !exactEntry )
+    {
+        // find the exceptions to the exceptions
+        if (  dxccRet.prefix == "KG4" && parsedCallsign.getBase().size() != 5 )
         {
-            dxccRet.dxcc = 0;
-            dxccRet.ituz = 0;
-            dxccRet.cqz = 0;
-            dxccRet.tz = 0;
+            //only KG4AA - KG4ZZ are US Navy in Guantanamo Bay. Other KG4s are USA
+            dxccRet = lookupDxccID(291); // USA
+
+            //do not overwrite the original prefix
+            dxccRet.prefix = "KG4";
         }
     }
 
@@ -1174,42 +1165,7 @@ DxccEntity Data::lookupDxccIDAD1C(const int dxccID)
 
     qCDebug(function_parameters) << dxccID;
 
-    if ( !isDXCCIDAD1CQueryValid )
-    {
-        qWarning() << "Cannot prepare Select statement";
-        return DxccEntity();
-    }
-
-    queryDXCCIDAD1C.bindValue(":dxccid", dxccID);
-    if ( ! queryDXCCIDAD1C.exec() )
-    {
-        qWarning() << "Cannot execte Select statement" << queryDXCCIDAD1C.lastError();
-        return DxccEntity();
-    }
-
-    DxccEntity dxccRet;
-
-    if ( queryDXCCIDAD1C.next() )
-    {
-        dxccRet.dxcc = queryDXCCIDAD1C.value(0).toInt();
-        dxccRet.country = queryDXCCIDAD1C.value(1).toString();
-        dxccRet.prefix = queryDXCCIDAD1C.value(2).toString();
-        dxccRet.cont = queryDXCCIDAD1C.value(3).toString();
-        dxccRet.cqz = queryDXCCIDAD1C.value(4).toInt();
-        dxccRet.ituz = queryDXCCIDAD1C.value(5).toInt();
-        dxccRet.latlon[0] = queryDXCCIDAD1C.value(6).toDouble();
-        dxccRet.latlon[1] = queryDXCCIDAD1C.value(7).toDouble();
-        dxccRet.tz = queryDXCCIDAD1C.value(8).toFloat();
-        dxccRet.flag = dxccFlag(dxccRet.dxcc);
-    }
-    else
-    {
-        dxccRet.dxcc = 0;
-        dxccRet.ituz = 0;
-        dxccRet.cqz = 0;
-        dxccRet.tz = 0;
-    }
-    return dxccRet;
+    return trieEntity2DxccEntity(*ad1cTrie(), dxccID);
 }
 
 DxccEntity Data::lookupDxccIDClublog(const int dxccID)
@@ -1218,42 +1174,7 @@ DxccEntity Data::lookupDxccIDClublog(const int dxccID)
 
     qCDebug(function_parameters) << dxccID;
 
-    if ( !isDXCCIDClublogQueryValid )
-    {
-        qWarning() << "Cannot prepare Select statement";
-        return DxccEntity();
-    }
-
-    queryDXCCIDClublog.bindValue(":dxccid", dxccID);
-    if ( ! queryDXCCIDClublog.exec() )
-    {
-        qWarning() << "Cannot execte Select statement" << queryDXCCIDClublog.lastError();
-        return DxccEntity();
-    }
-
-    DxccEntity dxccRet;
-
-    if ( queryDXCCIDClublog.next() )
-    {
-        dxccRet.dxcc = queryDXCCIDClublog.value(0).toInt();
-        dxccRet.country = queryDXCCIDClublog.value(1).toString();
-        dxccRet.prefix = queryDXCCIDClublog.value(2).toString();
-        dxccRet.cont = queryDXCCIDClublog.value(3).toString();
-        dxccRet.cqz = queryDXCCIDClublog.value(4).toInt();
-        dxccRet.ituz = queryDXCCIDClublog.value(5).toInt();
-        dxccRet.latlon[0] = queryDXCCIDClublog.value(6).toDouble();
-        dxccRet.latlon[1] = queryDXCCIDClublog.value(7).toDouble();
-        dxccRet.tz = queryDXCCIDClublog.value(8).toFloat();
-        dxccRet.flag = dxccFlag(dxccRet.dxcc);
-    }
-    else
-    {
-        dxccRet.dxcc = 0;
-        dxccRet.ituz = 0;
-        dxccRet.cqz = 0;
-        dxccRet.tz = 0;
-    }
-    return dxccRet;
+    return trieEntity2DxccEntity(*clublogTrie(), dxccID);
 }
 
 DxccEntity Data::lookupDxccID(const int dxccID)
@@ -1279,11 +1200,8 @@ DxccEntity Data::lookupDxccClublog(const QString &callsign, const QDateTime &dat
 
     if ( callsign.isEmpty()) return  DxccEntity();
 
-    if ( ! isDXCCClublogQueryValid )
-    {
-        qWarning() << "Cannot prepare Select statement";
-        return DxccEntity();
-    }
+    const QSharedPointer<const DxccPrefixTrie> trie = clublogTrie();
+    const qint64 at = date.toMSecsSinceEpoch();
 
     QString lookupPrefix = callsign; // use the callsign with optional prefix as default to find the dxcc
     const Callsign parsedCallsign(callsign); // use Callsign to split the callsign into its parts
@@ -1307,36 +1225,29 @@ DxccEntity Data::lookupDxccClublog(const QString &callsign, const QDateTime &dat
         }
     }
 
-    queryDXCCClublog.bindValue(":modifiedcall", lookupPrefix);
-    queryDXCCClublog.bindValue(":exactcall", callsign);
-    queryDXCCClublog.bindValue(":dxccdate", date);
-
-    if ( ! queryDXCCClublog.exec() )
-    {
-        qWarning() << "Cannot execute Select statement"
-                   << queryDXCCClublog.lastError()
-                   << queryDXCCClublog.lastQuery();
-        return DxccEntity();
-    }
+    // Clublog exceptions are full callsigns, prefixes are matched against the modified call
+    const DxccPrefixTrie::Entry *exactEntry = trie->exactMatch(callsign, at);
+    const DxccPrefixTrie::Entry *entry = ( exactEntry ) ? exactEntry
+                                                        : trie->longestPrefixMatch(lookupPrefix, at);
 
     DxccEntity dxccRet;
     const DxccEntity &ad1cDXCCData = lookupDxccAD1C(callsign);
 
-    if ( queryDXCCClublog.first() )
+    if ( entry )
     {
-        dxccRet.dxcc = queryDXCCClublog.value(0).toInt();
-        dxccRet.country = queryDXCCClublog.value(1).toString();
-        dxccRet.prefix = queryDXCCClublog.value(2).toString();
-        dxccRet.cont = queryDXCCClublog.value(3).toString();
-        dxccRet.cqz = queryDXCCClublog.value(4).toInt();
-        dxccRet.ituz = queryDXCCClublog.value(5).toInt();
-        dxccRet.latlon[0] = queryDXCCClublog.value(6).toDouble();
-        dxccRet.latlon[1] = queryDXCCClublog.value(7).toDouble();
-        dxccRet.tz = queryDXCCClublog.value(8).toFloat();
-        bool isExactMatch = queryDXCCClublog.value(9).toBool();
-        dxccRet.flag = dxccFlag(dxccRet.dxcc);
-
-        if ( !isExactMatch )
+        dxccRet = trieEntity2DxccEntity(*trie, entry->dxcc);
+        dxccRet.cqz = entry->cqz;
+        dxccRet.ituz = entry->ituz;
+
+        const DxccPrefixTrie::Entry *zoneException = trie->exactMatch(callsign, at,
+                                                                      DxccPrefixTrie::ZONE_EXCEPTION_ENTRY);
+        if ( zoneException )
+        {
+            dxccRet.cqz = zoneException->cqz;
+            dxccRet.ituz = 0;
+        }
+
+        if ( !exactEntry )
         {
             // find the exceptions to the exceptions
             if (  dxccRet.prefix == "KG4" && parsedCallsign.getBase().size() != 5 )
@@ -1378,6 +1289,85 @@ DxccEntity Data::lookupDxccClublog(const QString &callsign, const QDateTime &dat
     return dxccRet;
 }
 
+void Data::preparePrefixTries()
+{
+    FCT_IDENTIFICATION;
+
+    // Tries are built lazily over the default DB connection. Workers running
+    // in other threads must not trigger the build, therefore the owner
+    // thread calls this before a worker is started.
+    (void)ad1cTrie();
+    (void)clublogTrie();
+}
+
+void Data::reloadAD1CPrefixTrie()
+{
+    FCT_IDENTIFICATION;
+
+    // build the new trie outside of the lock and swap it
+    const QSharedPointer<const DxccPrefixTrie> newTrie = DxccPrefixTrie::fromAD1CTables();
+
+    QMutexLocker locker(&prefixTrieLock);
+    ad1cPrefixTrie = newTrie;
+}
+
+void Data::reloadClublogPrefixTrie()
+{
+    FCT_IDENTIFICATION;
+
+    const QSharedPointer<const DxccPrefixTrie> newTrie = DxccPrefixTrie::fromClublogTables();
+
+    QMutexLocker locker(&prefixTrieLock);
+    clublogPrefixTrie = newTrie;
+}
+
+QSharedPointer<const DxccPrefixTrie> Data::ad1cTrie()
+{
+    QMutexLocker locker(&prefixTrieLock);
+
+    if ( !ad1cPrefixTrie )
+        ad1cPrefixTrie = DxccPrefixTrie::fromAD1CTables();
+
+    return ad1cPrefixTrie;
+}
+
+QSharedPointer<const DxccPrefixTrie> Data::clublogTrie()
+{
+    QMutexLocker locker(&prefixTrieLock);
+
+    if ( !clublogPrefixTrie )
+        clublogPrefixTrie = DxccPrefixTrie::fromClublogTables();
+
+    return clublogPrefixTrie;
+}
+
+DxccEntity Data::trieEntity2DxccEntity(const DxccPrefixTrie &trie, qint32 dxcc) const
+{
+    DxccEntity dxccRet;
+    const DxccPrefixTrie::EntityInfo *info = trie.entity(dxcc);
+
+    if ( !info )
+    {
+        dxccRet.dxcc = 0;
+        dxccRet.ituz = 0;
+        dxccRet.cqz = 0;
+        dxccRet.tz = 0;
+        return dxccRet;
+    }
+
+    dxccRet.dxcc = dxcc;
+    dxccRet.country = info->name;
+    dxccRet.prefix = info->prefix;
+    dxccRet.cont = info->cont;
+    dxccRet.cqz = info->cqz;
+    dxccRet.ituz = info->ituz;
+    dxccRet.latlon[0] = info->lat;
+    dxccRet.latlon[1] = info->lon;
+    dxccRet.tz = info->tz;
+    dxccRet.flag = dxccFlag(dxcc);
+    return dxccRet;
+}
+
 SOTAEntity Data::lookupSOTA(const QString &SOTACode)
 {
     FCT_IDENTIFICATION;
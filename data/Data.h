@@ -8,7 +8,9 @@
 #include "WWFFEntity.h"
 #include "POTAEntity.h"
 #include "core/zonedetect.h"
-#include "core/QuadKeyCache.h"
+#include "DxccPrefixTrie.h"
+#include "DxccStatusIndex.h"
+#include "DupeIndex.h"
 
 class QCompleter;
 
@@ -142,9 +144,21 @@ public:
     static qulonglong countDupe(const QString& callsign,
                                 const QString &band,
                                 const QString &mode);
+    static qulonglong countDupe(const QString& callsign,
+                                const QString &band,
+                                const QString &mode,
+                                int dupeType,
+                                const QString &contestID,
+                                const QDateTime &dupeStartTime,
+                                const QSqlDatabase &db);
 
     static QString safeQueryString(const QUrlQuery &query);
-    DxccStatus dxccStatus(int dxcc, const QString &band, const QString &mode);
+    DxccStatus dxccStatus(int dxcc, const QString &band, const QString &mode,
+                          const QSqlDatabase &db = QSqlDatabase::database());
+    DxccStatus dxccStatus(int dxcc, const QString &band, const QString &mode,
+                          int myDXCC, bool lotwConfirmed, bool paperConfirmed,
+                          bool eqslConfirmed,
+                          const QSqlDatabase &db = QSqlDatabase::database());
     QStringList contestList();
     QStringList propagationModesList() const { return QStringList{""} + propagationModes.values(); }
     QStringList propagationModesIDList() const { return QStringList{""} + propagationModes.keys(); }
@@ -156,6 +170,7 @@ public:
     DxccEntity lookupDxccIDAD1C(const int dxccID);
     DxccEntity lookupDxccClublog(const QString &callsign, const QDateTime &date = QDateTime::currentDateTimeUtc());
     DxccEntity lookupDxccIDClublog(const int dxccID);
+    void preparePrefixTries();
     SOTAEntity lookupSOTA(const QString &SOTACode);
     POTAEntity lookupPOTA(const QString &POTACode);
     WWFFEntity lookupWWFF(const QString &reference);
@@ -180,9 +195,16 @@ public:
 signals:
 
 public slots:
-    void invalidateDXCCStatusCache(const QSqlRecord &record);
-    void invalidateSetOfDXCCStatusCache(const QSet<uint> &entities);
-    void clearDXCCStatusCache();
+    void addContactToDXCCStatusIndex(const QSqlRecord &record);
+    void refreshDXCCStatusIndex(const QSet<uint> &entities);
+    void prepareDXCCStatusIndexUpdate(const QSqlRecord &record);
+    void reloadDXCCStatusIndex();
+    void addContactToDupeIndex(const QSqlRecord &record);
+    void removeContactFromDupeIndex(const QSqlRecord &record);
+    void prepareDupeIndexUpdate(const QSqlRecord &record);
+    void invalidateDupeIndex();
+    void reloadAD1CPrefixTrie();
+    void reloadClublogPrefixTrie();
 
 private:
     void loadContests();
@@ -195,6 +217,14 @@ private:
     void loadWWFF();
     void loadPOTA();
     void loadTZ();
+    QSharedPointer<const DxccPrefixTrie> ad1cTrie();
+    QSharedPointer<const DxccPrefixTrie> clublogTrie();
+    DxccEntity trieEntity2DxccEntity(const DxccPrefixTrie &trie, qint32 dxcc) const;
+    static QString dxccStatusIndexStatement(const QString &whereClause);
+    void addContactsToDXCCStatusIndex(QSqlQuery &query);
+    static QString dxccModeGroup(const QString &mode,
+                                 const QSqlDatabase &db = QSqlDatabase::database());
+    bool loadDupeIndex(const QString &contestID, const QSqlDatabase &db);
 
     QHash<int, QVariantMap> dxccEntityStaticInfo;
     QMap<QString, QString> contests;
@@ -206,21 +236,21 @@ private:
     QMap<QString, QString> wwffRefID;
     QMap<QString, QString> potaRefID;
     ZoneDetect * zd;
-    QSqlQuery queryDXCC;
-    QSqlQuery queryDXCCIDAD1C;
-    QSqlQuery queryDXCCIDClublog;
-    QSqlQuery queryDXCCClublog;
+    QSharedPointer<const DxccPrefixTrie> ad1cPrefixTrie;
+    QSharedPointer<const DxccPrefixTrie> clublogPrefixTrie;
+    QMutex prefixTrieLock;
     QSqlQuery querySOTA;
     QSqlQuery queryWWFF;
     QSqlQuery queryPOTA;
-    bool isDXCCQueryValid;
-    bool isDXCCClublogQueryValid;
     bool isSOTAQueryValid;
     bool isWWFFQueryValid;
     bool isPOTAQueryValid;
-    bool isDXCCIDAD1CQueryValid;
-    bool isDXCCIDClublogQueryValid;
-    QuadKeyCache<DxccStatus> dxccStatusCache;
+    DxccStatusIndex dxccStatusIndex;
+    QMutex dxccStatusIndexLock;
+    QSet<uint> pendingDXCCStatusIndexRefresh;
+    DupeIndex dupeIndex;
+    QString dupeIndexContestID;
+    QMutex dupeIndexLock;
 
     static const char translitTab[];
     static const int tranlitIndexMap[];
@@ -0,0 +1,104 @@
+#include "DupeIndex.h"
+#include "core/debug.h"
+
+MODULE_IDENTIFICATION("qlog.data.dupeindex");
+
+DupeIndex::DupeIndex() :
+    contactCount(0)
+{
+    FCT_IDENTIFICATION;
+}
+
+void DupeIndex::addContact(const QString &callsign,
+                           const QString &band,
+                           const QString &modeGroup,
+                           const QDateTime &startTime)
+{
+    contacts[callsign].append(Entry{band, modeGroup, toUTCSecs(startTime)});
+    contactCount++;
+}
+
+void DupeIndex::removeContact(const QString &callsign,
+                              const QString &band,
+                              const QString &modeGroup,
+                              const QDateTime &startTime)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << callsign << band << modeGroup << startTime;
+
+    auto it = contacts.find(callsign);
+
+    if ( it == contacts.end() )
+        return;
+
+    QVector<Entry> &entries = it.value();
+    const qint64 time = toUTCSecs(startTime);
+
+    for ( int i = 0; i < entries.size(); ++i )
+    {
+        const Entry &entry = entries.at(i);
+
+        if ( entry.startTime == time
+             && entry.band == band
+             && entry.modeGroup == modeGroup )
+        {
+            entries.remove(i);
+            contactCount--;
+            break;
+        }
+    }
+
+    if ( entries.isEmpty() )
+        contacts.erase(it);
+}
+
+void DupeIndex::clear()
+{
+    FCT_IDENTIFICATION;
+
+    contacts.clear();
+    contactCount = 0;
+}
+
+qulonglong DupeIndex::count(const QString &callsign,
+                            const QString &band,
+                            const QString &modeGroup,
+                            const QDateTime &dupeStartTime,
+                            bool checkBand,
+                            bool checkMode) const
+{
+    const auto it = contacts.constFind(callsign);
+
+    if ( it == contacts.constEnd() )
+        return 0ULL;
+
+    const qint64 startTime = toUTCSecs(dupeStartTime);
+    qulonglong ret = 0ULL;
+
+    for ( const Entry &entry : it.value() )
+    {
+        if ( entry.startTime < startTime )
+            continue;
+
+        if ( checkBand && entry.band != band )
+            continue;
+
+        if ( checkMode && entry.modeGroup != modeGroup )
+            continue;
+
+        ret++;
+    }
+
+    return ret;
+}
+
+qint64 DupeIndex::toUTCSecs(const QDateTime &dateTime)
+{
+    QDateTime time(dateTime);
+
+    if ( time.timeSpec() == Qt::LocalTime )
+        time.setTimeSpec(Qt::UTC);
+
+    return time.toSecsSinceEpoch();
+}
@@ -0,0 +1,52 @@
+#ifndef QLOG_DATA_DUPEINDEX_H
+#define QLOG_DATA_DUPEINDEX_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QDateTime>
+
+// In-memory index of the contest contacts used for the dupe check.
+// It contains contacts of one contest only; the owner is responsible for
+// reloading it when the contest changes.
+// The object is not thread-safe; the owner has to serialize access.
+class DupeIndex
+{
+public:
+    DupeIndex();
+
+    void addContact(const QString &callsign,
+                    const QString &band,
+                    const QString &modeGroup,
+                    const QDateTime &startTime);
+    void removeContact(const QString &callsign,
+                       const QString &band,
+                       const QString &modeGroup,
+                       const QDateTime &startTime);
+    void clear();
+
+    qulonglong count(const QString &callsign,
+                     const QString &band,
+                     const QString &modeGroup,
+                     const QDateTime &dupeStartTime,
+                     bool checkBand,
+                     bool checkMode) const;
+
+    int size() const { return contactCount; }
+
+    // QSO times without an explicit time zone are in UTC
+    static qint64 toUTCSecs(const QDateTime &dateTime);
+
+private:
+    struct Entry
+    {
+        QString band;
+        QString modeGroup;
+        qint64 startTime;
+    };
+
+    QHash<QString, QVector<Entry>> contacts;
+    int contactCount;
+};
+
+#endif // QLOG_DATA_DUPEINDEX_H
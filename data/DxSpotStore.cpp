@@ -0,0 +1,133 @@
+#include <algorithm>
+
+#include "DxSpotStore.h"
+#include "rig/macros.h"
+#include "core/debug.h"
+
+MODULE_IDENTIFICATION("qlog.data.dxspotstore");
+
+const int DxSpotStore::DEFAULT_CAPACITY;
+
+DxSpotStore::DxSpotStore(int capacity) :
+    maxCount(qMax(capacity, 1)),
+    head(0),
+    count(0)
+{
+    FCT_IDENTIFICATION;
+}
+
+const DxSpot &DxSpotStore::at(int row) const
+{
+    return buffer.at(position(row));
+}
+
+void DxSpotStore::append(const DxSpot &spot)
+{
+    if ( count < buffer.size() )
+    {
+        // a free slot after the newest spot
+        buffer[(head + count) % buffer.size()] = spot;
+        count++;
+    }
+    else if ( count < maxCount )
+    {
+        // the buffer grows up to its capacity
+        if ( head != 0 )
+        {
+            std::rotate(buffer.begin(), buffer.begin() + head, buffer.end());
+            head = 0;
+        }
+        buffer.append(spot);
+        count++;
+    }
+    else
+    {
+        // full - the oldest spot is overwritten
+        removeFromIndex(buffer.at(head));
+        buffer[head] = spot;
+        head = (head + 1) % buffer.size();
+    }
+
+    callsignIndex[spot.callsign].append(IndexEntry{spot.dateTime.toMSecsSinceEpoch(), spot.freq});
+}
+
+void DxSpotStore::removeOldest(int removeCount)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << removeCount;
+
+    removeCount = qMin(removeCount, count);
+
+    for ( int i = 0; i < removeCount; i++ )
+    {
+        removeFromIndex(buffer.at(head));
+        buffer[head] = DxSpot();
+        head = (head + 1) % buffer.size();
+        count--;
+    }
+
+    if ( count == 0 )
+        head = 0;
+}
+
+void DxSpotStore::clear()
+{
+    FCT_IDENTIFICATION;
+
+    buffer.clear();
+    callsignIndex.clear();
+    head = 0;
+    count = 0;
+}
+
+bool DxSpotStore::isDuplicate(const DxSpot &spot,
+                              qint16 interval,
+                              double freqTolerance) const
+{
+    const auto it = callsignIndex.constFind(spot.callsign);
+
+    if ( it == callsignIndex.constEnd() )
+        return false;
+
+    const qint64 time = spot.dateTime.toMSecsSinceEpoch();
+    const QVector<IndexEntry> &entries = it.value();
+
+    // the newest first; spots are stored in the order of reception
+    for ( int i = entries.size() - 1; i >= 0; --i )
+    {
+        const IndexEntry &entry = entries.at(i);
+
+        // the same as QDateTime::secsTo
+        if ( (time - entry.timeMSecs) / 1000 > interval )
+            break;
+
+        if ( qAbs(MHz(entry.freq) - MHz(spot.freq)) < kHz(freqTolerance) )
+        {
+            qCDebug(runtime) << "Duplicate spot" << spot.callsign << entry.freq << spot.freq;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int DxSpotStore::position(int row) const
+{
+    return (head + count - 1 - row) % buffer.size();
+}
+
+void DxSpotStore::removeFromIndex(const DxSpot &spot)
+{
+    auto it = callsignIndex.find(spot.callsign);
+
+    if ( it == callsignIndex.end() )
+        return;
+
+    // the removed spot is the oldest one therefore it is the oldest one of its callsign
+    if ( !it.value().isEmpty() )
+        it.value().removeFirst();
+
+    if ( it.value().isEmpty() )
+        callsignIndex.erase(it);
+}
@@ -0,0 +1,61 @@
+#ifndef QLOG_DATA_DXSPOTSTORE_H
+#define QLOG_DATA_DXSPOTSTORE_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+
+#include "data/DxSpot.h"
+
+// Bounded store of received DX Spots. Spots are kept in a ring buffer;
+// when the buffer is full, the oldest spots are overwritten.
+// Row 0 is the newest spot.
+// The store also indexes the spots by callsign therefore the duplicate
+// check compares only the spots of the same callsign instead of walking
+// the whole spot list.
+// The object is not thread-safe; the owner has to serialize access.
+class DxSpotStore
+{
+public:
+    static const int DEFAULT_CAPACITY = 10000;
+
+    explicit DxSpotStore(int capacity = DEFAULT_CAPACITY);
+
+    int size() const { return count; }
+    int capacity() const { return maxCount; }
+    bool isEmpty() const { return count == 0; }
+
+    // row 0 is the newest spot
+    const DxSpot &at(int row) const;
+
+    // the spot becomes row 0; the oldest spot is dropped if the store is full
+    void append(const DxSpot &spot);
+    void removeOldest(int removeCount);
+    void clear();
+
+    // returns true if the store contains a spot of the same callsign received
+    // less than interval seconds before the spot and within the frequency tolerance
+    bool isDuplicate(const DxSpot &spot,
+                     qint16 interval,
+                     double freqTolerance) const;
+
+private:
+    struct IndexEntry
+    {
+        qint64 timeMSecs;
+        double freq;
+    };
+
+    int position(int row) const;
+    void removeFromIndex(const DxSpot &spot);
+
+    QVector<DxSpot> buffer;
+    int maxCount;
+    int head;           // position of the oldest spot
+    int count;
+
+    // callsign -> stored spots, the oldest first
+    QHash<QString, QVector<IndexEntry>> callsignIndex;
+};
+
+#endif // QLOG_DATA_DXSPOTSTORE_H
@@ -0,0 +1,368 @@
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QDateTime>
+#include <QPair>
+
+#include "DxccPrefixTrie.h"
+#include "core/debug.h"
+
+MODULE_IDENTIFICATION("qlog.data.dxccprefixtrie");
+
+constexpr qint64 DxccPrefixTrie::UNBOUNDED_FROM;
+constexpr qint64 DxccPrefixTrie::UNBOUNDED_TO;
+
+DxccPrefixTrie::DxccPrefixTrie()
+{
+    FCT_IDENTIFICATION;
+}
+
+QSharedPointer<const DxccPrefixTrie> DxccPrefixTrie::fromAD1CTables()
+{
+    FCT_IDENTIFICATION;
+
+    QSharedPointer<DxccPrefixTrie> trie(new DxccPrefixTrie());
+
+    QSqlQuery entityQuery;
+
+    if ( ! entityQuery.exec("SELECT id, name, prefix, cont, cqz, ituz, lat, lon, tz "
+                            "FROM dxcc_entities_ad1c") )
+    {
+        qWarning() << "Cannot execute Select statement" << entityQuery.lastError();
+        return trie;
+    }
+
+    while ( entityQuery.next() )
+    {
+        EntityInfo info;
+        info.name = entityQuery.value(1).toString();
+        info.prefix = entityQuery.value(2).toString();
+        info.cont = entityQuery.value(3).toString();
+        info.cqz = entityQuery.value(4).toInt();
+        info.ituz = entityQuery.value(5).toInt();
+        info.lat = entityQuery.value(6).toDouble();
+        info.lon = entityQuery.value(7).toDouble();
+        info.tz = entityQuery.value(8).toFloat();
+        trie->addEntity(entityQuery.value(0).toInt(), info);
+    }
+
+    QSqlQuery prefixQuery;
+
+    if ( ! prefixQuery.exec("SELECT p.prefix, p.exact, p.dxcc, "
+                            "       CASE WHEN (p.cqz != 0) THEN p.cqz ELSE e.cqz END, "
+                            "       CASE WHEN (p.ituz != 0) THEN p.ituz ELSE e.ituz END "
+                            "FROM dxcc_prefixes_ad1c p "
+                            "INNER JOIN dxcc_entities_ad1c e ON (p.dxcc = e.id)") )
+    {
+        qWarning() << "Cannot execute Select statement" << prefixQuery.lastError();
+        return trie;
+    }
+
+    while ( prefixQuery.next() )
+    {
+        Entry entry;
+        entry.validFrom = UNBOUNDED_FROM;
+        entry.validTo = UNBOUNDED_TO;
+        entry.dxcc = prefixQuery.value(2).toInt();
+        entry.cqz = prefixQuery.value(3).toInt();
+        entry.ituz = prefixQuery.value(4).toInt();
+        entry.type = ( prefixQuery.value(1).toBool() ) ? EXACT_ENTRY : PREFIX_ENTRY;
+        trie->addEntry(prefixQuery.value(0).toString(), entry);
+    }
+
+    trie->compile();
+
+    qCDebug(runtime) << "AD1C trie compiled; nodes:" << trie->nodeCount();
+
+    return trie;
+}
+
+QSharedPointer<const DxccPrefixTrie> DxccPrefixTrie::fromClublogTables()
+{
+    FCT_IDENTIFICATION;
+
+    QSharedPointer<DxccPrefixTrie> trie(new DxccPrefixTrie());
+
+    QSqlQuery entityQuery;
+
+    if ( ! entityQuery.exec("SELECT id, name, prefix, cont, cqz, ituz, lat, lon "
+                            "FROM dxcc_entities_clublog") )
+    {
+        qWarning() << "Cannot execute Select statement" << entityQuery.lastError();
+        return trie;
+    }
+
+    while ( entityQuery.next() )
+    {
+        EntityInfo info;
+        info.name = entityQuery.value(1).toString();
+        info.prefix = entityQuery.value(2).toString();
+        info.cont = entityQuery.value(3).toString();
+        info.cqz = entityQuery.value(4).toInt();
+        info.ituz = entityQuery.value(5).toInt();
+        info.lat = entityQuery.value(6).toDouble();
+        info.lon = entityQuery.value(7).toDouble();
+        trie->addEntity(entityQuery.value(0).toInt(), info);
+    }
+
+    QSqlQuery prefixQuery;
+
+    if ( ! prefixQuery.exec("SELECT p.prefix, p.exact, p.dxcc, "
+                            "       CASE WHEN (p.cqz != 0) THEN p.cqz ELSE e.cqz END, "
+                            "       CASE WHEN (p.ituz != 0) THEN p.ituz ELSE e.ituz END, "
+                            "       p.start, p.\"end\" "
+                            "FROM dxcc_prefixes_clublog p "
+                            "INNER JOIN dxcc_entities_clublog e ON (p.dxcc = e.id)") )
+    {
+        qWarning() << "Cannot execute Select statement" << prefixQuery.lastError();
+        return trie;
+    }
+
+    while ( prefixQuery.next() )
+    {
+        Entry entry;
+        entry.validFrom = parseTime(prefixQuery.value(5).toString(), UNBOUNDED_FROM);
+        entry.validTo = parseTime(prefixQuery.value(6).toString(), UNBOUNDED_TO);
+        entry.dxcc = prefixQuery.value(2).toInt();
+        entry.cqz = prefixQuery.value(3).toInt();
+        entry.ituz = prefixQuery.value(4).toInt();
+        entry.type = ( prefixQuery.value(1).toBool() ) ? EXACT_ENTRY : PREFIX_ENTRY;
+        trie->addEntry(prefixQuery.value(0).toString(), entry);
+    }
+
+    QSqlQuery zoneQuery;
+
+    if ( ! zoneQuery.exec("SELECT call, cqz, start, \"end\" FROM dxcc_zone_exceptions_clublog") )
+    {
+        qWarning() << "Cannot execute Select statement" << zoneQuery.lastError();
+        return trie;
+    }
+
+    while ( zoneQuery.next() )
+    {
+        Entry entry;
+        entry.validFrom = parseTime(zoneQuery.value(2).toString(), UNBOUNDED_FROM);
+        entry.validTo = parseTime(zoneQuery.value(3).toString(), UNBOUNDED_TO);
+        entry.dxcc = 0;
+        entry.cqz = zoneQuery.value(1).toInt();
+        entry.ituz = 0;
+        entry.type = ZONE_EXCEPTION_ENTRY;
+        trie->addEntry(zoneQuery.value(0).toString(), entry);
+    }
+
+    trie->compile();
+
+    qCDebug(runtime) << "Clublog trie compiled; nodes:" << trie->nodeCount();
+
+    return trie;
+}
+
+void DxccPrefixTrie::addEntity(qint32 dxcc, const EntityInfo &info)
+{
+    FCT_IDENTIFICATION;
+
+    entities.insert(dxcc, info);
+}
+
+void DxccPrefixTrie::addEntry(const QString &key, const Entry &entry)
+{
+    FCT_IDENTIFICATION;
+
+    if ( key.isEmpty() )
+        return;
+
+    pendingEntries[key].append(entry);
+}
+
+void DxccPrefixTrie::compile()
+{
+    FCT_IDENTIFICATION;
+
+    struct BuildNode
+    {
+        QVector<QPair<char, qint32>> children;
+        QVector<Entry> entries;
+    };
+
+    QVector<BuildNode> buildNodes(1); // root
+
+    for ( auto it = pendingEntries.cbegin(); it != pendingEntries.cend(); ++it )
+    {
+        qint32 current = 0;
+        bool isValidKey = true;
+
+        for ( const QChar &c : it.key() )
+        {
+            const char symbol = normalizeSymbol(c);
+
+            if ( symbol == 0 )
+            {
+                isValidKey = false;
+                break;
+            }
+
+            qint32 next = -1;
+            const QVector<QPair<char, qint32>> &children = buildNodes.at(current).children;
+
+            for ( const QPair<char, qint32> &edge : children )
+            {
+                if ( edge.first == symbol )
+                {
+                    next = edge.second;
+                    break;
+                }
+            }
+
+            if ( next < 0 )
+            {
+                next = buildNodes.size();
+                buildNodes[current].children.append(qMakePair(symbol, next));
+                buildNodes.append(BuildNode());
+            }
+            current = next;
+        }
+
+        if ( !isValidKey )
+        {
+            qCDebug(runtime) << "Skipping unsupported prefix" << it.key();
+            continue;
+        }
+
+        buildNodes[current].entries += it.value();
+    }
+
+    // flatten the tree - edges and entries of one node are stored continuously
+    nodes.resize(buildNodes.size());
+    edges.clear();
+    entries.clear();
+
+    for ( int i = 0; i < buildNodes.size(); ++i )
+    {
+        const BuildNode &buildNode = buildNodes.at(i);
+        Node &node = nodes[i];
+
+        node.firstEdge = edges.size();
+        node.edgeCount = static_cast<quint16>(buildNode.children.size());
+
+        for ( const QPair<char, qint32> &edge : buildNode.children )
+            edges.append(Edge{edge.second, edge.first});
+
+        node.firstEntry = entries.size();
+        node.entryCount = static_cast<quint16>(qMin(buildNode.entries.size(), 0xFFFF));
+        entries += buildNode.entries.mid(0, node.entryCount);
+    }
+
+    nodes.squeeze();
+    edges.squeeze();
+    entries.squeeze();
+    pendingEntries.clear();
+}
+
+const DxccPrefixTrie::Entry *DxccPrefixTrie::exactMatch(const QString &callsign,
+                                                        qint64 at,
+                                                        EntryType type) const
+{
+    if ( nodes.isEmpty() || callsign.isEmpty() )
+        return nullptr;
+
+    qint32 current = 0;
+
+    for ( const QChar &c : callsign )
+    {
+        current = child(nodes.at(current), normalizeSymbol(c));
+
+        if ( current < 0 )
+            return nullptr;
+    }
+
+    return findEntry(nodes.at(current), at, type);
+}
+
+const DxccPrefixTrie::Entry *DxccPrefixTrie::longestPrefixMatch(const QString &callsign,
+                                                                qint64 at) const
+{
+    if ( nodes.isEmpty() )
+        return nullptr;
+
+    const Entry *ret = nullptr;
+    qint32 current = 0;
+
+    for ( const QChar &c : callsign )
+    {
+        current = child(nodes.at(current), normalizeSymbol(c));
+
+        if ( current < 0 )
+            break;
+
+        const Entry *entry = findEntry(nodes.at(current), at, PREFIX_ENTRY);
+
+        if ( entry )
+            ret = entry;
+    }
+
+    return ret;
+}
+
+const DxccPrefixTrie::EntityInfo *DxccPrefixTrie::entity(qint32 dxcc) const
+{
+    auto it = entities.constFind(dxcc);
+    return ( it != entities.constEnd() ) ? &it.value() : nullptr;
+}
+
+qint32 DxccPrefixTrie::child(const Node &node, char symbol) const
+{
+    const Edge *edge = edges.constData() + node.firstEdge;
+    const Edge *end = edge + node.edgeCount;
+
+    for ( ; edge != end; ++edge )
+    {
+        if ( edge->symbol == symbol )
+            return edge->child;
+    }
+
+    return -1;
+}
+
+const DxccPrefixTrie::Entry *DxccPrefixTrie::findEntry(const Node &node,
+                                                       qint64 at,
+                                                       EntryType type) const
+{
+    const Entry *entry = entries.constData() + node.firstEntry;
+    const Entry *end = entry + node.entryCount;
+
+    for ( ; entry != end; ++entry )
+    {
+        if ( entry->type == type && entry->isValidAt(at) )
+            return entry;
+    }
+
+    return nullptr;
+}
+
+char DxccPrefixTrie::normalizeSymbol(const QChar &c)
+{
+    const ushort u = c.unicode();
+
+    if ( (u >= 'A' && u <= 'Z') || (u >= '0' && u <= '9') || u == '/' )
+        return static_cast<char>(u);
+
+    if ( u >= 'a' && u <= 'z' )
+        return static_cast<char>(u - ('a' - 'A'));
+
+    return 0;
+}
+
+qint64 DxccPrefixTrie::parseTime(const QString &value, qint64 defaultValue)
+{
+    if ( value.isEmpty() )
+        return defaultValue;
+
+    QDateTime time = QDateTime::fromString(value, Qt::ISODate);
+
+    if ( !time.isValid() )
+        return defaultValue;
+
+    if ( time.timeSpec() == Qt::LocalTime )
+        time.setTimeSpec(Qt::UTC);
+
+    return time.toMSecsSinceEpoch();
+}
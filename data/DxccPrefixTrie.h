@@ -0,0 +1,96 @@
+#ifndef QLOG_DATA_DXCCPREFIXTRIE_H
+#define QLOG_DATA_DXCCPREFIXTRIE_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QMap>
+#include <QSharedPointer>
+#include <limits>
+
+// Immutable longest-prefix-match trie compiled from the DXCC prefix tables
+// (AD1C or Clublog). After compile() the object is only read, therefore
+// one instance can be safely shared between threads.
+class DxccPrefixTrie
+{
+public:
+    enum EntryType
+    {
+        PREFIX_ENTRY = 0,
+        EXACT_ENTRY = 1,
+        ZONE_EXCEPTION_ENTRY = 2
+    };
+
+    static constexpr qint64 UNBOUNDED_FROM = std::numeric_limits<qint64>::min();
+    static constexpr qint64 UNBOUNDED_TO = std::numeric_limits<qint64>::max();
+
+    struct Entry
+    {
+        qint64 validFrom;  // msecs since epoch (UTC)
+        qint64 validTo;    // msecs since epoch (UTC)
+        qint32 dxcc;
+        qint32 cqz;        // already resolved against the entity
+        qint32 ituz;       // already resolved against the entity
+        quint8 type;
+
+        bool isValidAt(qint64 at) const { return validFrom <= at && at <= validTo; }
+    };
+
+    struct EntityInfo
+    {
+        QString name;
+        QString prefix;
+        QString cont;
+        qint32 cqz = 0;
+        qint32 ituz = 0;
+        double lat = 0.0;
+        double lon = 0.0;
+        float tz = 0.0;
+    };
+
+    static QSharedPointer<const DxccPrefixTrie> fromAD1CTables();
+    static QSharedPointer<const DxccPrefixTrie> fromClublogTables();
+
+    DxccPrefixTrie();
+
+    // building phase
+    void addEntity(qint32 dxcc, const EntityInfo &info);
+    void addEntry(const QString &key, const Entry &entry);
+    void compile();
+
+    // lookup phase
+    const Entry *exactMatch(const QString &callsign, qint64 at,
+                            EntryType type = EXACT_ENTRY) const;
+    const Entry *longestPrefixMatch(const QString &callsign, qint64 at) const;
+    const EntityInfo *entity(qint32 dxcc) const;
+    bool isEmpty() const { return entries.isEmpty(); }
+    int nodeCount() const { return nodes.size(); }
+
+private:
+    struct Node
+    {
+        qint32 firstEdge = 0;
+        qint32 firstEntry = 0;
+        quint16 edgeCount = 0;
+        quint16 entryCount = 0;
+    };
+
+    struct Edge
+    {
+        qint32 child;
+        char symbol;
+    };
+
+    qint32 child(const Node &node, char symbol) const;
+    const Entry *findEntry(const Node &node, qint64 at, EntryType type) const;
+    static char normalizeSymbol(const QChar &c);
+    static qint64 parseTime(const QString &value, qint64 defaultValue);
+
+    QVector<Node> nodes;
+    QVector<Edge> edges;
+    QVector<Entry> entries;
+    QHash<qint32, EntityInfo> entities;
+    QMap<QString, QVector<Entry>> pendingEntries;
+};
+
+#endif // QLOG_DATA_DXCCPREFIXTRIE_H
@@ -0,0 +1,152 @@
+#include "DxccStatusIndex.h"
+#include "core/debug.h"
+
+MODULE_IDENTIFICATION("qlog.data.dxccstatusindex");
+
+DxccStatusIndex::DxccStatusIndex()
+{
+    FCT_IDENTIFICATION;
+}
+
+void DxccStatusIndex::addContact(qint32 dxcc,
+                                 qint32 myDXCC,
+                                 const QString &band,
+                                 const QString &modeGroup,
+                                 bool paperConfirmed,
+                                 bool lotwConfirmed,
+                                 bool eqslConfirmed)
+{
+    int bandIndex = bandIndexes.value(band, -1);
+
+    if ( bandIndex < 0 )
+    {
+        if ( bandIndexes.size() < MAX_BANDS )
+        {
+            bandIndex = bandIndexes.size();
+            bandIndexes.insert(band, bandIndex);
+        }
+        else
+            qWarning() << "DXCC Status Index: too many bands; band is not indexed" << band;
+    }
+
+    EntityBits &entityBits = entities[dxcc][myDXCC];
+
+    // contacts with an unknown mode make the entity and the band worked
+    // but they do not belong to any mode group - the same as INNER JOIN modes
+    if ( modeGroup.isEmpty() || bandIndex < 0 )
+    {
+        if ( entityBits.isEmpty() )
+            entityBits.resize(1);
+
+        if ( bandIndex >= 0 )
+            entityBits[0].worked |= (Q_UINT64_C(1) << bandIndex);
+        return;
+    }
+
+    // index 0 is reserved for contacts without a mode group
+    int groupIndex = modeGroupIndexes.value(modeGroup, -1);
+
+    if ( groupIndex < 0 )
+    {
+        groupIndex = modeGroupIndexes.size() + 1;
+        modeGroupIndexes.insert(modeGroup, groupIndex);
+    }
+
+    if ( entityBits.size() <= groupIndex )
+        entityBits.resize(groupIndex + 1);
+
+    const quint64 bit = Q_UINT64_C(1) << bandIndex;
+    SlotBits &slot = entityBits[groupIndex];
+
+    slot.worked |= bit;
+    if ( paperConfirmed ) slot.paper |= bit;
+    if ( lotwConfirmed ) slot.lotw |= bit;
+    if ( eqslConfirmed ) slot.eqsl |= bit;
+}
+
+void DxccStatusIndex::removeEntity(qint32 dxcc)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << dxcc;
+
+    entities.remove(dxcc);
+}
+
+void DxccStatusIndex::clear()
+{
+    FCT_IDENTIFICATION;
+
+    entities.clear();
+    bandIndexes.clear();
+    modeGroupIndexes.clear();
+}
+
+DxccStatus DxccStatusIndex::status(qint32 dxcc,
+                                   qint32 myDXCC,
+                                   const QString &band,
+                                   const QString &modeGroup,
+                                   bool lotwConfirmed,
+                                   bool paperConfirmed,
+                                   bool eqslConfirmed) const
+{
+    const auto entityIt = entities.constFind(dxcc);
+
+    if ( entityIt == entities.constEnd() )
+        return DxccStatus::NewEntity;
+
+    const quint64 mask = bandMask(band);
+    const int groupIndex = modeGroupIndex(modeGroup);
+    bool entityWorked = false;
+    quint64 workedBands = 0;
+    SlotBits modeSlot;
+
+    // myDXCC == 0 - all records for the entity are merged
+    for ( auto it = entityIt.value().constBegin(); it != entityIt.value().constEnd(); ++it )
+    {
+        if ( myDXCC != 0 && it.key() != myDXCC )
+            continue;
+
+        const EntityBits &entityBits = it.value();
+
+        entityWorked = true;
+
+        for ( const SlotBits &slot : entityBits )
+            workedBands |= slot.worked;
+
+        if ( groupIndex > 0 && groupIndex < entityBits.size() )
+            modeSlot |= entityBits.at(groupIndex);
+    }
+
+    if ( !entityWorked )
+        return DxccStatus::NewEntity;
+
+    if ( !(workedBands & mask) )
+        return ( modeSlot.worked ) ? DxccStatus::NewBand : DxccStatus::NewBandMode;
+
+    if ( !modeSlot.worked )
+        return DxccStatus::NewMode;
+
+    if ( !(modeSlot.worked & mask) )
+        return DxccStatus::NewSlot;
+
+    quint64 confirmed = 0;
+
+    if ( lotwConfirmed ) confirmed |= modeSlot.lotw;
+    if ( paperConfirmed ) confirmed |= modeSlot.paper;
+    if ( eqslConfirmed ) confirmed |= modeSlot.eqsl;
+
+    return ( confirmed & mask ) ? DxccStatus::Confirmed : DxccStatus::Worked;
+}
+
+quint64 DxccStatusIndex::bandMask(const QString &band) const
+{
+    const int bandIndex = bandIndexes.value(band, -1);
+
+    return ( bandIndex < 0 ) ? 0 : (Q_UINT64_C(1) << bandIndex);
+}
+
+int DxccStatusIndex::modeGroupIndex(const QString &modeGroup) const
+{
+    return ( modeGroup.isEmpty() ) ? -1 : modeGroupIndexes.value(modeGroup, -1);
+}
@@ -0,0 +1,72 @@
+#ifndef QLOG_DATA_DXCCSTATUSINDEX_H
+#define QLOG_DATA_DXCCSTATUSINDEX_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+
+#include "Dxcc.h"
+
+// In-memory index of worked/confirmed DXCC slots. For every pair
+// (entity, my_dxcc) it stores one band bitmap per DXCC mode group
+// (CW, PHONE, DIGITAL ...) for worked QSOs and for each confirmation source.
+// The object is not thread-safe; the owner has to serialize access.
+class DxccStatusIndex
+{
+public:
+    // maximum number of distinct bands which can be indexed
+    static const int MAX_BANDS = 64;
+
+    DxccStatusIndex();
+
+    void addContact(qint32 dxcc,
+                    qint32 myDXCC,
+                    const QString &band,
+                    const QString &modeGroup,
+                    bool paperConfirmed,
+                    bool lotwConfirmed,
+                    bool eqslConfirmed);
+    void removeEntity(qint32 dxcc);
+    void clear();
+
+    // myDXCC == 0 means all my DXCC entities
+    DxccStatus status(qint32 dxcc,
+                      qint32 myDXCC,
+                      const QString &band,
+                      const QString &modeGroup,
+                      bool lotwConfirmed,
+                      bool paperConfirmed,
+                      bool eqslConfirmed) const;
+
+    int entityCount() const { return entities.size(); }
+
+private:
+    struct SlotBits
+    {
+        quint64 worked = 0;
+        quint64 paper = 0;
+        quint64 lotw = 0;
+        quint64 eqsl = 0;
+
+        SlotBits &operator|=(const SlotBits &other)
+        {
+            worked |= other.worked;
+            paper |= other.paper;
+            lotw |= other.lotw;
+            eqsl |= other.eqsl;
+            return *this;
+        }
+    };
+
+    // indexed by mode group index
+    typedef QVector<SlotBits> EntityBits;
+
+    quint64 bandMask(const QString &band) const;
+    int modeGroupIndex(const QString &modeGroup) const;
+
+    QHash<QString, int> bandIndexes;
+    QHash<QString, int> modeGroupIndexes;
+    QHash<qint32, QHash<qint32, EntityBits>> entities; // dxcc -> my_dxcc -> bits
+};
+
+#endif // QLOG_DATA_DXCCSTATUSINDEX_H
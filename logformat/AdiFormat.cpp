@@ -125,125 +125,6 @@ void AdiFormat::writeSQLRecord(const QSqlRecord &record,
     }
 }
 
-void AdiFormat::readField(QString& field, QString& value)
-{
-    FCT_IDENTIFICATION;
-
-    //qCDebug(function_parameters)<<field<< " " << value;
-
-    char c;
-
-    QString typeString;
-    QString lengthString;
-    int length = 0;
-
-    while (!stream.atEnd()) {
-        switch (state) {
-        case START:
-            stream >> c;
-            if (c == '<') {
-                inHeader = false;
-                state = KEY;
-                field = "";
-            }
-            else {
-                inHeader = true;
-                state = FIELD;
-            }
-            break;
-
-        case FIELD:
-            stream >> c;
-            if (c == '<') {
-                state = KEY;
-                field = "";
-            }
-            break;
-
-        case KEY:
-            stream >> c;
-            if (c == ':') {
-                state = SIZE;
-                lengthString = "";
-            }
-            else if (c == '>') {
-                state = FIELD;
-                if (inHeader && field.toLower() == "eoh") {
-                    inHeader = false;
-                }
-                else {
-                    value = "";
-                    return;
-                }
-            }
-            else {
-                field.append(c);
-            }
-            break;
-
-        case SIZE:
-            stream >> c;
-            if (c == ':') {
-                 if (!lengthString.isEmpty()) {
-                    length = lengthString.toInt();
-                 }
-                 state = DATA_TYPE;
-                 typeString = "";
-            }
-            else if (c == '>') {
-                if (!lengthString.isEmpty()) {
-                    length = lengthString.toInt();
-                }
-
-                if (length > 0) {
-                    state = VALUE;
-                    value = "";
-                }
-                else {
-                    state = FIELD;
-                    if (!inHeader) {
-                        value = "";
-                        return;
-                    }
-
-                }
-            }
-            else {
-                lengthString.append(c);
-            }
-            break;
-
-        case DATA_TYPE:
-            stream >> c;
-            if (c == '>') {
-                if (length > 0) {
-                    state = VALUE;
-                    value = "";
-                }
-                else {
-                    state = FIELD;
-                    if (!inHeader) {
-                        value = "";
-                        return;
-                    }
-                }
-            }
-            else {
-                typeString.append(c);
-            }
-            break;
-
-        case VALUE:
-            value = QString(stream.read(length));
-            state = FIELD;
-            if (!inHeader) {
-                return;
-            }
-            break;
-        }
-    }
-}
-
 void AdiFormat::mapContact2SQLRecord(QMap<QString, QVariant> &contact,
                                      QSqlRecord &record)
 {
@@ -649,28 +530,101 @@ bool AdiFormat::readContact(QMap<QString, QVariant>& contact)
 {
     FCT_IDENTIFICATION;
 
-    while (!stream.atEnd())
-    {
-        QString field;
-        QString value;
+    if ( !isTokenizerReady )
+        initTokenizer();
+
+    AdifTokenizer::Field field;
 
-        readField(field, value);
-        field = field.toLower();
+    while ( tokenizer.nextField(field) )
+    {
+        const QString &fieldName = tokenizedFieldName(field);
 
-        if (field == "eor")
+        if ( fieldName == QLatin1String("eor") )
         {
             return true;
         }
 
-        if (!value.isEmpty())
+        if ( fieldName == QLatin1String("eoh") )
+        {
+            // the file has a header which starts with '<' - drop header fields
+            contact.clear();
+            continue;
+        }
+
+        if ( field.valueLength > 0 )
         {
-            contact[field] = QVariant(value);
+            contact[fieldName] = ( isUtf8Input ) ? QVariant(QString::fromUtf8(field.value, field.valueLength))
+                                                 : QVariant(QString::fromLatin1(field.value, field.valueLength));
         }
     }
 
     return false;
 }
 
+qint64 AdiFormat::inputPosition()
+{
+    FCT_IDENTIFICATION;
+
+    return ( isTokenizerReady ) ? tokenizer.position() : stream.pos();
+}
+
+void AdiFormat::initTokenizer()
+{
+    FCT_IDENTIFICATION;
+
+    isTokenizerReady = true;
+
+    QIODevice *device = stream.device();
+    QFileDevice *file = qobject_cast<QFileDevice *>(device);
+
+    if ( file && !file->isSequential() && file->size() > 0 )
+    {
+        mappedData = file->map(0, file->size());
+
+        if ( mappedData )
+        {
+            qCDebug(runtime) << "Using memory-mapped file" << file->fileName();
+            mappedFile = file;
+            tokenizer.reset(reinterpret_cast<const char *>(mappedData), file->size());
+            return;
+        }
+
+        qCDebug(runtime) << "Cannot map the file, reading it to the buffer" << file->errorString();
+    }
+
+    if ( device )
+    {
+        // ADIF is an ASCII format; the stream is decoded as Latin-1 (see constructor)
+        importBuffer = device->readAll();
+        tokenizer.reset(importBuffer.constData(), importBuffer.size());
+        return;
+    }
+
+    // a stream over a QString (WSJTX, Fldigi, Network Notification) can contain
+    // any Unicode characters; their field lengths count the QString characters
+    isUtf8Input = true;
+    importBuffer = stream.readAll().toUtf8();
+    tokenizer.reset(importBuffer.constData(), importBuffer.size(), true);
+}
+
+const QString AdiFormat::tokenizedFieldName(const AdifTokenizer::Field &field)
+{
+    // field names are repeated in every record - convert each of them only once
+    const QByteArray rawName = QByteArray::fromRawData(field.name, field.nameLength);
+    auto it = fieldNameCache.constFind(rawName);
+
+    if ( it != fieldNameCache.constEnd() )
+        return it.value();
+
+    const QString name = QString::fromLatin1(field.name, field.nameLength).toLower();
+
+    // protection against broken files with random field names
+    if ( fieldNameCache.size() < 1024 )
+        fieldNameCache.insert(QByteArray(field.name, field.nameLength), name);
+
+    return name;
+}
+
 AdiFormat::AdiFormat(QTextStream &stream) :
     LogFormat(stream)
 {
@@ -683,6 +637,14 @@ AdiFormat::AdiFormat(QTextStream &stream) :
 #endif
 }
 
+AdiFormat::~AdiFormat()
+{
+    FCT_IDENTIFICATION;
+
+    if ( mappedFile && mappedData )
+        mappedFile->unmap(mappedData);
+}
+
 bool AdiFormat::importNext(QSqlRecord& record)
 {
     FCT_IDENTIFICATION;
@@ -1,12 +1,16 @@
 #ifndef QLOG_LOGFORMAT_ADIFORMAT_H
 #define QLOG_LOGFORMAT_ADIFORMAT_H
 
+#include <QPointer>
+#include <QFileDevice>
 #include "LogFormat.h"
+#include "AdifTokenizer.h"
 
 class AdiFormat : public LogFormat
 {
 public:
     explicit AdiFormat(QTextStream& stream);
+    virtual ~AdiFormat();
 
     virtual bool importNext(QSqlRecord& ) override;
 
@@ -34,6 +38,7 @@ protected:
     virtual void writeSQLRecord(const QSqlRecord& record,
                                 QMap<QString, QString> *applTags);
     virtual bool readContact(QVariantMap &);
+    virtual qint64 inputPosition() override;
     void mapContact2SQLRecord(QMap<QString, QVariant> &contact,
                               QSqlRecord &record);
     void contactFields2SQLRecord(QMap<QString, QVariant> &contact,
@@ -86,8 +91,8 @@ protected:
 
 private:
 
-    void readField(QString& field,
-                   QString& value);
+    void initTokenizer();
+    const QString tokenizedFieldName(const AdifTokenizer::Field &field);
     QDate parseDate(const QString &date);
     QTime parseTime(const QString &time);
     QString parseQslRcvd(const QString &value);
@@ -97,15 +102,6 @@ private:
     QString parseMorseKeyType(const QString &value);
     QString parseEqslAg(const QString &value);
 
-    enum ParserState {
-        START,
-        FIELD,
-        KEY,
-        SIZE,
-        DATA_TYPE,
-        VALUE
-    };
-
     static void preprocessINTLField(const QString &fieldName,
                                     const QString &fieldIntlName,
                                     QMap<QString, QVariant> &contact);
@@ -113,8 +109,13 @@ private:
                                     const QString &fieldIntlName,
                                     QSqlRecord &contact);
 
-    ParserState state = START;
-    bool inHeader = false;
+    AdifTokenizer tokenizer;
+    bool isTokenizerReady = false;
+    bool isUtf8Input = false;
+    QByteArray importBuffer;
+    QPointer<QFileDevice> mappedFile;
+    uchar *mappedData = nullptr;
+    QHash<QByteArray, QString> fieldNameCache;
 };
 
 #endif // QLOG_LOGFORMAT_ADIFORMAT_H
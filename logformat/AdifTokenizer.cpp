@@ -0,0 +1,171 @@
+#include <cstring>
+
+#include "AdifTokenizer.h"
+
+static inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static inline char toLowerAscii(char c)
+{
+    return ( c >= 'A' && c <= 'Z' ) ? static_cast<char>(c + ('a' - 'A')) : c;
+}
+
+// returns the end of the UTF-8 text which has the given number of UTF-16 units
+static const char *skipUtf16Units(const char *p, const char *end, qint64 units)
+{
+    while ( units > 0 && p < end )
+    {
+        const unsigned char c = static_cast<unsigned char>(*p);
+        qint64 bytes = 1;
+
+        if ( c >= 0xF0 )
+        {
+            // a surrogate pair in QString
+            bytes = 4;
+            units--;
+        }
+        else if ( c >= 0xE0 )
+            bytes = 3;
+        else if ( c >= 0xC0 )
+            bytes = 2;
+
+        units--;
+        p += qMin(bytes, static_cast<qint64>(end - p));
+    }
+
+    return p;
+}
+
+bool AdifTokenizer::Field::nameEquals(const char *lowerName) const
+{
+    int i = 0;
+
+    for ( ; i < nameLength; i++ )
+    {
+        if ( lowerName[i] == '\0' || toLowerAscii(name[i]) != lowerName[i] )
+            return false;
+    }
+
+    return lowerName[i] == '\0';
+}
+
+AdifTokenizer::AdifTokenizer() :
+    begin(nullptr),
+    cur(nullptr),
+    end(nullptr),
+    headerChecked(false),
+    inHeader(false),
+    utf8Text(false)
+{
+}
+
+AdifTokenizer::AdifTokenizer(const char *data, qint64 size, bool utf8Text)
+{
+    reset(data, size, utf8Text);
+}
+
+void AdifTokenizer::reset(const char *data, qint64 size, bool utf8Text)
+{
+    begin = cur = data;
+    end = ( data ) ? data + size : data;
+    headerChecked = false;
+    inHeader = false;
+    this->utf8Text = utf8Text;
+}
+
+bool AdifTokenizer::nextField(Field &field)
+{
+    if ( !headerChecked )
+    {
+        // ADIF Spec: a Header begins with any character other than <
+        headerChecked = true;
+        inHeader = ( cur < end && *cur != '<' );
+    }
+
+    while ( cur < end )
+    {
+        // memchr is vectorized by the C library - the only per-byte work
+        // is done there
+        const char *tagStart = static_cast<const char *>(memchr(cur, '<', end - cur));
+
+        if ( !tagStart )
+            break;
+
+        const char *tagEnd = static_cast<const char *>(memchr(tagStart + 1, '>', end - tagStart - 1));
+
+        if ( !tagEnd )
+            break;
+
+        const char *nameEnd = static_cast<const char *>(memchr(tagStart + 1, ':', tagEnd - tagStart - 1));
+
+        if ( !nameEnd )
+            nameEnd = tagEnd;
+
+        const char *nameBegin = tagStart + 1;
+
+        while ( nameBegin < nameEnd && isSpace(*nameBegin) )
+            nameBegin++;
+
+        const char *nameLast = nameEnd;
+
+        while ( nameLast > nameBegin && isSpace(*(nameLast - 1)) )
+            nameLast--;
+
+        qint64 length = 0;
+        const char *type = nullptr;
+        int typeLength = 0;
+
+        if ( nameEnd < tagEnd )
+        {
+            const char *p = nameEnd + 1;
+
+            while ( p < tagEnd && isSpace(*p) )
+                p++;
+
+            while ( p < tagEnd && *p >= '0' && *p <= '9' )
+            {
+                length = length * 10 + (*p - '0');
+                p++;
+            }
+
+            const char *typeSeparator = static_cast<const char *>(memchr(p, ':', tagEnd - p));
+
+            if ( typeSeparator )
+            {
+                type = typeSeparator + 1;
+                typeLength = static_cast<int>(tagEnd - type);
+            }
+        }
+
+        const char *value = tagEnd + 1;
+        const qint64 available = end - value;
+
+        if ( utf8Text )
+            length = skipUtf16Units(value, end, length) - value;
+        else if ( length > available )
+            length = available;
+
+        cur = value + length;
+
+        field.name = nameBegin;
+        field.nameLength = static_cast<int>(nameLast - nameBegin);
+        field.type = type;
+        field.typeLength = typeLength;
+        field.value = value;
+        field.valueLength = static_cast<int>(length);
+
+        if ( inHeader )
+        {
+            if ( field.nameEquals("eoh") )
+                inHeader = false;
+            continue;
+        }
+
+        return true;
+    }
+
+    cur = end;
+    return false;
+}
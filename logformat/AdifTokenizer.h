@@ -0,0 +1,44 @@
+#ifndef QLOG_LOGFORMAT_ADIFTOKENIZER_H
+#define QLOG_LOGFORMAT_ADIFTOKENIZER_H
+
+#include <QtGlobal>
+#include <QByteArray>
+
+// Zero-copy ADIF tokenizer. It works over a continuous byte buffer
+// (memory-mapped file or one large read buffer) and returns pointers
+// into that buffer. The buffer must outlive the tokenizer.
+// A buffer created from a QString is UTF-8 encoded and its field lengths
+// count the QString characters (UTF-16 units), not the bytes.
+class AdifTokenizer
+{
+public:
+    struct Field
+    {
+        const char *name = nullptr;
+        int nameLength = 0;
+        const char *type = nullptr;
+        int typeLength = 0;
+        const char *value = nullptr;
+        int valueLength = 0;
+
+        bool nameEquals(const char *lowerName) const;
+    };
+
+    AdifTokenizer();
+    AdifTokenizer(const char *data, qint64 size, bool utf8Text = false);
+
+    void reset(const char *data, qint64 size, bool utf8Text = false);
+    bool nextField(Field &field);
+    qint64 position() const { return cur - begin; }
+    qint64 size() const { return end - begin; }
+
+private:
+    const char *begin;
+    const char *cur;
+    const char *end;
+    bool headerChecked;
+    bool inHeader;
+    bool utf8Text;
+};
+
+#endif // QLOG_LOGFORMAT_ADIFTOKENIZER_H
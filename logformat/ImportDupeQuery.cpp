@@ -0,0 +1,69 @@
+#include <QSqlError>
+#include <QTimeZone>
+
+#include "ImportDupeQuery.h"
+#include "core/debug.h"
+
+MODULE_IDENTIFICATION("qlog.logformat.importdupequery");
+
+ImportDupeQuery::ImportDupeQuery(const QSqlDatabase &db) :
+    query(db),
+    valid(false)
+{
+    FCT_IDENTIFICATION;
+
+    // start_time range is only a pre-filter; it is wider than the dupe window
+    // and the exact window is checked by JULIANDAY for the range rows only.
+    // Band and mode are normalized by the caller.
+    valid = query.prepare("SELECT * FROM contacts "
+                          "WHERE callsign = :callsign "
+                          "AND start_time >= :fromDate AND start_time < :toDate "
+                          "AND upper(mode) = :mode "
+                          "AND upper(band) = :band "
+                          "AND COALESCE(sat_name, '') = COALESCE(:sat_name, '') "
+                          "AND ABS(JULIANDAY(start_time)-JULIANDAY(datetime(:startdate)))*24*60<30 "
+                          "LIMIT 1");
+
+    if ( !valid )
+        qWarning() << "Cannot prepare Dup statement" << query.lastError();
+}
+
+bool ImportDupeQuery::find(const QString &callsign,
+                           const QString &band,
+                           const QString &mode,
+                           const QVariant &satName,
+                           const QDateTime &startTime)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << callsign << band << mode << satName << startTime;
+
+    if ( !valid )
+        return false;
+
+    const QDateTime &utcTime = startTime.toTimeZone(QTimeZone::utc());
+
+    // start_time is compared as a string; a date prefix is lower than all
+    // times of the day regardless of the stored time format. One day is added
+    // on both sides to cover the dupe window and time zone offsets.
+    query.bindValue(":callsign", callsign.toUpper());
+    query.bindValue(":fromDate", utcTime.date().addDays(-1).toString("yyyy-MM-dd"));
+    query.bindValue(":toDate", utcTime.date().addDays(2).toString("yyyy-MM-dd"));
+    query.bindValue(":mode", mode.toUpper());
+    query.bindValue(":band", band.toUpper());
+    query.bindValue(":sat_name", satName);
+    query.bindValue(":startdate", utcTime.toString("yyyy-MM-dd hh:mm:ss"));
+
+    if ( !query.exec() )
+    {
+        qWarning() << "Cannot exect DUP statement" << query.lastError();
+        return false;
+    }
+
+    return query.next();
+}
+
+QSqlRecord ImportDupeQuery::record() const
+{
+    return query.record();
+}
@@ -0,0 +1,33 @@
+#ifndef QLOG_LOGFORMAT_IMPORTDUPEQUERY_H
+#define QLOG_LOGFORMAT_IMPORTDUPEQUERY_H
+
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <QDateTime>
+
+// Duplicate QSO lookup used by the log import. A QSO is a duplicate
+// if it has the same callsign, band, mode and satellite and its start time
+// is within 30 minutes. The candidates are selected by callsign and
+// a start_time range therefore the (callsign, start_time) index is used
+// instead of evaluating JULIANDAY for all QSOs of the callsign.
+class ImportDupeQuery
+{
+public:
+    explicit ImportDupeQuery(const QSqlDatabase &db);
+
+    bool isValid() const { return valid; }
+
+    // returns true if a duplicate exists; record() then contains the duplicate
+    bool find(const QString &callsign,
+              const QString &band,
+              const QString &mode,
+              const QVariant &satName,
+              const QDateTime &startTime);
+    QSqlRecord record() const;
+
+private:
+    QSqlQuery query;
+    bool valid;
+};
+
+#endif // QLOG_LOGFORMAT_IMPORTDUPEQUERY_H
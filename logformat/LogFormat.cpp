@@ -15,13 +15,21 @@
 #include "service/lotw/Lotw.h"
 #include "models/LogbookModel.h"
 #include "core/QSOFilterManager.h"
+#include "QSLContactIndex.h"
+#include "ImportDupeQuery.h"
 
 MODULE_IDENTIFICATION("qlog.logformat.logformat");
 
+const int LogFormat::DEFAULT_IMPORT_BATCH_SIZE = 1000;
+const int LogFormat::QSL_IMPORT_BATCH_SIZE = 5000;
+
 LogFormat::LogFormat(QTextStream& stream) :
     QObject(nullptr),
     stream(stream),
     exportedFields("*"),
+    dbConnectionName(QLatin1String(QSqlDatabase::defaultConnection)),
+    importBatchSize(0),
+    cancelRequested(0),
     duplicateQSOFunc(nullptr)
 {
     FCT_IDENTIFICATION;
@@ -155,7 +163,10 @@ void LogFormat::setFilterSendVia(const QString &value)
 void LogFormat::setUserFilter(const QString &value)
 {
     FCT_IDENTIFICATION;
-    userFilter = value;
+
+    // resolve the filter now - the export can run over another DB connection
+    userFilterWhereClause = ( value.isEmpty() ) ? QString()
+                                               : QSOFilterManager::getWhereClause(value);
 }
 
 void LogFormat::setFilterStationProfile(const StationProfile &profile)
@@ -208,8 +219,8 @@ QString LogFormat::getWhereClause()
                                ")").arg(filterStationProfile.getContactInnerJoin());
     }
 
-    if ( !userFilter.isEmpty() )
-        whereClause << QSOFilterManager::getWhereClause(userFilter);
+    if ( !userFilterWhereClause.isEmpty() )
+        whereClause << userFilterWhereClause;
 
     return whereClause.join(" AND ");
 }
@@ -277,6 +288,37 @@ void LogFormat::setDuplicateQSOCallback(duplicateQSOBehaviour (*func)(QSqlRecord
     duplicateQSOFunc = func;
 }
 
+void LogFormat::setDatabaseConnection(const QString &connectionName)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << connectionName;
+
+    dbConnectionName = connectionName;
+}
+
+void LogFormat::setImportBatchSize(int size)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << size;
+
+    // 0 = whole import in one transaction
+    importBatchSize = qMax(0, size);
+}
+
+void LogFormat::cancel()
+{
+    FCT_IDENTIFICATION;
+
+    cancelRequested = 1;
+}
+
+bool LogFormat::isCancelled() const
+{
+    return cancelRequested != 0;
+}
+
 #define RECORDIDX(a) ( (a) - 1 )
 
 unsigned long LogFormat::runImport(QTextStream& importLogStream,
@@ -292,26 +334,29 @@ unsigned long LogFormat::runImport(QTextStream& importLogStream,
     *errors = 0L;
     *warnings = 0L;
     unsigned long processedRec = 0;
+    unsigned long batchCount = 0;
+    bool cancelled = false;
 
-    QSqlQuery dupQuery;
-    QSqlQuery insertQuery;
+    QSqlDatabase db = QSqlDatabase::database(dbConnectionName);
+    ImportDupeQuery dupQuery(db);
+    QSqlQuery insertQuery(db);
+    QSqlQuery sotaQuery(db);
 
-    // It is important to use callsign index here
-    if ( ! dupQuery.prepare("SELECT * FROM contacts "
-                            "WHERE callsign=upper(:callsign) "
-                            "AND upper(mode)=upper(:mode) "
-                            "AND upper(band)=upper(:band) "
-                            "AND COALESCE(sat_name, '') = COALESCE(:sat_name, '') "
-                            "AND ABS(JULIANDAY(start_time)-JULIANDAY(datetime(:startdate)))*24*60<30") )
+    if ( ! dupQuery.isValid() )
     {
         qWarning() << "cannot prepare Dup statement";
         return 0;
     }
 
+    if ( ! sotaQuery.prepare("SELECT altm FROM sota_summits WHERE summit_code = :code") )
+    {
+        qWarning() << "cannot prepare SOTA statement";
+        return 0;
+    }
 
-    QSqlDatabase::database().transaction();
+    db.transaction();
 
-    QSqlTableModel model;
+    QSqlTableModel model(nullptr, db);
     model.setTable("contacts");
     model.removeColumn(model.fieldIndex("id"));
     QSqlRecord record = model.record();
@@ -382,17 +427,52 @@ unsigned long LogFormat::runImport(QTextStream& importLogStream,
         }
     };
 
-    if ( !insertQuery.prepare( QSqlDatabase::database().driver()->sqlStatement(QSqlDriver::InsertStatement,
-                                                                               "contacts",
-                                                                               record,
-                                                                               true)) )
+    auto lookupSOTAAltitude = [&](const QString &sotaRef, QVariant &altitude)
+    {
+        sotaQuery.bindValue(":code", sotaRef.toUpper());
+
+        if ( !sotaQuery.exec() )
+        {
+            qWarning() << "Cannot execute SOTA statement" << sotaQuery.lastError();
+            return false;
+        }
+
+        if ( !sotaQuery.next() )
+            return false;
+
+        altitude = sotaQuery.value(0);
+        return true;
+    };
+
+    if ( !insertQuery.prepare( db.driver()->sqlStatement(QSqlDriver::InsertStatement,
+                                                         "contacts",
+                                                         record,
+                                                         true)) )
     {
         qWarning() << "cannot prepare Insert statement" << insertQuery.lastError();
+        db.rollback();
         return 0;
     }
 
+    QElapsedTimer progressTimer;
+    progressTimer.start();
+
     while (true)
     {
+        if ( isCancelled() )
+        {
+            // drop only the uncommitted batch, already committed batches stay in the log
+            db.rollback();
+            count -= batchCount;
+            writeImportLog(importLogStream,
+                           INFO_SEVERITY,
+                           tr("Import cancelled; %n uncommitted contact(s) rolled back", "", batchCount));
+            qCDebug(runtime) << "Import cancelled, rolled back" << batchCount;
+            batchCount = 0;
+            cancelled = true;
+            break;
+        }
+
         record.clearValues();
 
         if (!this->importNext(record)) break;
@@ -407,7 +487,7 @@ unsigned long LogFormat::runImport(QTextStream& importLogStream,
              && !record.value(RECORDIDX(LogbookModel::COLUMN_FREQUENCY)).toString().isEmpty() )
         {
             double freq = record.value(RECORDIDX(LogbookModel::COLUMN_FREQUENCY)).toDouble();
-            record.setValue(RECORDIDX(LogbookModel::COLUMN_BAND), BandPlan::freq2Band(freq).name);
+            record.setValue(RECORDIDX(LogbookModel::COLUMN_BAND), BandPlan::freq2Band(freq, db).name);
         }
 
         // needed later
@@ -438,9 +518,12 @@ unsigned long LogFormat::runImport(QTextStream& importLogStream,
             continue;
         }
 
-        if ( processedRec % 1000 == 0)
+        if ( progressTimer.elapsed() >= 100 )
         {
-            emit importPosition(stream.pos());
+            const qint64 position = inputPosition();
+            emit importPosition(position);
+            emit importProgress(position, processedRec);
+            progressTimer.restart();
         }
 
         if ( isDateRange() )
@@ -460,18 +543,7 @@ unsigned long LogFormat::runImport(QTextStream& importLogStream,
 
         if ( dupSetting != ACCEPT_ALL )
         {
-            dupQuery.bindValue(":callsign", call);
-            dupQuery.bindValue(":mode", mode);
-            dupQuery.bindValue(":band", band);
-            dupQuery.bindValue(":startdate", start_time.toTimeZone(QTimeZone::utc()).toString("yyyy-MM-dd hh:mm:ss"));
-            dupQuery.bindValue(":sat_name", satName);
-
-            if ( !dupQuery.exec() )
-            {
-                qWarning() << "Cannot exect DUP statement";
-            }
-
-            if ( dupQuery.next() )
+            if ( dupQuery.find(call.toString(), band.toString(), mode.toString(), satName, start_time) )
             {
                 if ( dupSetting == SKIP_ALL)
                 {
@@ -716,12 +788,10 @@ unsigned long LogFormat::runImport(QTextStream& importLogStream,
         if ( record.value(RECORDIDX(LogbookModel::COLUMN_ALTITUDE)).toString().isEmpty()
              && !sota.toString().isEmpty() )
         {
-            const SOTAEntity &sotaInfo = Data::instance()->lookupSOTA(sota.toString());
-            if ( sotaInfo.summitCode.compare(sota.toString(), Qt::CaseInsensitive)
-                 && !sotaInfo.summitName.isEmpty() )
-            {
-                record.setValue(RECORDIDX(LogbookModel::COLUMN_ALTITUDE),sotaInfo.altm);
-            }
+            QVariant altitude;
+
+            if ( lookupSOTAAltitude(sota.toString(), altitude) )
+                record.setValue(RECORDIDX(LogbookModel::COLUMN_ALTITUDE), altitude);
         }
 
         /*******************************/
@@ -730,12 +800,10 @@ unsigned long LogFormat::runImport(QTextStream& importLogStream,
         if ( record.value(RECORDIDX(LogbookModel::COLUMN_MY_ALTITUDE)).toString().isEmpty()
              && !mysota.toString().isEmpty() )
         {
-            const SOTAEntity &sotaInfo = Data::instance()->lookupSOTA(mysota.toString());
-            if ( sotaInfo.summitCode.compare(sota.toString(), Qt::CaseInsensitive)
-                 && !sotaInfo.summitName.isEmpty() )
-            {
-                record.setValue(RECORDIDX(LogbookModel::COLUMN_MY_ALTITUDE),sotaInfo.altm);
-            }
+            QVariant altitude;
+
+            if ( lookupSOTAAltitude(mysota.toString(), altitude) )
+                record.setValue(RECORDIDX(LogbookModel::COLUMN_MY_ALTITUDE), altitude);
         }
 
         /******************/
@@ -769,13 +837,26 @@ unsigned long LogFormat::runImport(QTextStream& importLogStream,
                            record,
                            tr("Imported"));
             count++;
+            batchCount++;
+
+            if ( importBatchSize > 0
+                 && batchCount >= static_cast<unsigned long>(importBatchSize) )
+            {
+                if ( !db.commit() )
+                    qWarning() << "Cannot commit import batch" << db.lastError();
+
+                batchCount = 0;
+                db.transaction();
+            }
         }
     }
 
-    emit importPosition(stream.pos());
-    emit finished(count);
+    if ( !cancelled )
+        db.commit();
 
-    QSqlDatabase::database().commit();
+    emit importPosition(inputPosition());
+    emit importProgress(inputPosition(), processedRec);
+    emit finished(count);
 
     this->importEnd();
 
@@ -804,323 +885,460 @@ void LogFormat::runQSLImport(QSLFrom fromService)
     QSLMergeStat stats = {QStringList(), QStringList(), QStringList(), QStringList(), 0};
     this->importStart();
 
-    QSqlTableModel model;
-    model.setTable("contacts");
-    QSqlRecord QSLRecord = model.record(0);
+    QSqlDatabase db = QSqlDatabase::database(dbConnectionName);
+    QSqlRecord inputRecord = db.record("contacts");
+    QSLContactIndex contactIndex(dbConnectionName);
+    QHash<QString, QSqlQuery> updateQueries;
+    const int batchSize = ( importBatchSize > 0 ) ? importBatchSize : QSL_IMPORT_BATCH_SIZE;
+    bool inputEnd = false;
 
     // Cache for mode to dxcc group lookups; avoids repeated DB queries for the same
     // mode value when processing large imports (LoTW fallback path only).
     QMap<QString, QString> modeGroupCache;
 
-    while ( true )
+    /* QSLs are processed in batches. A batch is matched against the in-memory
+     * contact index, the matched contacts are read by one query and
+     * all updates of the batch are written in one transaction */
+    while ( !inputEnd )
     {
-        QSLRecord.clearValues();
+        QList<QSqlRecord> batch;
+        QDateTime batchFrom;
+        QDateTime batchTo;
 
-        if ( !this->importNext(QSLRecord) ) break;
+        while ( batch.size() < batchSize )
+        {
+            inputRecord.clearValues();
 
-        stats.qsosDownloaded++;
+            if ( !this->importNext(inputRecord) )
+            {
+                inputEnd = true;
+                break;
+            }
 
-        if ( stats.qsosDownloaded % 100 == 0 )
-        {
-            emit importPosition(stream.pos());
-        }
+            stats.qsosDownloaded++;
 
-        // needed later
-        const QVariant &call = QSLRecord.value("callsign");
-        const QVariant &band = QSLRecord.value("band");
-        const QVariant &mode = QSLRecord.value("mode");
-        const QVariant &start_time = QSLRecord.value("start_time");
-        const QVariant &satName = QSLRecord.value("sat_name");
+            if ( stats.qsosDownloaded % 100 == 0 )
+            {
+                emit importPosition(inputPosition());
+            }
 
-        /* checking matching fields if they are not empty */
-        if ( !start_time.toDateTime().isValid()
-             || call.toString().isEmpty()
-             || band.toString().isEmpty()
-             || mode.toString().isEmpty() )
-        {
-            qWarning() << "Import does not contain field start_time or callsign or band or mode ";
-            qCDebug(runtime) << QSLRecord;
-            stats.errorQSLs.append(reportFormatter(start_time.toDateTime(), call.toString(), mode.toString()));
-            continue;
-        }
+            const QVariant &call = inputRecord.value("callsign");
+            const QVariant &band = inputRecord.value("band");
+            const QVariant &mode = inputRecord.value("mode");
+            const QDateTime &startTime = inputRecord.value("start_time").toDateTime();
 
-        const QString startTimeStr = start_time.toDateTime().toTimeZone(QTimeZone::utc()).toString("yyyy-MM-dd hh:mm:ss");
+            /* checking matching fields if they are not empty */
+            if ( !startTime.isValid()
+                 || call.toString().isEmpty()
+                 || band.toString().isEmpty()
+                 || mode.toString().isEmpty() )
+            {
+                qWarning() << "Import does not contain field start_time or callsign or band or mode ";
+                qCDebug(runtime) << inputRecord;
+                stats.errorQSLs.append(reportFormatter(startTime, call.toString(), mode.toString()));
+                continue;
+            }
 
-        // Common filter conditions — shared by all match attempts
-        const QString baseFilter = QString(
-            "callsign=upper('%1') AND upper(band)=upper('%2') AND "
-            "COALESCE(sat_name, '') = upper('%3') AND "
-            "ABS(JULIANDAY(start_time)-JULIANDAY(datetime('%4')))*24*60<30"
-        ).arg(call.toString(), band.toString(), satName.toString(), startTimeStr);
+            if ( !batchFrom.isValid() || startTime < batchFrom ) batchFrom = startTime;
+            if ( !batchTo.isValid() || startTime > batchTo ) batchTo = startTime;
 
-        // First attempt: exact mode match (used for eQSL; also the fast path for LoTW)
-        model.setFilter(baseFilter + QString(" AND upper(mode)=upper('%1')").arg(mode.toString()));
-        model.select();
+            batch.append(inputRecord);
+        }
 
-        // LoTW fallback: LoTW confirms QSOs when both sides specify modes in the same
-        // group (CW / PHONE / DATA).
+        if ( batch.isEmpty() )
+            continue;
 
-        // Two submitted descriptions of a QSO match if
+        if ( !contactIndex.load(batchFrom, batchTo) )
+            qWarning() << "Cannot load contacts for QSL matching";
 
-        // https://lotw.arrl.org/lotw-help/frequently-asked-questions/#datamatch
-        // your QSO description specifies a callsign that matches the Callsign Certificate specified by the Station Location your QSO partner used to digitally sign the QSO
-        // your QSO partner's QSO description specifies a callsign that matches the Callsign Certificate specified by the Station Location you used to digitally sign the QSO
-        // both QSO descriptions specify start times within 30 minutes of each other
-        // both QSO descriptions specify the same band
-        // both QSO descriptions specify the same mode (an exact mode match), or must specify modes belonging to the same Mode Group
-        // for satellite QSOs, both QSO descriptions must specify the same satellite, and a propagation mode of SAT
-        if ( model.rowCount() != 1 && fromService == LOTW )
-        {
-            const QString modeStr = mode.toString();
-            QString dxccGroup = LotwBase::lotwGroupNameToDxcc(modeStr);
+        /* matching pass - contact IDs for all QSLs in the batch */
+        QVector<qlonglong> matchedIDs(batch.size(), QSLContactIndex::NO_MATCH);
+        QSet<qlonglong> uniqueIDs;
 
-            if ( dxccGroup.isEmpty() )
+        for ( int i = 0; i < batch.size(); i++ )
+        {
+            const QSqlRecord &record = batch.at(i);
+            const QString &call = record.value("callsign").toString();
+            const QString &band = record.value("band").toString();
+            const QString &mode = record.value("mode").toString();
+            const QString &satName = record.value("sat_name").toString();
+            const QDateTime &startTime = record.value("start_time").toDateTime().toTimeZone(QTimeZone::utc());
+
+            // First attempt: exact mode match (used for eQSL; also the fast path for LoTW)
+            qlonglong contactID = contactIndex.matchMode(call, band, satName, mode, startTime);
+
+            // LoTW fallback: LoTW confirms QSOs when both sides specify modes in the same
+            // group (CW / PHONE / DATA).
+
+            // Two submitted descriptions of a QSO match if
+
+            // https://lotw.arrl.org/lotw-help/frequently-asked-questions/#datamatch
+            // your QSO description specifies a callsign that matches the Callsign Certificate specified by the Station Location your QSO partner used to digitally sign the QSO
+            // your QSO partner's QSO description specifies a callsign that matches the Callsign Certificate specified by the Station Location you used to digitally sign the QSO
+            // both QSO descriptions specify start times within 30 minutes of each other
+            // both QSO descriptions specify the same band
+            // both QSO descriptions specify the same mode (an exact mode match), or must specify modes belonging to the same Mode Group
+            // for satellite QSOs, both QSO descriptions must specify the same satellite, and a propagation mode of SAT
+            if ( contactID == QSLContactIndex::NO_MATCH && fromService == LOTW )
             {
-                if ( !modeGroupCache.contains(modeStr) )
-                    modeGroupCache.insert(modeStr, BandPlan::modeToDXCCModeGroup(modeStr));
-                dxccGroup = modeGroupCache.value(modeStr);
-            }
+                QString dxccGroup = LotwBase::lotwGroupNameToDxcc(mode);
 
-            if ( !dxccGroup.isEmpty() )
-            {
-                qCDebug(runtime) << "LoTW: mode group fallback" << mode << "->" << dxccGroup;
-                model.setFilter(baseFilter + QString(
-                    " AND (SELECT dxcc FROM modes WHERE upper(name)=upper(mode) LIMIT 1) = '%1'"
-                ).arg(dxccGroup));
-                model.select();
+                if ( dxccGroup.isEmpty() )
+                {
+                    if ( !modeGroupCache.contains(mode) )
+                        modeGroupCache.insert(mode, BandPlan::modeToDXCCModeGroup(mode, db));
+                    dxccGroup = modeGroupCache.value(mode);
+                }
+
+                if ( !dxccGroup.isEmpty() )
+                {
+                    qCDebug(runtime) << "LoTW: mode group fallback" << mode << "->" << dxccGroup;
+                    contactID = contactIndex.matchModeGroup(call, band, satName, dxccGroup, startTime);
+                }
             }
-        }
 
-        if ( model.rowCount() != 1 )
-        {
-            stats.unmatchedQSLs.append(reportFormatter(start_time.toDateTime(), call.toString(), mode.toString()));
-            continue;
+            matchedIDs[i] = contactID;
+
+            if ( contactID != QSLContactIndex::NO_MATCH )
+                uniqueIDs.insert(contactID);
         }
 
-        /* we have one row for updating */
-        /* lets update it */
-        QSqlRecord originalRecord = model.record(0);
+        /* matched contacts are read at once; a contact can be matched by more QSLs
+         * in the batch therefore the next QSL works with the already updated record */
+        QHash<qlonglong, QSqlRecord> matchedContacts = loadQSLContacts(uniqueIDs);
 
-        switch ( fromService )
-        {
-        case LOTW:
+        if ( !db.transaction() )
+            qWarning() << "Cannot start QSL import transaction" << db.lastError();
+
+        for ( int i = 0; i < batch.size(); i++ )
         {
-            /* https://lotw.arrl.org/lotw-help/developer-query-qsos-qsls/?lang=en */
-            // always try to update contact from received QSL
-            if ( QSLRecord.value("qsl_rcvd").toString() == 'Y' ) // qsl_rcvd is OK because LoTW sends lotw_qsl_rcvd value in qsl_rcvd
+            const QSqlRecord &QSLRecord = batch.at(i);
+
+            // needed later
+            const QVariant &call = QSLRecord.value("callsign");
+            const QVariant &band = QSLRecord.value("band");
+            const QVariant &mode = QSLRecord.value("mode");
+            const QVariant &start_time = QSLRecord.value("start_time");
+            const QVariant &satName = QSLRecord.value("sat_name");
+
+            auto contactIt = matchedContacts.find(matchedIDs.at(i));
+
+            if ( contactIt == matchedContacts.end() )
             {
-                QStringList updatedFields;
-                bool callUpdate = false;
-                bool newlyReceived = (QSLRecord.value("qsl_rcvd").toString() != originalRecord.value("lotw_qsl_rcvd").toString());
+                stats.unmatchedQSLs.append(reportFormatter(start_time.toDateTime(), call.toString(), mode.toString()));
+                continue;
+            }
 
-                qCDebug(runtime) << "Attempt to" << (newlyReceived ? "force " : "") << "update QSO" << call.toString()
-                                 << band.toString() << start_time.toString();
+            /* we have one row for updating */
+            /* lets update it */
+            QSqlRecord &originalRecord = contactIt.value();
+            const QSqlRecord contactBefore = originalRecord;
 
-                auto conditionUpdate = [&](const QString &contactKey,
-                                           const QString &qslKey,
-                                           bool forceUpdate = false)
+            switch ( fromService )
+            {
+            case LOTW:
+            {
+                /* https://lotw.arrl.org/lotw-help/developer-query-qsos-qsls/?lang=en */
+                // always try to update contact from received QSL
+                if ( QSLRecord.value("qsl_rcvd").toString() == 'Y' ) // qsl_rcvd is OK because LoTW sends lotw_qsl_rcvd value in qsl_rcvd
                 {
-                    if ( !QSLRecord.value(qslKey).toString().isEmpty()
-                        && ( forceUpdate || originalRecord.value(contactKey).toString().isEmpty() ) )
-                    {
-                        qCDebug(runtime) << "Updating:" << contactKey
-                                         << "to" << QSLRecord.value(qslKey).toString()
-                                         << (forceUpdate ? "force update" : "");
-                        updatedFields.append(contactKey + "(" + QSLRecord.value(qslKey).toString()  +")");
-                        originalRecord.setValue(contactKey, QSLRecord.value(qslKey));
-                        return true;
-                    }
-                    return false;
-                };
+                    QStringList updatedFields;
+                    bool callUpdate = false;
+                    bool newlyReceived = (QSLRecord.value("qsl_rcvd").toString() != originalRecord.value("lotw_qsl_rcvd").toString());
 
-                auto conditionUpdateSpecial = [&](const QString &contactKey,
-                                                  const QString &qslKey,
-                                                  bool forceUpdate = false)
-                {
-                    QString contactValue = originalRecord.value(contactKey).toString();
-                    QString QSLValue = QSLRecord.value(qslKey).toString();
-                    contactValue.remove(reLeadingZero);
-                    QSLValue.remove(reLeadingZero);
+                    qCDebug(runtime) << "Attempt to" << (newlyReceived ? "force " : "") << "update QSO" << call.toString()
+                                     << band.toString() << start_time.toString();
 
-                    if ( !QSLValue.isEmpty()
-                        && ( forceUpdate || contactValue != QSLValue ) )
+                    auto conditionUpdate = [&](const QString &contactKey,
+                                               const QString &qslKey,
+                                               bool forceUpdate = false)
+                    {
+                        if ( !QSLRecord.value(qslKey).toString().isEmpty()
+                            && ( forceUpdate || originalRecord.value(contactKey).toString().isEmpty() ) )
+                        {
+                            qCDebug(runtime) << "Updating:" << contactKey
+                                             << "to" << QSLRecord.value(qslKey).toString()
+                                             << (forceUpdate ? "force update" : "");
+                            updatedFields.append(contactKey + "(" + QSLRecord.value(qslKey).toString()  +")");
+                            originalRecord.setValue(contactKey, QSLRecord.value(qslKey));
+                            return true;
+                        }
+                        return false;
+                    };
+
+                    auto conditionUpdateSpecial = [&](const QString &contactKey,
+                                                      const QString &qslKey,
+                                                      bool forceUpdate = false)
                     {
-                        qCDebug(runtime) << "Updating:" << contactKey
-                                         << "from" << originalRecord.value(contactKey).toString()
-                                         << "to" << QSLValue
-                                         << (forceUpdate ? "force update" : "");
-                        updatedFields.append(contactKey + "(" + QSLRecord.value(qslKey).toString()  +")");
-                        originalRecord.setValue(contactKey, QSLValue);
-                        return true;
+                        QString contactValue = originalRecord.value(contactKey).toString();
+                        QString QSLValue = QSLRecord.value(qslKey).toString();
+                        contactValue.remove(reLeadingZero);
+                        QSLValue.remove(reLeadingZero);
+
+                        if ( !QSLValue.isEmpty()
+                            && ( forceUpdate || contactValue != QSLValue ) )
+                        {
+                            qCDebug(runtime) << "Updating:" << contactKey
+                                             << "from" << originalRecord.value(contactKey).toString()
+                                             << "to" << QSLValue
+                                             << (forceUpdate ? "force update" : "");
+                            updatedFields.append(contactKey + "(" + QSLRecord.value(qslKey).toString()  +")");
+                            originalRecord.setValue(contactKey, QSLValue);
+                            return true;
+                        }
+                        return false;
+                    };
+
+                    callUpdate |= conditionUpdate("lotw_qsl_rcvd", "qsl_rcvd", newlyReceived);
+                    callUpdate |= conditionUpdate("lotw_qslrdate", "qsl_rdate", newlyReceived);
+                    callUpdate |= conditionUpdate("credit_granted", "credit_granted", newlyReceived);
+                    callUpdate |= conditionUpdate("credit_submitted", "credit_submitted", newlyReceived);
+                    callUpdate |= conditionUpdate("pfx", "pfx", newlyReceived);
+                    callUpdate |= conditionUpdate("iota", "iota", newlyReceived);
+                    callUpdate |= conditionUpdate("vucc_grids", "vucc_grids", newlyReceived);
+                    callUpdate |= conditionUpdate("state", "state", newlyReceived);
+                    callUpdate |= conditionUpdate("cnty", "cnty", newlyReceived);
+                    callUpdate |= conditionUpdateSpecial("ituz", "ituz", newlyReceived);
+                    callUpdate |= conditionUpdateSpecial("cqz", "cqz", newlyReceived);
+
+                    if ( originalRecord.value("qsl_rcvd_via").toString() != "E" )
+                    {
+                        qCDebug(runtime) << "Updating: qsl_rcvd_via from" << originalRecord.value("qsl_rcvd_via").toString() << "to E";
+                        originalRecord.setValue("qsl_rcvd_via", "E");
+                        updatedFields.append("qsl_rcvd_via (E)");
+                        callUpdate |= true;
                     }
-                    return false;
-                };
-
-                callUpdate |= conditionUpdate("lotw_qsl_rcvd", "qsl_rcvd", newlyReceived);
-                callUpdate |= conditionUpdate("lotw_qslrdate", "qsl_rdate", newlyReceived);
-                callUpdate |= conditionUpdate("credit_granted", "credit_granted", newlyReceived);
-                callUpdate |= conditionUpdate("credit_submitted", "credit_submitted", newlyReceived);
-                callUpdate |= conditionUpdate("pfx", "pfx", newlyReceived);
-                callUpdate |= conditionUpdate("iota", "iota", newlyReceived);
-                callUpdate |= conditionUpdate("vucc_grids", "vucc_grids", newlyReceived);
-                callUpdate |= conditionUpdate("state", "state", newlyReceived);
-                callUpdate |= conditionUpdate("cnty", "cnty", newlyReceived);
-                callUpdate |= conditionUpdateSpecial("ituz", "ituz", newlyReceived);
-                callUpdate |= conditionUpdateSpecial("cqz", "cqz", newlyReceived);
-
-                if ( originalRecord.value("qsl_rcvd_via").toString() != "E" )
-                {
-                    qCDebug(runtime) << "Updating: qsl_rcvd_via from" << originalRecord.value("qsl_rcvd_via").toString() << "to E";
-                    originalRecord.setValue("qsl_rcvd_via", "E");
-                    updatedFields.append("qsl_rcvd_via (E)");
-                    callUpdate |= true;
-                }
 
-                const QString origGrig = originalRecord.value("gridsquare").toString();
-                const Gridsquare dxNewGrid(QSLRecord.value("gridsquare").toString());
+                    const QString origGrig = originalRecord.value("gridsquare").toString();
+                    const Gridsquare dxNewGrid(QSLRecord.value("gridsquare").toString());
 
-                if ( ( newlyReceived
-                       ||  origGrig.isEmpty()
-                       || ( origGrig.length() < QSLRecord.value("gridsquare").toString().length()
-                            && dxNewGrid.isValid()
-                            && dxNewGrid.getGrid().contains(origGrig) ) )
-                    && !dxNewGrid.getGrid().isEmpty() )
-                {
-                    const Gridsquare myGrid(originalRecord.value("my_gridsquare").toString());
+                    if ( ( newlyReceived
+                           ||  origGrig.isEmpty()
+                           || ( origGrig.length() < QSLRecord.value("gridsquare").toString().length()
+                                && dxNewGrid.isValid()
+                                && dxNewGrid.getGrid().contains(origGrig) ) )
+                        && !dxNewGrid.getGrid().isEmpty() )
+                    {
+                        const Gridsquare myGrid(originalRecord.value("my_gridsquare").toString());
 
-                    originalRecord.setValue("gridsquare", dxNewGrid.getGrid());
+                        originalRecord.setValue("gridsquare", dxNewGrid.getGrid());
 
-                    double distance;
+                        double distance;
 
-                    if ( myGrid.distanceTo(dxNewGrid, distance) )
+                        if ( myGrid.distanceTo(dxNewGrid, distance) )
+                        {
+                            originalRecord.setValue("distance", QVariant(distance));
+                        }
+                        qCDebug(runtime) << "Updating: grid from " << origGrig << "to" << dxNewGrid.getGrid();
+                        updatedFields.append("gridsquare (" + dxNewGrid.getGrid()  +")");
+                        callUpdate |= true;
+                    }
+
+                    if ( callUpdate )
                     {
-                        originalRecord.setValue("distance", QVariant(distance));
+                        qCDebug(runtime) << "Calling update for" << call << band << mode << start_time << satName;
+                        if ( !updateQSLContact(contactBefore, originalRecord, updateQueries) )
+                        {
+                            qCDebug(runtime) << originalRecord;
+                        }
+                        if ( newlyReceived )
+                        {
+                            const DxccStatus status = Data::instance()->dxccStatus(originalRecord.value("dxcc").toInt(), band.toString(), mode.toString(), db);
+                            stats.newQSLs.append(reportFormatter(start_time.toDateTime(), call.toString(), mode.toString(), {tr("DXCC State:") + " " + Data::statusToText(status)}));
+                        }
+                        else
+                            stats.updatedQSOs.append(reportFormatter(start_time.toDateTime(), call.toString(), mode.toString(), updatedFields));
                     }
-                    qCDebug(runtime) << "Updating: grid from " << origGrig << "to" << dxNewGrid.getGrid();
-                    updatedFields.append("gridsquare (" + dxNewGrid.getGrid()  +")");
-                    callUpdate |= true;
                 }
+                break;
+            }
 
-                if ( callUpdate )
+            case EQSL:
+            {
+                /* http://www.eqsl.cc/qslcard/DownloadInBox.txt */
+                /*   CALL
+                     QSO_DATE
+                     TIME_ON
+                     BAND
+                     MODE
+                     SUBMODE (tag only present if non-blank)
+                     PROP_MODE (tag only present if non-blank)
+                     RST_SENT (will be the sender's RST Sent, not yours)
+                     RST_RCVD (we do not capture this in uploads, so will normally be 0 length)
+                     QSL_SENT (always Y)
+                     QSL_SENT_VIA (always E)
+                     QSLMSG (if non-null and containing only valid printable ASCII characters)
+                     QSLMSG_INTL (if non-null and containing international characters - see ADIF V3 specs)
+                     APP_EQSL_SWL (tag only present if sender is SWL and then always Y)
+                     APP_EQSL_AG (tag only present if sender has Authenticity Guaranteed status and then always Y)
+                     GRIDSQUARE (tag only present if non-blank and at least 4 long)
+                */
+                // LF: Since I consider this source unreliable, I will not update it here, as I do with LoTW
+                // try to update contact from received QSL only in case when contact != Y
+                if ( originalRecord.value("eqsl_qsl_rcvd").toString() != 'Y' )
                 {
-                    qCDebug(runtime) << "Calling update for" << call << band << mode << start_time << satName;
-                    if ( !model.setRecord(0, originalRecord) )
-                    {
-                        qWarning() << "Cannot update a Contact record - " << model.lastError();
-                        qCDebug(runtime) << originalRecord;
-                    }
+                    originalRecord.setValue("eqsl_qsl_rcvd", QSLRecord.value("qsl_sent"));
+
+                    originalRecord.setValue("eqsl_qslrdate", QDateTime::currentDateTimeUtc().date().toString("yyyy-MM-dd"));
+
+                    Gridsquare dxNewGrid(QSLRecord.value("gridsquare").toString());
 
-                    if ( !model.submitAll() )
+                    if ( dxNewGrid.isValid()
+                         && ( originalRecord.value("gridsquare").toString().isEmpty()
+                              ||
+                              dxNewGrid.getGrid().contains(originalRecord.value("gridsquare").toString()))
+                         )
                     {
-                        qWarning() << "Cannot commit changes to Contact Table - " << model.lastError();
+                        Gridsquare myGrid(originalRecord.value("my_gridsquare").toString());
+
+                        originalRecord.setValue("gridsquare", dxNewGrid.getGrid());
+
+                        double distance;
+
+                        if ( myGrid.distanceTo(dxNewGrid, distance) )
+                        {
+                            originalRecord.setValue("distance", QVariant(distance));
+                        }
                     }
-                    if ( newlyReceived )
+
+                    const QString &prevValue = originalRecord.value("qslmsg_rcvd").toString();
+                    const QString &newValue = QSLRecord.value("qslmsg").toString();
+
+                    if ( !newValue.isEmpty() )
+                        originalRecord.setValue("qslmsg_rcvd", prevValue.isEmpty() ? "eQSL: " + newValue : prevValue + "| eQSL: " + newValue);
+
+                    // temporary removed - ADIF 3.1.5 has no INTL equivalent for qslmsg_rcvd
+                    //originalRecord.setValue("qslmsg_int", QSLRecord.value("qslmsg_int"));
+
+                    originalRecord.setValue("qsl_rcvd_via", QSLRecord.value("qsl_sent_via"));
+
+                    /*
+                     * It appears that the life cycle of EQSL_AQ field is not fully understood
+                     * at the moment. Unfortunately, even on the ADIF forum there are differing opinions,
+                     * but I have gained the impression that the only authority that knows the correct
+                     * value of EQSL_AG is eQSL itself. Therefore, I believe that the value received from eQSL
+                     * should always be set here, even though the field’s value may vary at the time the QSL is received.
+                     */
+                    originalRecord.setValue("eqsl_ag", QSLRecord.value("eqsl_ag"));
+
+                    if ( !updateQSLContact(contactBefore, originalRecord, updateQueries) )
                     {
-                        const DxccStatus status = Data::instance()->dxccStatus(originalRecord.value("dxcc").toInt(), band.toString(), mode.toString());
-                        stats.newQSLs.append(reportFormatter(start_time.toDateTime(), call.toString(), mode.toString(), {tr("DXCC State:") + " " + Data::statusToText(status)}));
+                        qCDebug(runtime) << originalRecord;
                     }
-                    else
-                        stats.updatedQSOs.append(reportFormatter(start_time.toDateTime(), call.toString(), mode.toString(), updatedFields));
+                    const DxccStatus status = Data::instance()->dxccStatus(originalRecord.value("dxcc").toInt(), band.toString(), mode.toString(), db);
+                    stats.newQSLs.append(reportFormatter(start_time.toDateTime(), call.toString(), mode.toString(), {tr("DXCC State:") + " " + Data::statusToText(status)}));
                 }
+
+                break;
+            }
+
+            default:
+                qCDebug(runtime) << "Unknown QSL import";
             }
-            break;
         }
 
-        case EQSL:
-        {
-            /* http://www.eqsl.cc/qslcard/DownloadInBox.txt */
-            /*   CALL
-                 QSO_DATE
-                 TIME_ON
-                 BAND
-                 MODE
-                 SUBMODE (tag only present if non-blank)
-                 PROP_MODE (tag only present if non-blank)
-                 RST_SENT (will be the sender's RST Sent, not yours)
-                 RST_RCVD (we do not capture this in uploads, so will normally be 0 length)
-                 QSL_SENT (always Y)
-                 QSL_SENT_VIA (always E)
-                 QSLMSG (if non-null and containing only valid printable ASCII characters)
-                 QSLMSG_INTL (if non-null and containing international characters - see ADIF V3 specs)
-                 APP_EQSL_SWL (tag only present if sender is SWL and then always Y)
-                 APP_EQSL_AG (tag only present if sender has Authenticity Guaranteed status and then always Y)
-                 GRIDSQUARE (tag only present if non-blank and at least 4 long)
-            */
-            // LF: Since I consider this source unreliable, I will not update it here, as I do with LoTW
-            // try to update contact from received QSL only in case when contact != Y
-            if ( originalRecord.value("eqsl_qsl_rcvd").toString() != 'Y' )
-            {
-                originalRecord.setValue("eqsl_qsl_rcvd", QSLRecord.value("qsl_sent"));
+        if ( !db.commit() )
+            qWarning() << "Cannot commit QSL import transaction" << db.lastError();
+    }
 
-                originalRecord.setValue("eqsl_qslrdate", QDateTime::currentDateTimeUtc().date().toString("yyyy-MM-dd"));
+    emit importPosition(inputPosition());
 
-                Gridsquare dxNewGrid(QSLRecord.value("gridsquare").toString());
+    this->importEnd();
 
-                if ( dxNewGrid.isValid()
-                     && ( originalRecord.value("gridsquare").toString().isEmpty()
-                          ||
-                          dxNewGrid.getGrid().contains(originalRecord.value("gridsquare").toString()))
-                     )
-                {
-                    Gridsquare myGrid(originalRecord.value("my_gridsquare").toString());
+    emit QSLMergeFinished(stats);
+}
 
-                    originalRecord.setValue("gridsquare", dxNewGrid.getGrid());
+QHash<qlonglong, QSqlRecord> LogFormat::loadQSLContacts(const QSet<qlonglong> &contactIDs)
+{
+    FCT_IDENTIFICATION;
 
-                    double distance;
+    qCDebug(function_parameters) << contactIDs.size();
 
-                    if ( myGrid.distanceTo(dxNewGrid, distance) )
-                    {
-                        originalRecord.setValue("distance", QVariant(distance));
-                    }
-                }
+    QHash<qlonglong, QSqlRecord> ret;
+    QSqlQuery query(QSqlDatabase::database(dbConnectionName));
+    QStringList ids;
 
-                const QString &prevValue = originalRecord.value("qslmsg_rcvd").toString();
-                const QString &newValue = QSLRecord.value("qslmsg").toString();
+    auto loadChunk = [&]()
+    {
+        if ( ids.isEmpty() )
+            return;
 
-                if ( !newValue.isEmpty() )
-                    originalRecord.setValue("qslmsg_rcvd", prevValue.isEmpty() ? "eQSL: " + newValue : prevValue + "| eQSL: " + newValue);
+        // IDs are integers; they can be put directly into the statement
+        if ( !query.exec(QString("SELECT * FROM contacts WHERE id IN (%1)").arg(ids.join(","))) )
+            qWarning() << "Cannot load matched contacts" << query.lastError();
 
-                // temporary removed - ADIF 3.1.5 has no INTL equivalent for qslmsg_rcvd
-                //originalRecord.setValue("qslmsg_int", QSLRecord.value("qslmsg_int"));
+        while ( query.next() )
+        {
+            const QSqlRecord &record = query.record();
+            ret.insert(record.value("id").toLongLong(), record);
+        }
+        ids.clear();
+    };
 
-                originalRecord.setValue("qsl_rcvd_via", QSLRecord.value("qsl_sent_via"));
+    for ( const qlonglong id : contactIDs )
+    {
+        ids << QString::number(id);
 
-                /*
-                 * It appears that the life cycle of EQSL_AQ field is not fully understood
-                 * at the moment. Unfortunately, even on the ADIF forum there are differing opinions,
-                 * but I have gained the impression that the only authority that knows the correct
-                 * value of EQSL_AG is eQSL itself. Therefore, I believe that the value received from eQSL
-                 * should always be set here, even though the field’s value may vary at the time the QSL is received.
-                 */
-                originalRecord.setValue("eqsl_ag", QSLRecord.value("eqsl_ag"));
+        if ( ids.size() >= 500 )
+            loadChunk();
+    }
+    loadChunk();
 
-                if ( !model.setRecord(0, originalRecord) )
-                {
-                    qWarning() << "Cannot update a Contact record - " << model.lastError();
-                    qCDebug(runtime) << originalRecord;
-                }
+    return ret;
+}
 
-                if ( !model.submitAll() )
-                {
-                    qWarning() << "Cannot commit changes to Contact Table - " << model.lastError();
-                }
-                const DxccStatus status = Data::instance()->dxccStatus(originalRecord.value("dxcc").toInt(), band.toString(), mode.toString());
-                stats.newQSLs.append(reportFormatter(start_time.toDateTime(), call.toString(), mode.toString(), {tr("DXCC State:") + " " + Data::statusToText(status)}));
-            }
+bool LogFormat::updateQSLContact(const QSqlRecord &before,
+                                 const QSqlRecord &after,
+                                 QHash<QString, QSqlQuery> &updateQueries)
+{
+    FCT_IDENTIFICATION;
 
-            break;
-        }
+    QStringList changedFields;
+
+    for ( int i = 0; i < after.count(); i++ )
+    {
+        const QString &fieldName = after.fieldName(i);
 
-        default:
-            qCDebug(runtime) << "Unknown QSL import";
+        if ( fieldName != QLatin1String("id") && after.value(i) != before.value(fieldName) )
+            changedFields << fieldName;
+    }
+
+    if ( changedFields.isEmpty() )
+        return true;
+
+    // the statement is prepared once for every set of changed fields
+    const QString signature = changedFields.join(",");
+    auto it = updateQueries.find(signature);
+
+    if ( it == updateQueries.end() )
+    {
+        QSqlQuery query(QSqlDatabase::database(dbConnectionName));
+        QStringList assignments;
+
+        for ( const QString &fieldName : static_cast<const QStringList&>(changedFields) )
+            assignments << fieldName + " = :" + fieldName;
+
+        if ( !query.prepare(QString("UPDATE contacts SET %1 WHERE id = :id").arg(assignments.join(", "))) )
+        {
+            qWarning() << "Cannot prepare Contact update statement" << query.lastError();
+            return false;
         }
+        it = updateQueries.insert(signature, query);
     }
 
-    emit importPosition(stream.pos());
+    QSqlQuery &query = it.value();
 
-    this->importEnd();
+    for ( const QString &fieldName : static_cast<const QStringList&>(changedFields) )
+        query.bindValue(":" + fieldName, after.value(fieldName));
+    query.bindValue(":id", after.value("id"));
 
-    emit QSLMergeFinished(stats);
+    if ( !query.exec() )
+    {
+        qWarning() << "Cannot update a Contact record - " << query.lastError();
+        return false;
+    }
+
+    return true;
 }
 
 long LogFormat::runExport()
@@ -1129,7 +1347,7 @@ long LogFormat::runExport()
 
     this->exportStart();
 
-    QSqlQuery query;
+    QSqlQuery query(QSqlDatabase::database(dbConnectionName));
 
     QString queryStmt = QString("SELECT %1 FROM contacts WHERE %2 ORDER BY start_time ASC").arg(exportedFields.join(", "), getWhereClause());
 
@@ -1158,7 +1376,7 @@ long LogFormat::runExport()
     query.first();
     query.previous();
 
-    while (query.next())
+    while ( !isCancelled() && query.next() )
     {
         this->exportContact(query.record());
         count++;
@@ -1183,6 +1401,9 @@ long LogFormat::runExport(const QList<QSqlRecord> &selectedQSOs)
     long count = 0L;
     for (const QSqlRecord &qso: selectedQSOs)
     {
+        if ( isCancelled() )
+            break;
+
         QSqlRecord contactRecord;
 
         if ( exportedFields.first() != "*" )
@@ -73,17 +73,26 @@ public:
     void setExportedFields(const QStringList& fieldsList);
     void setFillMissingDxcc(bool fillMissingDxcc);
     void setDuplicateQSOCallback(duplicateQSOBehaviour (*func)(QSqlRecord *, QSqlRecord *));
+    void setDatabaseConnection(const QString &connectionName);
+    void setImportBatchSize(int size);
+    void cancel();
+    bool isCancelled() const;
 
     virtual void importStart() {}
     virtual void importEnd() {}
     virtual bool importNext(QSqlRecord&) { return false; }
+    virtual qint64 inputPosition() { return stream.pos(); }
 
     virtual void exportStart() {}
     virtual void exportEnd() {}
     virtual void exportContact(const QSqlRecord&, QMap<QString, QString> * = nullptr) {}
 
+    static const int DEFAULT_IMPORT_BATCH_SIZE;
+    static const int QSL_IMPORT_BATCH_SIZE;
+
 signals:
     void importPosition(qint64 value);
+    void importProgress(qint64 position, qint64 processedRecords);
     void exportProgress(float value);
     void finished(int count);
     void QSLMergeFinished(QSLMergeStat stats);
@@ -105,6 +114,11 @@ private:
 
     QString importLogSeverityToString(ImportLogSeverity);
 
+    QHash<qlonglong, QSqlRecord> loadQSLContacts(const QSet<qlonglong> &contactIDs);
+    bool updateQSLContact(const QSqlRecord &before,
+                          const QSqlRecord &after,
+                          QHash<QString, QSqlQuery> &updateQueries);
+
     void writeImportLog(QTextStream& errorLogStream,
                         ImportLogSeverity severity,
                         const QString &msg);
@@ -124,7 +138,10 @@ private:
     bool filterStationProfileSet = false;
     QStringList whereClause;
     QStringList exportedFields;
-    QString userFilter;
+    QString userFilterWhereClause;
+    QString dbConnectionName;
+    int importBatchSize;
+    QAtomicInt cancelRequested;
     bool filterPOTAOnly = false;
     bool fillMissingDxcc = false;
     duplicateQSOBehaviour (*duplicateQSOFunc)(QSqlRecord *, QSqlRecord *);
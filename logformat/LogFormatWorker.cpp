@@ -0,0 +1,177 @@
+#include "LogFormatWorker.h"
+#include "core/debug.h"
+#include "core/LogDatabase.h"
+#include "data/Data.h"
+
+MODULE_IDENTIFICATION("qlog.logformat.logformatworker");
+
+LogFormatWorker::LogFormatWorker() :
+    QObject(nullptr),
+    ownerThread(QThread::currentThread()),
+    logFormat(nullptr),
+    job(NO_JOB),
+    useStationProfile(false)
+{
+    FCT_IDENTIFICATION;
+
+    connect(&workerThread, &QThread::started, this, &LogFormatWorker::run);
+}
+
+LogFormatWorker::~LogFormatWorker()
+{
+    FCT_IDENTIFICATION;
+
+    cancel();
+    workerThread.quit();
+    workerThread.wait();
+
+    delete logFormat;
+}
+
+bool LogFormatWorker::open(const QString &filename,
+                           const QString &formatType,
+                           QIODevice::OpenMode mode)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << filename << formatType << mode;
+
+    file.setFileName(filename);
+
+    if ( !file.open(mode) )
+    {
+        qWarning() << "Cannot open file" << filename << file.errorString();
+        return false;
+    }
+
+    stream.setDevice(&file);
+
+    logFormat = LogFormat::open(formatType, stream);
+
+    if ( !logFormat )
+    {
+        qCritical() << "unknown log format";
+        return false;
+    }
+
+    logFormat->setParent(this);
+    return true;
+}
+
+void LogFormatWorker::startImport(const StationProfile *defaultStationProfile)
+{
+    FCT_IDENTIFICATION;
+
+    useStationProfile = ( defaultStationProfile != nullptr );
+
+    if ( useStationProfile )
+        stationProfile = *defaultStationProfile;
+
+    start(IMPORT_JOB);
+}
+
+void LogFormatWorker::startExport()
+{
+    FCT_IDENTIFICATION;
+
+    start(EXPORT_JOB);
+}
+
+void LogFormatWorker::startExport(const QList<QSqlRecord> &records)
+{
+    FCT_IDENTIFICATION;
+
+    exportRecords = records;
+    start(EXPORT_RECORDS_JOB);
+}
+
+void LogFormatWorker::cancel()
+{
+    FCT_IDENTIFICATION;
+
+    if ( logFormat )
+        logFormat->cancel();
+}
+
+void LogFormatWorker::start(JobType type)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << type;
+
+    if ( !logFormat || workerThread.isRunning() )
+    {
+        qWarning() << "Worker is not ready";
+        return;
+    }
+
+    // everything that is lazily loaded over the default connection
+    // must be ready before the worker starts
+    Data::instance()->preparePrefixTries();
+
+    job = type;
+    moveToThread(&workerThread);
+    workerThread.start();
+}
+
+void LogFormatWorker::run()
+{
+    FCT_IDENTIFICATION;
+
+    const QString connectionName = QString("logformatworker_%1").arg(reinterpret_cast<quintptr>(this));
+    const bool dbConnected = LogDatabase::instance()->openThreadConnection(connectionName);
+
+    unsigned long count = 0L;
+    unsigned long warnings = 0L;
+    unsigned long errors = 0L;
+    long exportCount = 0L;
+    QString details;
+    const JobType finishedJob = job;
+
+    if ( !dbConnected )
+    {
+        qWarning() << "Cannot open DB Connection for import/export";
+        details = tr("Cannot open a database connection");
+        errors = 1;
+    }
+    else
+    {
+        logFormat->setDatabaseConnection(connectionName);
+
+        switch ( finishedJob )
+        {
+        case IMPORT_JOB:
+        {
+            QTextStream out(&details);
+            count = logFormat->runImport(out,
+                                         ( useStationProfile ) ? &stationProfile : nullptr,
+                                         &warnings,
+                                         &errors);
+        }
+            break;
+        case EXPORT_JOB:
+            exportCount = logFormat->runExport();
+            break;
+        case EXPORT_RECORDS_JOB:
+            exportCount = logFormat->runExport(exportRecords);
+            break;
+        default:
+            break;
+        }
+    }
+
+    stream.flush();
+    logFormat->setDatabaseConnection(QLatin1String(QSqlDatabase::defaultConnection));
+    LogDatabase::closeThreadConnection(connectionName);
+
+    const bool cancelled = logFormat->isCancelled();
+
+    job = NO_JOB;
+    moveToThread(ownerThread);
+    workerThread.quit();
+
+    if ( finishedJob == IMPORT_JOB )
+        emit importFinished(count, warnings, errors, details, cancelled);
+    else
+        emit exportFinished(exportCount, cancelled);
+}
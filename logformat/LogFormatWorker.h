@@ -0,0 +1,69 @@
+#ifndef QLOG_LOGFORMAT_LOGFORMATWORKER_H
+#define QLOG_LOGFORMAT_LOGFORMATWORKER_H
+
+#include <QObject>
+#include <QThread>
+#include <QFile>
+#include <QTextStream>
+#include <QSqlRecord>
+
+#include "LogFormat.h"
+#include "data/StationProfile.h"
+
+// Runs LogFormat import/export in a dedicated thread over its own
+// DB connection. The owner thread configures format(), starts the job
+// and waits for importFinished/exportFinished. When the job is done,
+// the worker moves itself back to the owner thread.
+class LogFormatWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    LogFormatWorker();
+    ~LogFormatWorker();
+
+    bool open(const QString &filename,
+              const QString &formatType,
+              QIODevice::OpenMode mode);
+    LogFormat *format() const { return logFormat; }
+    bool isRunning() const { return workerThread.isRunning(); }
+
+    void startImport(const StationProfile *defaultStationProfile);
+    void startExport();
+    void startExport(const QList<QSqlRecord> &records);
+    void cancel();
+
+signals:
+    void importFinished(unsigned long count,
+                        unsigned long warnings,
+                        unsigned long errors,
+                        const QString &details,
+                        bool cancelled);
+    void exportFinished(long count, bool cancelled);
+
+private slots:
+    void run();
+
+private:
+    enum JobType
+    {
+        NO_JOB,
+        IMPORT_JOB,
+        EXPORT_JOB,
+        EXPORT_RECORDS_JOB
+    };
+
+    void start(JobType type);
+
+    QThread workerThread;
+    QThread *ownerThread;
+    QFile file;
+    QTextStream stream;
+    LogFormat *logFormat;
+    JobType job;
+    StationProfile stationProfile;
+    bool useStationProfile;
+    QList<QSqlRecord> exportRecords;
+};
+
+#endif // QLOG_LOGFORMAT_LOGFORMATWORKER_H
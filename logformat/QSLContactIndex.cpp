@@ -0,0 +1,201 @@
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QTimeZone>
+
+#include "QSLContactIndex.h"
+#include "core/debug.h"
+
+MODULE_IDENTIFICATION("qlog.logformat.qslcontactindex");
+
+const qint64 QSLContactIndex::MATCH_WINDOW_SECS;
+const qlonglong QSLContactIndex::NO_MATCH;
+
+QSLContactIndex::QSLContactIndex(const QString &connectionName) :
+    connectionName(connectionName),
+    contactCount(0)
+{
+    FCT_IDENTIFICATION;
+}
+
+bool QSLContactIndex::load(const QDateTime &from, const QDateTime &to)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << from << to;
+
+    // start_time is compared as a string; a date prefix is lower than all
+    // times of the day regardless of the time format. One day is added on
+    // both sides to cover time zone offsets.
+    const QDate fromDate = from.toTimeZone(QTimeZone::utc()).date().addDays(-1);
+    const QDate toDate = to.toTimeZone(QTimeZone::utc()).date().addDays(2);
+
+    if ( !loadedFrom.isValid() )
+    {
+        if ( !loadRange(fromDate, toDate) )
+            return false;
+
+        loadedFrom = fromDate;
+        loadedTo = toDate;
+        return true;
+    }
+
+    if ( fromDate < loadedFrom )
+    {
+        if ( !loadRange(fromDate, loadedFrom) )
+            return false;
+        loadedFrom = fromDate;
+    }
+
+    if ( toDate > loadedTo )
+    {
+        if ( !loadRange(loadedTo, toDate) )
+            return false;
+        loadedTo = toDate;
+    }
+
+    return true;
+}
+
+void QSLContactIndex::addContact(qlonglong id,
+                                 const QString &callsign,
+                                 const QString &band,
+                                 const QString &satName,
+                                 const QString &mode,
+                                 const QString &modeGroup,
+                                 qint64 startTime)
+{
+    contacts[key(callsign, band.toUpper(), satName)].append(Entry{id, startTime, mode.toUpper(), modeGroup});
+    contactCount++;
+}
+
+void QSLContactIndex::clear()
+{
+    FCT_IDENTIFICATION;
+
+    contacts.clear();
+    loadedFrom = QDate();
+    loadedTo = QDate();
+    contactCount = 0;
+}
+
+qlonglong QSLContactIndex::matchMode(const QString &callsign,
+                                     const QString &band,
+                                     const QString &satName,
+                                     const QString &mode,
+                                     const QDateTime &startTime) const
+{
+    const QVector<Entry> *entries = candidates(callsign, band, satName);
+
+    if ( !entries )
+        return NO_MATCH;
+
+    const qint64 time = startTime.toSecsSinceEpoch();
+    const QString upperMode = mode.toUpper();
+    qlonglong ret = NO_MATCH;
+
+    for ( const Entry &entry : *entries )
+    {
+        if ( qAbs(entry.startTime - time) >= MATCH_WINDOW_SECS || entry.mode != upperMode )
+            continue;
+
+        // more than one contact - the QSL is ambiguous
+        if ( ret != NO_MATCH )
+            return NO_MATCH;
+
+        ret = entry.id;
+    }
+
+    return ret;
+}
+
+qlonglong QSLContactIndex::matchModeGroup(const QString &callsign,
+                                          const QString &band,
+                                          const QString &satName,
+                                          const QString &modeGroup,
+                                          const QDateTime &startTime) const
+{
+    const QVector<Entry> *entries = candidates(callsign, band, satName);
+
+    if ( !entries || modeGroup.isEmpty() )
+        return NO_MATCH;
+
+    const qint64 time = startTime.toSecsSinceEpoch();
+    qlonglong ret = NO_MATCH;
+
+    for ( const Entry &entry : *entries )
+    {
+        if ( qAbs(entry.startTime - time) >= MATCH_WINDOW_SECS || entry.modeGroup != modeGroup )
+            continue;
+
+        if ( ret != NO_MATCH )
+            return NO_MATCH;
+
+        ret = entry.id;
+    }
+
+    return ret;
+}
+
+bool QSLContactIndex::loadRange(const QDate &from, const QDate &to)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << from << to;
+
+    QSqlQuery query(QSqlDatabase::database(connectionName));
+
+    if ( !query.prepare("SELECT id, callsign, band, COALESCE(sat_name, ''), mode, "
+                        "       (SELECT dxcc FROM modes WHERE upper(name) = upper(contacts.mode) LIMIT 1), "
+                        "       strftime('%s', start_time) "
+                        "FROM contacts "
+                        "WHERE start_time >= :fromDate AND start_time < :toDate") )
+    {
+        qWarning() << "Cannot prepare QSL Contact Index statement" << query.lastError();
+        return false;
+    }
+
+    query.setForwardOnly(true);
+    query.bindValue(":fromDate", from.toString("yyyy-MM-dd"));
+    query.bindValue(":toDate", to.toString("yyyy-MM-dd"));
+
+    if ( !query.exec() )
+    {
+        qWarning() << "Cannot load QSL Contact Index" << query.lastError();
+        return false;
+    }
+
+    int loaded = 0;
+
+    while ( query.next() )
+    {
+        if ( query.value(6).isNull() )
+            continue;
+
+        addContact(query.value(0).toLongLong(),
+                   query.value(1).toString(),
+                   query.value(2).toString(),
+                   query.value(3).toString(),
+                   query.value(4).toString(),
+                   query.value(5).toString(),
+                   query.value(6).toLongLong());
+        loaded++;
+    }
+
+    qCDebug(runtime) << "Loaded" << loaded << "contacts";
+    return true;
+}
+
+const QVector<QSLContactIndex::Entry> *QSLContactIndex::candidates(const QString &callsign,
+                                                                   const QString &band,
+                                                                   const QString &satName) const
+{
+    // QSL values are compared as upper(value) with the stored callsign and satellite
+    const auto it = contacts.constFind(key(callsign.toUpper(), band.toUpper(), satName.toUpper()));
+
+    return ( it != contacts.constEnd() ) ? &it.value() : nullptr;
+}
+
+QString QSLContactIndex::key(const QString &callsign, const QString &band, const QString &satName)
+{
+    return callsign + QLatin1Char('\t') + band + QLatin1Char('\t') + satName;
+}
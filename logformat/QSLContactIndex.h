@@ -0,0 +1,72 @@
+#ifndef QLOG_LOGFORMAT_QSLCONTACTINDEX_H
+#define QLOG_LOGFORMAT_QSLCONTACTINDEX_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QDate>
+#include <QDateTime>
+#include <QSqlDatabase>
+
+// In-memory index of contacts used to match downloaded QSLs (LoTW/eQSL).
+// Contacts are loaded by date ranges in one query per range and they are
+// matched by the same rules as the original SQL filter:
+// callsign, band, satellite, start time within +/-30 minutes and
+// mode or DXCC mode group.
+class QSLContactIndex
+{
+public:
+    static const qint64 MATCH_WINDOW_SECS = 30 * 60;
+    static const qlonglong NO_MATCH = -1;
+
+    explicit QSLContactIndex(const QString &connectionName = QLatin1String(QSqlDatabase::defaultConnection));
+
+    // loads all contacts between from and to; already loaded days are not loaded again
+    bool load(const QDateTime &from, const QDateTime &to);
+
+    void addContact(qlonglong id,
+                    const QString &callsign,
+                    const QString &band,
+                    const QString &satName,
+                    const QString &mode,
+                    const QString &modeGroup,
+                    qint64 startTime);
+    void clear();
+
+    // returns the contact ID if exactly one contact matches, otherwise NO_MATCH
+    qlonglong matchMode(const QString &callsign,
+                        const QString &band,
+                        const QString &satName,
+                        const QString &mode,
+                        const QDateTime &startTime) const;
+    qlonglong matchModeGroup(const QString &callsign,
+                             const QString &band,
+                             const QString &satName,
+                             const QString &modeGroup,
+                             const QDateTime &startTime) const;
+
+    int size() const { return contactCount; }
+
+private:
+    struct Entry
+    {
+        qlonglong id;
+        qint64 startTime;
+        QString mode;
+        QString modeGroup;
+    };
+
+    bool loadRange(const QDate &from, const QDate &to);
+    const QVector<Entry> *candidates(const QString &callsign,
+                                     const QString &band,
+                                     const QString &satName) const;
+    static QString key(const QString &callsign, const QString &band, const QString &satName);
+
+    QString connectionName;
+    QHash<QString, QVector<Entry>> contacts;
+    QDate loadedFrom;
+    QDate loadedTo; // exclusive
+    int contactCount;
+};
+
+#endif // QLOG_LOGFORMAT_QSLCONTACTINDEX_H
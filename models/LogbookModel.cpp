@@ -6,6 +6,7 @@
 #include "data/BandPlan.h"
 
 #include <QIcon>
+#include <QHash>
 
 LogbookModel::LogbookModel(QObject* parent, QSqlDatabase db)
         : QSqlTableModel(parent, db)
@@ -16,6 +17,15 @@ LogbookModel::LogbookModel(QObject* parent, QSqlDatabase db)
 
     for (auto it = fieldNameTranslationMap.begin(); it != fieldNameTranslationMap.end(); ++it)
         setHeaderData(it.key(), Qt::Horizontal, getFieldNameTranslation(it.key()));
+
+    callToolTipCache.setMaxCost(TOOLTIP_CACHE_SIZE);
+
+    // cached row tooltips are valid only for the current content of the model
+    connect(this, &LogbookModel::modelReset, this, &LogbookModel::clearRowCache);
+    connect(this, &LogbookModel::layoutChanged, this, &LogbookModel::clearRowCache);
+    connect(this, &LogbookModel::rowsInserted, this, &LogbookModel::clearRowCache);
+    connect(this, &LogbookModel::rowsRemoved, this, &LogbookModel::clearRowCache);
+    connect(this, &LogbookModel::dataChanged, this, &LogbookModel::clearRowCache);
 }
 
 QVariant LogbookModel::data(const QModelIndex &index, int role) const
@@ -24,10 +34,7 @@ QVariant LogbookModel::data(const QModelIndex &index, int role) const
         return QVariant();
 
     if (role == Qt::DecorationRole && index.column() == COLUMN_CALL) {
-        const QString &flag = Data::instance()->dxccFlag(QSqlTableModel::data(this->index(index.row(), COLUMN_DXCC), Qt::DisplayRole).toInt());
-
-        return ( !flag.isEmpty() ) ? QIcon(QString(":/flags/16/%1.png").arg(flag))
-                                   : QIcon(":/flags/16/unknown.png");
+        return flagIcon(QSqlTableModel::data(this->index(index.row(), COLUMN_DXCC), Qt::DisplayRole).toInt());
     }
 
     if (role == Qt::DecorationRole && (index.column() == COLUMN_QSL_RCVD || index.column() == COLUMN_QSL_SENT ||
@@ -37,7 +44,7 @@ QVariant LogbookModel::data(const QModelIndex &index, int role) const
     {
         QVariant value = QSqlTableModel::data(index, Qt::DisplayRole);
         if (value.toString() == "Y") {
-            return QIcon(":/icons/done-24px.svg");
+            return resourceIcon(":/icons/done-24px.svg");
         }
 //        else {
 //            return QIcon(":/icons/close-24px.svg");
@@ -46,78 +53,15 @@ QVariant LogbookModel::data(const QModelIndex &index, int role) const
 
     if ( role == Qt::ToolTipRole && index.column() == COLUMN_CALL )
     {
-        QString flag = Data::instance()->dxccFlag(QSqlTableModel::data(this->index(index.row(), COLUMN_DXCC), Qt::DisplayRole).toInt());
-
-        return QString("<img src=':/flags/64/%1.png'>").arg(flag) +
-               "<h2>" + QSqlTableModel::data(index, Qt::DisplayRole).toString() + "</h2>   " +
-               "<table>" +
-                " <tr>" +
-                "   <td><b>" + tr("Country") + ": </b></td>" +
-                "   <td>" + QCoreApplication::translate("DBStrings", QSqlTableModel::data(this->index(index.row(), COLUMN_COUNTRY), Qt::DisplayRole).toString().toUtf8().constData()) + "</td>" +
-                " </tr>" +
-               " <tr>" +
-               "   <td><b>" + tr("Band") + ": </b></td>" +
-               "   <td>" + QSqlTableModel::data(this->index(index.row(), COLUMN_BAND), Qt::DisplayRole).toString() + "</td>" +
-               " </tr>" +
-               " <tr>" +
-                "   <td><b>" + tr("Mode") + ": </b></td>" +
-                "   <td>" + QSqlTableModel::data(this->index(index.row(), COLUMN_MODE), Qt::DisplayRole).toString() + "</td>" +
-                " </tr>" +
-                " <tr>" +
-                "   <td><b>" + tr("RST Sent") + ": </b></td>" +
-                "   <td>" + QSqlTableModel::data(this->index(index.row(), COLUMN_RST_SENT), Qt::DisplayRole).toString() + "</td>" +
-                " </tr>" +
-                " <tr>" +
-                "   <td><b>" + tr("RST Rcvd") + ": </b></td>" +
-                "   <td>" + QSqlTableModel::data(this->index(index.row(), COLUMN_RST_RCVD), Qt::DisplayRole).toString() + "</td>" +
-                " </tr>" +
-                " <tr>" +
-                "   <td><b>" + tr("Gridsquare") + ": </b></td>" +
-                "   <td>" + QSqlTableModel::data(this->index(index.row(), COLUMN_GRID), Qt::DisplayRole).toString() + "</td>" +
-                " </tr>" +
-                " <tr>" +
-                "   <td><b>" + tr("QSL Message") + ": </b></td>" +
-                "   <td>" + QSqlTableModel::data(this->index(index.row(), COLUMN_QSLMSG), Qt::DisplayRole).toString() + "</td>" +
-                " </tr>" +
-                " <tr>" +
-                "   <td><b>" + tr("Comment") + ": </b></td>" +
-                "   <td>" + QSqlTableModel::data(this->index(index.row(), COLUMN_COMMENT_INTL), Qt::DisplayRole).toString() + "</td>" +
-                " </tr>" +
-                " <tr>" +
-                "   <td><b>" + tr("Notes") + ": </b></td>" +
-                "   <td>" + QSqlTableModel::data(this->index(index.row(), COLUMN_NOTES_INTL), Qt::DisplayRole).toString() + "</td>" +
-                " </tr>" +
-               "</table>" +
-               "<br>" +
-               "<table>" +
-               "  <tr> " +
-               "  <th></th><th>" + tr("Paper") + "</th><th>" + tr("LoTW") +"</th><th>" + tr("eQSL") +"</th>" +
-               "  </tr>" +
-               "  <tr> " +
-               "  <td><b>" + tr("QSL Received") + "</b></td>" +
-               QString("  <td><img src=':/icons/%1-24px.svg'></td>").arg((QSqlTableModel::data(this->index(index.row(),
-                                                                                                           COLUMN_QSL_RCVD),
-                                                                                               Qt::DisplayRole).toString() == "Y") ? "done" : "close") +
-               QString("  <td><img src=':/icons/%1-24px.svg'></td>").arg((QSqlTableModel::data(this->index(index.row(),
-                                                                                                           COLUMN_LOTW_RCVD),
-                                                                                               Qt::DisplayRole).toString() == "Y") ? "done" : "close") +
-               QString("  <td><img src=':/icons/%1-24px.svg'></td>").arg((QSqlTableModel::data(this->index(index.row(),
-                                                                                                           COLUMN_EQSL_QSL_RCVD),
-                                                                                               Qt::DisplayRole).toString() == "Y") ? "done" : "close") +
-                "  </tr> " +
-                "  <tr> " +
-                "  <td><b>" + tr("QSL Sent") + "</b></td>" +
-                QString("  <td><img src=':/icons/%1-24px.svg'></td>").arg((QSqlTableModel::data(this->index(index.row(),
-                                                                                                            COLUMN_QSL_SENT),
-                                                                                                Qt::DisplayRole).toString() == "Y") ? "done" : "close") +
-                QString("  <td><img src=':/icons/%1-24px.svg'></td>").arg((QSqlTableModel::data(this->index(index.row(),
-                                                                                                            COLUMN_LOTW_SENT),
-                                                                                                Qt::DisplayRole).toString() == "Y") ? "done" : "close") +
-                QString("  <td><img src=':/icons/%1-24px.svg'></td>").arg((QSqlTableModel::data(this->index(index.row(),
-                                                                                                            COLUMN_EQSL_QSL_SENT),
-                                                                                                Qt::DisplayRole).toString() == "Y") ? "done" : "close") +
-                "  </tr> " +
-               "</table>";
+        // the tooltip is built only when it is requested and it is kept for the row
+        const QString *cachedToolTip = callToolTipCache.object(index.row());
+
+        if ( cachedToolTip )
+            return *cachedToolTip;
+
+        const QString &toolTip = callToolTip(index.row());
+        callToolTipCache.insert(index.row(), new QString(toolTip));
+        return toolTip;
     }
     else if ( role == Qt::ToolTipRole && (index.column() == COLUMN_FIELDS
                                           || index.column() == COLUMN_NOTES
@@ -134,6 +78,116 @@ QVariant LogbookModel::data(const QModelIndex &index, int role) const
     return QSqlTableModel::data(index, role);
 }
 
+QString LogbookModel::callToolTip(int row) const
+{
+    auto value = [&](int column)
+    {
+        return QSqlTableModel::data(this->index(row, column), Qt::DisplayRole).toString();
+    };
+
+    auto qslIcon = [&](int column)
+    {
+        return QString("  <td><img src=':/icons/%1-24px.svg'></td>").arg((value(column) == "Y") ? "done" : "close");
+    };
+
+    QString flag = Data::instance()->dxccFlag(value(COLUMN_DXCC).toInt());
+
+    return QString("<img src=':/flags/64/%1.png'>").arg(flag) +
+           "<h2>" + value(COLUMN_CALL) + "</h2>   " +
+           "<table>" +
+            " <tr>" +
+            "   <td><b>" + tr("Country") + ": </b></td>" +
+            "   <td>" + QCoreApplication::translate("DBStrings", value(COLUMN_COUNTRY).toUtf8().constData()) + "</td>" +
+            " </tr>" +
+           " <tr>" +
+           "   <td><b>" + tr("Band") + ": </b></td>" +
+           "   <td>" + value(COLUMN_BAND) + "</td>" +
+           " </tr>" +
+           " <tr>" +
+            "   <td><b>" + tr("Mode") + ": </b></td>" +
+            "   <td>" + value(COLUMN_MODE) + "</td>" +
+            " </tr>" +
+            " <tr>" +
+            "   <td><b>" + tr("RST Sent") + ": </b></td>" +
+            "   <td>" + value(COLUMN_RST_SENT) + "</td>" +
+            " </tr>" +
+            " <tr>" +
+            "   <td><b>" + tr("RST Rcvd") + ": </b></td>" +
+            "   <td>" + value(COLUMN_RST_RCVD) + "</td>" +
+            " </tr>" +
+            " <tr>" +
+            "   <td><b>" + tr("Gridsquare") + ": </b></td>" +
+            "   <td>" + value(COLUMN_GRID) + "</td>" +
+            " </tr>" +
+            " <tr>" +
+            "   <td><b>" + tr("QSL Message") + ": </b></td>" +
+            "   <td>" + value(COLUMN_QSLMSG) + "</td>" +
+            " </tr>" +
+            " <tr>" +
+            "   <td><b>" + tr("Comment") + ": </b></td>" +
+            "   <td>" + value(COLUMN_COMMENT_INTL) + "</td>" +
+            " </tr>" +
+            " <tr>" +
+            "   <td><b>" + tr("Notes") + ": </b></td>" +
+            "   <td>" + value(COLUMN_NOTES_INTL) + "</td>" +
+            " </tr>" +
+           "</table>" +
+           "<br>" +
+           "<table>" +
+           "  <tr> " +
+           "  <th></th><th>" + tr("Paper") + "</th><th>" + tr("LoTW") +"</th><th>" + tr("eQSL") +"</th>" +
+           "  </tr>" +
+           "  <tr> " +
+           "  <td><b>" + tr("QSL Received") + "</b></td>" +
+           qslIcon(COLUMN_QSL_RCVD) +
+           qslIcon(COLUMN_LOTW_RCVD) +
+           qslIcon(COLUMN_EQSL_QSL_RCVD) +
+            "  </tr> " +
+            "  <tr> " +
+            "  <td><b>" + tr("QSL Sent") + "</b></td>" +
+            qslIcon(COLUMN_QSL_SENT) +
+            qslIcon(COLUMN_LOTW_SENT) +
+            qslIcon(COLUMN_EQSL_QSL_SENT) +
+            "  </tr> " +
+           "</table>";
+}
+
+void LogbookModel::clearRowCache()
+{
+    callToolTipCache.clear();
+}
+
+const QIcon &LogbookModel::resourceIcon(const QString &path)
+{
+    // QIcon created from a file decodes the image again for every new instance;
+    // icons are shared by all models (GUI thread only)
+    static QHash<QString, QIcon> icons;
+
+    auto it = icons.find(path);
+
+    if ( it == icons.end() )
+        it = icons.insert(path, QIcon(path));
+
+    return it.value();
+}
+
+const QIcon &LogbookModel::flagIcon(int dxcc)
+{
+    static QHash<int, QIcon> flags;
+
+    auto it = flags.find(dxcc);
+
+    if ( it == flags.end() )
+    {
+        const QString &flag = Data::instance()->dxccFlag(dxcc);
+
+        it = flags.insert(dxcc, ( !flag.isEmpty() ) ? resourceIcon(QString(":/flags/16/%1.png").arg(flag))
+                                                     : resourceIcon(":/flags/16/unknown.png"));
+    }
+
+    return it.value();
+}
+
 bool LogbookModel::setData(const QModelIndex &index, const QVariant &value, int role)
 {
     bool main_update_result = true;
@@ -3,6 +3,8 @@
 
 #include <QObject>
 #include <QSqlTableModel>
+#include <QCache>
+#include <QIcon>
 
 class LogbookModel : public QSqlTableModel
 {
@@ -202,7 +204,17 @@ public:
         COLUMN_LAST_ELEMENT = 181
     };
 
+private slots:
+    void clearRowCache();
+
 private:
+    static const int TOOLTIP_CACHE_SIZE = 256;
+
+    QString callToolTip(int row) const;
+    static const QIcon &resourceIcon(const QString &path);
+    static const QIcon &flagIcon(int dxcc);
+
+    mutable QCache<int, QString> callToolTipCache;
     static QMap<LogbookModel::ColumnID, QString> fieldNameTranslationMap;
 
 public:
@@ -0,0 +1 @@
+CREATE INDEX IF NOT EXISTS contacts_callsign_start_time_idx ON contacts (callsign, start_time);
@@ -0,0 +1 @@
+ALTER TABLE contacts_qsl_cards ADD COLUMN data_hash TEXT;
@@ -0,0 +1,5 @@
+DROP TRIGGER IF EXISTS insert_contacts_autovalue;
+DROP TRIGGER IF EXISTS update_callsign_contacts_autovalue;
+DROP TRIGGER IF EXISTS contacts_club_progress_insert;
+DROP TRIGGER IF EXISTS contacts_club_progress_delete;
+DROP TRIGGER IF EXISTS contacts_club_progress_update;
@@ -0,0 +1,13 @@
+QT += testlib core
+CONFIG += console testcase c++11
+TEMPLATE = app
+TARGET = tst_adiftokenizer
+
+INCLUDEPATH += $$PWD/../..
+
+SOURCES += \
+    tst_adiftokenizer.cpp \
+    ../../logformat/AdifTokenizer.cpp
+
+HEADERS += \
+    ../../logformat/AdifTokenizer.h
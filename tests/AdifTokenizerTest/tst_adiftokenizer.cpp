@@ -0,0 +1,220 @@
+#include <QtTest>
+
+#include "logformat/AdifTokenizer.h"
+
+namespace {
+QString fieldName(const AdifTokenizer::Field &field)
+{
+    return QString::fromLatin1(field.name, field.nameLength);
+}
+
+QString fieldValue(const AdifTokenizer::Field &field)
+{
+    return QString::fromLatin1(field.value, field.valueLength);
+}
+
+QByteArray generateLog(int records)
+{
+    QByteArray ret("### QLog ADIF Export\n"
+                   "<ADIF_VER:5>3.1.4\n"
+                   "<PROGRAMID:4>QLog\n"
+                   "<EOH>\n\n");
+
+    for ( int i = 0; i < records; i++ )
+    {
+        const QByteArray call = "OK" + QByteArray::number(i % 10) + "A" + QByteArray::number(i);
+        ret += "<call:" + QByteArray::number(call.size()) + ">" + call + "\n"
+               "<qso_date:8>20230101\n"
+               "<time_on:6>132300\n"
+               "<band:3>40m\n"
+               "<mode:2>CW\n"
+               "<freq:8>7.012000\n"
+               "<rst_sent:3>599\n"
+               "<rst_rcvd:3>599\n"
+               "<gridsquare:6>JN79FX\n"
+               "<name:11>Test Person\n"
+               "<qth:6>Prague\n"
+               "<comment:22>Generated test record\n"
+               "<eor>\n\n";
+    }
+    return ret;
+}
+}
+
+class AdifTokenizerTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void headerIsSkipped();
+    void noHeader();
+    void valueContainsTagCharacters();
+    void dataType();
+    void truncatedValue();
+    void emptyAndWhitespace();
+    void nameEquals();
+    void position();
+    void utf8StringStream();
+    void throughput_benchmark();
+};
+
+void AdifTokenizerTest::headerIsSkipped()
+{
+    const QByteArray data("Header text <ADIF_VER:5>3.1.4 <EOH>\n<CALL:6>OK1ABC<EOR>");
+    AdifTokenizer tokenizer(data.constData(), data.size());
+    AdifTokenizer::Field field;
+
+    QVERIFY(tokenizer.nextField(field));
+    QCOMPARE(fieldName(field), QString("CALL"));
+    QCOMPARE(fieldValue(field), QString("OK1ABC"));
+
+    QVERIFY(tokenizer.nextField(field));
+    QVERIFY(field.nameEquals("eor"));
+    QCOMPARE(field.valueLength, 0);
+
+    QVERIFY(!tokenizer.nextField(field));
+}
+
+void AdifTokenizerTest::noHeader()
+{
+    const QByteArray data("<call:6>OK1ABC<band:3>20m<eor>");
+    AdifTokenizer tokenizer(data.constData(), data.size());
+    AdifTokenizer::Field field;
+
+    QVERIFY(tokenizer.nextField(field));
+    QCOMPARE(fieldName(field), QString("call"));
+    QVERIFY(tokenizer.nextField(field));
+    QCOMPARE(fieldName(field), QString("band"));
+    QCOMPARE(fieldValue(field), QString("20m"));
+    QVERIFY(tokenizer.nextField(field));
+    QVERIFY(field.nameEquals("eor"));
+    QVERIFY(!tokenizer.nextField(field));
+}
+
+void AdifTokenizerTest::valueContainsTagCharacters()
+{
+    const QByteArray data("<comment:9>a<b>:c<d>e<eor>");
+    AdifTokenizer tokenizer(data.constData(), data.size());
+    AdifTokenizer::Field field;
+
+    QVERIFY(tokenizer.nextField(field));
+    QCOMPARE(fieldValue(field), QString("a<b>:c<d>"));
+    QVERIFY(tokenizer.nextField(field));
+    QVERIFY(field.nameEquals("eor"));
+}
+
+void AdifTokenizerTest::dataType()
+{
+    const QByteArray data("<freq:6:N>14.074<eor>");
+    AdifTokenizer tokenizer(data.constData(), data.size());
+    AdifTokenizer::Field field;
+
+    QVERIFY(tokenizer.nextField(field));
+    QCOMPARE(fieldName(field), QString("freq"));
+    QCOMPARE(QString::fromLatin1(field.type, field.typeLength), QString("N"));
+    QCOMPARE(fieldValue(field), QString("14.074"));
+}
+
+void AdifTokenizerTest::truncatedValue()
+{
+    const QByteArray data("<call:20>OK1ABC");
+    AdifTokenizer tokenizer(data.constData(), data.size());
+    AdifTokenizer::Field field;
+
+    QVERIFY(tokenizer.nextField(field));
+    QCOMPARE(fieldValue(field), QString("OK1ABC"));
+    QVERIFY(!tokenizer.nextField(field));
+    QCOMPARE(tokenizer.position(), tokenizer.size());
+}
+
+void AdifTokenizerTest::emptyAndWhitespace()
+{
+    AdifTokenizer emptyTokenizer;
+    AdifTokenizer::Field field;
+
+    QVERIFY(!emptyTokenizer.nextField(field));
+
+    const QByteArray data("<call:0><\n band :3>40m<eor>");
+    AdifTokenizer tokenizer(data.constData(), data.size());
+
+    QVERIFY(tokenizer.nextField(field));
+    QCOMPARE(field.valueLength, 0);
+    QVERIFY(tokenizer.nextField(field));
+    QCOMPARE(fieldName(field), QString("band"));
+    QCOMPARE(fieldValue(field), QString("40m"));
+}
+
+void AdifTokenizerTest::nameEquals()
+{
+    const QByteArray data("<EoR>");
+    AdifTokenizer tokenizer(data.constData(), data.size());
+    AdifTokenizer::Field field;
+
+    QVERIFY(tokenizer.nextField(field));
+    QVERIFY(field.nameEquals("eor"));
+    QVERIFY(!field.nameEquals("eo"));
+    QVERIFY(!field.nameEquals("eorx"));
+}
+
+void AdifTokenizerTest::position()
+{
+    const QByteArray data("<call:6>OK1ABC<eor>");
+    AdifTokenizer tokenizer(data.constData(), data.size());
+    AdifTokenizer::Field field;
+
+    QCOMPARE(tokenizer.position(), 0);
+    QVERIFY(tokenizer.nextField(field));
+    QCOMPARE(tokenizer.position(), 14);
+}
+
+void AdifTokenizerTest::utf8StringStream()
+{
+    const QString name = QString::fromUtf8("Jiří Šťastný");
+    const QString comment = QString::fromUtf8("73 de Zdeněk \u65e5\u672c \U0001F4FB!");
+    QString adif = QString("<NAME:%1>%2<COMMENT:%3>%4<CALL:6>OK1ABC<EOR>")
+                           .arg(name.length()).arg(name)
+                           .arg(comment.length()).arg(comment);
+
+    // the same way as AdiFormat reads a stream without a device
+    QTextStream stream(&adif);
+    const QByteArray data = stream.readAll().toUtf8();
+    AdifTokenizer tokenizer(data.constData(), data.size(), true);
+    AdifTokenizer::Field field;
+
+    QVERIFY(tokenizer.nextField(field));
+    QCOMPARE(fieldName(field), QString("NAME"));
+    QCOMPARE(QString::fromUtf8(field.value, field.valueLength), name);
+
+    QVERIFY(tokenizer.nextField(field));
+    QCOMPARE(fieldName(field), QString("COMMENT"));
+    QCOMPARE(QString::fromUtf8(field.value, field.valueLength), comment);
+
+    QVERIFY(tokenizer.nextField(field));
+    QCOMPARE(fieldValue(field), QString("OK1ABC"));
+    QVERIFY(tokenizer.nextField(field));
+    QVERIFY(field.nameEquals("eor"));
+    QVERIFY(!tokenizer.nextField(field));
+}
+
+void AdifTokenizerTest::throughput_benchmark()
+{
+    const QByteArray data = generateLog(10000);
+
+    QBENCHMARK
+    {
+        AdifTokenizer tokenizer(data.constData(), data.size());
+        AdifTokenizer::Field field;
+        int records = 0;
+
+        while ( tokenizer.nextField(field) )
+        {
+            if ( field.nameEquals("eor") )
+                records++;
+        }
+        QCOMPARE(records, 10000);
+    }
+}
+
+QTEST_APPLESS_MAIN(AdifTokenizerTest)
+
+#include "tst_adiftokenizer.moc"
@@ -1,6 +1,7 @@
 #include <QtTest>
 #include <QLoggingCategory>
 #include <memory>
+#include <vector>
 
 #define private public
 #include "core/AlertEvaluator.h"
@@ -193,6 +194,82 @@ DxSpot makeDxSpot(const DxSpotSpec &spec)
     }
     return spot;
 }
+
+const QStringList benchmarkBands = {"160m", "80m", "40m", "30m", "20m", "17m", "15m", "12m", "10m", "6m", "2m"};
+const QStringList benchmarkModes = {"CW", "PHONE", "DIGITAL", "FTx"};
+const QStringList benchmarkContinents = {"EU", "NA", "SA", "AF", "AS", "OC", "AN"};
+
+// a rule set similar to a heavily used installation
+std::vector<std::unique_ptr<AlertRule>> makeBenchmarkRules(int count)
+{
+    std::vector<std::unique_ptr<AlertRule>> rules;
+
+    for ( int i = 0; i < count; i++ )
+    {
+        RuleSpec spec;
+
+        spec.dxLogStatusMap = DxccStatus::All;
+        if ( i % 3 == 0 ) spec.band = "|" + benchmarkBands.at(i % benchmarkBands.size())
+                                      + "|" + benchmarkBands.at((i + 3) % benchmarkBands.size());
+        if ( i % 4 == 0 ) spec.mode = "|" + benchmarkModes.at(i % benchmarkModes.size());
+        if ( i % 5 == 0 ) spec.dxContinent = "|" + benchmarkContinents.at(i % benchmarkContinents.size());
+        if ( i % 2 == 0 ) spec.dxCountry = 1 + (i % 40);
+        if ( i % 7 == 0 ) spec.dxLogStatusMap = DxccStatus::NewEntity | DxccStatus::NewBand;
+        if ( i % 11 == 0 ) spec.dxMember = QStringList{"LOTW", "DOK"};
+        if ( i % 6 == 0 ) spec.callsignRe = QString("^OK%1").arg(i % 10);
+        if ( i % 9 == 0 ) spec.commentRe = "CQ|UP";
+
+        std::unique_ptr<AlertRule> rule = makeRule(spec, SpotAlert::DXSPOT | SpotAlert::WSJTXCQSPOT);
+        rule->ruleName = QString("rule%1").arg(i);
+        rules.push_back(std::move(rule));
+    }
+    return rules;
+}
+
+QList<DxSpot> makeBenchmarkSpots(int count)
+{
+    QList<DxSpot> spots;
+
+    for ( int i = 0; i < count; i++ )
+    {
+        DxSpotSpec spec;
+
+        spec.callsign = QString("OK%1ABC").arg(i % 10);
+        spec.comment = ( i % 3 ) ? "TNX QSO" : "CQ CQ UP 2";
+        spec.band = benchmarkBands.at(i % benchmarkBands.size());
+        spec.modeGroupString = benchmarkModes.at((i / 3) % benchmarkModes.size());
+        spec.dxcc = 1 + (i % 300);
+        spec.cont = benchmarkContinents.at(i % benchmarkContinents.size());
+        spec.status = 1 << (i % 7);
+        if ( i % 13 == 0 ) spec.members = QStringList{"DOK"};
+        spots << makeDxSpot(spec);
+    }
+    return spots;
+}
+
+QStringList matchRules(const std::vector<std::unique_ptr<AlertRule>> &rules, const DxSpot &spot)
+{
+    QStringList ret;
+
+    for ( const std::unique_ptr<AlertRule> &rule : rules )
+    {
+        if ( rule->match(spot) )
+            ret << rule->ruleName;
+    }
+    return ret;
+}
+
+AlertRuleMatcher makeMatcher(const std::vector<std::unique_ptr<AlertRule>> &rules)
+{
+    QList<AlertRule *> ruleList;
+
+    for ( const std::unique_ptr<AlertRule> &rule : rules )
+        ruleList << rule.get();
+
+    AlertRuleMatcher matcher;
+    matcher.compile(ruleList);
+    return matcher;
+}
 }
 
 class AlertEvaluatorTest : public QObject
@@ -209,6 +286,16 @@ private slots:
     void cross_valid();
     void cross_valid2_data();
     void cross_valid2();
+    void compiled_match_wsjtx_data();
+    void compiled_match_wsjtx();
+    void compiled_match_dxspot_data();
+    void compiled_match_dxspot();
+    void compiled_cross_valid_data();
+    void compiled_cross_valid();
+    void compiled_rule_order();
+    void compiled_band_token();
+    void match_benchmark_data();
+    void match_benchmark();
 };
 
 void AlertEvaluatorTest::initTestCase()
@@ -1309,6 +1396,147 @@ void AlertEvaluatorTest::cross_valid2()
     QCOMPARE(alertRule->match(spot), expected);
 }
 
+void AlertEvaluatorTest::compiled_match_wsjtx_data()
+{
+    match_wsjtx_data();
+}
+
+void AlertEvaluatorTest::compiled_match_wsjtx()
+{
+    QFETCH(RuleSpec, rule);
+    QFETCH(WsjtxSpec, input);
+    QFETCH(bool, expected);
+
+    auto alertRule = makeRule(rule, SpotAlert::WSJTXCQSPOT);
+    AlertRuleMatcher matcher;
+    matcher.compile({alertRule.get()});
+
+    QCOMPARE(!matcher.match(makeWsjtxEntry(input)).isEmpty(), expected);
+}
+
+void AlertEvaluatorTest::compiled_match_dxspot_data()
+{
+    match_dxspot_data();
+}
+
+void AlertEvaluatorTest::compiled_match_dxspot()
+{
+    QFETCH(RuleSpec, rule);
+    QFETCH(DxSpotSpec, input);
+    QFETCH(bool, expected);
+
+    auto alertRule = makeRule(rule, SpotAlert::DXSPOT);
+    AlertRuleMatcher matcher;
+    matcher.compile({alertRule.get()});
+
+    QCOMPARE(!matcher.match(makeDxSpot(input)).isEmpty(), expected);
+}
+
+void AlertEvaluatorTest::compiled_cross_valid_data()
+{
+    cross_valid_data();
+}
+
+void AlertEvaluatorTest::compiled_cross_valid()
+{
+    QFETCH(RuleSpec, rule);
+    QFETCH(DxSpotSpec, input);
+    QFETCH(bool, expected);
+
+    auto alertRule = makeRule(rule, SpotAlert::WSJTXCQSPOT);
+    AlertRuleMatcher matcher;
+    matcher.compile({alertRule.get()});
+
+    QCOMPARE(!matcher.match(makeDxSpot(input)).isEmpty(), expected);
+    QVERIFY(matcher.match(makeWsjtxEntry(WsjtxSpec())).size() == 1);
+}
+
+void AlertEvaluatorTest::compiled_rule_order()
+{
+    // rules with and without DXCC have to be reported in the rule order
+    RuleSpec anyCountry;
+    RuleSpec country;
+    country.dxCountry = 123;
+
+    auto rule1 = makeRule(country, SpotAlert::DXSPOT);
+    auto rule2 = makeRule(anyCountry, SpotAlert::DXSPOT);
+    auto rule3 = makeRule(country, SpotAlert::DXSPOT);
+    auto rule4 = makeRule(anyCountry, SpotAlert::DXSPOT);
+    rule1->ruleName = "rule1";
+    rule2->ruleName = "rule2";
+    rule3->ruleName = "rule3";
+    rule4->ruleName = "rule4";
+
+    AlertRuleMatcher matcher;
+    matcher.compile({rule1.get(), rule2.get(), rule3.get(), rule4.get()});
+
+    QCOMPARE(matcher.ruleCount(), 4);
+    QCOMPARE(matcher.match(makeDxSpot(DxSpotSpec())),
+             QStringList({"rule1", "rule2", "rule3", "rule4"}));
+
+    DxSpotSpec otherCountry;
+    otherCountry.dxcc = 124;
+    QCOMPARE(matcher.match(makeDxSpot(otherCountry)), QStringList({"rule2", "rule4"}));
+
+    matcher.clear();
+    QCOMPARE(matcher.ruleCount(), 0);
+    QVERIFY(matcher.match(makeDxSpot(DxSpotSpec())).isEmpty());
+}
+
+void AlertEvaluatorTest::compiled_band_token()
+{
+    // band values are compared as whole values
+    RuleSpec rule;
+    rule.band = "|2mm|6m";
+
+    auto alertRule = makeRule(rule, SpotAlert::DXSPOT);
+    AlertRuleMatcher matcher;
+    matcher.compile({alertRule.get()});
+
+    DxSpotSpec in;
+    in.band = "6m";
+    QCOMPARE(matcher.match(makeDxSpot(in)).size(), 1);
+    in.band = "2mm";
+    QCOMPARE(matcher.match(makeDxSpot(in)).size(), 1);
+    in.band = "2m";
+    QVERIFY(matcher.match(makeDxSpot(in)).isEmpty());
+}
+
+void AlertEvaluatorTest::match_benchmark_data()
+{
+    QTest::addColumn<bool>("compiled");
+
+    QTest::newRow("rules") << false;
+    QTest::newRow("compiled") << true;
+}
+
+void AlertEvaluatorTest::match_benchmark()
+{
+    QFETCH(bool, compiled);
+
+    const std::vector<std::unique_ptr<AlertRule>> rules = makeBenchmarkRules(120);
+    const QList<DxSpot> spots = makeBenchmarkSpots(1000);
+    const AlertRuleMatcher matcher = makeMatcher(rules);
+    int matched = 0;
+
+    if ( compiled )
+    {
+        QBENCHMARK
+        {
+            for ( const DxSpot &spot : spots )
+                matched += matcher.match(spot).size();
+        }
+    }
+    else
+    {
+        QBENCHMARK
+        {
+            for ( const DxSpot &spot : spots )
+                matched += matchRules(rules, spot).size();
+        }
+    }
+    QVERIFY(matched > 0);
+}
 
 QTEST_APPLESS_MAIN(AlertEvaluatorTest)
 
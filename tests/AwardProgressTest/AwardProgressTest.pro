@@ -0,0 +1,13 @@
+QT += testlib core sql
+CONFIG += console testcase c++11
+TEMPLATE = app
+TARGET = tst_awardprogress
+
+INCLUDEPATH += $$PWD/../..
+
+SOURCES += \
+    tst_awardprogress.cpp \
+    ../../core/AwardProgress.cpp
+
+HEADERS += \
+    ../../core/AwardProgress.h
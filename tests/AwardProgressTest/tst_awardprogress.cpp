@@ -0,0 +1,398 @@
+#include <QtTest>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QSqlRecord>
+
+#include "core/AwardProgress.h"
+
+namespace {
+const int LOG_SIZE = 50000;
+const int LOG_ENTITIES = 340;
+const QStringList BANDS = {"160m", "80m", "40m", "30m", "20m", "17m", "15m", "12m", "10m", "6m"};
+
+// the registered band-table awards; the reference expression and the
+// conditions follow the SQL fragments of the award definitions
+struct AwardCase
+{
+    QString key;
+    QString progressColumn;
+    QString reference;
+    QString where;
+    bool split;
+};
+
+const QList<AwardCase> AWARDS =
+{
+    {"dxcc", "dxcc", "c.dxcc", "AND c.my_dxcc = '291'", false},
+    {"itu", "ituz", "c.ituz", "AND c.my_dxcc = '291'", false},
+    {"wac", "cont", "c.cont", "AND c.my_dxcc = '291'", false},
+    {"waz", "cqz", "c.cqz", "AND c.my_dxcc = '291'", false},
+    {"was", "state", "c.state", "AND c.my_dxcc = '291' AND c.dxcc IN (6, 110, 291)", false},
+    {"wpx", "pfx", "c.pfx", "AND c.my_dxcc = '291'", false},
+    {"iota", "iota", "c.iota", "AND c.my_dxcc = '291'", false},
+    {"potah", "pota_ref", "c.pota", "", true},
+    {"potaa", "my_pota_ref", "c.my_pota_ref_str", "", true},
+    {"sota", "sota_ref", "c.sota_ref", "", false},
+    {"wwff", "wwff_ref", "c.wwff_ref", "", false},
+    {"grid2", "gridsquare", "substr(c.gridsquare, 1, 2)", "AND c.my_dxcc = '291' AND length(c.gridsquare) >= 2", false},
+    {"grid4", "gridsquare", "substr(c.gridsquare, 1, 4)", "AND c.my_dxcc = '291' AND length(c.gridsquare) >= 4", false},
+    {"grid6", "gridsquare", "substr(c.gridsquare, 1, 6)", "AND c.my_dxcc = '291' AND length(c.gridsquare) >= 6", false},
+    {"uscounty", "cnty", "upper(c.cnty)", "AND c.dxcc IN (291, 6, 110) AND c.cnty != ''", false},
+    {"rda", "cnty", "upper(c.cnty)", "AND c.dxcc IN (15, 54, 61, 126, 151) AND c.cnty != ''", false},
+    {"japan", "cnty", "upper(c.cnty)", "AND c.dxcc IN (339) AND c.cnty != ''", false},
+    {"nz", "cnty", "upper(c.cnty)", "AND c.dxcc IN (170) AND c.cnty != ''", false},
+    {"spanishdme", "cnty", "upper(c.cnty)", "AND c.dxcc IN (21, 29, 32, 281) AND c.cnty != ''", false},
+    {"ukd", "cnty", "upper(c.cnty)", "AND c.dxcc IN (288) AND c.cnty != ''", false}
+};
+}
+
+class AwardProgressTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void consistency();
+    void awards_data();
+    void awards();
+    void insertTrigger();
+    void updateTrigger();
+    void deleteTrigger();
+    void rebuild();
+    void award_benchmark_data();
+    void award_benchmark();
+
+private:
+    static QList<QVariantList> rows(const QString &stmt);
+    static QList<QVariantList> contactsGroups();
+    static QList<QVariantList> progressGroups();
+    static QString awardTable(const AwardCase &award, bool useProgress);
+    static void insertContacts(int from, int count);
+};
+
+void AwardProgressTest::initTestCase()
+{
+    QLoggingCategory::setFilterRules(QStringLiteral("*.debug=false"));
+
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE");
+    db.setDatabaseName(":memory:");
+    QVERIFY(db.open());
+
+    QSqlQuery query;
+    QVERIFY(query.exec("CREATE TABLE contacts (id INTEGER PRIMARY KEY, callsign TEXT, my_dxcc INTEGER, "
+                       "dxcc INTEGER, band TEXT, prop_mode TEXT, mode TEXT, "
+                       "eqsl_qsl_rcvd TEXT, lotw_qsl_rcvd TEXT, qsl_rcvd TEXT, qsl_sent TEXT, "
+                       "ituz INTEGER, cqz INTEGER, cont TEXT, state TEXT, cnty TEXT, pfx TEXT, iota TEXT, "
+                       "gridsquare TEXT, sota_ref TEXT, wwff_ref TEXT, pota_ref TEXT, my_pota_ref TEXT)"));
+    QVERIFY(query.exec("CREATE TABLE modes (name TEXT, dxcc TEXT)"));
+    QVERIFY(query.exec("INSERT INTO modes VALUES ('CW', 'CW'), ('SSB', 'PHONE'), ('FT8', 'DIGITAL'), "
+                       "                         ('FT4', 'DIGITAL'), ('RTTY', 'DIGITAL')"));
+
+    // contacts which exist before the progress is created
+    insertContacts(0, 100);
+
+    QVERIFY(AwardProgress::setup(db));
+    QVERIFY(AwardProgress::isAvailable());
+
+    // the contacts inserted by the trigger
+    QVERIFY(db.transaction());
+    insertContacts(100, LOG_SIZE - 100);
+    QVERIFY(db.commit());
+}
+
+// a few frequent entities, slowly changing bands and modes
+void AwardProgressTest::insertContacts(int from, int count)
+{
+    static const QStringList modes = {"CW", "SSB", "FT8", "FT8", "FT4", "RTTY"};
+    static const QStringList conts = {"EU", "NA", "AS", "AF", "SA", "OC"};
+    static const QStringList states = {"CA", "NY", "TX", "FL", "WA"};
+    static const QList<int> countyEntities = {291, 15, 339, 170, 281, 288};
+    QSqlQuery query;
+
+    QVERIFY(query.prepare("INSERT INTO contacts (callsign, my_dxcc, dxcc, band, prop_mode, mode, "
+                          "                      eqsl_qsl_rcvd, lotw_qsl_rcvd, qsl_rcvd, ituz, cqz, cont, "
+                          "                      state, cnty, pfx, iota, gridsquare, sota_ref, wwff_ref, "
+                          "                      pota_ref, my_pota_ref) "
+                          "VALUES (:callsign, :my_dxcc, :dxcc, :band, :prop_mode, :mode, "
+                          "        :eqsl, :lotw, :paper, :ituz, :cqz, :cont, "
+                          "        :state, :cnty, :pfx, :iota, :gridsquare, :sota_ref, :wwff_ref, "
+                          "        :pota_ref, :my_pota_ref)"));
+
+    for ( int i = from; i < from + count; i++ )
+    {
+        const int entity = ( i % 4 != 0 ) ? countyEntities.at(i % countyEntities.size())
+                                          : (i * 7) % LOG_ENTITIES + 1;
+        const QString grid = QString("%1%2%3%4%5%6").arg(QChar('J' + entity % 7))
+                                                    .arg(QChar('N' + i % 6))
+                                                    .arg(entity % 10)
+                                                    .arg((i / 7) % 10)
+                                                    .arg(QChar('a' + (i * 7) % 24))
+                                                    .arg(QChar('a' + (i / 3) % 24));
+
+        query.bindValue(":callsign", QString("OK%1ABC").arg(i % 5000));
+        query.bindValue(":my_dxcc", ( (i / 5000) % 4 == 0 ) ? 230 : 291);
+        query.bindValue(":dxcc", entity);
+        query.bindValue(":band", BANDS.at((i / 100) % BANDS.size()));
+        query.bindValue(":prop_mode", ( i % 200 == 0 ) ? QVariant("SAT") : QVariant());
+        query.bindValue(":mode", modes.at((i / 300) % modes.size()));
+        query.bindValue(":eqsl", ( i % 5 == 0 ) ? "Y" : "N");
+        query.bindValue(":lotw", ( i % 3 == 0 ) ? "Y" : "N");
+        query.bindValue(":paper", ( i % 11 == 0 ) ? QVariant("Y") : QVariant());
+        query.bindValue(":ituz", entity % 75 + 1);
+        query.bindValue(":cqz", entity % 40 + 1);
+        query.bindValue(":cont", conts.at(entity % conts.size()));
+        query.bindValue(":state", ( entity == 291 ) ? QVariant(states.at(i % states.size())) : QVariant());
+        query.bindValue(":cnty", ( countyEntities.contains(entity) ) ? QVariant(QString("C%1").arg(i % 300))
+                                                                     : ( i % 7 == 0 ) ? QVariant("") : QVariant());
+        query.bindValue(":pfx", QString("P%1").arg(i % 3000));
+        query.bindValue(":iota", ( i % 20 == 0 ) ? QVariant(QString("EU-%1").arg(i % 200)) : QVariant());
+        query.bindValue(":gridsquare", ( i % 5 < 2 ) ? QVariant() : QVariant(grid.left(( i % 5 == 2 ) ? 4 : 6)));
+        query.bindValue(":sota_ref", ( i % 50 == 0 ) ? QVariant(QString("OE/TI-%1").arg(i % 300)) : QVariant());
+        query.bindValue(":wwff_ref", ( i % 50 == 1 ) ? QVariant(QString("OKFF-%1").arg(i % 300)) : QVariant());
+        query.bindValue(":pota_ref", ( i % 100 == 0 ) ? QVariant(QString("K-%1,K-%2").arg(i % 700).arg((i + 1) % 700))
+                                                      : ( i % 20 == 0 ) ? QVariant(QString("K-%1").arg(i % 700))
+                                                                        : QVariant());
+        query.bindValue(":my_pota_ref", ( i % 30 == 0 ) ? QVariant(QString("K-%1").arg(i % 50)) : QVariant());
+        QVERIFY2(query.exec(), qPrintable(query.lastError().text()));
+    }
+}
+
+QList<QVariantList> AwardProgressTest::rows(const QString &stmt)
+{
+    QList<QVariantList> ret;
+    QSqlQuery query;
+
+    if ( !query.exec(stmt) )
+    {
+        qWarning() << query.lastError().text() << stmt;
+        return ret;
+    }
+
+    const int columns = query.record().count();
+
+    while ( query.next() )
+    {
+        QVariantList row;
+
+        for ( int i = 0; i < columns; i++ )
+            row << query.value(i);
+        ret << row;
+    }
+
+    return ret;
+}
+
+// the progress computed from scratch
+QList<QVariantList> AwardProgressTest::contactsGroups()
+{
+    QStringList stmts;
+
+    for ( const QString &column : AwardProgress::referenceColumns )
+    {
+        QString reference = QString("c.%1").arg(column);
+
+        if ( column == "gridsquare" )
+            reference = "substr(c.gridsquare, 1, 6)";
+        else if ( column == "cnty" )
+            reference = "NULLIF(c.cnty, '')";
+
+        const QString dxcc = ( AwardProgress::dxccReferenceColumns.contains(column) ) ? "c.dxcc" : "NULL";
+
+        stmts << QString("SELECT '%1' AS kind, %2 AS ref, c.my_dxcc AS my_dxcc, %3 AS dxcc, "
+                         "       c.band AS band, c.prop_mode AS prop_mode, c.mode AS mode, COUNT(1), "
+                         "       SUM(CASE WHEN c.eqsl_qsl_rcvd = 'Y' THEN 1 ELSE 0 END), "
+                         "       SUM(CASE WHEN c.lotw_qsl_rcvd = 'Y' THEN 1 ELSE 0 END), "
+                         "       SUM(CASE WHEN c.qsl_rcvd = 'Y' THEN 1 ELSE 0 END) "
+                         "FROM contacts c WHERE %2 IS NOT NULL "
+                         "GROUP BY kind, ref, my_dxcc, dxcc, band, prop_mode, mode").arg(column, reference, dxcc);
+    }
+
+    return rows(QString("SELECT * FROM (%1) ORDER BY 1, 2, 3, 4, 5, 6, 7").arg(stmts.join(" UNION ALL ")));
+}
+
+QList<QVariantList> AwardProgressTest::progressGroups()
+{
+    return rows("SELECT kind, ref, my_dxcc, dxcc, band, prop_mode, mode, cnt, eqsl_cnt, lotw_cnt, qsl_cnt "
+                "FROM contacts_award_progress "
+                "ORDER BY 1, 2, 3, 4, 5, 6, 7");
+}
+
+// the detail table of the award as it is evaluated by BandTableAward
+QString AwardProgressTest::awardTable(const AwardCase &award, bool useProgress)
+{
+    const QString contactSource = ( useProgress ) ? AwardProgress::sourceSelect(award.progressColumn)
+                                                  : QStringLiteral("SELECT * FROM contacts WHERE 1=1 ");
+    const QString confirmed = QStringLiteral("CASE WHEN (lotw_qsl_rcvd = 'Y' OR qsl_rcvd = 'Y') THEN 2 ELSE 1 END");
+    QStringList bandColumns;
+
+    for ( const QString &band : BANDS )
+        bandColumns << QString("MAX(CASE WHEN band = '%1' AND m.dxcc IN ('CW', 'PHONE', 'DIGITAL') "
+                               "THEN %2 ELSE 0 END) AS '%1'").arg(band, confirmed);
+    bandColumns << QString("MAX(CASE WHEN prop_mode = 'SAT' AND m.dxcc IN ('CW', 'PHONE', 'DIGITAL') "
+                           "THEN %1 ELSE 0 END) AS 'SAT'").arg(confirmed);
+
+    QString sourceContacts = QString("source_contacts AS (%1)").arg(contactSource);
+
+    // the same split as BandTableAward::generateSplitCTE()
+    if ( award.split )
+    {
+        const QString output = award.reference.mid(2);
+
+        sourceContacts = QString("split(id, my_dxcc, band, dxcc, eqsl_qsl_rcvd, lotw_qsl_rcvd, qsl_rcvd, prop_mode, mode, %1, str) AS ("
+                                 "  SELECT id, my_dxcc, band, dxcc, eqsl_qsl_rcvd, lotw_qsl_rcvd, qsl_rcvd, prop_mode, mode, "
+                                 "         '', %2||',' "
+                                 "  FROM (%3) "
+                                 "  UNION ALL "
+                                 "  SELECT id, my_dxcc, band, dxcc, eqsl_qsl_rcvd, lotw_qsl_rcvd, qsl_rcvd, prop_mode, mode, "
+                                 "         substr(str, 0, instr(str, ',')), TRIM(substr(str, instr(str, ',') + 1)) "
+                                 "  FROM split "
+                                 "  WHERE str != ''), "
+                                 "source_contacts AS ("
+                                 "  SELECT id, my_dxcc, band, dxcc, eqsl_qsl_rcvd, lotw_qsl_rcvd, qsl_rcvd, prop_mode, mode, %1 "
+                                 "  FROM split "
+                                 "  WHERE %1 != '')").arg(output, award.progressColumn, contactSource);
+    }
+
+    return QString("WITH %1 "
+                   "SELECT %2 AS col1, %3 "
+                   "FROM source_contacts c "
+                   "     INNER JOIN modes m ON c.mode = m.name "
+                   "WHERE %2 IS NOT NULL %4 "
+                   "GROUP BY 1 ORDER BY 1").arg(sourceContacts, award.reference,
+                                                bandColumns.join(", "), award.where);
+}
+
+void AwardProgressTest::consistency()
+{
+    const QList<QVariantList> expected = contactsGroups();
+
+    QVERIFY(!expected.isEmpty());
+    QCOMPARE(progressGroups(), expected);
+
+    // the QSOs with the same reference are counted in one row
+    QVERIFY(rows("SELECT COUNT(1) FROM contacts_award_progress WHERE kind = 'cqz'").value(0).value(0).toInt() < LOG_SIZE / 10);
+}
+
+void AwardProgressTest::awards_data()
+{
+    QTest::addColumn<int>("awardIndex");
+
+    for ( int i = 0; i < AWARDS.size(); i++ )
+        QTest::newRow(qPrintable(AWARDS.at(i).key)) << i;
+}
+
+void AwardProgressTest::awards()
+{
+    QFETCH(int, awardIndex);
+
+    const AwardCase &award = AWARDS.at(awardIndex);
+    const QList<QVariantList> expected = rows(awardTable(award, false));
+
+    QVERIFY(!expected.isEmpty());
+    QCOMPARE(rows(awardTable(award, true)), expected);
+}
+
+void AwardProgressTest::insertTrigger()
+{
+    QSqlQuery query;
+
+    QVERIFY(query.exec("INSERT INTO contacts (callsign, my_dxcc, dxcc, band, mode, cqz, lotw_qsl_rcvd) "
+                       "VALUES ('JA1ABC', 291, 339, '15m', 'SSB', 41, 'Y'), "
+                       "       ('JA2ABC', 291, 339, '15m', 'SSB', 41, 'N')"));
+
+    const QList<QVariantList> added = rows("SELECT cnt, lotw_cnt, eqsl_cnt FROM contacts_award_progress "
+                                           "WHERE kind = 'cqz' AND ref = 41");
+
+    QCOMPARE(added.size(), 1);
+    QCOMPARE(added.at(0).at(0).toInt(), 2);
+    QCOMPARE(added.at(0).at(1).toInt(), 1);
+    QCOMPARE(added.at(0).at(2).toInt(), 0);
+    QCOMPARE(progressGroups(), contactsGroups());
+}
+
+void AwardProgressTest::updateTrigger()
+{
+    QSqlQuery query;
+
+    // the confirmation changes the counters of the progress rows
+    QVERIFY(query.exec("UPDATE contacts SET lotw_qsl_rcvd = 'Y' WHERE id % 13 = 0"));
+    QVERIFY(query.exec("UPDATE contacts SET mode = 'CW', band = '17m' WHERE id % 17 = 0"));
+    QVERIFY(query.exec("UPDATE contacts SET cqz = NULL, gridsquare = 'AA00' WHERE id % 19 = 0"));
+    QVERIFY(query.exec("UPDATE contacts SET pota_ref = 'K-1,K-2,K-3', cnty = '' WHERE id % 23 = 0"));
+    QCOMPARE(progressGroups(), contactsGroups());
+
+    // the other columns do not touch the progress
+    const QList<QVariantList> before = progressGroups();
+    QVERIFY(query.exec("UPDATE contacts SET qsl_sent = 'Y', callsign = 'OK9ZZZ' WHERE id % 29 = 0"));
+    QCOMPARE(progressGroups(), before);
+}
+
+void AwardProgressTest::deleteTrigger()
+{
+    QSqlQuery query;
+
+    QVERIFY(query.exec("DELETE FROM contacts WHERE id % 31 = 0"));
+    QCOMPARE(progressGroups(), contactsGroups());
+
+    // the empty progress rows are removed
+    QVERIFY(query.exec("DELETE FROM contacts WHERE callsign IN ('JA1ABC', 'JA2ABC')"));
+    QVERIFY(rows("SELECT 1 FROM contacts_award_progress WHERE kind = 'cqz' AND ref = 41").isEmpty());
+    QVERIFY(rows("SELECT 1 FROM contacts_award_progress WHERE cnt <= 0").isEmpty());
+}
+
+void AwardProgressTest::rebuild()
+{
+    QSqlQuery query;
+
+    // the contacts are changed while the progress is not maintained
+    QVERIFY(query.exec("DROP TRIGGER contacts_award_progress_update"));
+    QVERIFY(query.exec("UPDATE contacts SET band = '2m' WHERE id % 37 = 0"));
+    QVERIFY(progressGroups() != contactsGroups());
+
+    QVERIFY(AwardProgress::setup(QSqlDatabase::database()));
+    QVERIFY(AwardProgress::isAvailable());
+    QCOMPARE(progressGroups(), contactsGroups());
+
+    // the explicit rebuild
+    QVERIFY(query.exec("UPDATE contacts_award_progress SET cnt = cnt + 1 "
+                       "WHERE id = (SELECT MIN(id) FROM contacts_award_progress)"));
+    QVERIFY(progressGroups() != contactsGroups());
+    QVERIFY(AwardProgress::rebuild(QSqlDatabase::database()));
+    QVERIFY(AwardProgress::isAvailable());
+    QCOMPARE(progressGroups(), contactsGroups());
+}
+
+void AwardProgressTest::award_benchmark_data()
+{
+    QTest::addColumn<bool>("useProgress");
+
+    QTest::newRow("contacts") << false;
+    QTest::newRow("progress") << true;
+}
+
+// all registered awards
+void AwardProgressTest::award_benchmark()
+{
+    QFETCH(bool, useProgress);
+
+    QStringList stmts;
+
+    for ( const AwardCase &award : AWARDS )
+        stmts << awardTable(award, useProgress);
+
+    int tableRows = 0;
+
+    QBENCHMARK
+    {
+        tableRows = 0;
+        for ( const QString &stmt : static_cast<const QStringList&>(stmts) )
+            tableRows += rows(stmt).size();
+    }
+
+    QVERIFY(tableRows > 0);
+}
+
+QTEST_MAIN(AwardProgressTest)
+
+#include "tst_awardprogress.moc"
@@ -35,8 +35,39 @@ private slots:
     void isFTxMode();
     void isFTxBandMode_data();
     void isFTxBandMode();
+    void bandName2Band();
+    void invalidateCache();
+    void failedLoadIsNotCached();
+    void freq2Band_benchmark_data();
+    void freq2Band_benchmark();
+
+private:
+    static Band freq2BandSQL(double freq);
 };
 
+// the original per-call SQL implementation - used as a reference for benchmarks
+Band BandPlanTest::freq2BandSQL(double freq)
+{
+    QSqlQuery query;
+
+    if ( ! query.prepare("SELECT name, start_freq, end_freq, sat_designator "
+                         "FROM bands "
+                         "WHERE :freq BETWEEN start_freq AND end_freq") )
+        return Band();
+
+    query.bindValue(0, freq);
+
+    if ( ! query.exec() || ! query.next() )
+        return Band();
+
+    Band band;
+    band.name = query.value(0).toString();
+    band.start = query.value(1).toDouble();
+    band.end = query.value(2).toDouble();
+    band.satDesignator  = query.value(3).toString();
+    return band;
+}
+
 void BandPlanTest::initTestCase()
 {
     QLoggingCategory::setFilterRules(QStringLiteral("*.debug=false"));
@@ -236,7 +267,12 @@ void BandPlanTest::freq2Band_data()
         {222.1, "1.25m"},
         {430.1, "70cm"},
         {902.1, "33cm"},
-        {1240.1, "23cm"}
+        {1240.1, "23cm"},
+        {14.0, "20m"},
+        {14.35, "20m"},
+        {27.0, ""},
+        {0.1, ""},
+        {20000.0, ""}
     };
 
     for (const Case &c : cases)
@@ -349,6 +385,96 @@ void BandPlanTest::isFTxBandMode()
     QCOMPARE(BandPlan::isFTxBandMode(mode), expected);
 }
 
+void BandPlanTest::bandName2Band()
+{
+    const Band band = BandPlan::bandName2Band(QStringLiteral("20M"));
+
+    QCOMPARE(band.name, QStringLiteral("20m"));
+    QCOMPARE(band.start, 14.000);
+    QCOMPARE(band.end, 14.350);
+    QVERIFY(BandPlan::bandName2Band(QStringLiteral("11m")).name.isEmpty());
+}
+
+void BandPlanTest::invalidateCache()
+{
+    // make sure that the tables are cached
+    QCOMPARE(BandPlan::freq2Band(14.1).name, QStringLiteral("20m"));
+
+    QSqlQuery query;
+
+    QVERIFY2(query.exec("INSERT INTO bands (name, start_freq, end_freq, enabled, sat_designator) "
+                        "VALUES ('11m', 26.965, 27.405, 0, NULL)"),
+             qPrintable(lastErrorString(query)));
+    QVERIFY2(query.exec("INSERT INTO modes (name, dxcc) VALUES ('VARA', 'DIGITAL')"),
+             qPrintable(lastErrorString(query)));
+
+    // cached tables do not contain the new rows
+    QVERIFY(BandPlan::freq2Band(27.0).name.isEmpty());
+    QVERIFY(BandPlan::modeToDXCCModeGroup(QStringLiteral("VARA")).isEmpty());
+
+    BandPlan::invalidateCache();
+
+    QCOMPARE(BandPlan::freq2Band(27.0).name, QStringLiteral("11m"));
+    QCOMPARE(BandPlan::bandName2Band(QStringLiteral("11m")).name, QStringLiteral("11m"));
+    QCOMPARE(BandPlan::modeToDXCCModeGroup(QStringLiteral("VARA")), QStringLiteral("DIGITAL"));
+
+    QVERIFY(query.exec("DELETE FROM bands WHERE name = '11m'"));
+    QVERIFY(query.exec("DELETE FROM modes WHERE name = 'VARA'"));
+    BandPlan::invalidateCache();
+
+    QVERIFY(BandPlan::freq2Band(27.0).name.isEmpty());
+}
+
+void BandPlanTest::failedLoadIsNotCached()
+{
+    QSqlQuery query;
+
+    QVERIFY2(query.exec("ALTER TABLE modes RENAME TO modes_backup"),
+             qPrintable(lastErrorString(query)));
+
+    BandPlan::invalidateCache();
+
+    QVERIFY(BandPlan::freq2Band(14.1).name.isEmpty());
+    QVERIFY(BandPlan::modeToDXCCModeGroup(QStringLiteral("CW")).isEmpty());
+
+    QVERIFY2(query.exec("ALTER TABLE modes_backup RENAME TO modes"),
+             qPrintable(lastErrorString(query)));
+
+    // the next lookup loads the tables again
+    QCOMPARE(BandPlan::freq2Band(14.1).name, QStringLiteral("20m"));
+    QCOMPARE(BandPlan::modeToDXCCModeGroup(QStringLiteral("CW")), QStringLiteral("CW"));
+}
+
+void BandPlanTest::freq2Band_benchmark_data()
+{
+    QTest::addColumn<bool>("cached");
+
+    QTest::newRow("sql") << false;
+    QTest::newRow("cached") << true;
+}
+
+void BandPlanTest::freq2Band_benchmark()
+{
+    QFETCH(bool, cached);
+
+    const double freq = 14.074;
+
+    if ( cached )
+    {
+        QBENCHMARK
+        {
+            BandPlan::freq2Band(freq);
+        }
+    }
+    else
+    {
+        QBENCHMARK
+        {
+            freq2BandSQL(freq);
+        }
+    }
+}
+
 QTEST_MAIN(BandPlanTest)
 
 #include "tst_bandplan.moc"
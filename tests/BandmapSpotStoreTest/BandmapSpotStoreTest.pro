@@ -0,0 +1,14 @@
+QT += testlib core sql network
+CONFIG += console testcase c++11
+TEMPLATE = app
+TARGET = tst_bandmapspotstore
+
+INCLUDEPATH += $$PWD/../..
+
+SOURCES += \
+    tst_bandmapspotstore.cpp \
+    ../../data/BandmapSpotStore.cpp
+
+HEADERS += \
+    ../../data/BandmapSpotStore.h \
+    ../../data/DxSpot.h
@@ -0,0 +1,259 @@
+#include <QtTest>
+
+#include "data/BandmapSpotStore.h"
+
+namespace {
+const int STORE_SIZE = 20000;
+const int STORE_ENTITIES = 340;
+const int AGING_INTERVAL = 30 * 60;
+}
+
+class BandmapSpotStoreTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void insert();
+    void replaceDuplicate();
+    void sameFrequency();
+    void removeRange();
+    void removeOlderThan();
+    void updateCallsign();
+    void updateEntity();
+    void clear();
+    void aging_benchmark_data();
+    void aging_benchmark();
+
+private:
+    static DxSpot spot(const QString &callsign, double freq, qint32 dxcc, const QDateTime &time);
+    static QDateTime utc(const QString &time);
+    static int countCallsign(const BandmapSpotStore &store, const QString &callsign);
+    static int linearAging(QMap<double, DxSpot> &spots, int interval);
+
+    QMap<double, DxSpot> linearSpots;
+    BandmapSpotStore store;
+};
+
+QDateTime BandmapSpotStoreTest::utc(const QString &time)
+{
+    QDateTime ret = QDateTime::fromString(time, Qt::ISODate);
+    ret.setTimeSpec(Qt::UTC);
+    return ret;
+}
+
+DxSpot BandmapSpotStoreTest::spot(const QString &callsign, double freq, qint32 dxcc, const QDateTime &time)
+{
+    DxSpot ret;
+
+    ret.callsign = callsign;
+    ret.freq = freq;
+    ret.dxcc.dxcc = dxcc;
+    ret.dateTime = time;
+    return ret;
+}
+
+int BandmapSpotStoreTest::countCallsign(const BandmapSpotStore &store, const QString &callsign)
+{
+    int ret = 0;
+
+    for ( auto it = store.cbegin(); it != store.cend(); ++it )
+        ret += ( it.value().callsign == callsign );
+
+    return ret;
+}
+
+void BandmapSpotStoreTest::initTestCase()
+{
+    QLoggingCategory::setFilterRules(QStringLiteral("*.debug=false"));
+
+    // fresh spots - the aging does not remove anything
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+
+    for ( int i = 0; i < STORE_SIZE; i++ )
+    {
+        const DxSpot newSpot = spot(QString("OK%1ABC").arg(i), 1.8 + i * 0.01, i % STORE_ENTITIES, now.addSecs(-(i % 600)));
+        linearSpots.insert(newSpot.freq, newSpot);
+        store.insert(newSpot);
+    }
+
+    QCOMPARE(store.size(), STORE_SIZE);
+}
+
+void BandmapSpotStoreTest::insert()
+{
+    BandmapSpotStore spots;
+    const QDateTime time = utc("2024-01-01T10:00:00");
+
+    spots.insert(spot("OK1ABC", 14.025, 503, time));
+    spots.insert(spot("DL1XYZ", 14.020, 230, time));
+    spots.insert(spot("OK1ABC", 7.025, 503, time));
+
+    QCOMPARE(spots.size(), 3);
+    QCOMPARE(spots.cbegin().value().callsign, QStringLiteral("OK1ABC"));
+    QCOMPARE(spots.value(14.020).callsign, QStringLiteral("DL1XYZ"));
+}
+
+void BandmapSpotStoreTest::replaceDuplicate()
+{
+    BandmapSpotStore spots;
+    const QDateTime time = utc("2024-01-01T10:00:00");
+
+    spots.insert(spot("OK1ABC", 14.025, 503, time));
+    spots.insert(spot("ok1abc", 14.028, 503, time.addSecs(60)));
+
+    QCOMPARE(spots.size(), 1);
+    QCOMPARE(spots.value(14.028).dateTime, time.addSecs(60));
+
+    // the replaced spot is not aged
+    QCOMPARE(spots.removeOlderThan(time), 0);
+    QCOMPARE(spots.size(), 1);
+}
+
+void BandmapSpotStoreTest::sameFrequency()
+{
+    BandmapSpotStore spots;
+    const QDateTime time = utc("2024-01-01T10:00:00");
+    int visited = 0;
+
+    spots.insert(spot("OK1ABC", 14.025, 503, time));
+    spots.insert(spot("DL1XYZ", 14.025, 230, time.addSecs(60)));
+
+    QCOMPARE(spots.size(), 1);
+    QCOMPARE(spots.value(14.025).callsign, QStringLiteral("DL1XYZ"));
+
+    // the replaced spot is removed from the indexes
+    spots.updateCallsign("OK1ABC", [&visited](DxSpot &) { visited++; });
+    spots.updateEntity(503, [&visited](DxSpot &) { visited++; });
+    QCOMPARE(visited, 0);
+}
+
+void BandmapSpotStoreTest::removeRange()
+{
+    BandmapSpotStore spots;
+    const QDateTime time = utc("2024-01-01T10:00:00");
+
+    spots.insert(spot("OK1ABC", 7.025, 503, time));
+    spots.insert(spot("OK2ABC", 14.025, 503, time));
+    spots.insert(spot("OK3ABC", 14.350, 503, time));
+    spots.insert(spot("OK4ABC", 21.025, 503, time));
+
+    spots.removeRange(14.0, 14.35);
+
+    QCOMPARE(spots.size(), 2);
+    QCOMPARE(countCallsign(spots, "OK2ABC"), 0);
+    QCOMPARE(countCallsign(spots, "OK3ABC"), 0);
+    QCOMPARE(spots.removeOlderThan(time), 2);
+}
+
+void BandmapSpotStoreTest::removeOlderThan()
+{
+    BandmapSpotStore spots;
+    const QDateTime time = utc("2024-01-01T10:00:00");
+
+    spots.insert(spot("OK1ABC", 7.025, 503, time));
+    spots.insert(spot("OK2ABC", 14.025, 503, time.addSecs(60)));
+    spots.insert(spot("OK3ABC", 21.025, 503, time.addSecs(120)));
+    spots.insert(spot("OK4ABC", 28.025, 503, time.addSecs(120)));
+
+    QCOMPARE(spots.removeOlderThan(time.addSecs(-1)), 0);
+    QCOMPARE(spots.removeOlderThan(time.addSecs(60)), 2);
+    QCOMPARE(spots.size(), 2);
+    QCOMPARE(spots.cbegin().value().callsign, QStringLiteral("OK3ABC"));
+    QCOMPARE(spots.removeOlderThan(time.addSecs(120)), 2);
+    QCOMPARE(spots.size(), 0);
+}
+
+void BandmapSpotStoreTest::updateCallsign()
+{
+    BandmapSpotStore spots;
+    const QDateTime time = utc("2024-01-01T10:00:00");
+
+    spots.insert(spot("OK1ABC", 7.025, 503, time));
+    spots.insert(spot("OK1ABC", 14.025, 503, time));
+    spots.insert(spot("DL1XYZ", 14.030, 230, time));
+
+    spots.updateCallsign("OK1ABC", [](DxSpot &spot) { spot.dupeCount = 1; });
+
+    QCOMPARE(spots.value(7.025).dupeCount, 1ULL);
+    QCOMPARE(spots.value(14.025).dupeCount, 1ULL);
+    QCOMPARE(spots.value(14.030).dupeCount, 0ULL);
+}
+
+void BandmapSpotStoreTest::updateEntity()
+{
+    BandmapSpotStore spots;
+    const QDateTime time = utc("2024-01-01T10:00:00");
+
+    spots.insert(spot("OK1ABC", 7.025, 503, time));
+    spots.insert(spot("OK2XYZ", 14.025, 503, time));
+    spots.insert(spot("DL1XYZ", 14.030, 230, time));
+
+    spots.updateEntity(503, [](DxSpot &spot) { spot.status = DxccStatus::Worked; });
+
+    QCOMPARE(spots.value(7.025).status, DxccStatus::Worked);
+    QCOMPARE(spots.value(14.025).status, DxccStatus::Worked);
+    QCOMPARE(spots.value(14.030).status, DxccStatus::UnknownStatus);
+}
+
+void BandmapSpotStoreTest::clear()
+{
+    BandmapSpotStore spots;
+    const QDateTime time = utc("2024-01-01T10:00:00");
+    int visited = 0;
+
+    spots.insert(spot("OK1ABC", 7.025, 503, time));
+    spots.clear();
+
+    QCOMPARE(spots.size(), 0);
+    QCOMPARE(spots.removeOlderThan(time), 0);
+    spots.updateCallsign("OK1ABC", [&visited](DxSpot &) { visited++; });
+    QCOMPARE(visited, 0);
+}
+
+// the original spot aging
+int BandmapSpotStoreTest::linearAging(QMap<double, DxSpot> &spots, int interval)
+{
+    int removed = 0;
+    QMutableMapIterator<double, DxSpot> spotIterator(spots);
+
+    while ( spotIterator.hasNext() )
+    {
+        spotIterator.next();
+
+        if ( spotIterator.value().dateTime.addSecs(interval) <= QDateTime::currentDateTimeUtc() )
+        {
+            spotIterator.remove();
+            removed++;
+        }
+    }
+
+    return removed;
+}
+
+void BandmapSpotStoreTest::aging_benchmark_data()
+{
+    QTest::addColumn<bool>("indexed");
+
+    QTest::newRow("map") << false;
+    QTest::newRow("store") << true;
+}
+
+void BandmapSpotStoreTest::aging_benchmark()
+{
+    QFETCH(bool, indexed);
+
+    int removed = 0;
+
+    QBENCHMARK
+    {
+        removed = ( indexed ) ? store.removeOlderThan(QDateTime::currentDateTimeUtc().addSecs(-AGING_INTERVAL))
+                              : linearAging(linearSpots, AGING_INTERVAL);
+    }
+
+    QCOMPARE(removed, 0);
+}
+
+QTEST_APPLESS_MAIN(BandmapSpotStoreTest)
+
+#include "tst_bandmapspotstore.moc"
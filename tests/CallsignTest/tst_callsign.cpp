@@ -1,7 +1,12 @@
 #include <QtTest>
+#include <QRandomGenerator>
 #include "data/Callsign.h"
 #include "generated_cases.h"
 
+namespace {
+const int RANDOM_CALLSIGNS = 200000;
+}
+
 class CallsignTest : public QObject
 {
     Q_OBJECT
@@ -12,6 +17,15 @@ private slots:
     void parse();
     void wpx_data();
     void wpx();
+    void regexEquivalence();
+    void copy();
+    void parse_benchmark_data();
+    void parse_benchmark();
+
+private:
+    static QStringList corpus();
+    static QStringList regexParts(const QString &callsign);
+    static QStringList parserParts(const QString &callsign);
 };
 
 void CallsignTest::initTestCase()
@@ -115,6 +129,105 @@ void CallsignTest::wpx()
     QCOMPARE(cs.getWPXPrefix(), expectedPrefix);
 }
 
+// random strings of the callsign characters and delimiters;
+// the parser must split them exactly as the regular expression
+void CallsignTest::regexEquivalence()
+{
+    const QString alphabet = QStringLiteral("AKOPZ0189/ #a");
+    QRandomGenerator generator(1);
+
+    for ( int i = 0; i < RANDOM_CALLSIGNS; i++ )
+    {
+        QString callsign;
+        const int length = generator.bounded(13);
+
+        for ( int j = 0; j < length; j++ )
+            callsign += alphabet.at(generator.bounded(alphabet.size()));
+
+        QCOMPARE(parserParts(callsign), regexParts(callsign));
+    }
+}
+
+void CallsignTest::copy()
+{
+    Callsign cs(QStringLiteral("sp/ok1abc/p"));
+    const Callsign copied(cs);
+
+    cs = Callsign(QStringLiteral("invalid"));
+
+    QVERIFY(!cs.isValid());
+    QVERIFY(copied.isValid());
+    QCOMPARE(copied.getCallsign(), QStringLiteral("SP/OK1ABC/P"));
+    QCOMPARE(copied.getBase(), QStringLiteral("OK1ABC"));
+    QCOMPARE(copied.getWPXPrefix(), QStringLiteral("SP0"));
+    QVERIFY(!Callsign().isValid());
+}
+
+void CallsignTest::parse_benchmark_data()
+{
+    QTest::addColumn<bool>("useRegex");
+
+    QTest::newRow("regex") << true;
+    QTest::newRow("parser") << false;
+}
+
+void CallsignTest::parse_benchmark()
+{
+    QFETCH(bool, useRegex);
+
+    const QStringList callsigns = corpus();
+    int parts = 0;
+
+    QBENCHMARK
+    {
+        parts = 0;
+        for ( const QString &callsign : callsigns )
+            parts += ( useRegex ) ? regexParts(callsign).size() : parserParts(callsign).size();
+    }
+
+    QVERIFY(parts > 0);
+}
+
+QStringList CallsignTest::corpus()
+{
+    QStringList ret;
+
+    for ( const ParseCase &parseCase : kParseCases )
+        ret << QString::fromLatin1(parseCase.callsign);
+
+    for ( const WPXCase &wpxCase : kWPXCases )
+        ret << QString::fromLatin1(wpxCase.callsign);
+
+    return ret;
+}
+
+// the previous implementation - the expression is compiled for each callsign
+QStringList CallsignTest::regexParts(const QString &callsign)
+{
+    const QString fullCallsign = callsign.toUpper();
+    const QRegularExpressionMatch match = QRegularExpression(Callsign::callsignRegExString(),
+                                                             QRegularExpression::CaseInsensitiveOption).match(fullCallsign);
+
+    if ( !match.hasMatch() )
+        return QStringList();
+
+    return { fullCallsign,
+             match.captured(2), match.captured(1), match.captured(3), match.captured(4),
+             match.captured(5), match.captured(8), match.captured(7) };
+}
+
+QStringList CallsignTest::parserParts(const QString &callsign)
+{
+    const Callsign cs(callsign);
+
+    if ( !cs.isValid() )
+        return QStringList();
+
+    return { cs.getCallsign(),
+             cs.getHostPrefix(), cs.getHostPrefixWithDelimiter(), cs.getBase(), cs.getBasePrefix(),
+             cs.getBasePrefixNumber(), cs.getSuffix(), cs.getSuffixWithDelimiter() };
+}
+
 QTEST_APPLESS_MAIN(CallsignTest)
 
 #include "tst_callsign.moc"
@@ -0,0 +1,22 @@
+QT += testlib core sql
+CONFIG += console testcase c++11
+TEMPLATE = app
+TARGET = tst_clubprogress
+
+INCLUDEPATH += $$PWD/../..
+
+SOURCES += \
+    tst_clubprogress.cpp \
+    ../../core/ClubProgress.cpp \
+    ../../core/SQLFunctions.cpp
+
+HEADERS += \
+    ../../core/ClubProgress.h \
+    ../../core/SQLFunctions.h
+
+unix: LIBS += -lsqlite3
+
+win32: {
+   INCLUDEPATH += $$[QT_INSTALL_PREFIX]/../Src/qtbase/src/3rdparty/sqlite/
+   SOURCES += $$[QT_INSTALL_PREFIX]/../Src/qtbase/src/3rdparty/sqlite/sqlite3.c
+}
@@ -0,0 +1,396 @@
+#include <QtTest>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QSqlRecord>
+#include <QSqlDriver>
+#include <sqlite3.h>
+
+#include "core/ClubProgress.h"
+#include "core/SQLFunctions.h"
+
+namespace {
+const int LOG_SIZE = 50000;
+const int LOG_CALLSIGNS = 8000;
+const int MEMBERS = 20000;
+const QStringList CLUBS = {"AGCW", "CWOPS", "FISTS", "SKCC"};
+const QStringList BANDS = {"160m", "80m", "40m", "30m", "20m", "17m", "15m", "12m", "10m", "6m"};
+const QStringList MODES = {"CW", "SSB", "FT8", "FT8", "FT4", "RTTY"};
+const int STATUS_CALLSIGNS = 50;
+}
+
+class ClubProgressTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void consistency();
+    void status_data();
+    void status();
+    void insertTrigger();
+    void updateTrigger();
+    void deleteTrigger();
+    void rebuild();
+    void status_benchmark_data();
+    void status_benchmark();
+
+private:
+    static QList<QVariantList> rows(const QString &stmt);
+    static QList<QVariantList> contactsGroups();
+    static QList<QVariantList> progressGroups();
+    static QList<QVariantList> clubStatus(const QString &callsign, const QString &mode, bool useProgress);
+    static QString memberCallsign(int index);
+    static void insertContacts(int from, int count);
+};
+
+void ClubProgressTest::initTestCase()
+{
+    QLoggingCategory::setFilterRules(QStringLiteral("*.debug=false"));
+
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE");
+    db.setDatabaseName(":memory:");
+    QVERIFY(db.open());
+
+    const QVariant handle = db.driver()->handle();
+    QVERIFY(handle.isValid() && qstrcmp(handle.typeName(), "sqlite3*") == 0);
+    QVERIFY(SQLFunctions::registerFunctions(*static_cast<sqlite3 * const *>(handle.constData())));
+
+    QSqlQuery query;
+    QVERIFY(query.exec("PRAGMA foreign_keys = ON"));
+    QVERIFY(query.exec("CREATE TABLE contacts (id INTEGER PRIMARY KEY, callsign TEXT, band TEXT, mode TEXT, "
+                       "eqsl_qsl_rcvd TEXT, lotw_qsl_rcvd TEXT, qsl_rcvd TEXT, qsl_sent TEXT)"));
+    QVERIFY(query.exec("CREATE TABLE contacts_autovalue (contactid INTEGER PRIMARY KEY REFERENCES contacts(id) ON DELETE CASCADE, "
+                       "base_callsign TEXT)"));
+    QVERIFY(query.exec("CREATE INDEX contacts_autovalue_call_idx ON contacts_autovalue(base_callsign)"));
+    QVERIFY(query.exec("CREATE TRIGGER insert_contacts_autovalue "
+                       "AFTER INSERT ON contacts "
+                       "FOR EACH ROW "
+                       "BEGIN "
+                       "  INSERT OR REPLACE INTO contacts_autovalue (contactid, base_callsign) "
+                       "  VALUES (NEW.id, base_callsign(NEW.callsign)); "
+                       "END"));
+    QVERIFY(query.exec("CREATE TRIGGER update_callsign_contacts_autovalue "
+                       "AFTER UPDATE ON contacts "
+                       "FOR EACH ROW "
+                       "WHEN OLD.callsign <> NEW.callsign "
+                       "BEGIN "
+                       "  INSERT OR REPLACE INTO contacts_autovalue (contactid, base_callsign) "
+                       "  VALUES (NEW.id, base_callsign(NEW.callsign)); "
+                       "END"));
+    QVERIFY(query.exec("CREATE TABLE membership (callsign TEXT, member_id TEXT, valid_from TEXT, "
+                       "valid_to TEXT, clubid TEXT)"));
+    QVERIFY(query.exec("CREATE INDEX membership_callsign_idx ON membership(callsign)"));
+    QVERIFY(query.exec("CREATE INDEX membership_clubid_idx ON membership(clubid)"));
+    QVERIFY(query.exec("CREATE VIEW contact_clubs_view AS "
+                       "SELECT contactid, clubid "
+                       "FROM contacts_autovalue c, membership m "
+                       "WHERE c.base_callsign = m.callsign"));
+    QVERIFY(query.exec("CREATE TABLE modes (name TEXT, dxcc TEXT)"));
+    QVERIFY(query.exec("INSERT INTO modes VALUES ('CW', 'CW'), ('SSB', 'PHONE'), ('FT8', 'DIGITAL'), "
+                       "                         ('FT4', 'DIGITAL'), ('RTTY', 'DIGITAL')"));
+
+    // big clubs; some callsigns are members of more clubs or listed twice in one club
+    QVERIFY(db.transaction());
+    QVERIFY(query.prepare("INSERT INTO membership VALUES (?, ?, NULL, NULL, ?)"));
+    for ( int i = 0; i < MEMBERS; i++ )
+    {
+        query.addBindValue(memberCallsign(i));
+        query.addBindValue(QString::number(i));
+        query.addBindValue(CLUBS.at(i % CLUBS.size()));
+        QVERIFY2(query.exec(), qPrintable(query.lastError().text()));
+
+        if ( i % 7 == 0 || i % 101 == 0 )
+        {
+            query.addBindValue(memberCallsign(i));
+            query.addBindValue(QString::number(i + MEMBERS));
+            query.addBindValue(CLUBS.at(( i % 101 == 0 ) ? i % CLUBS.size() : (i + 1) % CLUBS.size()));
+            QVERIFY2(query.exec(), qPrintable(query.lastError().text()));
+        }
+    }
+    QVERIFY(db.commit());
+
+    // contacts which exist before the progress is created
+    insertContacts(0, 100);
+
+    QVERIFY(ClubProgress::setup(db));
+    QVERIFY(ClubProgress::isAvailable());
+
+    // the contacts inserted by the trigger
+    QVERIFY(db.transaction());
+    insertContacts(100, LOG_SIZE - 100);
+    QVERIFY(db.commit());
+}
+
+void ClubProgressTest::consistency()
+{
+    const QList<QVariantList> expected = contactsGroups();
+
+    QVERIFY(!expected.isEmpty());
+    QCOMPARE(progressGroups(), expected);
+
+    // the QSOs of one club, band and mode are counted in one row
+    QVERIFY(rows("SELECT COUNT(1) FROM contacts_club_progress").value(0).value(0).toInt()
+            <= CLUBS.size() * BANDS.size() * MODES.size());
+}
+
+void ClubProgressTest::status_data()
+{
+    QTest::addColumn<QString>("callsign");
+    QTest::addColumn<QString>("mode");
+
+    QTest::newRow("member") << memberCallsign(1) << "CW";
+    QTest::newRow("member of two clubs") << memberCallsign(7) << "FT8";
+    QTest::newRow("listed twice") << memberCallsign(101) << "SSB";
+    QTest::newRow("unknown mode") << memberCallsign(2) << "JT65";
+    QTest::newRow("non-member") << "OK1ZZZ" << "CW";
+}
+
+// the club status rows are the same for the contacts and the progress
+void ClubProgressTest::status()
+{
+    QFETCH(QString, callsign);
+    QFETCH(QString, mode);
+
+    QCOMPARE(clubStatus(callsign, mode, true), clubStatus(callsign, mode, false));
+}
+
+void ClubProgressTest::insertTrigger()
+{
+    QSqlQuery query;
+    const QString member = memberCallsign(3);
+
+    QVERIFY(query.exec(QString("INSERT INTO contacts (callsign, band, mode, lotw_qsl_rcvd) "
+                               "VALUES ('%1', '2m', 'SSB', 'Y'), "
+                               "       ('%1/P', '2m', 'SSB', 'N'), "
+                               "       ('OK1ZZZ', '2m', 'SSB', 'Y')").arg(member)));
+
+    const QList<QVariantList> added = rows("SELECT cnt, lotw_cnt, eqsl_cnt FROM contacts_club_progress "
+                                           "WHERE band = '2m'");
+
+    QCOMPARE(added.size(), 1);
+    QCOMPARE(added.at(0).at(0).toInt(), 2);
+    QCOMPARE(added.at(0).at(1).toInt(), 1);
+    QCOMPARE(added.at(0).at(2).toInt(), 0);
+    QCOMPARE(progressGroups(), contactsGroups());
+}
+
+void ClubProgressTest::updateTrigger()
+{
+    QSqlQuery query;
+
+    // the confirmation changes the counters of the progress rows
+    QVERIFY(query.exec("UPDATE contacts SET lotw_qsl_rcvd = 'Y' WHERE id % 13 = 0"));
+    QVERIFY(query.exec("UPDATE contacts SET mode = 'CW', band = '17m' WHERE id % 17 = 0"));
+    QVERIFY(query.exec("UPDATE contacts SET band = NULL, qsl_rcvd = 'Y' WHERE id % 19 = 0"));
+    QCOMPARE(progressGroups(), contactsGroups());
+
+    // the QSO is moved to other clubs
+    QVERIFY(query.exec(QString("UPDATE contacts SET callsign = '%1' WHERE id % 23 = 0").arg(memberCallsign(7))));
+    QVERIFY(query.exec("UPDATE contacts SET callsign = 'OK1ZZZ' WHERE id % 29 = 0"));
+    QCOMPARE(progressGroups(), contactsGroups());
+
+    // the other columns do not touch the progress
+    const QList<QVariantList> before = progressGroups();
+    QVERIFY(query.exec("UPDATE contacts SET qsl_sent = 'Y' WHERE id % 31 = 0"));
+    QCOMPARE(progressGroups(), before);
+}
+
+void ClubProgressTest::deleteTrigger()
+{
+    QSqlQuery query;
+
+    QVERIFY(query.exec("DELETE FROM contacts WHERE id % 37 = 0"));
+    QCOMPARE(progressGroups(), contactsGroups());
+
+    // the empty progress rows are removed
+    QVERIFY(query.exec("DELETE FROM contacts WHERE band = '2m'"));
+    QVERIFY(rows("SELECT 1 FROM contacts_club_progress WHERE band = '2m'").isEmpty());
+    QVERIFY(rows("SELECT 1 FROM contacts_club_progress WHERE cnt <= 0").isEmpty());
+}
+
+void ClubProgressTest::rebuild()
+{
+    QSqlQuery query;
+
+    // the club lists are changed
+    ClubProgress::invalidate();
+    QVERIFY(!ClubProgress::isAvailable());
+    QVERIFY(query.exec("DELETE FROM membership WHERE clubid = 'FISTS'"));
+    QVERIFY(query.exec("UPDATE membership SET clubid = 'FOC' WHERE clubid = 'SKCC' AND member_id % 2 = 0"));
+    QVERIFY(progressGroups() != contactsGroups());
+
+    QVERIFY(ClubProgress::rebuild(QSqlDatabase::database()));
+    QVERIFY(ClubProgress::isAvailable());
+    QCOMPARE(progressGroups(), contactsGroups());
+
+    // the contacts are changed while the progress is not maintained
+    QVERIFY(query.exec("DROP TRIGGER contacts_club_progress_update"));
+    QVERIFY(query.exec("UPDATE contacts SET band = '2m' WHERE id % 41 = 0"));
+    QVERIFY(progressGroups() != contactsGroups());
+
+    QVERIFY(ClubProgress::setup(QSqlDatabase::database()));
+    QVERIFY(ClubProgress::isAvailable());
+    QCOMPARE(progressGroups(), contactsGroups());
+}
+
+void ClubProgressTest::status_benchmark_data()
+{
+    QTest::addColumn<bool>("useProgress");
+
+    QTest::newRow("contacts") << false;
+    QTest::newRow("progress") << true;
+}
+
+void ClubProgressTest::status_benchmark()
+{
+    QFETCH(bool, useProgress);
+
+    int statusRows = 0;
+
+    QBENCHMARK
+    {
+        statusRows = 0;
+        for ( int i = 0; i < STATUS_CALLSIGNS; i++ )
+            statusRows += clubStatus(memberCallsign(i * 7), MODES.at(i % MODES.size()), useProgress).size();
+    }
+
+    QVERIFY(statusRows > 0);
+}
+
+// most of the QSOs are with club members; some of them are portable
+void ClubProgressTest::insertContacts(int from, int count)
+{
+    QSqlQuery query;
+
+    QVERIFY(query.prepare("INSERT INTO contacts (callsign, band, mode, eqsl_qsl_rcvd, lotw_qsl_rcvd, qsl_rcvd) "
+                          "VALUES (:callsign, :band, :mode, :eqsl, :lotw, :paper)"));
+
+    for ( int i = from; i < from + count; i++ )
+    {
+        const int callsignIndex = (i * 7919) % LOG_CALLSIGNS;
+        QString callsign = ( i % 5 == 0 ) ? QString("DL%1XYZ").arg(callsignIndex)
+                                          : memberCallsign(callsignIndex);
+
+        if ( i % 13 == 0 )
+            callsign.append("/P");
+        else if ( i % 17 == 0 )
+            callsign.prepend("SV9/");
+
+        query.bindValue(":callsign", callsign);
+        query.bindValue(":band", BANDS.at((i / 100) % BANDS.size()));
+        query.bindValue(":mode", ( i % 97 == 0 ) ? QString("JT65") : MODES.at((i / 300) % MODES.size()));
+        query.bindValue(":eqsl", ( i % 5 == 0 ) ? "Y" : "N");
+        query.bindValue(":lotw", ( i % 3 == 0 ) ? "Y" : "N");
+        query.bindValue(":paper", ( i % 11 == 0 ) ? QVariant("Y") : QVariant());
+        QVERIFY2(query.exec(), qPrintable(query.lastError().text()));
+    }
+}
+
+QString ClubProgressTest::memberCallsign(int index)
+{
+    return QString("OK%1ABC").arg(index);
+}
+
+QList<QVariantList> ClubProgressTest::rows(const QString &stmt)
+{
+    QList<QVariantList> ret;
+    QSqlQuery query;
+
+    if ( !query.exec(stmt) )
+    {
+        qWarning() << query.lastError().text() << stmt;
+        return ret;
+    }
+
+    const int columns = query.record().count();
+
+    while ( query.next() )
+    {
+        QVariantList row;
+
+        for ( int i = 0; i < columns; i++ )
+            row << query.value(i);
+        ret << row;
+    }
+
+    return ret;
+}
+
+// the progress computed from scratch
+QList<QVariantList> ClubProgressTest::contactsGroups()
+{
+    return rows("SELECT m.clubid, c.band, c.mode, COUNT(1), "
+                "       SUM(CASE WHEN c.eqsl_qsl_rcvd = 'Y' THEN 1 ELSE 0 END), "
+                "       SUM(CASE WHEN c.lotw_qsl_rcvd = 'Y' THEN 1 ELSE 0 END), "
+                "       SUM(CASE WHEN c.qsl_rcvd = 'Y' THEN 1 ELSE 0 END) "
+                "FROM contacts c, contacts_autovalue a, "
+                "     (SELECT DISTINCT callsign, clubid FROM membership) m "
+                "WHERE a.contactid = c.id AND a.base_callsign = m.callsign "
+                "GROUP BY 1, 2, 3 ORDER BY 1, 2, 3");
+}
+
+QList<QVariantList> ClubProgressTest::progressGroups()
+{
+    return rows("SELECT clubid, band, mode, cnt, eqsl_cnt, lotw_cnt, qsl_cnt "
+                "FROM contacts_club_progress "
+                "ORDER BY 1, 2, 3");
+}
+
+// the rows of ClubStatusQuery::getClubStatus; a slot is confirmed if any of its rows is confirmed
+QList<QVariantList> ClubProgressTest::clubStatus(const QString &callsign, const QString &mode, bool useProgress)
+{
+    const QString clubContacts = ( useProgress ) ? ClubProgress::sourceSelect()
+                                                 : QStringLiteral("SELECT con2club.clubid, c.band, c.mode, "
+                                                                  "       c.eqsl_qsl_rcvd, c.lotw_qsl_rcvd, c.qsl_rcvd "
+                                                                  "FROM contacts c, "
+                                                                  "     contact_clubs_view con2club "
+                                                                  "WHERE con2club.contactid = c.id");
+    QList<QVariantList> ret;
+    QSqlQuery query;
+
+    if ( !query.prepare(QString("SELECT clubid, band, mode, MAX(confirmed), current_mode, member_id FROM ("
+                                "SELECT DISTINCT clubid, NULL band, NULL mode, "
+                                "        NULL confirmed, NULL current_mode, member_id "
+                                "FROM membership  WHERE callsign = ? "
+                                "UNION ALL "
+                                "SELECT DISTINCT c.clubid, c.band, o.dxcc mode, "
+                                "                CASE WHEN (c.lotw_qsl_rcvd = 'Y' OR c.qsl_rcvd = 'Y') THEN 1 ELSE 0 END confirmed, "
+                                "               (SELECT modes.dxcc FROM modes WHERE modes.name = ? LIMIT 1) current_mode, "
+                                "               NULL member_id "
+                                "FROM (%1) c, "
+                                "    modes o "
+                                "WHERE o.name = c.mode "
+                                "AND c.clubid in (SELECT clubid FROM membership a WHERE a.callsign = ?)) "
+                                "GROUP BY clubid, band, mode, current_mode, member_id "
+                                "ORDER BY 1, 3, 2, 6").arg(clubContacts)) )
+    {
+        qWarning() << query.lastError().text();
+        return ret;
+    }
+
+    query.addBindValue(callsign);
+    query.addBindValue(mode);
+    query.addBindValue(callsign);
+
+    if ( !query.exec() )
+    {
+        qWarning() << query.lastError().text();
+        return ret;
+    }
+
+    while ( query.next() )
+    {
+        QVariantList row;
+
+        for ( int i = 0; i < 6; i++ )
+            row << query.value(i);
+        ret << row;
+    }
+
+    return ret;
+}
+
+QTEST_MAIN(ClubProgressTest)
+
+#include "tst_clubprogress.moc"
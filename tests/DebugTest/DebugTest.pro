@@ -0,0 +1,13 @@
+QT += testlib core
+CONFIG += console testcase c++11
+TEMPLATE = app
+TARGET = tst_debug
+
+INCLUDEPATH += $$PWD/../..
+
+SOURCES += \
+    tst_debug.cpp \
+    ../../core/debug.cpp
+
+HEADERS += \
+    ../../core/debug.h
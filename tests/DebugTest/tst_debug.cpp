@@ -0,0 +1,106 @@
+#include <QtTest>
+
+#include "core/debug.h"
+
+MODULE_IDENTIFICATION("qlog.test.debug");
+
+namespace {
+static int counter = 0;
+
+// noinline - the benchmark must measure a real function entry
+Q_DECL_NOINLINE void tracedFunction()
+{
+    FCT_IDENTIFICATION;
+
+    counter++;
+}
+
+Q_DECL_NOINLINE void untracedFunction()
+{
+    counter++;
+}
+
+static int messageCount = 0;
+
+void countingMessageHandler(QtMsgType, const QMessageLogContext &, const QString &)
+{
+    messageCount++;
+}
+}
+
+class DebugTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanup();
+    void categoryNames();
+    void functionEntered_levels();
+    void functionEntered_disabled_benchmark();
+    void functionEntered_baseline_benchmark();
+};
+
+void DebugTest::initTestCase()
+{
+    set_debug_level(LEVEL_PRODUCTION);
+}
+
+void DebugTest::cleanup()
+{
+    set_debug_level(LEVEL_PRODUCTION);
+}
+
+void DebugTest::categoryNames()
+{
+    QCOMPARE(QString(function_entered.categoryName()), QString("qlog.test.debug.function.entered"));
+    QCOMPARE(QString(function_parameters.categoryName()), QString("qlog.test.debug.function.parameters"));
+    QCOMPARE(QString(runtime.categoryName()), QString("qlog.test.debug.runtime"));
+}
+
+void DebugTest::functionEntered_levels()
+{
+    set_debug_level(LEVEL_PRODUCTION);
+    QVERIFY(!function_entered.isDebugEnabled());
+    QVERIFY(!runtime.isDebugEnabled());
+
+    set_debug_level(LEVEL_DEBUG_RUNTIME);
+    QVERIFY(!function_entered.isDebugEnabled());
+    QVERIFY(runtime.isDebugEnabled());
+
+    set_debug_level(LEVEL_DEBUG_MAX);
+    QVERIFY(function_parameters.isDebugEnabled());
+    QVERIFY(runtime.isDebugEnabled());
+
+#ifndef QLOG_DISABLE_FUNCTION_TRACING
+    QVERIFY(function_entered.isDebugEnabled());
+
+    messageCount = 0;
+    QtMessageHandler oldHandler = qInstallMessageHandler(countingMessageHandler);
+    tracedFunction();
+    qInstallMessageHandler(oldHandler);
+    QCOMPARE(messageCount, 1);
+#endif
+}
+
+void DebugTest::functionEntered_disabled_benchmark()
+{
+    set_debug_level(LEVEL_PRODUCTION);
+
+    QBENCHMARK
+    {
+        tracedFunction();
+    }
+}
+
+void DebugTest::functionEntered_baseline_benchmark()
+{
+    QBENCHMARK
+    {
+        untracedFunction();
+    }
+}
+
+QTEST_APPLESS_MAIN(DebugTest)
+
+#include "tst_debug.moc"
@@ -0,0 +1,13 @@
+QT += testlib core
+CONFIG += console testcase c++11
+TEMPLATE = app
+TARGET = tst_dupeindex
+
+INCLUDEPATH += $$PWD/../..
+
+SOURCES += \
+    tst_dupeindex.cpp \
+    ../../data/DupeIndex.cpp
+
+HEADERS += \
+    ../../data/DupeIndex.h
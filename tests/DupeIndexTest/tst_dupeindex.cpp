@@ -0,0 +1,137 @@
+#include <QtTest>
+
+#include "data/DupeIndex.h"
+
+class DupeIndexTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void count_data();
+    void count();
+    void dupeWindow();
+    void timeSpec();
+    void removeContact();
+    void clear();
+    void count_benchmark();
+
+private:
+    static QDateTime utc(const QString &time);
+    DupeIndex index;
+};
+
+QDateTime DupeIndexTest::utc(const QString &time)
+{
+    QDateTime ret = QDateTime::fromString(time, Qt::ISODate);
+    ret.setTimeSpec(Qt::UTC);
+    return ret;
+}
+
+void DupeIndexTest::initTestCase()
+{
+    QLoggingCategory::setFilterRules(QStringLiteral("*.debug=false"));
+
+    index.addContact("OK1ABC", "20m", "CW", utc("2024-01-01T10:00:00"));
+    index.addContact("OK1ABC", "40m", "PHONE", utc("2024-01-01T11:00:00"));
+    index.addContact("DL1XYZ", "20m", "DIGITAL", utc("2024-01-01T12:00:00"));
+}
+
+void DupeIndexTest::count_data()
+{
+    QTest::addColumn<QString>("callsign");
+    QTest::addColumn<QString>("band");
+    QTest::addColumn<QString>("modeGroup");
+    QTest::addColumn<bool>("checkBand");
+    QTest::addColumn<bool>("checkMode");
+    QTest::addColumn<qulonglong>("expected");
+
+    QTest::newRow("allBands") << "OK1ABC" << "10m" << "CW" << false << false << 2ULL;
+    QTest::newRow("eachBand") << "OK1ABC" << "20m" << "PHONE" << true << false << 1ULL;
+    QTest::newRow("eachBandNew") << "OK1ABC" << "10m" << "CW" << true << false << 0ULL;
+    QTest::newRow("eachBandMode") << "OK1ABC" << "40m" << "PHONE" << true << true << 1ULL;
+    QTest::newRow("eachBandModeNew") << "OK1ABC" << "40m" << "CW" << true << true << 0ULL;
+    QTest::newRow("unknownCallsign") << "OK2ABC" << "20m" << "CW" << false << false << 0ULL;
+    QTest::newRow("caseSensitive") << "ok1abc" << "20m" << "CW" << false << false << 0ULL;
+}
+
+void DupeIndexTest::count()
+{
+    QFETCH(QString, callsign);
+    QFETCH(QString, band);
+    QFETCH(QString, modeGroup);
+    QFETCH(bool, checkBand);
+    QFETCH(bool, checkMode);
+    QFETCH(qulonglong, expected);
+
+    QCOMPARE(index.count(callsign, band, modeGroup, utc("2024-01-01T00:00:00"),
+                         checkBand, checkMode), expected);
+}
+
+void DupeIndexTest::dupeWindow()
+{
+    QCOMPARE(index.count("OK1ABC", "20m", "CW", utc("2024-01-01T10:00:00"), false, false), 2ULL);
+    QCOMPARE(index.count("OK1ABC", "20m", "CW", utc("2024-01-01T10:00:01"), false, false), 1ULL);
+    QCOMPARE(index.count("OK1ABC", "20m", "CW", utc("2024-01-01T11:00:01"), false, false), 0ULL);
+}
+
+void DupeIndexTest::timeSpec()
+{
+    DupeIndex localIndex;
+
+    // QSO time without a time zone is UTC
+    localIndex.addContact("OK1ABC", "20m", "CW",
+                          QDateTime::fromString("2024-01-01T10:00:00", Qt::ISODate));
+
+    QCOMPARE(localIndex.count("OK1ABC", "20m", "CW", utc("2024-01-01T10:00:00"), true, true), 1ULL);
+    QCOMPARE(localIndex.count("OK1ABC", "20m", "CW", utc("2024-01-01T10:00:01"), true, true), 0ULL);
+}
+
+void DupeIndexTest::removeContact()
+{
+    DupeIndex localIndex;
+
+    localIndex.addContact("OK1ABC", "20m", "CW", utc("2024-01-01T10:00:00"));
+    localIndex.addContact("OK1ABC", "20m", "CW", utc("2024-01-01T10:05:00"));
+    QCOMPARE(localIndex.size(), 2);
+
+    // not matching contact
+    localIndex.removeContact("OK1ABC", "40m", "CW", utc("2024-01-01T10:00:00"));
+    QCOMPARE(localIndex.size(), 2);
+
+    localIndex.removeContact("OK1ABC", "20m", "CW", utc("2024-01-01T10:00:00"));
+    QCOMPARE(localIndex.size(), 1);
+    QCOMPARE(localIndex.count("OK1ABC", "20m", "CW", utc("2024-01-01T00:00:00"), true, true), 1ULL);
+
+    localIndex.removeContact("OK1ABC", "20m", "CW", utc("2024-01-01T10:05:00"));
+    QCOMPARE(localIndex.size(), 0);
+    QCOMPARE(localIndex.count("OK1ABC", "20m", "CW", utc("2024-01-01T00:00:00"), false, false), 0ULL);
+}
+
+void DupeIndexTest::clear()
+{
+    DupeIndex localIndex;
+
+    localIndex.addContact("OK1ABC", "20m", "CW", utc("2024-01-01T10:00:00"));
+    localIndex.clear();
+
+    QCOMPARE(localIndex.size(), 0);
+    QCOMPARE(localIndex.count("OK1ABC", "20m", "CW", utc("2024-01-01T00:00:00"), false, false), 0ULL);
+}
+
+void DupeIndexTest::count_benchmark()
+{
+    const QString callsign(QStringLiteral("OK1ABC"));
+    const QString band(QStringLiteral("20m"));
+    const QString modeGroup(QStringLiteral("CW"));
+    const QDateTime start = utc("2024-01-01T00:00:00");
+
+    QBENCHMARK
+    {
+        index.count(callsign, band, modeGroup, start, true, true);
+    }
+}
+
+QTEST_APPLESS_MAIN(DupeIndexTest)
+
+#include "tst_dupeindex.moc"
@@ -0,0 +1,14 @@
+QT += testlib core sql network
+CONFIG += console testcase c++11
+TEMPLATE = app
+TARGET = tst_dxspotstore
+
+INCLUDEPATH += $$PWD/../..
+
+SOURCES += \
+    tst_dxspotstore.cpp \
+    ../../data/DxSpotStore.cpp
+
+HEADERS += \
+    ../../data/DxSpotStore.h \
+    ../../data/DxSpot.h
@@ -0,0 +1,232 @@
+#include <QtTest>
+
+#include "data/DxSpotStore.h"
+
+namespace {
+const int STREAM_SIZE = 100000;
+const int STREAM_CALLSIGNS = 3000;
+const int STREAM_SPOTS_PER_SEC = 20;
+const qint16 STREAM_DEDUP_INTERVAL = 30;
+const double STREAM_DEDUP_TOLERANCE = 5;
+}
+
+class DxSpotStoreTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void order();
+    void capacity();
+    void removeOldest();
+    void growAfterRemove();
+    void isDuplicate_data();
+    void isDuplicate();
+    void evictedNotDuplicate();
+    void clear();
+    void stream_benchmark();
+
+private:
+    static DxSpot spot(const QString &callsign, double freq, const QDateTime &time);
+    static QDateTime utc(const QString &time);
+    static int runStore(const QList<DxSpot> &stream);
+
+    QList<DxSpot> stream;
+};
+
+QDateTime DxSpotStoreTest::utc(const QString &time)
+{
+    QDateTime ret = QDateTime::fromString(time, Qt::ISODate);
+    ret.setTimeSpec(Qt::UTC);
+    return ret;
+}
+
+DxSpot DxSpotStoreTest::spot(const QString &callsign, double freq, const QDateTime &time)
+{
+    DxSpot ret;
+
+    ret.callsign = callsign;
+    ret.freq = freq;
+    ret.dateTime = time;
+    return ret;
+}
+
+void DxSpotStoreTest::initTestCase()
+{
+    QLoggingCategory::setFilterRules(QStringLiteral("*.debug=false"));
+
+    const QDateTime start = utc("2024-01-01T00:00:00");
+
+    // spots of the same DX station are repeated by several spotters
+    for ( int i = 0; i < STREAM_SIZE; i++ )
+    {
+        const int station = (i * 7919) % STREAM_CALLSIGNS;
+        stream << spot(QString("OK%1ABC").arg(station),
+                       14.000 + (station % 300) * 0.001 + (i % 3) * 0.0005,
+                       start.addMSecs(qint64(i) * 1000 / STREAM_SPOTS_PER_SEC));
+    }
+}
+
+void DxSpotStoreTest::order()
+{
+    DxSpotStore store(5);
+    const QDateTime time = utc("2024-01-01T10:00:00");
+
+    store.append(spot("OK1A", 14.010, time));
+    store.append(spot("OK1B", 14.020, time));
+    store.append(spot("OK1C", 14.030, time));
+
+    QCOMPARE(store.size(), 3);
+    QCOMPARE(store.at(0).callsign, QStringLiteral("OK1C"));
+    QCOMPARE(store.at(1).callsign, QStringLiteral("OK1B"));
+    QCOMPARE(store.at(2).callsign, QStringLiteral("OK1A"));
+}
+
+void DxSpotStoreTest::capacity()
+{
+    DxSpotStore store(3);
+    const QDateTime time = utc("2024-01-01T10:00:00");
+
+    for ( int i = 0; i < 10; i++ )
+        store.append(spot(QString("OK%1A").arg(i), 14.010, time.addSecs(i)));
+
+    QCOMPARE(store.size(), 3);
+    QCOMPARE(store.capacity(), 3);
+    QCOMPARE(store.at(0).callsign, QStringLiteral("OK9A"));
+    QCOMPARE(store.at(1).callsign, QStringLiteral("OK8A"));
+    QCOMPARE(store.at(2).callsign, QStringLiteral("OK7A"));
+}
+
+void DxSpotStoreTest::removeOldest()
+{
+    DxSpotStore store(4);
+    const QDateTime time = utc("2024-01-01T10:00:00");
+
+    for ( int i = 0; i < 6; i++ )
+        store.append(spot(QString("OK%1A").arg(i), 14.010, time.addSecs(i)));
+
+    store.removeOldest(3);
+
+    QCOMPARE(store.size(), 1);
+    QCOMPARE(store.at(0).callsign, QStringLiteral("OK5A"));
+
+    store.removeOldest(10);
+    QVERIFY(store.isEmpty());
+}
+
+void DxSpotStoreTest::growAfterRemove()
+{
+    DxSpotStore store(10);
+    const QDateTime time = utc("2024-01-01T10:00:00");
+
+    for ( int i = 0; i < 4; i++ )
+        store.append(spot(QString("OK%1A").arg(i), 14.010, time.addSecs(i)));
+
+    // the buffer is not full; the free slots are reused before it grows
+    store.removeOldest(2);
+
+    for ( int i = 4; i < 12; i++ )
+        store.append(spot(QString("OK%1A").arg(i), 14.010, time.addSecs(i)));
+
+    QCOMPARE(store.size(), 10);
+
+    for ( int row = 0; row < store.size(); row++ )
+        QCOMPARE(store.at(row).callsign, QString("OK%1A").arg(11 - row));
+}
+
+void DxSpotStoreTest::isDuplicate_data()
+{
+    QTest::addColumn<QString>("callsign");
+    QTest::addColumn<double>("freq");
+    QTest::addColumn<QString>("time");
+    QTest::addColumn<bool>("expected");
+
+    QTest::newRow("same") << "OK1ABC" << 14.025 << "2024-01-01T10:00:02" << true;
+    QTest::newRow("freqTolerance") << "OK1ABC" << 14.029 << "2024-01-01T10:00:02" << true;
+    QTest::newRow("otherFreq") << "OK1ABC" << 14.031 << "2024-01-01T10:00:02" << false;
+    QTest::newRow("otherBand") << "OK1ABC" << 7.025 << "2024-01-01T10:00:02" << false;
+    QTest::newRow("window") << "OK1ABC" << 14.025 << "2024-01-01T10:00:03" << true;
+    QTest::newRow("outOfWindow") << "OK1ABC" << 14.025 << "2024-01-01T10:00:04" << false;
+    QTest::newRow("otherCallsign") << "OK2ABC" << 14.025 << "2024-01-01T10:00:02" << false;
+    // the older spot of the callsign is still within the window
+    QTest::newRow("secondSpot") << "DL1XYZ" << 7.010 << "2024-01-01T10:00:02" << true;
+}
+
+void DxSpotStoreTest::isDuplicate()
+{
+    QFETCH(QString, callsign);
+    QFETCH(double, freq);
+    QFETCH(QString, time);
+    QFETCH(bool, expected);
+
+    DxSpotStore store;
+
+    store.append(spot("DL1XYZ", 7.010, utc("2024-01-01T10:00:00")));
+    store.append(spot("OK1ABC", 14.025, utc("2024-01-01T10:00:00")));
+    store.append(spot("DL1XYZ", 14.070, utc("2024-01-01T10:00:01")));
+
+    const DxSpot entry = spot(callsign, freq, utc(time));
+
+    QCOMPARE(store.isDuplicate(entry, 3, 5), expected);
+}
+
+void DxSpotStoreTest::evictedNotDuplicate()
+{
+    DxSpotStore store(2);
+    const QDateTime time = utc("2024-01-01T10:00:00");
+
+    store.append(spot("OK1ABC", 14.025, time));
+    store.append(spot("DL1A", 14.010, time));
+    store.append(spot("DL1B", 14.020, time));
+
+    QVERIFY(!store.isDuplicate(spot("OK1ABC", 14.025, time), 3, 5));
+    QVERIFY(store.isDuplicate(spot("DL1A", 14.010, time), 3, 5));
+}
+
+void DxSpotStoreTest::clear()
+{
+    DxSpotStore store(3);
+    const QDateTime time = utc("2024-01-01T10:00:00");
+
+    store.append(spot("OK1ABC", 14.025, time));
+    store.clear();
+
+    QVERIFY(store.isEmpty());
+    QVERIFY(!store.isDuplicate(spot("OK1ABC", 14.025, time), 3, 5));
+
+    store.append(spot("DL1A", 14.010, time));
+    QCOMPARE(store.at(0).callsign, QStringLiteral("DL1A"));
+}
+
+int DxSpotStoreTest::runStore(const QList<DxSpot> &stream)
+{
+    DxSpotStore store;
+    int inserted = 0;
+
+    for ( const DxSpot &entry : stream )
+    {
+        if ( store.isDuplicate(entry, STREAM_DEDUP_INTERVAL, STREAM_DEDUP_TOLERANCE) )
+            continue;
+
+        store.append(entry);
+        inserted++;
+    }
+
+    return inserted;
+}
+
+void DxSpotStoreTest::stream_benchmark()
+{
+    int inserted = 0;
+
+    QBENCHMARK
+    {
+        inserted = runStore(stream);
+    }
+
+    QVERIFY(inserted > 0);
+}
+
+QTEST_APPLESS_MAIN(DxSpotStoreTest)
+
+#include "tst_dxspotstore.moc"
@@ -0,0 +1,13 @@
+QT += testlib core sql
+CONFIG += console testcase c++11
+TEMPLATE = app
+TARGET = tst_dxccprefixtrie
+
+INCLUDEPATH += $$PWD/../..
+
+SOURCES += \
+    tst_dxccprefixtrie.cpp \
+    ../../data/DxccPrefixTrie.cpp
+
+HEADERS += \
+    ../../data/DxccPrefixTrie.h
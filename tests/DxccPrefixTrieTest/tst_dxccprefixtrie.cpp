@@ -0,0 +1,172 @@
+#include <QtTest>
+
+#include "data/DxccPrefixTrie.h"
+
+class DxccPrefixTrieTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void longestPrefixMatch_data();
+    void longestPrefixMatch();
+    void exactMatch();
+    void validityInterval();
+    void zoneException();
+    void entityInfo();
+    void emptyTrie();
+    void lookup_benchmark();
+
+private:
+    static DxccPrefixTrie::Entry entry(qint32 dxcc,
+                                       DxccPrefixTrie::EntryType type = DxccPrefixTrie::PREFIX_ENTRY,
+                                       qint64 from = DxccPrefixTrie::UNBOUNDED_FROM,
+                                       qint64 to = DxccPrefixTrie::UNBOUNDED_TO);
+    DxccPrefixTrie trie;
+};
+
+DxccPrefixTrie::Entry DxccPrefixTrieTest::entry(qint32 dxcc,
+                                                DxccPrefixTrie::EntryType type,
+                                                qint64 from,
+                                                qint64 to)
+{
+    DxccPrefixTrie::Entry ret;
+    ret.validFrom = from;
+    ret.validTo = to;
+    ret.dxcc = dxcc;
+    ret.cqz = dxcc % 40;
+    ret.ituz = dxcc % 75;
+    ret.type = type;
+    return ret;
+}
+
+void DxccPrefixTrieTest::initTestCase()
+{
+    QLoggingCategory::setFilterRules(QStringLiteral("*.debug=false"));
+
+    DxccPrefixTrie::EntityInfo czech;
+    czech.name = QStringLiteral("Czech Republic");
+    czech.prefix = QStringLiteral("OK");
+    czech.cont = QStringLiteral("EU");
+    czech.cqz = 15;
+    czech.ituz = 28;
+    trie.addEntity(503, czech);
+
+    trie.addEntry(QStringLiteral("OK"), entry(503));
+    trie.addEntry(QStringLiteral("OL"), entry(503));
+    trie.addEntry(QStringLiteral("K"), entry(291));
+    trie.addEntry(QStringLiteral("KG4"), entry(105));
+    trie.addEntry(QStringLiteral("KH6"), entry(110));
+    trie.addEntry(QStringLiteral("KH6"), entry(110));
+    trie.addEntry(QStringLiteral("VP2E"), entry(12));
+    trie.addEntry(QStringLiteral("VP2M"), entry(96));
+    trie.addEntry(QStringLiteral("VP2"), entry(65));
+    trie.addEntry(QStringLiteral("K1ABC"), entry(110, DxccPrefixTrie::EXACT_ENTRY));
+    trie.addEntry(QStringLiteral("OK0"), entry(503, DxccPrefixTrie::PREFIX_ENTRY, 0, 1000));
+    trie.addEntry(QStringLiteral("OK0"), entry(504, DxccPrefixTrie::PREFIX_ENTRY, 1001, 2000));
+    trie.addEntry(QStringLiteral("OK1XYZ"), entry(0, DxccPrefixTrie::ZONE_EXCEPTION_ENTRY, 0, 1000));
+    trie.addEntry(QStringLiteral("OK?"), entry(1));
+    trie.compile();
+}
+
+void DxccPrefixTrieTest::longestPrefixMatch_data()
+{
+    QTest::addColumn<QString>("callsign");
+    QTest::addColumn<int>("dxcc");
+
+    QTest::newRow("simple") << "OK1ABC" << 503;
+    QTest::newRow("lowercase") << "ok1abc" << 503;
+    QTest::newRow("short") << "K1ABC" << 291;
+    QTest::newRow("longer") << "KG4AB" << 105;
+    QTest::newRow("longest") << "VP2EAA" << 12;
+    QTest::newRow("fallback") << "VP2AA" << 65;
+    QTest::newRow("unknown") << "ZZ1ZZ" << -1;
+    QTest::newRow("invalidChar") << "OK?" << 503;
+    QTest::newRow("empty") << "" << -1;
+}
+
+void DxccPrefixTrieTest::longestPrefixMatch()
+{
+    QFETCH(QString, callsign);
+    QFETCH(int, dxcc);
+
+    const DxccPrefixTrie::Entry *result = trie.longestPrefixMatch(callsign, 0);
+
+    if ( dxcc < 0 )
+    {
+        QVERIFY(result == nullptr);
+        return;
+    }
+
+    QVERIFY(result != nullptr);
+    QCOMPARE(result->dxcc, dxcc);
+}
+
+void DxccPrefixTrieTest::exactMatch()
+{
+    const DxccPrefixTrie::Entry *result = trie.exactMatch(QStringLiteral("K1ABC"), 0);
+
+    QVERIFY(result != nullptr);
+    QCOMPARE(result->dxcc, 110);
+
+    // exact entries are not used as prefixes
+    QVERIFY(trie.exactMatch(QStringLiteral("K1ABCD"), 0) == nullptr);
+    QCOMPARE(trie.longestPrefixMatch(QStringLiteral("K1ABCD"), 0)->dxcc, 291);
+
+    // prefix entries are not exact entries
+    QVERIFY(trie.exactMatch(QStringLiteral("OK"), 0) == nullptr);
+}
+
+void DxccPrefixTrieTest::validityInterval()
+{
+    QCOMPARE(trie.longestPrefixMatch(QStringLiteral("OK0AA"), 500)->dxcc, 503);
+    QCOMPARE(trie.longestPrefixMatch(QStringLiteral("OK0AA"), 1500)->dxcc, 504);
+
+    // outside of both intervals - falls back to the shorter prefix
+    const DxccPrefixTrie::Entry *result = trie.longestPrefixMatch(QStringLiteral("OK0AA"), 5000);
+    QVERIFY(result != nullptr);
+    QCOMPARE(result->dxcc, 503);
+}
+
+void DxccPrefixTrieTest::zoneException()
+{
+    QVERIFY(trie.exactMatch(QStringLiteral("OK1XYZ"), 500, DxccPrefixTrie::ZONE_EXCEPTION_ENTRY) != nullptr);
+    QVERIFY(trie.exactMatch(QStringLiteral("OK1XYZ"), 5000, DxccPrefixTrie::ZONE_EXCEPTION_ENTRY) == nullptr);
+    QVERIFY(trie.exactMatch(QStringLiteral("OK1XYZ"), 500) == nullptr);
+}
+
+void DxccPrefixTrieTest::entityInfo()
+{
+    const DxccPrefixTrie::EntityInfo *info = trie.entity(503);
+
+    QVERIFY(info != nullptr);
+    QCOMPARE(info->name, QStringLiteral("Czech Republic"));
+    QCOMPARE(info->cqz, 15);
+    QVERIFY(trie.entity(1) == nullptr);
+}
+
+void DxccPrefixTrieTest::emptyTrie()
+{
+    DxccPrefixTrie emptyTrie;
+
+    QVERIFY(emptyTrie.isEmpty());
+    QVERIFY(emptyTrie.longestPrefixMatch(QStringLiteral("OK1ABC"), 0) == nullptr);
+    QVERIFY(emptyTrie.exactMatch(QStringLiteral("OK1ABC"), 0) == nullptr);
+
+    emptyTrie.compile();
+    QVERIFY(emptyTrie.longestPrefixMatch(QStringLiteral("OK1ABC"), 0) == nullptr);
+}
+
+void DxccPrefixTrieTest::lookup_benchmark()
+{
+    const QString callsign(QStringLiteral("VP2EAA"));
+
+    QBENCHMARK
+    {
+        trie.longestPrefixMatch(callsign, 0);
+    }
+}
+
+QTEST_APPLESS_MAIN(DxccPrefixTrieTest)
+
+#include "tst_dxccprefixtrie.moc"
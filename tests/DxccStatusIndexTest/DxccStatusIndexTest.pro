@@ -0,0 +1,13 @@
+QT += testlib core
+CONFIG += console testcase c++11
+TEMPLATE = app
+TARGET = tst_dxccstatusindex
+
+INCLUDEPATH += $$PWD/../..
+
+SOURCES += \
+    tst_dxccstatusindex.cpp \
+    ../../data/DxccStatusIndex.cpp
+
+HEADERS += \
+    ../../data/DxccStatusIndex.h
@@ -0,0 +1,138 @@
+#include <QtTest>
+
+#include "data/DxccStatusIndex.h"
+
+Q_DECLARE_METATYPE(DxccStatus)
+
+class DxccStatusIndexTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void status_data();
+    void status();
+    void confirmationSource();
+    void myDXCCFilter();
+    void unknownModeGroup();
+    void removeEntity();
+    void clear();
+    void status_benchmark();
+
+private:
+    DxccStatusIndex index;
+};
+
+void DxccStatusIndexTest::initTestCase()
+{
+    QLoggingCategory::setFilterRules(QStringLiteral("*.debug=false"));
+
+    // OK - 20m CW confirmed by LoTW, 40m PHONE worked
+    index.addContact(503, 291, "20m", "CW", false, true, false);
+    index.addContact(503, 291, "40m", "PHONE", false, false, false);
+    // DL - 20m DIGITAL confirmed by paper
+    index.addContact(230, 291, "20m", "DIGITAL", true, false, false);
+}
+
+void DxccStatusIndexTest::status_data()
+{
+    QTest::addColumn<int>("dxcc");
+    QTest::addColumn<QString>("band");
+    QTest::addColumn<QString>("modeGroup");
+    QTest::addColumn<DxccStatus>("expected");
+
+    QTest::newRow("newEntity") << 1 << "20m" << "CW" << DxccStatus::NewEntity;
+    QTest::newRow("newBandMode") << 503 << "10m" << "DIGITAL" << DxccStatus::NewBandMode;
+    QTest::newRow("newBand") << 503 << "10m" << "CW" << DxccStatus::NewBand;
+    QTest::newRow("newMode") << 503 << "20m" << "DIGITAL" << DxccStatus::NewMode;
+    QTest::newRow("newSlot") << 503 << "40m" << "CW" << DxccStatus::NewSlot;
+    QTest::newRow("worked") << 503 << "40m" << "PHONE" << DxccStatus::Worked;
+    QTest::newRow("confirmed") << 503 << "20m" << "CW" << DxccStatus::Confirmed;
+    QTest::newRow("unknownBand") << 503 << "2190m" << "CW" << DxccStatus::NewBand;
+}
+
+void DxccStatusIndexTest::status()
+{
+    QFETCH(int, dxcc);
+    QFETCH(QString, band);
+    QFETCH(QString, modeGroup);
+    QFETCH(DxccStatus, expected);
+
+    QCOMPARE(index.status(dxcc, 291, band, modeGroup, true, true, true), expected);
+}
+
+void DxccStatusIndexTest::confirmationSource()
+{
+    QCOMPARE(index.status(503, 291, "20m", "CW", true, false, false), DxccStatus::Confirmed);
+    QCOMPARE(index.status(503, 291, "20m", "CW", false, true, true), DxccStatus::Worked);
+    QCOMPARE(index.status(230, 291, "20m", "DIGITAL", false, true, false), DxccStatus::Confirmed);
+    QCOMPARE(index.status(230, 291, "20m", "DIGITAL", true, false, true), DxccStatus::Worked);
+    QCOMPARE(index.status(230, 291, "20m", "DIGITAL", false, false, false), DxccStatus::Worked);
+}
+
+void DxccStatusIndexTest::myDXCCFilter()
+{
+    DxccStatusIndex localIndex;
+
+    localIndex.addContact(503, 291, "20m", "CW", false, false, false);
+    localIndex.addContact(503, 230, "40m", "CW", false, false, true);
+
+    QCOMPARE(localIndex.status(503, 291, "40m", "CW", true, true, true), DxccStatus::NewBand);
+    QCOMPARE(localIndex.status(503, 230, "40m", "CW", true, true, true), DxccStatus::Confirmed);
+    QCOMPARE(localIndex.status(503, 1, "40m", "CW", true, true, true), DxccStatus::NewEntity);
+
+    // 0 - all my entities are merged
+    QCOMPARE(localIndex.status(503, 0, "20m", "CW", true, true, true), DxccStatus::Worked);
+    QCOMPARE(localIndex.status(503, 0, "40m", "CW", true, true, true), DxccStatus::Confirmed);
+}
+
+void DxccStatusIndexTest::unknownModeGroup()
+{
+    DxccStatusIndex localIndex;
+
+    // contact with a mode which is not in the modes table
+    localIndex.addContact(503, 291, "20m", QString(), false, false, false);
+
+    QCOMPARE(localIndex.status(503, 291, "20m", "CW", true, true, true), DxccStatus::NewMode);
+    QCOMPARE(localIndex.status(503, 291, "40m", "CW", true, true, true), DxccStatus::NewBandMode);
+    QCOMPARE(localIndex.status(503, 291, "20m", QString(), true, true, true), DxccStatus::NewMode);
+}
+
+void DxccStatusIndexTest::removeEntity()
+{
+    DxccStatusIndex localIndex;
+
+    localIndex.addContact(503, 291, "20m", "CW", false, false, false);
+    localIndex.addContact(230, 291, "20m", "CW", false, false, false);
+    localIndex.removeEntity(503);
+
+    QCOMPARE(localIndex.entityCount(), 1);
+    QCOMPARE(localIndex.status(503, 291, "20m", "CW", true, true, true), DxccStatus::NewEntity);
+    QCOMPARE(localIndex.status(230, 291, "20m", "CW", true, true, true), DxccStatus::Worked);
+}
+
+void DxccStatusIndexTest::clear()
+{
+    DxccStatusIndex localIndex;
+
+    localIndex.addContact(503, 291, "20m", "CW", false, false, false);
+    localIndex.clear();
+
+    QCOMPARE(localIndex.entityCount(), 0);
+    QCOMPARE(localIndex.status(503, 291, "20m", "CW", true, true, true), DxccStatus::NewEntity);
+}
+
+void DxccStatusIndexTest::status_benchmark()
+{
+    const QString band(QStringLiteral("20m"));
+    const QString modeGroup(QStringLiteral("CW"));
+
+    QBENCHMARK
+    {
+        index.status(503, 291, band, modeGroup, true, true, true);
+    }
+}
+
+QTEST_APPLESS_MAIN(DxccStatusIndexTest)
+
+#include "tst_dxccstatusindex.moc"
@@ -0,0 +1,13 @@
+QT += testlib core sql
+CONFIG += console testcase c++11
+TEMPLATE = app
+TARGET = tst_importdupequery
+
+INCLUDEPATH += $$PWD/../..
+
+SOURCES += \
+    tst_importdupequery.cpp \
+    ../../logformat/ImportDupeQuery.cpp
+
+HEADERS += \
+    ../../logformat/ImportDupeQuery.h
@@ -0,0 +1,226 @@
+#include <QtTest>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+
+#include "logformat/ImportDupeQuery.h"
+
+namespace {
+const int LOG_SIZE = 100000;
+const int CLUB_QSOS = 30000;     // QSOs with one prolific callsign
+const int SAMPLE_SIZE = 200;     // records used for the JULIANDAY statement
+const QString CLUB_CALLSIGN = QStringLiteral("OK1KCL");
+}
+
+class ImportDupeQueryTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void find_data();
+    void find();
+    void record();
+    void selfMerge_benchmark_data();
+    void selfMerge_benchmark();
+
+private:
+    struct Contact
+    {
+        QString callsign;
+        QString band;
+        QString mode;
+        QDateTime startTime;
+    };
+
+    static QDateTime utc(const QString &time);
+    static QList<Contact> readLog();
+    static bool findJulianDay(QSqlQuery &query, const Contact &contact);
+
+    QList<Contact> log;
+};
+
+QDateTime ImportDupeQueryTest::utc(const QString &time)
+{
+    QDateTime ret = QDateTime::fromString(time, Qt::ISODate);
+    ret.setTimeSpec(Qt::UTC);
+    return ret;
+}
+
+void ImportDupeQueryTest::initTestCase()
+{
+    QLoggingCategory::setFilterRules(QStringLiteral("*.debug=false"));
+
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE");
+    db.setDatabaseName(":memory:");
+    QVERIFY(db.open());
+
+    QSqlQuery query;
+    QVERIFY(query.exec("CREATE TABLE contacts (id INTEGER PRIMARY KEY, callsign TEXT, band TEXT, "
+                       "sat_name TEXT, mode TEXT, start_time TEXT)"));
+    QVERIFY(query.exec("CREATE INDEX contacts_callsign_idx ON contacts (callsign)"));
+    QVERIFY(query.exec("CREATE INDEX contacts_start_time_idx ON contacts (start_time)"));
+    QVERIFY(query.exec("CREATE INDEX contacts_callsign_start_time_idx ON contacts (callsign, start_time)"));
+
+    static const QStringList bands = {"80m", "40m", "20m", "15m", "10m"};
+    static const QStringList modes = {"CW", "SSB", "FT8"};
+    const QDateTime start = utc("2010-01-01T00:00:00");
+
+    QVERIFY(db.transaction());
+    QVERIFY(query.prepare("INSERT INTO contacts (callsign, band, sat_name, mode, start_time) "
+                          "VALUES (:callsign, :band, :sat_name, :mode, :start_time)"));
+
+    // start_time is bound as QDateTime - the same as the QSO insert
+    for ( int i = 0; i < LOG_SIZE; i++ )
+    {
+        query.bindValue(":callsign", ( i < CLUB_QSOS ) ? CLUB_CALLSIGN : QString("OK%1ABC").arg(i % 7000));
+        query.bindValue(":band", bands.at(i % bands.size()));
+        query.bindValue(":sat_name", QVariant());
+        query.bindValue(":mode", modes.at((i / 5) % modes.size()));
+        query.bindValue(":start_time", start.addSecs(i * 3600LL));
+        QVERIFY2(query.exec(), qPrintable(query.lastError().text()));
+    }
+
+    QVERIFY(query.exec("INSERT INTO contacts (callsign, band, sat_name, mode, start_time) "
+                       "VALUES ('DL1SAT', '2m', 'AO-91', 'FM', '2024-05-01T10:00:00.000Z'), "
+                       "('DL1OLD', '20m', NULL, 'CW', '2024-05-01 23:50:00')"));
+    QVERIFY(db.commit());
+
+    log = readLog();
+    QCOMPARE(log.size(), LOG_SIZE + 1);
+}
+
+void ImportDupeQueryTest::find_data()
+{
+    QTest::addColumn<QString>("callsign");
+    QTest::addColumn<QString>("band");
+    QTest::addColumn<QString>("mode");
+    QTest::addColumn<QString>("satName");
+    QTest::addColumn<QString>("startTime");
+    QTest::addColumn<bool>("expected");
+
+    QTest::newRow("exact") << "DL1SAT" << "2m" << "FM" << "AO-91" << "2024-05-01T10:00:00" << true;
+    QTest::newRow("lowerCase") << "dl1sat" << "2M" << "fm" << "AO-91" << "2024-05-01T10:00:00" << true;
+    QTest::newRow("window") << "DL1SAT" << "2m" << "FM" << "AO-91" << "2024-05-01T10:29:00" << true;
+    QTest::newRow("windowBefore") << "DL1SAT" << "2m" << "FM" << "AO-91" << "2024-05-01T09:31:00" << true;
+    QTest::newRow("outOfWindow") << "DL1SAT" << "2m" << "FM" << "AO-91" << "2024-05-01T10:30:00" << false;
+    QTest::newRow("otherSat") << "DL1SAT" << "2m" << "FM" << "SO-50" << "2024-05-01T10:00:00" << false;
+    QTest::newRow("noSat") << "DL1SAT" << "2m" << "FM" << "" << "2024-05-01T10:00:00" << false;
+    QTest::newRow("otherMode") << "DL1SAT" << "2m" << "SSB" << "AO-91" << "2024-05-01T10:00:00" << false;
+    QTest::newRow("otherBand") << "DL1SAT" << "70cm" << "FM" << "AO-91" << "2024-05-01T10:00:00" << false;
+    // stored without 'T'; the window crosses midnight
+    QTest::newRow("spaceFormat") << "DL1OLD" << "20m" << "CW" << "" << "2024-05-02T00:10:00" << true;
+    QTest::newRow("spaceFormatOut") << "DL1OLD" << "20m" << "CW" << "" << "2024-05-02T00:20:00" << false;
+}
+
+void ImportDupeQueryTest::find()
+{
+    QFETCH(QString, callsign);
+    QFETCH(QString, band);
+    QFETCH(QString, mode);
+    QFETCH(QString, satName);
+    QFETCH(QString, startTime);
+    QFETCH(bool, expected);
+
+    ImportDupeQuery query(QSqlDatabase::database());
+
+    QVERIFY(query.isValid());
+    QCOMPARE(query.find(callsign, band, mode,
+                        ( satName.isEmpty() ) ? QVariant() : QVariant(satName),
+                        utc(startTime)), expected);
+}
+
+void ImportDupeQueryTest::record()
+{
+    ImportDupeQuery query(QSqlDatabase::database());
+
+    QVERIFY(query.find("DL1SAT", "2m", "FM", "AO-91", utc("2024-05-01T10:05:00")));
+    QCOMPARE(query.record().value("callsign").toString(), QStringLiteral("DL1SAT"));
+    QCOMPARE(query.record().value("id").toInt(), LOG_SIZE + 1);
+}
+
+QList<ImportDupeQueryTest::Contact> ImportDupeQueryTest::readLog()
+{
+    QList<Contact> ret;
+    QSqlQuery query;
+
+    if ( !query.exec("SELECT callsign, band, mode, start_time FROM contacts WHERE sat_name IS NULL ORDER BY id") )
+        return ret;
+
+    while ( query.next() )
+    {
+        QDateTime startTime = query.value(3).toDateTime();
+
+        if ( startTime.timeSpec() == Qt::LocalTime )
+            startTime.setTimeSpec(Qt::UTC);
+        ret << Contact{query.value(0).toString(), query.value(1).toString(),
+                       query.value(2).toString(), startTime};
+    }
+
+    return ret;
+}
+
+// the original import statement
+bool ImportDupeQueryTest::findJulianDay(QSqlQuery &query, const Contact &contact)
+{
+    query.bindValue(":callsign", contact.callsign);
+    query.bindValue(":mode", contact.mode);
+    query.bindValue(":band", contact.band);
+    query.bindValue(":startdate", contact.startTime.toTimeZone(QTimeZone::utc()).toString("yyyy-MM-dd hh:mm:ss"));
+    query.bindValue(":sat_name", QVariant());
+
+    return query.exec() && query.next();
+}
+
+void ImportDupeQueryTest::selfMerge_benchmark_data()
+{
+    QTest::addColumn<bool>("range");
+
+    QTest::newRow("julianday") << false;
+    QTest::newRow("range") << true;
+}
+
+void ImportDupeQueryTest::selfMerge_benchmark()
+{
+    QFETCH(bool, range);
+
+    // the prolific callsign is the worst case for the original statement
+    int found = 0;
+
+    if ( range )
+    {
+        ImportDupeQuery query(QSqlDatabase::database());
+
+        QBENCHMARK
+        {
+            found = 0;
+            for ( int i = 0; i < SAMPLE_SIZE; i++ )
+            {
+                const Contact &contact = log.at(i);
+                found += query.find(contact.callsign, contact.band, contact.mode, QVariant(), contact.startTime);
+            }
+        }
+    }
+    else
+    {
+        QSqlQuery query;
+
+        QVERIFY(query.prepare("SELECT * FROM contacts "
+                              "WHERE callsign=upper(:callsign) "
+                              "AND upper(mode)=upper(:mode) "
+                              "AND upper(band)=upper(:band) "
+                              "AND COALESCE(sat_name, '') = COALESCE(:sat_name, '') "
+                              "AND ABS(JULIANDAY(start_time)-JULIANDAY(datetime(:startdate)))*24*60<30"));
+        QBENCHMARK
+        {
+            found = 0;
+            for ( int i = 0; i < SAMPLE_SIZE; i++ )
+                found += findJulianDay(query, log.at(i));
+        }
+    }
+    QCOMPARE(found, SAMPLE_SIZE);
+}
+
+QTEST_MAIN(ImportDupeQueryTest)
+
+#include "tst_importdupequery.moc"
@@ -0,0 +1,13 @@
+QT += testlib core sql
+CONFIG += console testcase c++11
+TEMPLATE = app
+TARGET = tst_logbooksearchindex
+
+INCLUDEPATH += $$PWD/../..
+
+SOURCES += \
+    tst_logbooksearchindex.cpp \
+    ../../core/LogbookSearchIndex.cpp
+
+HEADERS += \
+    ../../core/LogbookSearchIndex.h
@@ -0,0 +1,292 @@
+#include <QtTest>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+
+#include "core/LogbookSearchIndex.h"
+
+namespace {
+const int LOG_SIZE = 100000;
+}
+
+class LogbookSearchIndexTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void whereClause_data();
+    void whereClause();
+    void shortText();
+    void quoting();
+    void unicodeCase();
+    void triggers();
+    void rebuild();
+    void search_benchmark_data();
+    void search_benchmark();
+
+private:
+    static QList<qlonglong> ids(const QString &where);
+    static QList<qlonglong> likeIds(const QStringList &columns, const QString &text);
+    static QString likeWhere(const QStringList &columns, const QString &text);
+    static int filteredCount(const QString &where);
+    static const QStringList textColumns;
+};
+
+const QStringList LogbookSearchIndexTest::textColumns =
+{
+    "name", "name_intl", "qth", "qth_intl", "comment", "comment_intl", "notes", "notes_intl"
+};
+
+void LogbookSearchIndexTest::initTestCase()
+{
+    QLoggingCategory::setFilterRules(QStringLiteral("*.debug=false"));
+
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE");
+    db.setDatabaseName(":memory:");
+    QVERIFY(db.open());
+
+    QStringList columns;
+
+    for ( const QString &column : LogbookSearchIndex::indexedColumns )
+        columns << column + " TEXT";
+
+    QSqlQuery query;
+    QVERIFY(query.exec(QString("CREATE TABLE contacts (id INTEGER PRIMARY KEY, %1, "
+                               "band TEXT, qsl_rcvd TEXT)").arg(columns.join(", "))));
+
+    // contacts which exist before the index is created
+    QVERIFY(query.exec("INSERT INTO contacts (callsign, gridsquare, name, name_intl, qth, qth_intl) "
+                       "VALUES ('OK1MLG', 'JN79', 'Ladislav', 'Ladislav', 'Praha', 'Praha'), "
+                       "       ('DL1ABC', 'JO62', 'Muller', 'Müller', 'Berlin', 'Berlin')"));
+
+    QVERIFY(LogbookSearchIndex::setup(db));
+
+    if ( !LogbookSearchIndex::isAvailable() )
+        QSKIP("FTS5 trigram is not supported by the SQLite library");
+
+    static const QStringList prefixes = {"OK", "OL", "DL", "G", "F", "W", "JA", "VK", "LY", "SP"};
+    static const QStringList names = {"Jan", "Petr", "Karel", "John", "Peter", "Hans", "Yuki", "Bob"};
+    static const QStringList cities = {"Brno", "Ostrava", "Hamburg", "London", "Paris", "Tokyo", "Sydney"};
+    static const QStringList comments = {"tnx QSO", "CQ WW", "POTA activation", "", "nice signal", "QRP 5W"};
+
+    QVERIFY(db.transaction());
+    QVERIFY(query.prepare("INSERT INTO contacts (callsign, gridsquare, pota_ref, name, name_intl, "
+                          "qth, qth_intl, comment, comment_intl, notes, notes_intl, band) "
+                          "VALUES (:callsign, :gridsquare, :pota_ref, :name, :name, "
+                          ":qth, :qth, :comment, :comment, :notes, :notes, '20m')"));
+
+    // the contacts inserted by the trigger
+    for ( int i = 0; i < LOG_SIZE; i++ )
+    {
+        const QString callsign = QString("%1%2%3").arg(prefixes.at(i % prefixes.size()))
+                                                  .arg(i % 10)
+                                                  .arg(QString::number(i, 36).toUpper());
+        query.bindValue(":callsign", callsign);
+        query.bindValue(":gridsquare", QString("JN%1").arg(i % 100, 2, 10, QChar('0')));
+        query.bindValue(":pota_ref", ( i % 50 == 0 ) ? QVariant(QString("OK-%1").arg(i % 4000, 4, 10, QChar('0'))) : QVariant());
+        query.bindValue(":name", names.at(i % names.size()));
+        query.bindValue(":qth", cities.at(i % cities.size()));
+        query.bindValue(":comment", comments.at(i % comments.size()));
+        query.bindValue(":notes", ( i % 1000 == 0 ) ? QVariant(QString("Met at Ham Radio %1").arg(2000 + i % 25)) : QVariant());
+        QVERIFY2(query.exec(), qPrintable(query.lastError().text()));
+    }
+
+    QVERIFY(db.commit());
+}
+
+QList<qlonglong> LogbookSearchIndexTest::ids(const QString &where)
+{
+    QList<qlonglong> ret;
+    QSqlQuery query;
+
+    if ( !query.exec(QString("SELECT id FROM contacts WHERE %1 ORDER BY id").arg(where)) )
+    {
+        qWarning() << query.lastError().text() << where;
+        return ret;
+    }
+
+    while ( query.next() )
+        ret << query.value(0).toLongLong();
+
+    return ret;
+}
+
+// reference result with a bound LIKE pattern
+QList<qlonglong> LogbookSearchIndexTest::likeIds(const QStringList &columns, const QString &text)
+{
+    QList<qlonglong> ret;
+    QStringList predicates;
+
+    for ( const QString &column : columns )
+        predicates << QString("%1 LIKE :text").arg(column);
+
+    QSqlQuery query;
+
+    if ( !query.prepare(QString("SELECT id FROM contacts WHERE %1 ORDER BY id").arg(predicates.join(" OR "))) )
+        return ret;
+
+    query.bindValue(":text", QString("%%1%").arg(text));
+
+    if ( !query.exec() )
+        return ret;
+
+    while ( query.next() )
+        ret << query.value(0).toLongLong();
+
+    return ret;
+}
+
+// the original logbook filter
+QString LogbookSearchIndexTest::likeWhere(const QStringList &columns, const QString &text)
+{
+    QStringList predicates;
+
+    for ( const QString &column : columns )
+        predicates << QString("%1 LIKE '%%2%'").arg(column, text);
+
+    return QString("(%1)").arg(predicates.join(" OR "));
+}
+
+int LogbookSearchIndexTest::filteredCount(const QString &where)
+{
+    QSqlQuery query(QString("SELECT COUNT(1) FROM contacts WHERE %1").arg(where));
+
+    return query.first() ? query.value(0).toInt() : -1;
+}
+
+void LogbookSearchIndexTest::whereClause_data()
+{
+    QTest::addColumn<QStringList>("columns");
+    QTest::addColumn<QString>("text");
+
+    QTest::newRow("callsign") << QStringList{"callsign"} << "OK1";
+    QTest::newRow("callsignLower") << QStringList{"callsign"} << "dl5";
+    QTest::newRow("callsignInner") << QStringList{"callsign"} << "7A1";
+    QTest::newRow("callsignFull") << QStringList{"callsign"} << "OK1MLG";
+    QTest::newRow("callsignNone") << QStringList{"callsign"} << "ZZZZ";
+    QTest::newRow("gridsquare") << QStringList{"gridsquare"} << "JN79";
+    QTest::newRow("pota") << QStringList{"pota_ref"} << "OK-01";
+    QTest::newRow("name") << textColumns << "pet";
+    QTest::newRow("qth") << textColumns << "ondo";
+    QTest::newRow("comment") << textColumns << "pota act";
+    QTest::newRow("notes") << textColumns << "Ham Radio 2012";
+    QTest::newRow("otherColumn") << QStringList{"callsign"} << "Brno";
+}
+
+void LogbookSearchIndexTest::whereClause()
+{
+    QFETCH(QStringList, columns);
+    QFETCH(QString, text);
+
+    const QString where = LogbookSearchIndex::whereClause(columns, text);
+
+    QVERIFY(where.contains("MATCH"));
+    QCOMPARE(ids(where), likeIds(columns, text));
+}
+
+void LogbookSearchIndexTest::shortText()
+{
+    // trigrams cannot match shorter texts
+    const QString where = LogbookSearchIndex::whereClause({"callsign"}, "OK");
+
+    QVERIFY(!where.contains("MATCH"));
+    QCOMPARE(ids(where), likeIds({"callsign"}, "OK"));
+
+    // a column which is not indexed
+    QVERIFY(!LogbookSearchIndex::whereClause({"band"}, "20m").contains("MATCH"));
+}
+
+void LogbookSearchIndexTest::quoting()
+{
+    QSqlQuery query;
+
+    QVERIFY(query.exec("INSERT INTO contacts (callsign, name, name_intl) "
+                       "VALUES ('EI1QT', 'O''Brien \"Bob\"', 'O''Brien \"Bob\"')"));
+
+    const qlonglong id = query.lastInsertId().toLongLong();
+
+    for ( const QString &text : {QString("O'Brien"), QString("\"Bob\""), QString("'%")} )
+    {
+        const QString where = LogbookSearchIndex::whereClause(textColumns, text);
+
+        QCOMPARE(ids(where), likeIds(textColumns, text));
+    }
+
+    QCOMPARE(ids(LogbookSearchIndex::whereClause(textColumns, "O'Brien \"Bob\"")), QList<qlonglong>{id});
+    QVERIFY(query.exec(QString("DELETE FROM contacts WHERE id = %1").arg(id)));
+}
+
+void LogbookSearchIndexTest::unicodeCase()
+{
+    // LIKE folds ASCII only; the trigram tokenizer folds also non-ASCII letters
+    QCOMPARE(ids(LogbookSearchIndex::whereClause(textColumns, "MÜLLER")).size(), 1);
+    QCOMPARE(ids(LogbookSearchIndex::whereClause(textColumns, "muller")).size(), 1);
+}
+
+void LogbookSearchIndexTest::triggers()
+{
+    QSqlQuery query;
+
+    QVERIFY(query.exec("UPDATE contacts SET callsign = 'OK1XYZ', qth = 'Plzen', qth_intl = 'Plzeň' "
+                       "WHERE callsign = 'OK1MLG'"));
+
+    QVERIFY(ids(LogbookSearchIndex::whereClause({"callsign"}, "1MLG")).isEmpty());
+    QCOMPARE(ids(LogbookSearchIndex::whereClause({"callsign"}, "1XYZ")).size(), 1);
+    QCOMPARE(ids(LogbookSearchIndex::whereClause(textColumns, "plzeň")).size(), 1);
+
+    // the upload status update does not touch the index
+    QVERIFY(query.exec("UPDATE contacts SET qsl_rcvd = 'Y' WHERE callsign = 'OK1XYZ'"));
+    QCOMPARE(ids(LogbookSearchIndex::whereClause({"callsign"}, "1XYZ")).size(), 1);
+
+    QVERIFY(query.exec("DELETE FROM contacts WHERE callsign = 'OK1XYZ'"));
+    QVERIFY(ids(LogbookSearchIndex::whereClause({"callsign"}, "1XYZ")).isEmpty());
+
+    QVERIFY2(query.exec("INSERT INTO contacts_search (contacts_search) VALUES ('integrity-check')"),
+             qPrintable(query.lastError().text()));
+}
+
+void LogbookSearchIndexTest::rebuild()
+{
+    QSqlQuery query;
+
+    // the contact is changed while the index is not maintained
+    QVERIFY(query.exec("DROP TRIGGER contacts_search_update"));
+    QVERIFY(query.exec("UPDATE contacts SET callsign = 'OK2REB' WHERE callsign = 'DL1ABC'"));
+
+    QVERIFY(LogbookSearchIndex::setup(QSqlDatabase::database()));
+    QVERIFY(LogbookSearchIndex::isAvailable());
+
+    QCOMPARE(ids(LogbookSearchIndex::whereClause({"callsign"}, "2REB")).size(), 1);
+    QVERIFY(ids(LogbookSearchIndex::whereClause({"callsign"}, "1ABC")).isEmpty());
+    QVERIFY(query.exec("INSERT INTO contacts_search (contacts_search) VALUES ('integrity-check')"));
+}
+
+void LogbookSearchIndexTest::search_benchmark_data()
+{
+    QTest::addColumn<bool>("indexed");
+
+    QTest::newRow("like") << false;
+    QTest::newRow("index") << true;
+}
+
+void LogbookSearchIndexTest::search_benchmark()
+{
+    QFETCH(bool, indexed);
+
+    // the same statements as the logbook - the filtered model and the count label
+    const QString where = ( indexed ) ? LogbookSearchIndex::whereClause(textColumns, "Ham Radio")
+                                     : likeWhere(textColumns, "Ham Radio");
+    int count = 0;
+
+    QBENCHMARK
+    {
+        count = filteredCount(where);
+    }
+
+    QCOMPARE(count, LOG_SIZE / 1000);
+}
+
+QTEST_MAIN(LogbookSearchIndexTest)
+
+#include "tst_logbooksearchindex.moc"
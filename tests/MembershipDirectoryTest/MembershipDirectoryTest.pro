@@ -0,0 +1,22 @@
+QT += testlib core sql network widgets
+CONFIG += console testcase c++11
+TEMPLATE = app
+TARGET = tst_membershipdirectory
+
+INCLUDEPATH += $$PWD/../..
+
+SOURCES += \
+    tst_membershipdirectory.cpp \
+    test_stubs.cpp \
+    ../../core/MembershipDirectory.cpp \
+    ../../core/MembershipQE.cpp \
+    ../../core/ClubProgress.cpp \
+    ../../core/LogParam.cpp \
+    ../../data/Callsign.cpp
+
+HEADERS += \
+    ../../core/MembershipDirectory.h \
+    ../../core/MembershipQE.h \
+    ../../core/ClubProgress.h \
+    ../../core/LogParam.h \
+    ../../data/Callsign.h
@@ -0,0 +1,36 @@
+// Stubs for missing dependencies in MembershipDirectory tests
+// These provide minimal implementations to satisfy linker
+
+#include <QString>
+#include "core/LogDatabase.h"
+#include "data/BandPlan.h"
+
+// Stubs for LogDatabase used in MembershipQE and LogParam
+LogDatabase::LogDatabase()
+{
+}
+
+QString LogDatabase::currentPlatformId()
+{
+    return QStringLiteral("TestPlatform");
+}
+
+QString LogDatabase::dbFilename()
+{
+    return QStringLiteral(":memory:");
+}
+
+bool LogDatabase::openThreadConnection(const QString &)
+{
+    return false;
+}
+
+void LogDatabase::closeThreadConnection(const QString &)
+{
+}
+
+// Stubs for BandPlan constants used in LogParam
+const QString BandPlan::MODE_GROUP_STRING_PHONE = QStringLiteral("PHONE");
+const QString BandPlan::MODE_GROUP_STRING_CW = QStringLiteral("CW");
+const QString BandPlan::MODE_GROUP_STRING_FTx = QStringLiteral("FTx");
+const QString BandPlan::MODE_GROUP_STRING_DIGITAL = QStringLiteral("DIGITAL");
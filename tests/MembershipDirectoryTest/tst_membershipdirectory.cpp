@@ -0,0 +1,281 @@
+#include <QtTest>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QRandomGenerator>
+
+#include "core/MembershipDirectory.h"
+#include "core/MembershipQE.h"
+
+namespace {
+const int MEMBER_CALLSIGNS = 50000;
+const int NON_MEMBER_CALLSIGNS = 50000;
+const QStringList CLUBS = {"AGCW", "CWOPS", "DIG", "FISTS", "FOC", "HSC", "SKCC", "TENTEN"};
+const int QUERY_ROUNDS = 20000;
+const double MAX_FALSE_POSITIVE_RATE = 0.03;
+}
+
+class MembershipDirectoryTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void members();
+    void nonMembers();
+    void unknownCallsign();
+    void snapshot();
+    void membershipQuery();
+    void query_benchmark_data();
+    void query_benchmark();
+
+private:
+    static QString callsign(int index, bool member);
+    static QStringList sqlMembers(QSqlQuery &query, const QString &callsign);
+    static QStringList directoryMembers(const MembershipDirectory &directory, const QString &callsign);
+    static QStringList clubInfoMembers(const QList<ClubInfo> &clubs);
+    static QStringList queriedCallsigns();
+
+    QSharedPointer<const MembershipDirectory> directory;
+};
+
+void MembershipDirectoryTest::initTestCase()
+{
+    QLoggingCategory::setFilterRules(QStringLiteral("*.debug=false"));
+
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE");
+    db.setDatabaseName(":memory:");
+    QVERIFY(db.open());
+
+    QSqlQuery query;
+    QVERIFY(query.exec("CREATE TABLE membership (callsign TEXT, member_id TEXT, valid_from TEXT, "
+                       "valid_to TEXT, clubid TEXT)"));
+    QVERIFY(query.exec("CREATE INDEX membership_callsign_idx ON membership(callsign)"));
+    QVERIFY(query.prepare("INSERT INTO membership VALUES (:callsign, :member_id, :valid_from, :valid_to, :clubid)"));
+
+    QRandomGenerator random(1);
+
+    QVERIFY(db.transaction());
+    for ( int i = 0; i < MEMBER_CALLSIGNS; i++ )
+    {
+        const int clubs = 1 + random.bounded(3);
+
+        for ( int j = 0; j < clubs; j++ )
+        {
+            query.bindValue(":callsign", callsign(i, true));
+            query.bindValue(":member_id", QString::number(random.bounded(100000)));
+            query.bindValue(":valid_from", (random.bounded(4) == 0) ? QString() : QString("19900101"));
+            query.bindValue(":valid_to", (random.bounded(4) == 0) ? QString("20201231") : QString("20991231"));
+            query.bindValue(":clubid", CLUBS.at(random.bounded(CLUBS.size())));
+            QVERIFY2(query.exec(), qPrintable(query.lastError().text()));
+        }
+    }
+    QVERIFY(db.commit());
+
+    directory = MembershipDirectory::load(db);
+    QVERIFY(!directory.isNull());
+    QCOMPARE(directory->callsignCount(), MEMBER_CALLSIGNS);
+}
+
+// the directory returns the same memberships as the membership table
+void MembershipDirectoryTest::members()
+{
+    QSqlQuery query;
+
+    QVERIFY(query.prepare("SELECT DISTINCT callsign, member_id, valid_from, valid_to, clubid "
+                          "FROM membership WHERE callsign = :callsign ORDER BY clubid"));
+
+    for ( int i = 0; i < MEMBER_CALLSIGNS; i++ )
+    {
+        const QString member = callsign(i, true);
+
+        QVERIFY(directory->mightContain(member));
+        QCOMPARE(directoryMembers(*directory, member), sqlMembers(query, member));
+    }
+}
+
+// no false negatives and only a few false positives
+void MembershipDirectoryTest::nonMembers()
+{
+    int falsePositives = 0;
+
+    for ( int i = 0; i < NON_MEMBER_CALLSIGNS; i++ )
+    {
+        const QString nonMember = callsign(i, false);
+
+        if ( directory->mightContain(nonMember) )
+            falsePositives++;
+
+        QVERIFY(directory->members(nonMember).isEmpty());
+    }
+
+    const double rate = static_cast<double>(falsePositives) / NON_MEMBER_CALLSIGNS;
+
+    qInfo() << "Bloom filter false positive rate:" << rate;
+    QVERIFY(rate < MAX_FALSE_POSITIVE_RATE);
+}
+
+void MembershipDirectoryTest::unknownCallsign()
+{
+    QVERIFY(directory->members(QString()).isEmpty());
+    QVERIFY(directory->members("ok1mlg").isEmpty());
+}
+
+void MembershipDirectoryTest::snapshot()
+{
+    QVERIFY(MembershipDirectory::current().isNull());
+
+    MembershipDirectory::setCurrent(directory);
+    QCOMPARE(MembershipDirectory::current(), directory);
+
+    // the reader keeps the previous snapshot
+    const QSharedPointer<const MembershipDirectory> reader = MembershipDirectory::current();
+    MembershipDirectory::setCurrent(MembershipDirectory::load());
+    QVERIFY(MembershipDirectory::current() != reader);
+    QCOMPARE(reader->callsignCount(), MEMBER_CALLSIGNS);
+    QCOMPARE(MembershipDirectory::current()->callsignCount(), MEMBER_CALLSIGNS);
+
+    MembershipDirectory::setCurrent(QSharedPointer<const MembershipDirectory>());
+}
+
+// MembershipQE::query returns the same memberships before and after
+// the directory is loaded
+void MembershipDirectoryTest::membershipQuery()
+{
+    QSqlQuery sqlQuery;
+    QSqlQuery clubQuery;
+
+    QVERIFY(sqlQuery.prepare("SELECT DISTINCT callsign, member_id, valid_from, valid_to, clubid "
+                             "FROM membership WHERE callsign = :callsign ORDER BY clubid"));
+    QVERIFY(MembershipQE::prepareClubQuery(clubQuery));
+    QVERIFY(MembershipDirectory::current().isNull());
+
+    QStringList callsigns;
+
+    for ( int i = 0; i < MEMBER_CALLSIGNS; i += 50 )
+        callsigns << callsign(i, true) << callsign(i, false);
+
+    QHash<QString, QStringList> sqlPath;
+
+    for ( const QString &member : qAsConst(callsigns) )
+    {
+        const QList<ClubInfo> clubs = MembershipQE::query(member, clubQuery);
+
+        for ( const ClubInfo &club : clubs )
+            QCOMPARE(club.getCallsign(), member);
+
+        sqlPath[member] = clubInfoMembers(clubs);
+        QCOMPARE(sqlPath[member], sqlMembers(sqlQuery, member));
+    }
+
+    MembershipDirectory::setCurrent(directory);
+
+    for ( const QString &member : qAsConst(callsigns) )
+        QCOMPARE(clubInfoMembers(MembershipQE::query(member, clubQuery)), sqlPath.value(member));
+
+    MembershipDirectory::setCurrent(QSharedPointer<const MembershipDirectory>());
+}
+
+void MembershipDirectoryTest::query_benchmark_data()
+{
+    QTest::addColumn<bool>("useDirectory");
+
+    QTest::newRow("sql") << false;
+    QTest::newRow("directory") << true;
+}
+
+void MembershipDirectoryTest::query_benchmark()
+{
+    QFETCH(bool, useDirectory);
+
+    const QStringList callsigns = queriedCallsigns();
+    QSqlQuery query;
+    int found = 0;
+
+    QVERIFY(query.prepare("SELECT DISTINCT callsign, member_id, valid_from, valid_to, clubid "
+                          "FROM membership WHERE callsign = :callsign ORDER BY clubid"));
+
+    QBENCHMARK
+    {
+        found = 0;
+        for ( const QString &callsign : callsigns )
+            found += ( useDirectory ) ? directoryMembers(*directory, callsign).size()
+                                      : sqlMembers(query, callsign).size();
+    }
+
+    QVERIFY(found > 0);
+}
+
+QString MembershipDirectoryTest::callsign(int index, bool member)
+{
+    // members and non-members differ in the last letter
+    return QString("OK%1%2%3").arg(index % 10)
+                              .arg(QString::number(index / 10, 36).toUpper())
+                              .arg(( member ) ? 'A' : 'Z');
+}
+
+QStringList MembershipDirectoryTest::sqlMembers(QSqlQuery &query, const QString &callsign)
+{
+    QStringList ret;
+
+    query.bindValue(":callsign", callsign);
+
+    if ( !query.exec() )
+        return ret;
+
+    while ( query.next() )
+        ret << QStringList({query.value(4).toString(),
+                            query.value(1).toString(),
+                            query.value(2).toString(),
+                            query.value(3).toString()}).join('|');
+
+    // the order of the memberships in one club is not defined
+    ret.sort();
+    return ret;
+}
+
+QStringList MembershipDirectoryTest::directoryMembers(const MembershipDirectory &directory,
+                                                      const QString &callsign)
+{
+    QStringList ret;
+    const QVector<MembershipDirectory::Member> members = directory.members(callsign);
+
+    for ( const MembershipDirectory::Member &member : members )
+        ret << QStringList({member.clubID,
+                            member.memberID,
+                            member.validFrom.toString("yyyyMMdd"),
+                            member.validTo.toString("yyyyMMdd")}).join('|');
+
+    ret.sort();
+    return ret;
+}
+
+QStringList MembershipDirectoryTest::clubInfoMembers(const QList<ClubInfo> &clubs)
+{
+    QStringList ret;
+
+    for ( const ClubInfo &club : clubs )
+        ret << QStringList({club.getClubInfo(),
+                            club.getID(),
+                            club.getValidFrom().toString("yyyyMMdd"),
+                            club.getValidTo().toString("yyyyMMdd")}).join('|');
+
+    ret.sort();
+    return ret;
+}
+
+// a typical band - most of the spotted callsigns are not members of any club
+QStringList MembershipDirectoryTest::queriedCallsigns()
+{
+    QRandomGenerator random(2);
+    QStringList ret;
+
+    for ( int i = 0; i < QUERY_ROUNDS; i++ )
+        ret << callsign(random.bounded(MEMBER_CALLSIGNS), random.bounded(5) == 0);
+
+    return ret;
+}
+
+QTEST_GUILESS_MAIN(MembershipDirectoryTest)
+
+#include "tst_membershipdirectory.moc"
@@ -0,0 +1,13 @@
+QT += testlib core sql
+CONFIG += console testcase c++11
+TEMPLATE = app
+TARGET = tst_qslcontactindex
+
+INCLUDEPATH += $$PWD/../..
+
+SOURCES += \
+    tst_qslcontactindex.cpp \
+    ../../logformat/QSLContactIndex.cpp
+
+HEADERS += \
+    ../../logformat/QSLContactIndex.h
@@ -0,0 +1,286 @@
+#include <QtTest>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+
+#include "logformat/QSLContactIndex.h"
+
+namespace {
+const int BENCHMARK_CONTACTS = 100000;
+const int SQL_CONFIRMATIONS = 200;
+}
+
+class QSLContactIndexTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void matchMode_data();
+    void matchMode();
+    void matchModeGroup();
+    void ambiguous();
+    void incrementalLoad();
+    void match_benchmark_data();
+    void match_benchmark();
+
+private:
+    struct Confirmation
+    {
+        QString callsign;
+        QString band;
+        QString mode;
+        QDateTime startTime;
+    };
+
+    static QDateTime utc(const QString &time);
+    static void insertContacts(const QString &connectionName, int count);
+    static QList<Confirmation> makeConfirmations(int count);
+    static qlonglong matchSQL(QSqlQuery &query, const Confirmation &confirmation);
+    static int matchIndex(const QString &connectionName, const QList<Confirmation> &confirmations);
+};
+
+QDateTime QSLContactIndexTest::utc(const QString &time)
+{
+    QDateTime ret = QDateTime::fromString(time, Qt::ISODate);
+    ret.setTimeSpec(Qt::UTC);
+    return ret;
+}
+
+void QSLContactIndexTest::initTestCase()
+{
+    QLoggingCategory::setFilterRules(QStringLiteral("*.debug=false"));
+
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE");
+    db.setDatabaseName(":memory:");
+    QVERIFY(db.open());
+
+    QSqlQuery query;
+    QVERIFY(query.exec("CREATE TABLE contacts (id INTEGER PRIMARY KEY, callsign TEXT, band TEXT, "
+                       "sat_name TEXT, mode TEXT, start_time TEXT)"));
+    QVERIFY(query.exec("CREATE INDEX contacts_start_time_idx ON contacts (start_time)"));
+    QVERIFY(query.exec("CREATE TABLE modes (name TEXT, dxcc TEXT)"));
+    QVERIFY(query.exec("INSERT INTO modes VALUES ('CW', 'CW'), ('SSB', 'PHONE'), ('FM', 'PHONE'), "
+                       "('FT8', 'DIGITAL'), ('RTTY', 'DIGITAL')"));
+    QVERIFY(query.exec("INSERT INTO contacts (id, callsign, band, sat_name, mode, start_time) VALUES "
+                       "(1, 'OK1ABC', '20m', NULL, 'CW', '2024-01-01T10:00:00'), "
+                       "(2, 'OK1ABC', '40m', NULL, 'SSB', '2024-01-01T11:00:00'), "
+                       "(3, 'DL1XYZ', '2m', 'AO-91', 'FM', '2024-01-02T12:00:00'), "
+                       "(4, 'ok2low', '20m', NULL, 'FT8', '2024-01-03T08:00:00')"));
+
+    // second database for the benchmark
+    QSqlDatabase benchmarkDB = QSqlDatabase::addDatabase("QSQLITE", "benchmark");
+    benchmarkDB.setDatabaseName(":memory:");
+    QVERIFY(benchmarkDB.open());
+    insertContacts("benchmark", BENCHMARK_CONTACTS);
+}
+
+void QSLContactIndexTest::matchMode_data()
+{
+    QTest::addColumn<QString>("callsign");
+    QTest::addColumn<QString>("band");
+    QTest::addColumn<QString>("satName");
+    QTest::addColumn<QString>("mode");
+    QTest::addColumn<QString>("startTime");
+    QTest::addColumn<qlonglong>("expected");
+
+    QTest::newRow("exact") << "OK1ABC" << "20m" << "" << "CW" << "2024-01-01T10:00:00" << 1LL;
+    QTest::newRow("lowerCaseQSL") << "ok1abc" << "20M" << "" << "cw" << "2024-01-01T10:00:00" << 1LL;
+    QTest::newRow("window") << "OK1ABC" << "20m" << "" << "CW" << "2024-01-01T10:29:59" << 1LL;
+    QTest::newRow("windowBefore") << "OK1ABC" << "20m" << "" << "CW" << "2024-01-01T09:30:01" << 1LL;
+    QTest::newRow("outOfWindow") << "OK1ABC" << "20m" << "" << "CW" << "2024-01-01T10:30:00" << QSLContactIndex::NO_MATCH;
+    QTest::newRow("otherBand") << "OK1ABC" << "40m" << "" << "CW" << "2024-01-01T10:00:00" << QSLContactIndex::NO_MATCH;
+    QTest::newRow("otherMode") << "OK1ABC" << "20m" << "" << "SSB" << "2024-01-01T10:00:00" << QSLContactIndex::NO_MATCH;
+    QTest::newRow("sat") << "DL1XYZ" << "2m" << "ao-91" << "FM" << "2024-01-02T12:10:00" << 3LL;
+    QTest::newRow("satMissing") << "DL1XYZ" << "2m" << "" << "FM" << "2024-01-02T12:10:00" << QSLContactIndex::NO_MATCH;
+    // stored callsign is compared with upper(QSL callsign)
+    QTest::newRow("lowerCaseContact") << "ok2low" << "20m" << "" << "FT8" << "2024-01-03T08:00:00" << QSLContactIndex::NO_MATCH;
+}
+
+void QSLContactIndexTest::matchMode()
+{
+    QFETCH(QString, callsign);
+    QFETCH(QString, band);
+    QFETCH(QString, satName);
+    QFETCH(QString, mode);
+    QFETCH(QString, startTime);
+    QFETCH(qlonglong, expected);
+
+    QSLContactIndex index;
+
+    QVERIFY(index.load(utc(startTime), utc(startTime)));
+    QCOMPARE(index.matchMode(callsign, band, satName, mode, utc(startTime)), expected);
+}
+
+void QSLContactIndexTest::matchModeGroup()
+{
+    QSLContactIndex index;
+
+    QVERIFY(index.load(utc("2024-01-01T00:00:00"), utc("2024-01-01T23:00:00")));
+
+    QCOMPARE(index.matchMode("OK1ABC", "40m", "", "USB", utc("2024-01-01T11:00:00")), QSLContactIndex::NO_MATCH);
+    QCOMPARE(index.matchModeGroup("OK1ABC", "40m", "", "PHONE", utc("2024-01-01T11:00:00")), 2LL);
+    QCOMPARE(index.matchModeGroup("OK1ABC", "40m", "", "CW", utc("2024-01-01T11:00:00")), QSLContactIndex::NO_MATCH);
+    QCOMPARE(index.matchModeGroup("OK1ABC", "40m", "", "", utc("2024-01-01T11:00:00")), QSLContactIndex::NO_MATCH);
+}
+
+void QSLContactIndexTest::ambiguous()
+{
+    QSLContactIndex index(QLatin1String("none"));
+
+    index.addContact(10, "OK1ABC", "20m", "", "CW", "CW", utc("2024-01-01T10:00:00").toSecsSinceEpoch());
+    index.addContact(11, "OK1ABC", "20m", "", "CW", "CW", utc("2024-01-01T10:20:00").toSecsSinceEpoch());
+
+    QCOMPARE(index.size(), 2);
+    QCOMPARE(index.matchMode("OK1ABC", "20m", "", "CW", utc("2024-01-01T10:10:00")), QSLContactIndex::NO_MATCH);
+    QCOMPARE(index.matchMode("OK1ABC", "20m", "", "CW", utc("2024-01-01T09:40:00")), 10LL);
+    QCOMPARE(index.matchModeGroup("OK1ABC", "20m", "", "CW", utc("2024-01-01T10:45:00")), 11LL);
+
+    index.clear();
+    QCOMPARE(index.size(), 0);
+}
+
+void QSLContactIndexTest::incrementalLoad()
+{
+    QSLContactIndex index;
+
+    QVERIFY(index.load(utc("2024-01-03T08:00:00"), utc("2024-01-03T08:00:00")));
+    const int firstLoad = index.size();
+
+    // the same range again - nothing is loaded
+    QVERIFY(index.load(utc("2024-01-03T09:00:00"), utc("2024-01-03T10:00:00")));
+    QCOMPARE(index.size(), firstLoad);
+
+    QVERIFY(index.load(utc("2023-12-01T00:00:00"), utc("2024-02-01T00:00:00")));
+    QCOMPARE(index.size(), 4);
+    QCOMPARE(index.matchMode("OK1ABC", "20m", "", "CW", utc("2024-01-01T10:00:00")), 1LL);
+}
+
+void QSLContactIndexTest::insertContacts(const QString &connectionName, int count)
+{
+    QSqlDatabase db = QSqlDatabase::database(connectionName);
+    QSqlQuery query(db);
+
+    QVERIFY(query.exec("CREATE TABLE contacts (id INTEGER PRIMARY KEY, callsign TEXT, band TEXT, "
+                       "sat_name TEXT, mode TEXT, start_time TEXT)"));
+    QVERIFY(query.exec("CREATE INDEX contacts_start_time_idx ON contacts (start_time)"));
+    QVERIFY(query.exec("CREATE TABLE modes (name TEXT, dxcc TEXT)"));
+    QVERIFY(query.exec("INSERT INTO modes VALUES ('CW', 'CW'), ('SSB', 'PHONE'), ('FT8', 'DIGITAL')"));
+
+    static const QStringList bands = {"80m", "40m", "20m", "15m", "10m"};
+    static const QStringList modes = {"CW", "SSB", "FT8"};
+    const QDateTime start = utc("2015-01-01T00:00:00");
+
+    QVERIFY(db.transaction());
+    QVERIFY(query.prepare("INSERT INTO contacts (callsign, band, mode, start_time) "
+                          "VALUES (:callsign, :band, :mode, :startTime)"));
+
+    for ( int i = 0; i < count; i++ )
+    {
+        query.bindValue(":callsign", QString("OK%1ABC").arg(i % 5000));
+        query.bindValue(":band", bands.at(i % bands.size()));
+        query.bindValue(":mode", modes.at((i / 7) % modes.size()));
+        query.bindValue(":startTime", start.addSecs(i * 1200LL).toString("yyyy-MM-ddThh:mm:ss"));
+        QVERIFY(query.exec());
+    }
+    QVERIFY(db.commit());
+}
+
+QList<QSLContactIndexTest::Confirmation> QSLContactIndexTest::makeConfirmations(int count)
+{
+    static const QStringList bands = {"80m", "40m", "20m", "15m", "10m"};
+    static const QStringList modes = {"CW", "SSB", "FT8"};
+    const QDateTime start = utc("2015-01-01T00:00:00");
+    QList<Confirmation> ret;
+
+    // every contact is confirmed; the confirmation time differs by a few minutes
+    for ( int i = 0; i < count; i++ )
+    {
+        ret << Confirmation{QString("ok%1abc").arg(i % 5000),
+                            bands.at(i % bands.size()),
+                            modes.at((i / 7) % modes.size()),
+                            start.addSecs(i * 1200LL + (i % 10) * 60)};
+    }
+    return ret;
+}
+
+// the original per-QSL SQL filter
+qlonglong QSLContactIndexTest::matchSQL(QSqlQuery &query, const Confirmation &confirmation)
+{
+    const QString startTimeStr = confirmation.startTime.toString("yyyy-MM-dd hh:mm:ss");
+
+    query.exec(QString("SELECT id FROM contacts WHERE "
+                       "callsign=upper('%1') AND upper(band)=upper('%2') AND "
+                       "COALESCE(sat_name, '') = upper('') AND "
+                       "ABS(JULIANDAY(start_time)-JULIANDAY(datetime('%3')))*24*60<30 AND "
+                       "upper(mode)=upper('%4')").arg(confirmation.callsign,
+                                                      confirmation.band,
+                                                      startTimeStr,
+                                                      confirmation.mode));
+    qlonglong ret = QSLContactIndex::NO_MATCH;
+    int rows = 0;
+
+    while ( query.next() )
+    {
+        ret = query.value(0).toLongLong();
+        rows++;
+    }
+    return ( rows == 1 ) ? ret : QSLContactIndex::NO_MATCH;
+}
+
+int QSLContactIndexTest::matchIndex(const QString &connectionName, const QList<Confirmation> &confirmations)
+{
+    QSLContactIndex index(connectionName);
+    int matched = 0;
+
+    index.load(confirmations.first().startTime, confirmations.last().startTime);
+
+    for ( const Confirmation &confirmation : confirmations )
+    {
+        if ( index.matchMode(confirmation.callsign, confirmation.band, QString(),
+                             confirmation.mode, confirmation.startTime) != QSLContactIndex::NO_MATCH )
+            matched++;
+    }
+    return matched;
+}
+
+void QSLContactIndexTest::match_benchmark_data()
+{
+    QTest::addColumn<bool>("indexed");
+
+    QTest::newRow("sql") << false;
+    QTest::newRow("index") << true;
+}
+
+void QSLContactIndexTest::match_benchmark()
+{
+    QFETCH(bool, indexed);
+
+    const QList<Confirmation> confirmations = makeConfirmations(( indexed ) ? BENCHMARK_CONTACTS
+                                                                            : SQL_CONFIRMATIONS);
+    int matched = 0;
+
+    if ( indexed )
+    {
+        QBENCHMARK
+        {
+            matched = matchIndex("benchmark", confirmations);
+        }
+    }
+    else
+    {
+        QSqlQuery query(QSqlDatabase::database("benchmark"));
+
+        QBENCHMARK
+        {
+            matched = 0;
+            for ( const Confirmation &confirmation : confirmations )
+                matched += ( matchSQL(query, confirmation) != QSLContactIndex::NO_MATCH );
+        }
+    }
+    QCOMPARE(matched, confirmations.size());
+}
+
+QTEST_MAIN(QSLContactIndexTest)
+
+#include "tst_qslcontactindex.moc"
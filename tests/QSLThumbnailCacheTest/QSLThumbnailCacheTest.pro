@@ -0,0 +1,13 @@
+QT += testlib core gui
+CONFIG += console testcase c++11
+TEMPLATE = app
+TARGET = tst_qslthumbnailcache
+
+INCLUDEPATH += $$PWD/../..
+
+SOURCES += \
+    tst_qslthumbnailcache.cpp \
+    ../../core/QSLThumbnailCache.cpp
+
+HEADERS += \
+    ../../core/QSLThumbnailCache.h
@@ -0,0 +1,191 @@
+#include <QtTest>
+#include <QBuffer>
+#include <QImage>
+#include <QPainter>
+#include <QTemporaryDir>
+
+#include "core/QSLThumbnailCache.h"
+
+namespace {
+const QSize CARD_SIZE(2000, 1280);  // typical scanned paper QSL
+}
+
+class QSLThumbnailCacheTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void thumbnail_data();
+    void thumbnail();
+    void notAnImage();
+    void key();
+    void cache();
+    void thumbnail_benchmark_data();
+    void thumbnail_benchmark();
+
+private:
+    static QByteArray card(const QSize &size, const char *format);
+    static QImage referenceThumbnail(const QByteArray &data);
+
+    QTemporaryDir cacheDir;
+    QByteArray jpegCard;
+};
+
+void QSLThumbnailCacheTest::initTestCase()
+{
+    QLoggingCategory::setFilterRules(QStringLiteral("*.debug=false"));
+
+    QVERIFY(cacheDir.isValid());
+
+    jpegCard = card(CARD_SIZE, "JPG");
+    QVERIFY(!jpegCard.isEmpty());
+}
+
+void QSLThumbnailCacheTest::thumbnail_data()
+{
+    QTest::addColumn<QByteArray>("data");
+
+    QTest::newRow("jpeg landscape") << card(CARD_SIZE, "JPG");
+    QTest::newRow("jpeg portrait") << card(CARD_SIZE.transposed(), "JPG");
+    QTest::newRow("png landscape") << card(CARD_SIZE, "PNG");
+    QTest::newRow("small png") << card(QSize(100, 60), "PNG");
+}
+
+// the thumbnail has the same size as the full resolution image scaled down
+void QSLThumbnailCacheTest::thumbnail()
+{
+    QFETCH(QByteArray, data);
+
+    const QImage thumbnail = QSLThumbnailCache::createThumbnail(data);
+    const QImage reference = referenceThumbnail(data);
+
+    QVERIFY(!thumbnail.isNull());
+    QCOMPARE(thumbnail.size(), reference.size());
+
+    // the card is red on the left and blue on the right
+    const QColor left = thumbnail.pixelColor(thumbnail.width() / 8, thumbnail.height() / 2);
+    const QColor right = thumbnail.pixelColor(thumbnail.width() * 7 / 8, thumbnail.height() / 2);
+
+    QVERIFY(left.red() > left.blue());
+    QVERIFY(right.blue() > right.red());
+}
+
+void QSLThumbnailCacheTest::notAnImage()
+{
+    QVERIFY(QSLThumbnailCache::createThumbnail(QByteArray("%PDF-1.4\n%\xe2\xe3\xcf\xd3\n")).isNull());
+    QVERIFY(QSLThumbnailCache::createThumbnail(QByteArray()).isNull());
+}
+
+void QSLThumbnailCacheTest::key()
+{
+    const QString key = QSLThumbnailCache::key(1, 0, "card.jpg", "abc");
+
+    QCOMPARE(QSLThumbnailCache::key(1, 0, "card.jpg", "abc"), key);
+    QVERIFY(QSLThumbnailCache::key(2, 0, "card.jpg", "abc") != key);
+    QVERIFY(QSLThumbnailCache::key(1, 1, "card.jpg", "abc") != key);
+    QVERIFY(QSLThumbnailCache::key(1, 0, "back.jpg", "abc") != key);
+    QVERIFY(QSLThumbnailCache::key(1, 0, "card.jpg", "abd") != key);
+
+    // the content is unknown
+    QVERIFY(QSLThumbnailCache::key(1, 0, "card.jpg", QString()).isEmpty());
+
+    // the key is a valid file name
+    QVERIFY(!key.contains('/') && !key.contains('.'));
+}
+
+void QSLThumbnailCacheTest::cache()
+{
+    const QSLThumbnailCache thumbnailCache(cacheDir.filePath("cache"));
+    const QString key = QSLThumbnailCache::key(1, 0, "../card.jpg", "abc");
+    const QImage thumbnail = QSLThumbnailCache::createThumbnail(jpegCard);
+
+    QVERIFY(thumbnailCache.load(key).isNull());
+    QVERIFY(thumbnailCache.store(key, thumbnail));
+
+    QImage cached = thumbnailCache.load(key);
+    QCOMPARE(cached.size(), thumbnail.size());
+    QCOMPARE(cached.convertToFormat(QImage::Format_RGB32), thumbnail.convertToFormat(QImage::Format_RGB32));
+
+    // replaced thumbnail
+    const QImage small = QSLThumbnailCache::createThumbnail(card(QSize(100, 60), "PNG"));
+    QVERIFY(thumbnailCache.store(key, small));
+    QCOMPARE(thumbnailCache.load(key).size(), small.size());
+
+    // the content of the card is changed
+    QVERIFY(thumbnailCache.load(QSLThumbnailCache::key(1, 0, "../card.jpg", "abd")).isNull());
+
+    QVERIFY(!thumbnailCache.store(QString(), thumbnail));
+    QVERIFY(!thumbnailCache.store(key, QImage()));
+    QVERIFY(thumbnailCache.load(QString()).isNull());
+}
+
+void QSLThumbnailCacheTest::thumbnail_benchmark_data()
+{
+    QTest::addColumn<int>("path");
+
+    QTest::newRow("full decode") << 0;
+    QTest::newRow("scaled decode") << 1;
+    QTest::newRow("cache") << 2;
+}
+
+void QSLThumbnailCacheTest::thumbnail_benchmark()
+{
+    QFETCH(int, path);
+
+    const QSLThumbnailCache thumbnailCache(cacheDir.filePath("benchmark"));
+    const QString key = QSLThumbnailCache::key(1, 0, "card.jpg", "benchmark");
+
+    QVERIFY(thumbnailCache.store(key, QSLThumbnailCache::createThumbnail(jpegCard)));
+
+    QImage thumbnail;
+
+    QBENCHMARK
+    {
+        switch ( path )
+        {
+        case 0:
+            thumbnail = referenceThumbnail(jpegCard);
+            break;
+        case 1:
+            thumbnail = QSLThumbnailCache::createThumbnail(jpegCard);
+            break;
+        default:
+            thumbnail = thumbnailCache.load(key);
+        }
+    }
+
+    QVERIFY(!thumbnail.isNull());
+}
+
+QByteArray QSLThumbnailCacheTest::card(const QSize &size, const char *format)
+{
+    QImage image(size, QImage::Format_RGB32);
+    QPainter painter(&image);
+
+    painter.fillRect(0, 0, size.width() / 2, size.height(), Qt::red);
+    painter.fillRect(size.width() / 2, 0, size.width() - size.width() / 2, size.height(), Qt::blue);
+    painter.setPen(Qt::white);
+
+    for ( int i = 0; i < size.height(); i += 8 )
+        painter.drawLine(0, i, size.width(), i + size.height() / 4);
+
+    painter.end();
+
+    QByteArray ret;
+    QBuffer buffer(&ret);
+    buffer.open(QIODevice::WriteOnly);
+    image.save(&buffer, format);
+    return ret;
+}
+
+// the previous thumbnail generation - the full resolution image is decoded and scaled
+QImage QSLThumbnailCacheTest::referenceThumbnail(const QByteArray &data)
+{
+    return QImage::fromData(data).scaled(QSLThumbnailCache::thumbnailSize,
+                                         Qt::KeepAspectRatio, Qt::SmoothTransformation);
+}
+
+QTEST_GUILESS_MAIN(QSLThumbnailCacheTest)
+
+#include "tst_qslthumbnailcache.moc"
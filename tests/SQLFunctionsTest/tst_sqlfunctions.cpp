@@ -0,0 +1,226 @@
+#include <QtTest>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QSqlDriver>
+#include <QRandomGenerator>
+#include <sqlite3.h>
+
+#include "core/SQLFunctions.h"
+
+namespace {
+const int RANDOM_CALLSIGNS = 100000;
+const int IMPORT_SIZE = 20000;
+
+// the base callsign evaluated by the contacts_autovalue triggers before the native function
+const QString BASE_CALLSIGN_CTE =
+    "(WITH tokenizedCallsign(word, csv) AS ( SELECT '', %1||'/' "
+    "                                        UNION ALL "
+    "                                        SELECT substr(csv, 0, instr(csv, '/')), substr(csv, instr(csv, '/') + 1) "
+    "                                        FROM tokenizedCallsign "
+    "                                        WHERE csv != '' ) "
+    " SELECT word FROM tokenizedCallsign "
+    " WHERE word != '' and word REGEXP '^([A-Z][0-9]|[A-Z]{1,2}|[0-9][A-Z])([0-9]|[0-9]+)([A-Z]+)$' LIMIT 1)";
+}
+
+class SQLFunctionsTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void baseCallsign_data();
+    void baseCallsign();
+    void sqlNull();
+    void cteEquivalence();
+    void import_benchmark_data();
+    void import_benchmark();
+
+private:
+    static void createContacts(bool native);
+    static void importContacts();
+    static QString randomCallsign(QRandomGenerator &random);
+};
+
+void SQLFunctionsTest::initTestCase()
+{
+    QLoggingCategory::setFilterRules(QStringLiteral("*.debug=false"));
+
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE");
+    db.setDatabaseName(":memory:");
+    db.setConnectOptions("QSQLITE_ENABLE_REGEXP");
+    QVERIFY(db.open());
+
+    const QVariant handle = db.driver()->handle();
+    QVERIFY(handle.isValid() && qstrcmp(handle.typeName(), "sqlite3*") == 0);
+    QVERIFY(SQLFunctions::registerFunctions(*static_cast<sqlite3 * const *>(handle.constData())));
+    QVERIFY(!SQLFunctions::registerFunctions(nullptr));
+
+    QSqlQuery query;
+    QVERIFY(query.exec("PRAGMA foreign_keys = ON"));
+}
+
+void SQLFunctionsTest::baseCallsign_data()
+{
+    QTest::addColumn<QString>("callsign");
+    QTest::addColumn<QString>("base");
+
+    QTest::newRow("base") << "OK1ABC" << "OK1ABC";
+    QTest::newRow("one letter prefix") << "W1AW" << "W1AW";
+    QTest::newRow("letter digit prefix") << "E73A" << "E73A";
+    QTest::newRow("digit letter prefix") << "9A1AA" << "9A1AA";
+    QTest::newRow("long number") << "OK12345ABC" << "OK12345ABC";
+    QTest::newRow("portable") << "OK1ABC/P" << "OK1ABC";
+    QTest::newRow("host prefix") << "SV9/OK1ABC/P" << "OK1ABC";
+    QTest::newRow("host prefix like base") << "DL1A/OK1ABC" << "DL1A";
+    QTest::newRow("maritime mobile") << "OK1ABC/MM" << "OK1ABC";
+    QTest::newRow("empty parts") << "//OK1ABC//" << "OK1ABC";
+    QTest::newRow("three letter prefix") << "ABC1DEF" << QString();
+    QTest::newRow("no suffix") << "OK1" << QString();
+    QTest::newRow("no number") << "OKABC" << QString();
+    QTest::newRow("lower case") << "ok1abc" << QString();
+    QTest::newRow("digits only") << "12345" << QString();
+    QTest::newRow("empty") << "" << QString();
+    QTest::newRow("slash") << "/" << QString();
+    QTest::newRow("non-ascii") << QString::fromUtf8("OK1ÁBC") << QString();
+}
+
+void SQLFunctionsTest::baseCallsign()
+{
+    QFETCH(QString, callsign);
+    QFETCH(QString, base);
+
+    QCOMPARE(SQLFunctions::baseCallsign(callsign), base);
+
+    QSqlQuery query;
+
+    QVERIFY(query.prepare("SELECT base_callsign(?)"));
+    query.addBindValue(callsign);
+    QVERIFY2(query.exec() && query.first(), qPrintable(query.lastError().text()));
+    QCOMPARE(query.value(0).toString(), base);
+    QCOMPARE(query.value(0).isNull(), base.isNull());
+}
+
+void SQLFunctionsTest::sqlNull()
+{
+    QSqlQuery query;
+
+    QVERIFY(query.exec("SELECT base_callsign(NULL), base_callsign(12345)"));
+    QVERIFY(query.first());
+    QVERIFY(query.value(0).isNull());
+    QVERIFY(query.value(1).isNull());
+
+    QVERIFY(!query.exec("SELECT base_callsign('OK1ABC', 'OK1ABC')"));
+}
+
+// the native function returns the same value as the CTE of the previous triggers
+void SQLFunctionsTest::cteEquivalence()
+{
+    QRandomGenerator random(1);
+    QSqlQuery query;
+
+    QVERIFY(query.prepare(QString("SELECT base_callsign(?), %1").arg(BASE_CALLSIGN_CTE.arg("?"))));
+
+    for ( int i = 0; i < RANDOM_CALLSIGNS; i++ )
+    {
+        const QString callsign = randomCallsign(random);
+
+        query.addBindValue(callsign);
+        query.addBindValue(callsign);
+        QVERIFY2(query.exec() && query.first(), qPrintable(query.lastError().text()));
+
+        if ( query.value(0).toString() != query.value(1).toString()
+             || query.value(0).isNull() != query.value(1).isNull() )
+            QFAIL(qPrintable(QString("%1: %2 != %3").arg(callsign,
+                                                        query.value(0).toString(),
+                                                        query.value(1).toString())));
+    }
+}
+
+void SQLFunctionsTest::import_benchmark_data()
+{
+    QTest::addColumn<bool>("native");
+
+    QTest::newRow("cte trigger") << false;
+    QTest::newRow("native trigger") << true;
+}
+
+void SQLFunctionsTest::import_benchmark()
+{
+    QFETCH(bool, native);
+
+    QBENCHMARK
+    {
+        createContacts(native);
+        importContacts();
+    }
+
+    QSqlQuery query;
+    QVERIFY(query.exec("SELECT COUNT(1) FROM contacts_autovalue WHERE base_callsign IS NOT NULL"));
+    QVERIFY(query.first());
+    QVERIFY(query.value(0).toInt() > 0);
+}
+
+// the contacts table with the contacts_autovalue insert trigger
+void SQLFunctionsTest::createContacts(bool native)
+{
+    const QString baseCallsign = ( native ) ? QStringLiteral("base_callsign(NEW.callsign)")
+                                            : BASE_CALLSIGN_CTE.arg("NEW.callsign");
+    QSqlQuery query;
+
+    QVERIFY(query.exec("DROP TABLE IF EXISTS contacts_autovalue"));
+    QVERIFY(query.exec("DROP TABLE IF EXISTS contacts"));
+    QVERIFY(query.exec("CREATE TABLE contacts (id INTEGER PRIMARY KEY, callsign TEXT, band TEXT, mode TEXT)"));
+    QVERIFY(query.exec("CREATE TABLE contacts_autovalue (contactid INTEGER PRIMARY KEY REFERENCES contacts(id) ON DELETE CASCADE, "
+                       "base_callsign TEXT)"));
+    QVERIFY(query.exec("CREATE INDEX contacts_autovalue_call_idx ON contacts_autovalue(base_callsign)"));
+    QVERIFY2(query.exec(QString("CREATE TRIGGER insert_contacts_autovalue "
+                                "AFTER INSERT ON contacts "
+                                "FOR EACH ROW "
+                                "BEGIN "
+                                "  INSERT OR REPLACE INTO contacts_autovalue (contactid, base_callsign) "
+                                "  VALUES (NEW.id, %1); "
+                                "END").arg(baseCallsign)), qPrintable(query.lastError().text()));
+}
+
+// an ADIF import in one transaction
+void SQLFunctionsTest::importContacts()
+{
+    QSqlDatabase db = QSqlDatabase::database();
+    QSqlQuery query;
+
+    QVERIFY(db.transaction());
+    QVERIFY(query.prepare("INSERT INTO contacts (callsign, band, mode) VALUES (?, '20m', 'CW')"));
+
+    for ( int i = 0; i < IMPORT_SIZE; i++ )
+    {
+        QString callsign = QString("OK%1ABC").arg(i % 5000);
+
+        if ( i % 13 == 0 )
+            callsign.append("/P");
+        else if ( i % 17 == 0 )
+            callsign.prepend("SV9/");
+
+        query.addBindValue(callsign);
+        QVERIFY2(query.exec(), qPrintable(query.lastError().text()));
+    }
+
+    QVERIFY(db.commit());
+}
+
+// mostly callsign-like strings with portable designators
+QString SQLFunctionsTest::randomCallsign(QRandomGenerator &random)
+{
+    static const QString alphabet = QStringLiteral("AAKOZ0129//a \n");
+    const int length = random.bounded(13);
+    QString ret;
+
+    for ( int i = 0; i < length; i++ )
+        ret.append(alphabet.at(random.bounded(alphabet.size())));
+
+    return ret;
+}
+
+QTEST_GUILESS_MAIN(SQLFunctionsTest)
+
+#include "tst_sqlfunctions.moc"
@@ -0,0 +1,13 @@
+QT += testlib core sql
+CONFIG += console testcase c++11
+TEMPLATE = app
+TARGET = tst_statisticsrollup
+
+INCLUDEPATH += $$PWD/../..
+
+SOURCES += \
+    tst_statisticsrollup.cpp \
+    ../../core/StatisticsRollup.cpp
+
+HEADERS += \
+    ../../core/StatisticsRollup.h
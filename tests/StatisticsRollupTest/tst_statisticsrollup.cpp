@@ -0,0 +1,327 @@
+#include <QtTest>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QSqlRecord>
+
+#include "core/StatisticsRollup.h"
+
+namespace {
+const int LOG_SIZE = 100000;
+const int LOG_QSOS_PER_DAY = 300;     // QSOs of one operating day
+const int LOG_DAYS_BETWEEN = 11;      // days between two operating days
+const int LOG_ENTITIES = 150;
+}
+
+class StatisticsRollupTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void consistency();
+    void aggregates_data();
+    void aggregates();
+    void insertTrigger();
+    void updateTrigger();
+    void deleteTrigger();
+    void nullKeys();
+    void rebuild();
+    void aggregate_benchmark_data();
+    void aggregate_benchmark();
+
+private:
+    static QList<QVariantList> rows(const QString &stmt);
+    static QList<QVariantList> contactsGroups();
+    static QList<QVariantList> rollupGroups();
+    static QString perYear(bool useRollup);
+};
+
+void StatisticsRollupTest::initTestCase()
+{
+    QLoggingCategory::setFilterRules(QStringLiteral("*.debug=false"));
+
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE");
+    db.setDatabaseName(":memory:");
+    QVERIFY(db.open());
+
+    QSqlQuery query;
+    QVERIFY(query.exec("CREATE TABLE contacts (id INTEGER PRIMARY KEY, start_time TEXT, callsign TEXT, "
+                       "station_callsign TEXT, my_gridsquare TEXT, my_rig TEXT, my_antenna TEXT, "
+                       "band TEXT, mode TEXT, prop_mode TEXT, cont TEXT, dxcc INTEGER, "
+                       "eqsl_qsl_rcvd TEXT, lotw_qsl_rcvd TEXT, qsl_rcvd TEXT, qsl_sent TEXT)"));
+
+    // contacts which exist before the rollup is created
+    QVERIFY(query.exec("INSERT INTO contacts (start_time, callsign, station_callsign, band, mode, cont, dxcc, "
+                       "                      eqsl_qsl_rcvd, lotw_qsl_rcvd, qsl_rcvd) "
+                       "VALUES ('2015-06-01T10:00:00.000Z', 'OK1MLG', 'OK1ABC', '20m', 'CW', 'EU', 503, 'N', 'Y', 'N'), "
+                       "       ('2015-06-01T11:00:00.000Z', 'DL1ABC', 'OK1ABC', '20m', 'CW', 'EU', 230, 'N', 'N', 'N')"));
+
+    QVERIFY(StatisticsRollup::setup(db));
+    QVERIFY(StatisticsRollup::isAvailable());
+
+    static const QStringList bands = {"160m", "80m", "40m", "30m", "20m", "17m", "15m", "12m", "10m", "6m"};
+    static const QStringList modes = {"CW", "SSB", "FT8", "FT8", "FT8", "RTTY"};
+    static const QStringList conts = {"EU", "EU", "NA", "AS", "AF", "SA", "OC"};
+    const QDateTime start(QDate(2014, 1, 1), QTime(0, 0), Qt::UTC);
+
+    // the contacts inserted by the trigger; operating days with
+    // slowly changing bands and modes and a few frequent entities
+    QVERIFY(db.transaction());
+    QVERIFY(query.prepare("INSERT INTO contacts (start_time, callsign, station_callsign, my_gridsquare, my_rig, "
+                          "                      my_antenna, band, mode, prop_mode, cont, dxcc, "
+                          "                      eqsl_qsl_rcvd, lotw_qsl_rcvd, qsl_rcvd) "
+                          "VALUES (:start_time, :callsign, :station_callsign, :my_gridsquare, :my_rig, "
+                          "        :my_antenna, :band, :mode, :prop_mode, :cont, :dxcc, "
+                          "        :eqsl, :lotw, :paper)"));
+
+    for ( int i = 0; i < LOG_SIZE; i++ )
+    {
+        const QDateTime time = start.addDays(qint64(i / LOG_QSOS_PER_DAY) * LOG_DAYS_BETWEEN)
+                                    .addSecs((i % LOG_QSOS_PER_DAY) * 120);
+        const int entity = ( i % 4 != 0 ) ? i % 5 : (i * 7) % LOG_ENTITIES;
+
+        query.bindValue(":start_time", time.toString("yyyy-MM-dd'T'HH:mm:ss.zzz'Z'"));
+        query.bindValue(":callsign", QString("OK%1ABC").arg(i % 5000));
+        query.bindValue(":station_callsign", ( (i / 20000) % 2 == 0 ) ? "OK1ABC" : "OK1XYZ");
+        query.bindValue(":my_gridsquare", ( (i / 10000) % 3 == 0 ) ? QVariant() : QVariant("JN79"));
+        query.bindValue(":my_rig", ( (i / 30000) % 2 == 0 ) ? QVariant() : QVariant("IC-7300"));
+        query.bindValue(":my_antenna", ( (i / 7000) % 2 == 0 ) ? QVariant("Yagi") : QVariant("Dipole"));
+        query.bindValue(":band", bands.at((i / 100) % bands.size()));
+        query.bindValue(":mode", ( i % 97 == 0 ) ? QVariant() : QVariant(modes.at((i / LOG_QSOS_PER_DAY) % modes.size())));
+        query.bindValue(":prop_mode", ( i % 50 == 0 ) ? QVariant("SAT") : QVariant());
+        query.bindValue(":cont", conts.at(entity % conts.size()));
+        query.bindValue(":dxcc", entity);
+        query.bindValue(":eqsl", ( i % 5 == 0 ) ? "Y" : "N");
+        query.bindValue(":lotw", ( i % 4 == 0 ) ? "Y" : "N");
+        query.bindValue(":paper", ( i % 11 == 0 ) ? QVariant("Y") : QVariant());
+        QVERIFY2(query.exec(), qPrintable(query.lastError().text()));
+    }
+
+    QVERIFY(db.commit());
+}
+
+QList<QVariantList> StatisticsRollupTest::rows(const QString &stmt)
+{
+    QList<QVariantList> ret;
+    QSqlQuery query;
+
+    if ( !query.exec(stmt) )
+    {
+        qWarning() << query.lastError().text() << stmt;
+        return ret;
+    }
+
+    const int columns = query.record().count();
+
+    while ( query.next() )
+    {
+        QVariantList row;
+
+        for ( int i = 0; i < columns; i++ )
+            row << query.value(i);
+        ret << row;
+    }
+
+    return ret;
+}
+
+// the rollup computed from scratch
+QList<QVariantList> StatisticsRollupTest::contactsGroups()
+{
+    const QString columns = StatisticsRollup::groupColumns.join(", ");
+
+    return rows(QString("SELECT date(start_time) AS day, %1, "
+                        "       CASE WHEN (eqsl_qsl_rcvd = 'Y' OR lotw_qsl_rcvd = 'Y' OR qsl_rcvd = 'Y') "
+                        "       THEN 1 ELSE 0 END AS confirmed, COUNT(1) "
+                        "FROM contacts "
+                        "GROUP BY day, %1, confirmed "
+                        "ORDER BY day, %1, confirmed").arg(columns));
+}
+
+QList<QVariantList> StatisticsRollupTest::rollupGroups()
+{
+    const QString columns = StatisticsRollup::groupColumns.join(", ");
+
+    return rows(QString("SELECT day, %1, confirmed, cnt "
+                        "FROM contacts_rollup "
+                        "ORDER BY day, %1, confirmed").arg(columns));
+}
+
+// the statement of the QSOs per Year chart
+QString StatisticsRollupTest::perYear(bool useRollup)
+{
+    const QString source = ( useRollup ) ? StatisticsRollup::tableName : QStringLiteral("contacts");
+    const QString countExpr = ( useRollup ) ? QStringLiteral("SUM(cnt)") : QStringLiteral("COUNT(1)");
+    const QString timeColumn = ( useRollup ) ? QStringLiteral("day") : QStringLiteral("start_time");
+
+    return QString("WITH RECURSIVE cnt(incnt) AS ( "
+                   " SELECT CAST(MIN(%3) as INTEGER) from %1 "
+                   " UNION ALL "
+                   " SELECT incnt + 1 FROM cnt WHERE incnt < (select strftime('%Y', DATE())) "
+                   " ) "
+                   " SELECT col1, SUM(cnt) "
+                   " FROM ( "
+                   "   SELECT incnt as col1, 0 as cnt from cnt "
+                   "   UNION ALL "
+                   "   SELECT CAST(strftime('%Y', %3) as INTEGER) as col1, %2 as cnt "
+                   "   FROM %1 WHERE (band = '20m') GROUP BY col1 "
+                   " ) "
+                   " GROUP BY col1 ORDER BY col1").arg(source, countExpr, timeColumn);
+}
+
+void StatisticsRollupTest::consistency()
+{
+    const QList<QVariantList> expected = contactsGroups();
+
+    QVERIFY(!expected.isEmpty());
+    // QSOs of the same day and key are counted in one row
+    QVERIFY(expected.size() < LOG_SIZE);
+    QCOMPARE(rollupGroups(), expected);
+}
+
+void StatisticsRollupTest::aggregates_data()
+{
+    QTest::addColumn<QString>("contactsStmt");
+    QTest::addColumn<QString>("rollupStmt");
+
+    QTest::newRow("mode") << "SELECT IFNULL(mode, 'NA'), COUNT(1) FROM contacts WHERE 1 = 1 GROUP BY mode ORDER BY mode"
+                          << "SELECT IFNULL(mode, 'NA'), SUM(cnt) FROM contacts_rollup WHERE 1 = 1 GROUP BY mode ORDER BY mode";
+    QTest::newRow("contFiltered") << "SELECT cont, COUNT(1) FROM contacts WHERE (my_rig is NULL) AND (band = '40m') GROUP BY cont ORDER BY cont"
+                                  << "SELECT cont, SUM(cnt) FROM contacts_rollup WHERE (my_rig is NULL) AND (band = '40m') GROUP BY cont ORDER BY cont";
+    QTest::newRow("dateRange") << "SELECT dxcc, COUNT(1) FROM contacts "
+                                  "WHERE (datetime(start_time) BETWEEN datetime('2017-03-01 00:00:00') AND datetime('2019-06-30 23:59:59')) "
+                                  "GROUP BY dxcc ORDER BY dxcc"
+                               << "SELECT dxcc, SUM(cnt) FROM contacts_rollup "
+                                  "WHERE (day BETWEEN '2017-03-01' AND '2019-06-30') "
+                                  "GROUP BY dxcc ORDER BY dxcc";
+    QTest::newRow("dayInWeek") << "SELECT CAST(strftime('%w', start_time) AS INTEGER) AS col1, COUNT(1) FROM contacts WHERE (station_callsign = 'OK1XYZ') GROUP BY col1 ORDER BY col1"
+                               << "SELECT CAST(strftime('%w', day) AS INTEGER) AS col1, SUM(cnt) FROM contacts_rollup WHERE (station_callsign = 'OK1XYZ') GROUP BY col1 ORDER BY col1";
+    QTest::newRow("confirmed") << "SELECT (1.0 * COUNT(1)/(SELECT COUNT(1) FROM contacts WHERE (my_antenna = 'Yagi'))) * 100 FROM contacts "
+                                  "WHERE (my_antenna = 'Yagi') AND (eqsl_qsl_rcvd = 'Y' OR lotw_qsl_rcvd = 'Y' OR qsl_rcvd = 'Y')"
+                               << "SELECT (1.0 * SUM(cnt)/(SELECT SUM(cnt) FROM contacts_rollup WHERE (my_antenna = 'Yagi'))) * 100 FROM contacts_rollup "
+                                  "WHERE (my_antenna = 'Yagi') AND confirmed = 1";
+    QTest::newRow("year") << perYear(false) << perYear(true);
+}
+
+void StatisticsRollupTest::aggregates()
+{
+    QFETCH(QString, contactsStmt);
+    QFETCH(QString, rollupStmt);
+
+    const QList<QVariantList> expected = rows(contactsStmt);
+
+    QVERIFY(!expected.isEmpty());
+    QCOMPARE(rows(rollupStmt), expected);
+}
+
+void StatisticsRollupTest::insertTrigger()
+{
+    QSqlQuery query;
+
+    QVERIFY(query.exec("INSERT INTO contacts (start_time, callsign, station_callsign, band, mode, cont, dxcc) "
+                       "VALUES ('2024-02-29T23:59:59.900Z', 'JA1ABC', 'OK1NEW', '15m', 'SSB', 'AS', 339)"));
+    QVERIFY(query.exec("INSERT INTO contacts (start_time, callsign, station_callsign, band, mode, cont, dxcc) "
+                       "VALUES ('2024-02-29T00:00:00.000Z', 'JA2ABC', 'OK1NEW', '15m', 'SSB', 'AS', 339)"));
+
+    const QList<QVariantList> added = rows("SELECT day, cnt FROM contacts_rollup WHERE station_callsign = 'OK1NEW'");
+
+    QCOMPARE(added.size(), 1);
+    QCOMPARE(added.at(0).at(0).toString(), QStringLiteral("2024-02-29"));
+    QCOMPARE(added.at(0).at(1).toInt(), 2);
+    QCOMPARE(rollupGroups(), contactsGroups());
+}
+
+void StatisticsRollupTest::updateTrigger()
+{
+    QSqlQuery query;
+
+    // the confirmation moves QSOs between the rollup rows
+    QVERIFY(query.exec("UPDATE contacts SET lotw_qsl_rcvd = 'Y' WHERE id % 13 = 0"));
+    QVERIFY(query.exec("UPDATE contacts SET mode = 'CW', band = '17m' WHERE id % 17 = 0"));
+    QVERIFY(query.exec("UPDATE contacts SET start_time = '2013-12-31T12:00:00.000Z' WHERE id % 19 = 0"));
+    QVERIFY(query.exec("UPDATE contacts SET dxcc = NULL, cont = NULL WHERE id % 23 = 0"));
+    QCOMPARE(rollupGroups(), contactsGroups());
+
+    // the other columns do not touch the rollup
+    const QList<QVariantList> before = rollupGroups();
+    QVERIFY(query.exec("UPDATE contacts SET qsl_sent = 'Y', callsign = 'OK9ZZZ' WHERE id % 29 = 0"));
+    QCOMPARE(rollupGroups(), before);
+}
+
+void StatisticsRollupTest::deleteTrigger()
+{
+    QSqlQuery query;
+
+    QVERIFY(query.exec("DELETE FROM contacts WHERE id % 31 = 0"));
+    QCOMPARE(rollupGroups(), contactsGroups());
+
+    // the empty rollup rows are removed
+    QVERIFY(query.exec("DELETE FROM contacts WHERE station_callsign = 'OK1NEW'"));
+    QVERIFY(rows("SELECT 1 FROM contacts_rollup WHERE station_callsign = 'OK1NEW'").isEmpty());
+    QVERIFY(rows("SELECT 1 FROM contacts_rollup WHERE cnt <= 0").isEmpty());
+}
+
+void StatisticsRollupTest::nullKeys()
+{
+    QSqlQuery query;
+
+    QVERIFY(query.exec("INSERT INTO contacts (callsign) VALUES ('OK1NULL')"));
+    QVERIFY(query.exec("INSERT INTO contacts (callsign) VALUES ('OK2NULL')"));
+
+    const QList<QVariantList> nullRow = rows("SELECT cnt FROM contacts_rollup WHERE day IS NULL AND band IS NULL");
+
+    QCOMPARE(nullRow.size(), 1);
+    QCOMPARE(nullRow.at(0).at(0).toInt(), 2);
+
+    QVERIFY(query.exec("DELETE FROM contacts WHERE callsign IN ('OK1NULL', 'OK2NULL')"));
+    QVERIFY(rows("SELECT 1 FROM contacts_rollup WHERE day IS NULL AND band IS NULL").isEmpty());
+    QCOMPARE(rollupGroups(), contactsGroups());
+}
+
+void StatisticsRollupTest::rebuild()
+{
+    QSqlQuery query;
+
+    // the contacts are changed while the rollup is not maintained
+    QVERIFY(query.exec("DROP TRIGGER contacts_rollup_update"));
+    QVERIFY(query.exec("UPDATE contacts SET band = '2m' WHERE id % 37 = 0"));
+    QVERIFY(rollupGroups() != contactsGroups());
+
+    QVERIFY(StatisticsRollup::setup(QSqlDatabase::database()));
+    QVERIFY(StatisticsRollup::isAvailable());
+    QCOMPARE(rollupGroups(), contactsGroups());
+
+    // nothing is rebuilt if the rollup is complete
+    QVERIFY(query.exec("UPDATE contacts_rollup SET cnt = cnt + 1 WHERE rowid = 1"));
+    QVERIFY(StatisticsRollup::setup(QSqlDatabase::database()));
+    QVERIFY(rollupGroups() != contactsGroups());
+    QVERIFY(query.exec("UPDATE contacts_rollup SET cnt = cnt - 1 WHERE rowid = 1"));
+}
+
+void StatisticsRollupTest::aggregate_benchmark_data()
+{
+    QTest::addColumn<bool>("useRollup");
+
+    QTest::newRow("contacts") << false;
+    QTest::newRow("rollup") << true;
+}
+
+void StatisticsRollupTest::aggregate_benchmark()
+{
+    QFETCH(bool, useRollup);
+
+    const QString stmt = perYear(useRollup);
+    QList<QVariantList> result;
+
+    QBENCHMARK
+    {
+        result = rows(stmt);
+    }
+
+    QVERIFY(!result.isEmpty());
+}
+
+QTEST_MAIN(StatisticsRollupTest)
+
+#include "tst_statisticsrollup.moc"
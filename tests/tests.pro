@@ -1,15 +1,31 @@
 TEMPLATE = subdirs
 CONFIG += ordered
-SUBDIRS += CallsignTest \
+SUBDIRS += AdifTokenizerTest \
+           BandmapSpotStoreTest \
+           CallsignTest \
            CredentialStoreTest \
            DataTest \
+           DebugTest \
+           DxccPrefixTrieTest \
+           DxccStatusIndexTest \
+           DupeIndexTest \
+           DxSpotStoreTest \
            FileCompressorTest \
            GridsquareTest \
            BandPlanTest \
            AlertEvaluatorTest \
            DxServerStringTest \
            HostsPortStringTest \
+           ImportDupeQueryTest \
+           LogbookSearchIndexTest \
            MigrationTest \
            PasswordCipherTest \
+           QSLContactIndexTest \
            QuadKeyCacheTest \
-           RigctldManagerTest
+           RigctldManagerTest \
+           StatisticsRollupTest \
+           AwardProgressTest \
+           QSLThumbnailCacheTest \
+           MembershipDirectoryTest \
+           ClubProgressTest \
+           SQLFunctionsTest
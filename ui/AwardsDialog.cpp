@@ -6,6 +6,8 @@
 #include "models/SqlListModel.h"
 #include "core/debug.h"
 #include "core/QSOFilterManager.h"
+#include "core/LogDatabase.h"
+#include "core/AwardProgress.h"
 
 #include "awards/AwardDXCC.h"
 #include "awards/AwardITU.h"
@@ -30,7 +32,8 @@ MODULE_IDENTIFICATION("qlog.ui.awardsdialog");
 
 AwardsDialog::AwardsDialog(QWidget *parent) :
     QDialog(parent),
-    ui(new Ui::AwardsDialog)
+    ui(new Ui::AwardsDialog),
+    rebuildThread(nullptr)
 {
     FCT_IDENTIFICATION;
     ui->setupUi(this);
@@ -60,6 +63,10 @@ AwardsDialog::AwardsDialog(QWidget *parent) :
                                                                       ui->userFilterComboBox));
     ui->userFilterComboBox->blockSignals(false);
 
+    rebuildButton = ui->buttonBox->addButton(tr("Rebuild"), QDialogButtonBox::ActionRole);
+    rebuildButton->setToolTip(tr("Recompute the award progress from the log"));
+    connect(rebuildButton, &QPushButton::clicked, this, &AwardsDialog::rebuildProgress);
+
     refreshTable(0);
 }
 
@@ -67,6 +74,12 @@ AwardsDialog::~AwardsDialog()
 {
     FCT_IDENTIFICATION;
 
+    if ( rebuildThread )
+    {
+        rebuildThread->wait();
+        delete rebuildThread;
+    }
+
     qDeleteAll(m_awards);
     delete ui;
 }
@@ -103,6 +116,39 @@ void AwardsDialog::refreshTable(int)
     award->updateData(buildFilterParams());
 }
 
+void AwardsDialog::rebuildProgress()
+{
+    FCT_IDENTIFICATION;
+
+    if ( rebuildThread )
+        return;
+
+    rebuildButton->setEnabled(false);
+
+    // the awards read the contacts table until the rebuild is finished
+    rebuildThread = QThread::create([]()
+    {
+        const QString connectionName(QStringLiteral("awardprogress_rebuild"));
+
+        if ( LogDatabase::instance()->openThreadConnection(connectionName) )
+            AwardProgress::rebuild(QSqlDatabase::database(connectionName, false));
+        else
+            qWarning() << "Cannot open DB Connection for the Award Progress rebuild";
+
+        LogDatabase::closeThreadConnection(connectionName);
+    });
+
+    connect(rebuildThread, &QThread::finished, this, [this]()
+    {
+        rebuildThread->deleteLater();
+        rebuildThread = nullptr;
+        rebuildButton->setEnabled(true);
+        refreshTable(0);
+    });
+
+    rebuildThread->start();
+}
+
 AwardDefinition* AwardsDialog::currentAward() const
 {
     FCT_IDENTIFICATION;
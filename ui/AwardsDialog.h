@@ -3,6 +3,8 @@
 
 #include <QDialog>
 #include <QComboBox>
+#include <QPushButton>
+#include <QThread>
 #include "awards/AwardDefinition.h"
 #include "models/SqlListModel.h"
 
@@ -20,6 +22,7 @@ public:
 
 public slots:
     void refreshTable(int);
+    void rebuildProgress();
 
 signals:
     void awardConditionSelected(QString, QString, QString);
@@ -28,6 +31,8 @@ private:
     Ui::AwardsDialog *ui;
     QList<AwardDefinition*> m_awards;
     SqlListModel* entityCallsignModel;
+    QPushButton *rebuildButton;
+    QThread *rebuildThread;
 
     AwardDefinition* currentAward() const;
     AwardFilterParams buildFilterParams() const;
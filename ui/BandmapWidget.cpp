@@ -1,10 +1,10 @@
 #include <QGraphicsScene>
 #include <QGraphicsTextItem>
-#include <QMutableMapIterator>
 #include <QMenu>
-#include <QTextDocument>
 #include <QScrollBar>
 #include <QGraphicsSceneMouseEvent>
+#include <QGraphicsSceneHelpEvent>
+#include <QToolTip>
 #include <QLinearGradient>
 #include <QPainterPath>
 #include <algorithm>
@@ -23,7 +23,7 @@ MODULE_IDENTIFICATION("qlog.ui.bandmapwidget");
 
 #define WIDGET_CENTER ( height()/2 - 50 )
 
-QMap<double, DxSpot> BandmapWidget::spots;
+BandmapSpotStore BandmapWidget::spots;
 QList<BandmapWidget *> BandmapWidget::nonVfoWidgets;
 double BandmapWidget::lastSeenVFOFreq = 0.0;
 BandmapWidget *BandmapWidget::vfoWidget = nullptr;
@@ -107,18 +107,16 @@ void BandmapWidget::update()
      ****************/
     update_timer->setInterval(BANDMAP_MAX_REFRESH_TIME);
 
-    /*************
-     * Clear All *
-     *************/
-    clearAllCallsignFromScene();
-
     clearFreqMark(&rxMark);
     clearFreqMark(&txMark);
 
-    bandmapScene->clear();
-
     // do not show bandmap for submm bands
-    if ( rx_freq > 250000.0 || currentBand.start >= 300000.0 ) return;
+    if ( rx_freq > 250000.0 || currentBand.start >= 300000.0 )
+    {
+        clearAllCallsignFromScene();
+        clearRuler();
+        return;
+    }
 
     /*******************
      * Determine Scale *
@@ -136,6 +134,44 @@ void BandmapWidget::update()
     /****************/
     /* Draw bandmap */
     /****************/
+    drawRuler(step, digits, steps);
+
+    const QString &endFreqDigits= QString::number(currentBand.end + step*steps, 'f', digits);
+    bandmapScene->setSceneRect(135 - (endFreqDigits.size() * PIXELSPERSTEP),
+                               0,
+                               0,
+                               steps * PIXELSPERSTEP + 10);
+
+    /************************/
+    /* Draw TX and RX Marks */
+    /************************/
+    drawTXRXMarks(step);
+
+    /*****************
+     * Draw Stations *
+     *****************/
+    updateStations();
+}
+
+void BandmapWidget::drawRuler(double step, int digits, int steps)
+{
+    FCT_IDENTIFICATION;
+
+    // the ruler depends only on the band, the zoom and the mode;
+    // it is not redrawn when the spots are refreshed
+    const QString key = QString("%1|%2|%3|%4|%5|%6").arg(currentBand.start)
+                                                    .arg(currentBand.end)
+                                                    .arg(step)
+                                                    .arg(digits)
+                                                    .arg(currBandMode)
+                                                    .arg(showEmergencyMarkers);
+
+    if ( key == rulerKey )
+        return;
+
+    clearRuler();
+    rulerKey = key;
+
     const QPen gridPen(QColor(192, 192, 192));
     const QBrush highlightBrush(QColor(102, 153, 255, 100));
 
@@ -148,40 +184,38 @@ void BandmapWidget::update()
         if ( !currBandMode.isEmpty()
              && i < steps
              && currBandMode == BandPlan::freq2BandModeGroupString(plottedFreq) )
-            bandmapScene->addRect(0, y, 10, 10, QPen(Qt::NoPen), highlightBrush);
+            rulerItems << bandmapScene->addRect(0, y, 10, 10, QPen(Qt::NoPen), highlightBrush);
 
         const int lineLength = (i % 5 == 0) ? 15 : 10;
 
-        bandmapScene->addLine(0, y, lineLength, y, gridPen);
+        rulerItems << bandmapScene->addLine(0, y, lineLength, y, gridPen);
 
         if ( i % 5 == 0 )
         {
             QGraphicsTextItem* text = bandmapScene->addText(QString::number(plottedFreq, 'f', digits));
             const QRectF rect = text->boundingRect();
             text->setPos(-rect.width() - 5, y - (rect.height() / 2));
+            rulerItems << text;
         }
     }
 
-    const QString &endFreqDigits= QString::number(currentBand.end + step*steps, 'f', digits);
-    bandmapScene->setSceneRect(135 - (endFreqDigits.size() * PIXELSPERSTEP),
-                               0,
-                               0,
-                               steps * PIXELSPERSTEP + 10);
-
-    /************************/
-    /* Draw TX and RX Marks */
-    /************************/
-    drawTXRXMarks(step);
-
     /*****************************/
     /* Draw Emergency Freq Marks */
     /*****************************/
     drawEmergencyMarkers(step);
 
-    /*****************
-     * Draw Stations *
-     *****************/
-    updateStations();
+    // spots are always above the ruler
+    for ( QGraphicsItem *item : static_cast<const QList<QGraphicsItem *>&>(rulerItems) )
+        item->setZValue(item->zValue() - 10);
+}
+
+void BandmapWidget::clearRuler()
+{
+    FCT_IDENTIFICATION;
+
+    qDeleteAll(rulerItems);
+    rulerItems.clear();
+    rulerKey.clear();
 }
 
 void BandmapWidget::spotAging()
@@ -201,17 +235,7 @@ void BandmapWidget::spotAging()
 
     if ( clear_interval_sec <= 0 ) return;
 
-    QMutableMapIterator<double, DxSpot> spotIterator(spots);
-
-    while ( spotIterator.hasNext() )
-    {
-        spotIterator.next();
-        //clear spots automatically
-        if ( spotIterator.value().dateTime.addSecs(clear_interval_sec) <= QDateTime::currentDateTimeUtc() )
-        {
-            spotIterator.remove();
-        }
-    }
+    spots.removeOlderThan(QDateTime::currentDateTimeUtc().addSecs(-clear_interval_sec));
 }
 
 void BandmapWidget::updateStations()
@@ -223,69 +247,79 @@ void BandmapWidget::updateStations()
      ****************/
     update_timer->setInterval(BANDMAP_MAX_REFRESH_TIME);
 
-    clearAllCallsignFromScene();
-
     spotAging();
 
     // do not show bandmap for submm bands
-    if ( rx_freq > 250000.0 || currentBand.start >= 300000.0 )return;
+    if ( rx_freq > 250000.0 || currentBand.start >= 300000.0 )
+    {
+        clearAllCallsignFromScene();
+        return;
+    }
 
     double step;
     int digits;
     double min_y = 0;
-    const QColor lineColor(192,192,192);
+    const QPen linePen(QColor(192,192,192));
     const QColor defaultTextColor = qApp->palette().color(QPalette::Text);
     const QString timeFormat = locale.formatTimeShort();
 
     determineStepDigits(step, digits);
 
-    QMap<double, DxSpot>::iterator lower = spots.lowerBound(currentBand.start);
-    QMap<double, DxSpot>::iterator upper = spots.upperBound(currentBand.end);
+    // items of the displayed spots are reused; only the items of the removed
+    // spots are deleted and only the items of the new spots are created
+    QMap<double, SpotItems> prevItems;
+    prevItems.swap(spotItems);
 
-    while ( lower != upper )
+    BandmapSpotStore::const_iterator lower = spots.lowerBound(currentBand.start);
+    BandmapSpotStore::const_iterator upper = spots.upperBound(currentBand.end);
+
+    for ( ; lower != upper; ++lower )
     {
-        DxSpot &spot = lower.value();
+        const DxSpot &spot = lower.value();
 
         double freq_y = ((lower.key() - currentBand.start) / step) * PIXELSPERSTEP;
         double text_y = std::max(min_y + 5.0, freq_y);
 
+        SpotItems items;
+        auto prevIt = prevItems.find(lower.key());
+
+        if ( prevIt != prevItems.end() )
+        {
+            items = prevIt.value();
+            prevItems.erase(prevIt);
+        }
+        else
+        {
+            items.line = bandmapScene->addLine(QLineF(), linePen);
+            items.text = new BandmapSpotItem();
+            bandmapScene->addItem(items.text);
+        }
+
+        items.text->setSpot(spot,
+                            spot.callsign + " @ " + locale.toString(spot.dateTime, timeFormat),
+                            Data::statusToColor(spot.status, spot.dupeCount, defaultTextColor));
+
+        const qreal halfHeight = items.text->boundingRect().height() / 2;
+        const QPointF textPos(40, text_y - halfHeight);
+        const QLineF line(17, freq_y, 40, text_y);
+
+        if ( items.text->pos() != textPos )
+            items.text->setPos(textPos);
+
         /*************************
          * Draw Line to Callsign *
          *************************/
-        lineItemList.append(bandmapScene->addLine(17, freq_y, 40, text_y, QPen(lineColor)));
-
-        const QString &callsignTmp = spot.callsign;
-        const QString &timeTmp = locale.toString(spot.dateTime, timeFormat);
-
-        QGraphicsTextItem* text = bandmapScene->addText(callsignTmp + " @ " + timeTmp);
-        text->document()->setDocumentMargin(0);
-
-        qreal halfHeight = text->boundingRect().height() / 2;
-        text->setPos(40, text_y - halfHeight);
-        text->setFlags(QGraphicsItem::ItemIsFocusable |
-                       QGraphicsItem::ItemIsSelectable |
-                       text->flags());
-        text->setProperty("freq", lower.key());
-        text->setProperty("bandmode", static_cast<int>(spot.bandPlanMode));
-
-        QString unit;
-        unsigned char decP;
-        double spotFreq = Data::MHz2UserFriendlyFreq(lower.key(), unit, decP);
-        text->setToolTip(QString("<b>%1</b> de %2<br/>%3 %4; %5<br/>%6").arg(callsignTmp,
-                                                             spot.spotter,
-                                                             QString::number(spotFreq, 'f', decP),
-                                                             unit,
-                                                             spot.modeGroupString,
-                                                             spot.comment));
+        if ( items.line->line() != line )
+            items.line->setLine(line);
 
         min_y = text_y + halfHeight;
+        spotItems.insert(lower.key(), items);
+    }
 
-        text->setDefaultTextColor(Data::statusToColor(spot.status,
-                                                      spot.dupeCount,
-                                                      defaultTextColor));
-
-        textItemList.append(text);
-        ++lower;
+    for ( const SpotItems &items : static_cast<const QMap<double, SpotItems>&>(prevItems) )
+    {
+        delete items.line;
+        delete items.text;
     }
 
     // Resize scene and view dynamically
@@ -310,11 +344,7 @@ void BandmapWidget::clearWidgetBand()
 {
     FCT_IDENTIFICATION;
 
-    auto begin = spots.lowerBound(currentBand.start);
-    auto end = spots.upperBound(currentBand.end);
-
-    while (begin != end)
-        begin = spots.erase(begin);
+    spots.removeRange(currentBand.start, currentBand.end);
 
     if ( vfoWidget )
         vfoWidget->updateStations(); // this causes that all bandmap will be updated
@@ -366,27 +396,13 @@ void BandmapWidget::clearAllCallsignFromScene()
 {
     FCT_IDENTIFICATION;
 
-    QMutableListIterator<QGraphicsLineItem*> lineIterator(lineItemList);
-
-    while ( lineIterator.hasNext() )
-    {
-        lineIterator.next();
-        bandmapScene->removeItem(lineIterator.value());
-        delete lineIterator.value();
-    }
-
-    lineItemList.clear();
-
-    QMutableListIterator<QGraphicsTextItem*> textIterator(textItemList);
-
-    while ( textIterator.hasNext() )
+    for ( const SpotItems &items : static_cast<const QMap<double, SpotItems>&>(spotItems) )
     {
-        textIterator.next();
-        bandmapScene->removeItem(textIterator.value());
-        delete textIterator.value();
+        delete items.line;
+        delete items.text;
     }
 
-    textItemList.clear();
+    spotItems.clear();
 }
 
 void BandmapWidget::clearFreqMark(QGraphicsPolygonItem **currentPolygon)
@@ -460,26 +476,6 @@ void BandmapWidget::drawTXRXMarks(double step)
     }
 }
 
-void BandmapWidget::removeDuplicates(DxSpot &spot)
-{
-    FCT_IDENTIFICATION;
-
-    QMap<double, DxSpot>::iterator lower = spots.lowerBound(spot.freq - 0.005);
-    QMap<double, DxSpot>::iterator upper = spots.upperBound(spot.freq + 0.005);
-
-    while ( lower != upper )
-    {
-        if ( lower.value().callsign.compare(spot.callsign, Qt::CaseInsensitive) == 0 )
-        {
-            lower = spots.erase(lower);
-        }
-        else
-        {
-            ++lower;
-        }
-    }
-}
-
 void BandmapWidget::addSpot(DxSpot spot)
 {
     FCT_IDENTIFICATION;
@@ -493,8 +489,7 @@ void BandmapWidget::addSpot(DxSpot spot)
 
     qCDebug(function_parameters) << spot.freq << spot.callsign;
 
-    this->removeDuplicates(spot);
-    spots.insert(spot.freq, spot);
+    spots.insert(spot);
 
     if ( spot.band == currentBand.name )
     {
@@ -537,12 +532,12 @@ DxSpot BandmapWidget::nearestSpot(const double freq) const
 {
     FCT_IDENTIFICATION;
 
-    QMap<double, DxSpot>::const_iterator it = spots.constFind(freq);
+    BandmapSpotStore::const_iterator it = spots.constFind(freq);
 
     if( it == spots.cend() )
     {
-        QMap<double, DxSpot>::const_iterator lower = spots.lowerBound(freq - Hz2MHz(1000));
-        QMap<double, DxSpot>::const_iterator upper = spots.upperBound(freq + Hz2MHz(1000));
+        BandmapSpotStore::const_iterator lower = spots.lowerBound(freq - Hz2MHz(1000));
+        BandmapSpotStore::const_iterator upper = spots.upperBound(freq + Hz2MHz(1000));
 
         it = std::min_element( lower, upper,
                 [freq](const DxSpot &p1,
@@ -727,9 +722,9 @@ void BandmapWidget::updateSpotsStatusWhenQSOAdded(const QSqlRecord &record)
     const QString &dxccModeGroup = BandPlan::modeToDXCCModeGroup(record.value("mode").toString());
     const QString &callsign = record.value("callsign").toString();
 
-    for ( auto it = spots.begin(); it != spots.end(); ++it )
+    // the QSO changes only the status of its entity and the dupe count of its callsign
+    spots.updateEntity(dxcc, [&](DxSpot &spot)
     {
-        DxSpot &spot =  it.value();
         spot.status = Data::dxccNewStatusWhenQSOAdded(spot.status,
                                                       spot.dxcc.dxcc,
                                                       spot.band,
@@ -739,13 +734,16 @@ void BandmapWidget::updateSpotsStatusWhenQSOAdded(const QSqlRecord &record)
                                                       dxcc,
                                                       band,
                                                       dxccModeGroup);
-        if ( spot.callsign == callsign )
-            spot.dupeCount = Data::dupeNewCountWhenQSOAdded(spot.dupeCount,
-                                                            spot.band,
-                                                            spot.modeGroupString,
-                                                            band,
-                                                            dxccModeGroup);
-    }
+    });
+
+    spots.updateCallsign(callsign, [&](DxSpot &spot)
+    {
+        spot.dupeCount = Data::dupeNewCountWhenQSOAdded(spot.dupeCount,
+                                                        spot.band,
+                                                        spot.modeGroupString,
+                                                        band,
+                                                        dxccModeGroup);
+    });
     updateStations();
     if ( callsign == lastNearestSpot.callsign )
         updateNearestSpot(true);
@@ -782,17 +780,15 @@ void BandmapWidget::updateSpotsDupeWhenQSODeleted(const QSqlRecord &record)
     const QString &band = record.value("band").toString();
     const QString &dxccModeGroup = BandPlan::modeToDXCCModeGroup(record.value("mode").toString());
 
-    for ( auto it = spots.begin(); it != spots.end(); ++it )
+    spots.updateCallsign(callsign, [&](DxSpot &spot)
     {
-        DxSpot &spot =  it.value();
-
-        if ( spot.dupeCount && spot.callsign == callsign )
+        if ( spot.dupeCount )
             spot.dupeCount = Data::dupeNewCountWhenQSODelected(spot.dupeCount,
                                                                spot.band,
                                                                spot.modeGroupString,
                                                                band,
                                                                dxccModeGroup);
-    }
+    });
     // do not call updateStation. it will be updated at the end of delete procedure
     // by updateSpotsDxccStatusWhenQSODeleted;
 }
@@ -813,14 +809,12 @@ void BandmapWidget::updateSpotsDxccStatusWhenQSODeleted(const QSet<uint> &entiti
     if ( entities.isEmpty() )
         return;
 
-    for ( auto it = spots.begin(); it != spots.end(); ++it )
+    for ( uint entity : entities )
     {
-        DxSpot &spot =  it.value();
-
-        if ( !entities.contains(spot.dxcc.dxcc) )
-            continue;
-
-        spot.status = Data::instance()->dxccStatus(spot.dxcc.dxcc, spot.band, spot.modeGroupString);
+        spots.updateEntity(entity, [](DxSpot &spot)
+        {
+            spot.status = Data::instance()->dxccStatus(spot.dxcc.dxcc, spot.band, spot.modeGroupString);
+        });
     }
     updateStations();
     updateNearestSpot(true);
@@ -837,11 +831,10 @@ void BandmapWidget::recalculateDxccStatus()
         return;
     }
 
-    for ( auto it = spots.begin(); it != spots.end(); ++it )
+    spots.updateAll([](DxSpot &spot)
     {
-        DxSpot &spot = it.value();
         spot.status = Data::instance()->dxccStatus(spot.dxcc.dxcc, spot.band, spot.modeGroupString);
-    }
+    });
     updateStations();
     updateNearestSpot(true);
 }
@@ -857,8 +850,10 @@ void BandmapWidget::resetDupe()
         return;
     }
 
-    for ( auto it = spots.begin(); it != spots.end(); ++it )
-        it.value().dupeCount = 0;
+    spots.updateAll([](DxSpot &spot)
+    {
+        spot.dupeCount = 0;
+    });
 
     updateStations();
 }
@@ -874,13 +869,12 @@ void BandmapWidget::recalculateDupe()
         return;
     }
 
-    for ( auto it = spots.begin(); it != spots.end(); ++it )
+    spots.updateAll([](DxSpot &spot)
     {
-        DxSpot &spot = it.value();
         spot.dupeCount = Data::countDupe(spot.callsign,
                                          spot.band,
                                          spot.modeGroupString);
-    }
+    });
     updateStations();
 }
 
@@ -1082,11 +1076,11 @@ void BandmapWidget::drawEmergencyMarkers(double step)
     glow.setColorAt(0.5,  QColor(220, 30, 30, 115));
     glow.setColorAt(0.65, QColor(220, 30, 30,  70));
     glow.setColorAt(1.0,  QColor(220, 30, 30,   0));
-    bandmapScene->addRect(0, y - glowH, pillX, 2.0 * glowH,
-                          QPen(Qt::NoPen), QBrush(glow));
+    rulerItems << bandmapScene->addRect(0, y - glowH, pillX, 2.0 * glowH,
+                                        QPen(Qt::NoPen), QBrush(glow));
 
     // Sharp centre line — runs from the scale up to the SOS pill
-    bandmapScene->addLine(0, y, pillX, y, QPen(lineColor, 2));
+    rulerItems << bandmapScene->addLine(0, y, pillX, y, QPen(lineColor, 2));
 
     // Pill label — sized dynamically around the text
     QGraphicsSimpleTextItem *textItem = bandmapScene->addSimpleText(tr("SOS"), emergencyFont);
@@ -1106,6 +1100,8 @@ void BandmapWidget::drawEmergencyMarkers(double step)
 
     pillItem->setZValue(1);
     textItem->setZValue(2);
+
+    rulerItems << pillItem << textItem;
 }
 
 void BandmapWidget::drawMarkers(double frequency)
@@ -1321,13 +1317,12 @@ void GraphicsScene::mousePressEvent(QGraphicsSceneMouseEvent *evt)
 
     if ( evt->button() & Qt::LeftButton )
     {
-        QGraphicsItem *item = itemAt(evt->scenePos(), QTransform());
-        QGraphicsTextItem *focusedSpot = dynamic_cast<QGraphicsTextItem*>(item);
+        const BandmapSpotItem *focusedSpot = qgraphicsitem_cast<BandmapSpotItem*>(itemAt(evt->scenePos(), QTransform()));
 
-        if ( focusedSpot && focusedSpot->property("freq").isValid() )
-            emit spotClicked(focusedSpot->toPlainText().split(" ").first(),
-                             focusedSpot->property("freq").toDouble(),
-                             static_cast<BandPlan::BandPlanMode>(focusedSpot->property("bandmode").toInt()));
+        if ( focusedSpot )
+            emit spotClicked(focusedSpot->getSpot().callsign,
+                             focusedSpot->getSpot().freq,
+                             focusedSpot->getSpot().bandPlanMode);
     }
     evt->accept();
 }
@@ -1339,4 +1334,53 @@ void GraphicsScene::mouseDoubleClickEvent(QGraphicsSceneMouseEvent *evt)
     evt->accept();
 }
 
+void GraphicsScene::helpEvent(QGraphicsSceneHelpEvent *helpEvent)
+{
+    FCT_IDENTIFICATION;
+
+    const BandmapSpotItem *spotItem = qgraphicsitem_cast<BandmapSpotItem*>(itemAt(helpEvent->scenePos(), QTransform()));
+
+    if ( !spotItem )
+    {
+        QGraphicsScene::helpEvent(helpEvent);
+        return;
+    }
+
+    QToolTip::showText(helpEvent->screenPos(), spotItem->toolTipText(), helpEvent->widget());
+    helpEvent->setAccepted(true);
+}
+
+BandmapSpotItem::BandmapSpotItem(QGraphicsItem *parent) :
+    QGraphicsSimpleTextItem(parent)
+{
+    setFlags(QGraphicsItem::ItemIsFocusable |
+             QGraphicsItem::ItemIsSelectable |
+             flags());
+}
+
+void BandmapSpotItem::setSpot(const DxSpot &newSpot, const QString &label, const QColor &color)
+{
+    spot = newSpot;
+
+    if ( text() != label )
+        setText(label);
+
+    if ( brush().color() != color )
+        setBrush(color);
+}
+
+QString BandmapSpotItem::toolTipText() const
+{
+    QString unit;
+    unsigned char decP;
+    double spotFreq = Data::MHz2UserFriendlyFreq(spot.freq, unit, decP);
+
+    return QString("<b>%1</b> de %2<br/>%3 %4; %5<br/>%6").arg(spot.callsign,
+                                                             spot.spotter,
+                                                             QString::number(spotFreq, 'f', decP),
+                                                             unit,
+                                                             spot.modeGroupString,
+                                                             spot.comment);
+}
+
 #undef WIDGET_CENTER
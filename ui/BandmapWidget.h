@@ -11,6 +11,7 @@
 #include <QSqlRecord>
 
 #include "data/DxSpot.h"
+#include "data/BandmapSpotStore.h"
 #include "data/Band.h"
 #include "rig/Rig.h"
 #include "core/LogLocale.h"
@@ -22,6 +23,25 @@ class BandmapWidget;
 
 class QGraphicsScene;
 
+// Callsign label of one spot. The item is kept in the scene while the spot
+// is displayed; a refresh only changes its text, color and position.
+// The tooltip is created when it is requested.
+class BandmapSpotItem : public QGraphicsSimpleTextItem
+{
+public:
+    enum { Type = UserType + 1 };
+
+    explicit BandmapSpotItem(QGraphicsItem *parent = nullptr);
+
+    int type() const override { return Type; }
+    void setSpot(const DxSpot &newSpot, const QString &label, const QColor &color);
+    const DxSpot &getSpot() const { return spot; };
+    QString toolTipText() const;
+
+private:
+    DxSpot spot;
+};
+
 class GraphicsScene : public QGraphicsScene
 {
     Q_OBJECT;
@@ -35,6 +55,7 @@ signals:
 protected:
     void mousePressEvent (QGraphicsSceneMouseEvent *evt) override;
     void mouseDoubleClickEvent(QGraphicsSceneMouseEvent *evt) override;
+    void helpEvent(QGraphicsSceneHelpEvent *helpEvent) override;
 };
 
 class BandmapWidget : public QWidget, public ShutdownAwareWidget
@@ -86,11 +107,12 @@ signals:
     void requestNewNonVfoBandmapWindow(const QString &id, const QString &bandName);
 
 private:
-    void removeDuplicates(DxSpot &spot);
     void spotAging();
 
     void determineStepDigits(double &step, int &digits) const;
     void clearAllCallsignFromScene();
+    void drawRuler(double step, int digits, int steps);
+    void clearRuler();
     void clearFreqMark(QGraphicsPolygonItem **);
     void drawFreqMark(const double, const double, const QColor&, QGraphicsPolygonItem **);
     void drawTXRXMarks(double);
@@ -130,13 +152,19 @@ private:
     Band currentBand;
     BandmapZoom zoom;
     GraphicsScene* bandmapScene;
-    static QMap<double, DxSpot> spots;
+    static BandmapSpotStore spots;
     static QList<BandmapWidget *> nonVfoWidgets;
     static BandmapWidget* vfoWidget;
     static double lastSeenVFOFreq;
     QTimer *update_timer;
-    QList<QGraphicsLineItem *> lineItemList;
-    QList<QGraphicsTextItem *> textItemList;
+    struct SpotItems
+    {
+        BandmapSpotItem *text;
+        QGraphicsLineItem *line;
+    };
+    QMap<double, SpotItems> spotItems;    // the same keys as spots
+    QList<QGraphicsItem *> rulerItems;
+    QString rulerKey;
     QGraphicsPolygonItem* rxMark;
     QGraphicsPolygonItem* txMark;
     bool keepRXCenter;
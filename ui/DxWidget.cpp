@@ -38,6 +38,7 @@
 #define CONSOLE_VIEW 4
 #define NUM_OF_RECONNECT_ATTEMPTS 3
 #define RECONNECT_TIMEOUT 10000
+#define ENRICHER_STATISTICS_PERIOD 10000
 
 MODULE_IDENTIFICATION("qlog.ui.dxwidget");
 
@@ -133,7 +134,7 @@ void DxClusterCredentials::refreshDescriptorCache(const QStringList &serverStrin
 
 int DxTableModel::rowCount(const QModelIndex&) const
 {
-    return dxData.count();
+    return dxData.size();
 }
 
 int DxTableModel::columnCount(const QModelIndex&) const
@@ -210,32 +211,69 @@ QVariant DxTableModel::headerData(int section, Qt::Orientation orientation, int
 bool DxTableModel::addEntry(const DxSpot &entry, bool deduplicate,
                             qint16 dedup_interval, double dedup_freq_tolerance)
 {
-    bool shouldInsert = true;
-    if ( deduplicate )
+    return !addEntries(QList<DxSpot>{entry}, deduplicate,
+                       dedup_interval, dedup_freq_tolerance).isEmpty();
+}
+
+QList<DxSpot> DxTableModel::addEntries(const QList<DxSpot> &entries, bool deduplicate,
+                                       qint16 dedup_interval, double dedup_freq_tolerance)
+{
+    QList<DxSpot> inserted;
+
+    for ( const DxSpot &entry : entries )
     {
-        for (const DxSpot &record : static_cast<const QList<DxSpot>&>(dxData))
-        {
-            if ( record.dateTime.secsTo(entry.dateTime) > dedup_interval )
-                break;
+        if ( deduplicate
+             && ( isBatchDuplicate(inserted, entry, dedup_interval, dedup_freq_tolerance)
+                  || dxData.isDuplicate(entry, dedup_interval, dedup_freq_tolerance) ) )
+            continue;
 
-            if ( record.callsign == entry.callsign
-                 && qAbs(MHz(record.freq) - MHz(entry.freq)) < kHz(dedup_freq_tolerance) )
-            {
-                qCDebug(runtime) << "Duplicate spot" << record.callsign << record.freq <<  entry.callsign << entry.freq;
-                shouldInsert = false;
-                break;
-            }
-        }
+        inserted.append(entry);
     }
 
-    if ( shouldInsert )
+    if ( inserted.isEmpty() )
+        return inserted;
+
+    // only the newest spots fit into the store
+    const int batchStart = qMax(0, inserted.size() - dxData.capacity());
+    const int batchSize = inserted.size() - batchStart;
+    const int overflow = dxData.size() + batchSize - dxData.capacity();
+
+    if ( overflow > 0 )
+    {
+        // the oldest spots are at the bottom
+        beginRemoveRows(QModelIndex(), dxData.size() - overflow, dxData.size() - 1);
+        dxData.removeOldest(overflow);
+        endRemoveRows();
+    }
+
+    // the newest spot is at the top - the whole batch is inserted at once
+    beginInsertRows(QModelIndex(), 0, batchSize - 1);
+    for ( int i = batchStart; i < inserted.size(); i++ )
+        dxData.append(inserted.at(i));
+    endInsertRows();
+
+    return inserted;
+}
+
+bool DxTableModel::isBatchDuplicate(const QList<DxSpot> &batch, const DxSpot &entry,
+                                    qint16 dedup_interval, double dedup_freq_tolerance) const
+{
+    for ( auto it = batch.crbegin(); it != batch.crend(); ++it )
     {
-        beginInsertRows(QModelIndex(), 0, 0);
-        dxData.prepend(entry);
-        endInsertRows();
+        const DxSpot &record = *it;
+
+        if ( record.dateTime.secsTo(entry.dateTime) > dedup_interval )
+            break;
+
+        if ( record.callsign == entry.callsign
+             && qAbs(MHz(record.freq) - MHz(entry.freq)) < kHz(dedup_freq_tolerance) )
+        {
+            qCDebug(runtime) << "Duplicate spot" << record.callsign << record.freq <<  entry.callsign << entry.freq;
+            return true;
+        }
     }
 
-    return shouldInsert;
+    return false;
 }
 
 void DxTableModel::clear()
@@ -539,6 +577,18 @@ DxWidget::DxWidget(QWidget *parent) :
     spottercontregexp.setPatternOptions(QRegularExpression::CaseInsensitiveOption);
     bandregexp.setPatternOptions(QRegularExpression::CaseInsensitiveOption);
 
+    // spot enricher uses these singletons from its thread - make sure that
+    // they are created and initialized in the GUI thread
+    PotaQE::instance();
+    Data::instance()->preparePrefixTries();
+
+    spotEnricher.moveToThread(&spotEnricherThread);
+    connect(&spotEnricherThread, &QThread::finished,
+            &spotEnricher, &DxSpotEnricher::closeConnection, Qt::DirectConnection);
+    connect(&spotEnricher, &DxSpotEnricher::spotsEnriched,
+            this, &DxWidget::processEnrichedSpots);
+    spotEnricherThread.start();
+
     reloadSetting();
     serverComboSetup();
 
@@ -1167,6 +1217,9 @@ void DxWidget::receive()
         }
         ui->log->appendPlainText(line);
     }
+
+    // all spots received in one read are enriched as one batch
+    dispatchPendingSpots();
 }
 
 void DxWidget::socketError(QAbstractSocket::SocketError socker_error)
@@ -1824,335 +1877,130 @@ void DxWidget::processDxSpot(const QString &spotter,
 
     qCDebug(function_parameters) << spotter << freq << call << comment << dateTime << dateTime.isNull();
 
+    // parse stage - only raw values are filled here. The DB-dependent
+    // properties are resolved by spotEnricher in its own thread.
     DxSpot spot;
 
     spot.dateTime = (!dateTime.isValid()) ? QDateTime::currentDateTime().toTimeZone(QTimeZone::utc())
                                     : dateTime;
     spot.callsign = call;
     spot.freq = freq.toDouble() / 1000;
-    spot.band = BandPlan::freq2Band(spot.freq).name;
     spot.spotter = spotter;
     spot.comment = comment.trimmed();
-    spot.bandPlanMode = modeGroupFromComment(spot.comment);
-    if ( spot.bandPlanMode == BandPlan::BAND_MODE_UNKNOWN )
-    {
-        spot.bandPlanMode = BandPlan::freq2BandMode(spot.freq);
-    }
-    if ( spot.bandPlanMode == BandPlan::BAND_MODE_PHONE )
-    {
-        spot.bandPlanMode = (spot.freq < 10.0 ) ? BandPlan::BAND_MODE_LSB
-                                                : BandPlan::BAND_MODE_USB;
-    }
-    spot.modeGroupString = BandPlan::bandMode2BandModeGroupString(spot.bandPlanMode);
-    spot.dxcc = Data::instance()->lookupDxcc(call);
-    spot.dxcc_spotter = Data::instance()->lookupDxcc(spotter);
-    spot.status = Data::instance()->dxccStatus(spot.dxcc.dxcc, spot.band, spot.modeGroupString);
-    spot.callsign_member = MembershipQE::instance()->query(spot.callsign);
-    spot.dupeCount = Data::countDupe(spot.callsign, spot.band, spot.modeGroupString);
-    wwffRefFromComment(spot);
-    potaRefFromComment(spot);
-    sotaRefFromComment(spot);
-    iotaRefFromComment(spot);
-    splitFreqFromComment(spot);
-
-#if 0
-    if ( !spot.sotaRef.isEmpty() )
-        qInfo() << "SOTA" << spot.sotaRef << spot.comment;
-
-    if ( !spot.wwffRef.isEmpty() )
-        qInfo() << "WWFF" << spot.wwffRef << spot.comment;
-
-    if ( !spot.potaRef.isEmpty() )
-        qInfo() << "POTA" << spot.potaRef << spot.comment;
-
-    if ( !spot.iotaRef.isEmpty() )
-        qInfo() << "IOTA" << spot.iotaRef << spot.comment;
-#endif
-
-    emit newSpot(spot);
-
-    if ( spot.modeGroupString.contains(moderegexp)
-         && spot.dxcc.cont.contains(contregexp)
-         && spot.dxcc_spotter.cont.contains(spottercontregexp)
-         && spot.band.contains(bandregexp)
-         && ( spot.status & dxccStatusFilter)
-         && ( dxMemberFilter.size() == 0
-            || (dxMemberFilter.size() && spot.memberList2Set().intersects(dxMemberFilter)) )
-         && spot.dupeCount == 0
-        )
-    {
-        if ( dxTableModel->addEntry(spot, deduplicateSpots, deduplicatetime, deduplicatefreq) )
-            emit newFilteredSpot(spot);
-    }
-}
-
-QVector<int> DxWidget::dxcListHiddenCols() const
-{
-    QVector<int> ret;
-    ret.reserve(dxTableModel->columnCount());
-
-    for ( int i = 0; i < dxTableModel->columnCount(); ++i )
-    {
-        if (ui->dxTable->isColumnHidden(i))
-            ret.append(i);
-    }
-
-    return ret;
-}
-
-BandPlan::BandPlanMode DxWidget::modeGroupFromComment(const QString &comment) const
-{
-    FCT_IDENTIFICATION;
-
-    qCDebug(function_parameters) << comment;
-
-#if (QT_VERSION >= QT_VERSION_CHECK(5, 15, 0))
-    const QStringList &tokenizedComment = comment.split(" ", Qt::SkipEmptyParts);
-#else /* Due to ubuntu 20.04 where qt5.12 is present */
-    const QStringList &tokenizedComment = comment.split(" ", QString::SkipEmptyParts);
-#endif
-
-    if ( tokenizedComment.contains("CW", Qt::CaseInsensitive)
-         || tokenizedComment.contains("<CW>", Qt::CaseInsensitive)
-        )
-        return BandPlan::BAND_MODE_CW;
-
-    if ( tokenizedComment.contains("FT8", Qt::CaseInsensitive)
-         || tokenizedComment.contains("<FT8>", Qt::CaseInsensitive)
-        )
-        return BandPlan::BAND_MODE_FT8;
-
-    if ( tokenizedComment.contains("FT4", Qt::CaseInsensitive)
-         || tokenizedComment.contains("<FT4>", Qt::CaseInsensitive)
-       )
-        return BandPlan::BAND_MODE_FT4;
-
-    if ( tokenizedComment.contains("FT2", Qt::CaseInsensitive)
-        || tokenizedComment.contains("<FT2>", Qt::CaseInsensitive )
-       )
-        return BandPlan::BAND_MODE_FT2;
-
-    if ( tokenizedComment.contains("MSK144", Qt::CaseInsensitive) )
-        return BandPlan::BAND_MODE_DIGITAL;
-
-    if ( tokenizedComment.contains("RTTY", Qt::CaseInsensitive) )
-        return BandPlan::BAND_MODE_DIGITAL;
 
-    if ( tokenizedComment.contains("SSTV", Qt::CaseInsensitive) )
-        return BandPlan::BAND_MODE_DIGITAL;
-
-    if ( tokenizedComment.contains("PACKET", Qt::CaseInsensitive) )
-        return BandPlan::BAND_MODE_DIGITAL;
-
-    if ( tokenizedComment.contains("SSB", Qt::CaseInsensitive)
-         || tokenizedComment.contains("<SSB>", Qt::CaseInsensitive)
-        )
-        return BandPlan::BAND_MODE_PHONE;
-
-    if ( tokenizedComment.contains("USB", Qt::CaseInsensitive) )
-        return BandPlan::BAND_MODE_USB;
-
-    if ( tokenizedComment.contains("LSB", Qt::CaseInsensitive) )
-        return BandPlan::BAND_MODE_LSB;
-
-    if ( tokenizedComment.contains("<FM>", Qt::CaseInsensitive) )
-        return BandPlan::BAND_MODE_PHONE;
-
-    return BandPlan::BAND_MODE_UNKNOWN;
+    pendingSpots.append(spot);
 }
 
-QString DxWidget::refFromComment(const QString &comment,
-                                 bool &flag,
-                                 const QRegularExpression &regEx,
-                                 const QString &refType,
-                                 int justified = 0) const
+void DxWidget::dispatchPendingSpots()
 {
     FCT_IDENTIFICATION;
 
-    QRegularExpressionMatch stringMatch = regEx.match(comment);
-    QString ref;
+    if ( pendingSpots.isEmpty() )
+        return;
 
-    if (stringMatch.hasMatch())
-    {
-        flag = true;
-        ref = stringMatch.captured(1).toUpper() + "-" + stringMatch.captured(2).rightJustified(justified, '0');
-        qCDebug(runtime) << refType << ":" << ref << "in comment:" << comment;
-    }
+    qCDebug(runtime) << "Dispatching spots" << pendingSpots.size();
 
-    return ref;
+    QMetaObject::invokeMethod(&spotEnricher, "enrich", Qt::QueuedConnection,
+                              Q_ARG(QList<DxSpot>, pendingSpots),
+                              Q_ARG(DxSpotEnricher::Context, DxSpotEnricher::Context::current()));
+    pendingSpots.clear();
 }
 
-void DxWidget::wwffRefFromComment(DxSpot &spot) const
+void DxWidget::processEnrichedSpots(QList<DxSpot> spots,
+                                    DxSpotEnricher::Statistics statistics)
 {
     FCT_IDENTIFICATION;
 
-    static QRegularExpression wwffRegEx(QStringLiteral("(?:^|\\s)([A-Za-z0-9]{1,3}[Ff]{2})[- ]?(\\d{1,4})(?:\\s|$)"),
-                                        QRegularExpression::CaseInsensitiveOption);
-
-    spot.containsWWFF = spot.comment.contains("WWFF", Qt::CaseInsensitive);
-    spot.wwffRef = refFromComment(spot.comment, spot.containsWWFF,
-                                  wwffRegEx, QStringLiteral("WWFF"), 4);
-}
-
-void DxWidget::potaRefFromComment(DxSpot &spot) const
-{
-    FCT_IDENTIFICATION;
+    qCDebug(function_parameters) << spots.size();
 
-    spot.containsPOTA = spot.comment.contains("POTA", Qt::CaseInsensitive);
+    // filter stage - filter settings are owned by the GUI thread
+    QList<DxSpot> filteredSpots;
 
-    if ( spot.dxcc.dxcc == 0 )
-        return;
+    for ( const DxSpot &spot : static_cast<const QList<DxSpot>&>(spots) )
+    {
+#if 0
+        if ( !spot.sotaRef.isEmpty() )
+            qInfo() << "SOTA" << spot.sotaRef << spot.comment;
 
-    QString flagA2Code = Data::instance()->dxccFlag(spot.dxcc.dxcc);
+        if ( !spot.wwffRef.isEmpty() )
+            qInfo() << "WWFF" << spot.wwffRef << spot.comment;
 
-    if ( flagA2Code == "england" || flagA2Code == "scotland"
-         || flagA2Code == "wales")
-        flagA2Code = "GB";
+        if ( !spot.potaRef.isEmpty() )
+            qInfo() << "POTA" << spot.potaRef << spot.comment;
 
-    QRegularExpression potaCountryRE(QString("(?:^|\\s)(%0)-(\\d{1,5})(?:\\s|@|$)").arg(flagA2Code),
-                                     QRegularExpression::CaseInsensitiveOption);
+        if ( !spot.iotaRef.isEmpty() )
+            qInfo() << "IOTA" << spot.iotaRef << spot.comment;
+#endif
 
-    spot.potaRef = refFromComment(spot.comment, spot.containsPOTA,
-                                  potaCountryRE, QStringLiteral("POTA_alternative"), 4);
-    if ( !spot.containsPOTA )
-    {
-        Callsign dxSpotCallsign(spot.callsign);
-        // If POTA Info is not present in the comment, try to find it using POTAQE
-        const QString &ref = PotaQE::instance()->findReferenceId(dxSpotCallsign, spot.freq).reference;
-        if ( !ref.isEmpty() )
+        emit newSpot(spot);
+
+        if ( spot.modeGroupString.contains(moderegexp)
+             && spot.dxcc.cont.contains(contregexp)
+             && spot.dxcc_spotter.cont.contains(spottercontregexp)
+             && spot.band.contains(bandregexp)
+             && ( spot.status & dxccStatusFilter)
+             && ( dxMemberFilter.size() == 0
+                || (dxMemberFilter.size() && spot.memberList2Set().intersects(dxMemberFilter)) )
+             && spot.dupeCount == 0
+            )
         {
-            spot.potaRef = ref;
-            spot.containsPOTA = true;
-            qCDebug(runtime) << "Found POTA" << spot.callsign << ref;
-            spot.comment.append(" [+] POTA " + ref);
+            filteredSpots.append(spot);
         }
     }
-}
 
-void DxWidget::sotaRefFromComment(DxSpot &spot) const
-{
-    FCT_IDENTIFICATION;
-
-    static QRegularExpression sotaRefRegEx(QStringLiteral("(?:^|\\s)([A-Za-z0-9]{1,3}/[A-Za-z]{2})-?(\\d{1,3})(?:\\s|$)"),
-                                           QRegularExpression::CaseInsensitiveOption);
+    const QList<DxSpot> &insertedSpots = dxTableModel->addEntries(filteredSpots, deduplicateSpots,
+                                                                  deduplicatetime, deduplicatefreq);
 
-    spot.containsSOTA = spot.comment.contains("SOTA", Qt::CaseInsensitive);
-
-    if ( spot.comment.contains("FT8", Qt::CaseInsensitive)  // a false detection in case of TNX/FT8 comments
-        || spot.comment.contains("FT4",Qt::CaseInsensitive) )
-        return;
+    for ( const DxSpot &spot : insertedSpots )
+        emit newFilteredSpot(spot);
 
-    spot.sotaRef = refFromComment(spot.comment, spot.containsSOTA,
-                                  sotaRefRegEx, QStringLiteral("SOTA"), 3);
+    updateEnricherStatistics(statistics);
 }
 
-void DxWidget::iotaRefFromComment(DxSpot &spot) const
+void DxWidget::updateEnricherStatistics(const DxSpotEnricher::Statistics &statistics)
 {
     FCT_IDENTIFICATION;
 
-    spot.containsIOTA = spot.comment.contains("IOTA", Qt::CaseInsensitive);
+    enricherStatistics.spots += statistics.spots;
+    enricherStatistics.resolveNs += statistics.resolveNs;
+    enricherStatistics.statusNs += statistics.statusNs;
+    enricherStatistics.referenceNs += statistics.referenceNs;
 
-    if ( spot.dxcc.cont.isEmpty() )
+    if ( !enricherStatisticsTimer.isValid() )
+    {
+        enricherStatisticsTimer.start();
         return;
+    }
 
-    QRegularExpression iotaRegEx(QString("(?:^|\\s)(%0)[- ]?(\\d{1,3})(?:\\s|$)").arg(spot.dxcc.cont),
-                                 QRegularExpression::CaseInsensitiveOption);
-    spot.iotaRef = refFromComment(spot.comment, spot.containsIOTA,
-                                  iotaRegEx, QStringLiteral("IOTA"), 3);
-}
-
-void DxWidget::splitFreqFromComment(DxSpot &spot) const
-{
-    FCT_IDENTIFICATION;
+    const qint64 elapsedMs = enricherStatisticsTimer.elapsed();
 
-    if ( spot.comment.isEmpty() || spot.freq <= 0.0 )
+    if ( elapsedMs < ENRICHER_STATISTICS_PERIOD )
         return;
 
-    // Absolute TX frequency: "QSX 14250", "QSX 14.250", "LISTENING 28510", "LSN 28.510"
-    static QRegularExpression absFreqRx(QStringLiteral("\\b(?:QSX|LISTENING|LSN)\\s+(\\d+\\.?\\d*)\\b"),
-                                        QRegularExpression::CaseInsensitiveOption);
-    QRegularExpressionMatch match = absFreqRx.match(spot.comment);
-    if ( match.hasMatch() )
-    {
-        double freq = match.captured(1).toDouble();
-        if ( freq > 1000.0 )
-            freq = freq / 1000.0; // kHz → MHz
-        if ( freq > 0.0 )
-        {
-            spot.freqTX = freq;
-            qCDebug(runtime) << "Split absolute TX:" << spot.freqTX << "from:" << spot.comment;
-            return;
-        }
-    }
+    const int spots = qMax(enricherStatistics.spots, 1);
 
-    // Relative offset UP: "UP 5", "UP 5-10", "UP5" (kHz above spot freq)
-    static QRegularExpression upNRx(QStringLiteral("\\bUP\\s*(\\d+(?:\\.\\d+)?)(?:\\s*[-/]\\s*\\d+(?:\\.\\d+)?)?\\b"),
-                                    QRegularExpression::CaseInsensitiveOption);
-    match = upNRx.match(spot.comment);
-    if ( match.hasMatch() )
-    {
-        double offsetKHz = match.captured(1).toDouble();
-        if ( offsetKHz > 0.0 )
-        {
-            spot.freqTX = spot.freq + offsetKHz / 1000.0;
-            qCDebug(runtime) << "Split UP" << offsetKHz << "kHz, TX:" << spot.freqTX;
-            return;
-        }
-    }
+    qCDebug(runtime) << "DX Spot pipeline:"
+                     << enricherStatistics.spots * 1000.0 / elapsedMs << "spots/s;"
+                     << "avg latency [us] resolve:" << enricherStatistics.resolveNs / 1000.0 / spots
+                     << "status:" << enricherStatistics.statusNs / 1000.0 / spots
+                     << "references:" << enricherStatistics.referenceNs / 1000.0 / spots;
 
-    // Relative offset UP reversed: "1 UP", "5 UP", "5UP"
-    static QRegularExpression nUpRx(QStringLiteral("\\b(\\d+(?:\\.\\d+)?)\\s*UP\\b"),
-                                    QRegularExpression::CaseInsensitiveOption);
-    match = nUpRx.match(spot.comment);
-    if ( match.hasMatch() )
-    {
-        double offsetKHz = match.captured(1).toDouble();
-        if ( offsetKHz > 0.0 )
-        {
-            spot.freqTX = spot.freq + offsetKHz / 1000.0;
-            qCDebug(runtime) << "Split" << offsetKHz << "UP kHz, TX:" << spot.freqTX;
-            return;
-        }
-    }
+    enricherStatistics = DxSpotEnricher::Statistics();
+    enricherStatisticsTimer.restart();
+}
 
-    // Relative offset DOWN: "DN 5", "DOWN 5", "DWN 5"
-    static QRegularExpression dnNRx(QStringLiteral("\\b(?:DN|DOWN|DWN)\\s*(\\d+(?:\\.\\d+)?)\\b"),
-                                    QRegularExpression::CaseInsensitiveOption);
-    match = dnNRx.match(spot.comment);
-    if ( match.hasMatch() )
-    {
-        double offsetKHz = match.captured(1).toDouble();
-        if ( offsetKHz > 0.0 )
-        {
-            spot.freqTX = spot.freq - offsetKHz / 1000.0;
-            qCDebug(runtime) << "Split DOWN" << offsetKHz << "kHz, TX:" << spot.freqTX;
-            return;
-        }
-    }
+QVector<int> DxWidget::dxcListHiddenCols() const
+{
+    QVector<int> ret;
+    ret.reserve(dxTableModel->columnCount());
 
-    // Relative offset DOWN reversed: "5 DN", "5 DOWN"
-    static QRegularExpression nDnRx(QStringLiteral("\\b(\\d+(?:\\.\\d+)?)\\s*(?:DN|DOWN|DWN)\\b"),
-                                    QRegularExpression::CaseInsensitiveOption);
-    match = nDnRx.match(spot.comment);
-    if ( match.hasMatch() )
+    for ( int i = 0; i < dxTableModel->columnCount(); ++i )
     {
-        double offsetKHz = match.captured(1).toDouble();
-        if ( offsetKHz > 0.0 )
-        {
-            spot.freqTX = spot.freq - offsetKHz / 1000.0;
-            qCDebug(runtime) << "Split" << offsetKHz << "DOWN kHz, TX:" << spot.freqTX;
-            return;
-        }
+        if (ui->dxTable->isColumnHidden(i))
+            ret.append(i);
     }
 
-    // Bare "UP" without number → 1 kHz default offset
-    static QRegularExpression bareUpRx(QStringLiteral("\\bUP\\b"),
-                                       QRegularExpression::CaseInsensitiveOption);
-    if ( bareUpRx.match(spot.comment).hasMatch() )
-    {
-        spot.freqTX = spot.freq + 1.0 / 1000.0;
-        qCDebug(runtime) << "Split bare UP, TX:" << spot.freqTX;
-    }
+    return ret;
 }
 
 DxWidget::~DxWidget()
@@ -2160,6 +2008,8 @@ DxWidget::~DxWidget()
     FCT_IDENTIFICATION;
 
     disconnectCluster(false);
+    spotEnricherThread.quit();
+    spotEnricherThread.wait();
     delete ui;
 }
 
@@ -7,8 +7,12 @@
 #include <QRegularExpression>
 #include <QSqlRecord>
 #include <QLabel>
+#include <QThread>
+#include <QElapsedTimer>
 
 #include "data/DxSpot.h"
+#include "data/DxSpotStore.h"
+#include "core/DxSpotEnricher.h"
 #include "data/WCYSpot.h"
 #include "data/WWVSpot.h"
 #include "data/ToAllSpot.h"
@@ -42,11 +46,19 @@ public:
                   bool deduplicate = false,
                   qint16 dedup_interval = DEDUPLICATION_TIME,
                   double dedup_freq_tolerance = DEDUPLICATION_FREQ_TOLERANCE);
+    // returns the list of inserted spots
+    QList<DxSpot> addEntries(const QList<DxSpot> &entries,
+                             bool deduplicate = false,
+                             qint16 dedup_interval = DEDUPLICATION_TIME,
+                             double dedup_freq_tolerance = DEDUPLICATION_FREQ_TOLERANCE);
     const DxSpot getSpot(const QModelIndex& index) const {return dxData.at(index.row());};
     void clear();
 
 private:
-    QList<DxSpot> dxData;
+    bool isBatchDuplicate(const QList<DxSpot> &batch, const DxSpot &entry,
+                          qint16 dedup_interval, double dedup_freq_tolerance) const;
+
+    DxSpotStore dxData;
     LogLocale locale;
 };
 
@@ -164,6 +176,8 @@ private slots:
 
     void displayedColumns();
     void trendDoubleClicked(int row, int column);
+    void processEnrichedSpots(QList<DxSpot> spots,
+                              DxSpotEnricher::Statistics statistics);
 
 signals:
     void tuneDx(DxSpot);
@@ -221,6 +235,11 @@ private:
     QStringList trendBandList;
     QLabel *trendTableCornerLabel;
     const NewContactWidget *newContactWidget;
+    QList<DxSpot> pendingSpots;
+    DxSpotEnricher spotEnricher;
+    QThread spotEnricherThread;
+    DxSpotEnricher::Statistics enricherStatistics;
+    QElapsedTimer enricherStatisticsTimer;
 
     void connectCluster();
     void disconnectCluster(bool tryReconnect = false);
@@ -255,16 +274,10 @@ private:
                        const QString &comment,
                        const QDateTime &dateTime = QDateTime());
 
+    void dispatchPendingSpots();
+    void updateEnricherStatistics(const DxSpotEnricher::Statistics &statistics);
+
     QVector<int> dxcListHiddenCols() const;
-    BandPlan::BandPlanMode modeGroupFromComment(const QString &comment) const;
-    QString refFromComment(const QString &comment, bool &flag,
-                           const QRegularExpression &regEx,
-                           const QString &refType, int justified) const;
-    void wwffRefFromComment(DxSpot &spot) const;
-    void potaRefFromComment(DxSpot &spot) const;
-    void sotaRefFromComment(DxSpot &spot) const;
-    void iotaRefFromComment(DxSpot &spot) const;
-    void splitFreqFromComment(DxSpot &spot) const;
 
     QColor getHeatmapColor(int value, int maxValue);
 
@@ -4,8 +4,10 @@
 #include <QMessageBox>
 #include <QProgressDialog>
 #include <QSqlError>
+#include <QEventLoop>
 #include "ui_ExportDialog.h"
 #include <logformat/PotaAdiFormat.h>
+#include "logformat/LogFormatWorker.h"
 
 #include "core/debug.h"
 #include "models/SqlListModel.h"
@@ -173,31 +175,25 @@ void ExportDialog::runExport()
         return;
     }
 
-    QFile file(ui->fileEdit->text());
+    LogFormatWorker worker;
 
-    if ( ! file.open(QFile::WriteOnly | QFile::Text) )
+    if ( ! worker.open(ui->fileEdit->text(),
+                       ui->typeSelect->currentText(),
+                       QFile::WriteOnly | QFile::Text) )
     {
         QMessageBox::critical(nullptr, QMessageBox::tr("QLog Error"),
                              QMessageBox::tr("Cannot write to the file"));
         return;
     }
 
-    QTextStream out(&file);
-
-    LogFormat *format = LogFormat::open(ui->typeSelect->currentText(), out);
-
-    if ( !format )
-    {
-        qCritical() << "unknown log format";
-        return;
-    }
+    LogFormat *format = worker.format();
 
     PotaAdiFormat *potaFormat = dynamic_cast<PotaAdiFormat *>(format);
 
     if ( potaFormat )
     {
         potaFormat->setPotaOnly(true);
-        potaFormat->setExportDirectory(QFileInfo(file).canonicalPath());
+        potaFormat->setExportDirectory(QFileInfo(ui->fileEdit->text()).canonicalPath());
     }
 
     if ( ui->dateRangeCheckBox->isChecked() )
@@ -249,18 +245,35 @@ void ExportDialog::runExport()
     progressDialog.setMinimumDuration(0);
 
     connect(format, &LogFormat::exportProgress, &progressDialog, &QProgressDialog::setValue);
+    // the worker lives in its thread now - cancel directly, the flag is atomic
+    connect(&progressDialog, &QProgressDialog::canceled, this, [&worker]()
+    {
+        worker.cancel();
+    });
 
     long count = 0L;
+    bool cancelled = false;
+    QEventLoop loop;
 
-    if ( qsos4export.size() > 0 )
+    connect(&worker, &LogFormatWorker::exportFinished, &loop, [&](long exportedCount, bool exportCancelled)
     {
-        count = format->runExport(qsos4export);
-    }
+        count = exportedCount;
+        cancelled = exportCancelled;
+        loop.quit();
+    });
+
+    // The export runs in the worker thread, the application stays responsive
+    if ( qsos4export.size() > 0 )
+        worker.startExport(qsos4export);
     else
-    {
-        count = format->runExport();
+        worker.startExport();
 
+    loop.exec();
+
+    if ( qsos4export.size() == 0 )
+    {
         if ( count > 0
+             && !cancelled
              && ui->exportTypeCombo->currentData() == "qsl"
              && ui->markAsSentCheckbox->isChecked() )
         {
@@ -275,8 +288,6 @@ void ExportDialog::runExport()
 
     progressDialog.close();
 
-    delete format;
-
     if ( potaFormat && qsos4export.size() > 0 ) // TODO: correctly calculate
                                                 // the exported QSOs in case of POTA formatter and direct export dialog
         QMessageBox::information(nullptr, QMessageBox::tr("QLog Information"),
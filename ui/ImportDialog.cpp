@@ -1,9 +1,12 @@
 #include <QFileDialog>
 #include <QMessageBox>
+#include <QEventLoop>
+#include <QThread>
 #include "ImportDialog.h"
 #include "ui_ImportDialog.h"
 #include "logformat/LogFormat.h"
 #include "core/debug.h"
+#include "core/LogParam.h"
 #include "data/StationProfile.h"
 #include "data/RigProfile.h"
 
@@ -11,7 +14,9 @@ MODULE_IDENTIFICATION("qlog.ui.importdialog");
 
 ImportDialog::ImportDialog(QWidget *parent) :
     QDialog(parent),
-    ui(new Ui::ImportDialog)
+    ui(new Ui::ImportDialog),
+    size(0),
+    activeWorker(nullptr)
 {
     FCT_IDENTIFICATION;
 
@@ -121,13 +126,41 @@ void ImportDialog::toggleComment()
     commentChanged(ui->commentEdit->text());
 }
 
-void ImportDialog::computeProgress(qint64 position)
+void ImportDialog::computeProgress(qint64 position, qint64 processedRecords)
 {
     FCT_IDENTIFICATION;
 
-    int progress = (int)(position * 100 / size);
+    qCDebug(function_parameters) << position << processedRecords;
+
+    if ( size <= 0 )
+        return;
+
+    const int progress = static_cast<int>(qMin<qint64>(position * 100 / size, 100));
+    const double elapsedSecs = importTimer.elapsed() / 1000.0;
     ui->progressBar->setValue(progress);
-    QCoreApplication::processEvents();
+
+    if ( elapsedSecs <= 0.0 || position <= 0 )
+        return;
+
+    const int recordsPerSecond = static_cast<int>(processedRecords / elapsedSecs);
+    const int etaSecs = static_cast<int>(elapsedSecs * (size - position) / position);
+
+    ui->progressBar->setFormat(tr("%p% - %1 QSOs/s - ETA %2").arg(recordsPerSecond)
+                                                            .arg(QTime(0, 0).addSecs(etaSecs).toString("mm:ss")));
+}
+
+void ImportDialog::reject()
+{
+    FCT_IDENTIFICATION;
+
+    if ( activeWorker )
+    {
+        // running import - rollback the current batch and finish
+        activeWorker->cancel();
+        return;
+    }
+
+    QDialog::reject();
 }
 
 void ImportDialog::stationProfileTextChanged(const QString &newProfileName)
@@ -158,6 +191,16 @@ LogFormat::duplicateQSOBehaviour ImportDialog::showDuplicateDialog(QSqlRecord *i
 
     LogFormat::duplicateQSOBehaviour ret = LogFormat::ACCEPT_ONE;
 
+    // Import runs in a worker thread, the question must be asked by the GUI thread
+    if ( QThread::currentThread() != QCoreApplication::instance()->thread() )
+    {
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [&]()
+        {
+            ret = showDuplicateDialog(imported, original);
+        }, Qt::BlockingQueuedConnection);
+        return ret;
+    }
+
     QMessageBox::StandardButton reply;
 
     QString inLogQSO = tr("<p><b>In-Log QSO:</b></p><p>")
@@ -245,11 +288,18 @@ void ImportDialog::runImport()
         return;
     }
 
-    QFile file(ui->fileEdit->text());
-    file.open(QFile::ReadOnly | QFile::Text);
-    QTextStream in(&file);
+    LogFormatWorker worker;
 
-    size = file.size();
+    if ( !worker.open(ui->fileEdit->text(),
+                      ui->typeSelect->currentText(),
+                      QFile::ReadOnly | QFile::Text) )
+    {
+        QMessageBox::critical(nullptr, QMessageBox::tr("QLog Error"),
+                              QMessageBox::tr("Cannot read the file"));
+        return;
+    }
+
+    size = QFileInfo(ui->fileEdit->text()).size();
 
     QMap<QString, QString> defaults;
 
@@ -263,15 +313,11 @@ void ImportDialog::runImport()
         defaults["comment_intl"] = ui->commentEdit->text();
     }
 
-    LogFormat* format = LogFormat::open(ui->typeSelect->currentText(), in);
-
-    if (!format) {
-        qCritical() << "unknown log format";
-        return;
-    }
+    LogFormat* format = worker.format();
 
     format->setDefaults(defaults);
     format->setFillMissingDxcc(ui->fillMissingDxccCheckBox->isChecked());
+    format->setImportBatchSize(LogParam::getImportBatchSize(LogFormat::DEFAULT_IMPORT_BATCH_SIZE));
 
     if (!ui->allCheckBox->isChecked()) {
         format->setFilterDateRange(ui->startDateEdit->date(), ui->endDateEdit->date());
@@ -279,9 +325,9 @@ void ImportDialog::runImport()
 
     format->setDuplicateQSOCallback(showDuplicateDialog);
 
-    connect(format, &LogFormat::importPosition, this, &ImportDialog::computeProgress);
+    connect(format, &LogFormat::importProgress, this, &ImportDialog::computeProgress);
 
-    ui->buttonBox->setEnabled(false);
+    ui->buttonBox->button(QDialogButtonBox::Ok)->setEnabled(false);
     ui->fileEdit->setEnabled(false);
     ui->typeSelect->setEnabled(false);
     ui->browseButton->setEnabled(false);
@@ -297,14 +343,32 @@ void ImportDialog::runImport()
     ui->fillMissingDxccCheckBox->setEnabled(false);
 
     QString s;
-    QTextStream out(&s);
+    unsigned long count = 0L;
     unsigned long errors = 0L;
     unsigned long warnings = 0L;
-
-    int count = format->runImport(out,
-                                  ( ui->profileCheckBox->isChecked() && selectedStationProfile != StationProfile() ) ?&selectedStationProfile: nullptr,
-                                  &warnings,
-                                  &errors);
+    QEventLoop loop;
+
+    connect(&worker, &LogFormatWorker::importFinished, &loop,
+            [&](unsigned long importedCount,
+                unsigned long importWarnings,
+                unsigned long importErrors,
+                const QString &details,
+                bool)
+    {
+        count = importedCount;
+        warnings = importWarnings;
+        errors = importErrors;
+        s = details;
+        loop.quit();
+    });
+
+    // The import runs in the worker thread. The local event loop keeps
+    // the rest of the application (DXC, WSJTX, Rig) alive in the meantime.
+    activeWorker = &worker;
+    importTimer.start();
+    worker.startImport(( ui->profileCheckBox->isChecked() && selectedStationProfile != StationProfile() ) ? &selectedStationProfile : nullptr);
+    loop.exec();
+    activeWorker = nullptr;
 
     QString report = QObject::tr("<b>Imported</b>: %n contact(s)", "", count) + "<br/>" +
                      QObject::tr("<b>Warning(s)</b>: %n", "", warnings) + "<br/>" +
@@ -341,8 +405,6 @@ void ImportDialog::runImport()
                           count, warnings, errors);
     }
 
-    delete format;
-
     qCDebug(runtime).noquote() << s;
 
     accept();
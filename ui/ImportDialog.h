@@ -3,7 +3,9 @@
 
 #include <QDialog>
 #include <QSqlRecord>
+#include <QElapsedTimer>
 #include <logformat/LogFormat.h>
+#include "logformat/LogFormatWorker.h"
 #include "data/StationProfile.h"
 #include "core/LogLocale.h"
 
@@ -19,12 +21,15 @@ public:
     explicit ImportDialog(QWidget *parent = 0);
     ~ImportDialog();
 
+public slots:
+    void reject() override;
+
 private slots:
     void browse();
     void toggleAll();
     void toggleComment();
     void runImport();
-    void computeProgress(qint64 position);
+    void computeProgress(qint64 position, qint64 processedRecords);
     void stationProfileTextChanged(const QString&);
     void rigProfileTextChanged(const QString&);
     void toggleMyProfile();
@@ -34,6 +39,8 @@ private slots:
 private:
     Ui::ImportDialog *ui;
     qint64 size;
+    QElapsedTimer importTimer;
+    LogFormatWorker *activeWorker;
     StationProfile selectedStationProfile;
     LogLocale locale;
 
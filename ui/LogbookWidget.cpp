@@ -31,6 +31,7 @@
 #include "service/GenericCallbook.h"
 #include "core/QSOFilterManager.h"
 #include "core/LogParam.h"
+#include "core/LogbookSearchIndex.h"
 
 MODULE_IDENTIFICATION("qlog.ui.logbookwidget");
 
@@ -47,39 +48,51 @@ LogbookWidget::LogbookWidget(QWidget *parent) :
     searchTypeList.insert(CALLSIGN_SEARCH,
                           SearchDefinition(CALLSIGN_SEARCH,
                                            ui->actionSearchCallsign,
-                                           "callsign"));
+                                           {"callsign"}));
     searchTypeList.insert(GRIDSQUARE_SEARCH,
                           SearchDefinition(GRIDSQUARE_SEARCH,
                                            ui->actionSearchGrid,
-                                           "gridsquare"));
+                                           {"gridsquare"}));
 
     searchTypeList.insert(POTA_SEARCH,
                           SearchDefinition(POTA_SEARCH,
                                            ui->actionSearchPOTA,
-                                           "pota_ref"));
+                                           {"pota_ref"}));
 
     searchTypeList.insert(SOTA_SEARCH,
                           SearchDefinition(SOTA_SEARCH,
                                            ui->actionSearchSOTA,
-                                           "sota_ref"));
+                                           {"sota_ref"}));
 
     searchTypeList.insert(WWFF_SEARCH,
                           SearchDefinition(WWFF_SEARCH,
                                            ui->actionSearchWWFF,
-                                           "wwff_ref"));
+                                           {"wwff_ref"}));
 
     searchTypeList.insert(SIG_SEARCH,
                           SearchDefinition(SIG_SEARCH,
                                            ui->actionSearchSIG,
-                                           "sig_intl"));
+                                           {"sig_intl"}));
 
     searchTypeList.insert(IOTA_SEARCH,
                           SearchDefinition(IOTA_SEARCH,
                                            ui->actionSearchIOTA,
-                                           "iota"));
+                                           {"iota"}));
+
+    searchTypeList.insert(TEXT_SEARCH,
+                          SearchDefinition(TEXT_SEARCH,
+                                           ui->actionSearchText,
+                                           {"name", "name_intl", "qth", "qth_intl",
+                                            "comment", "comment_intl", "notes", "notes_intl"}));
 
     setupSearchMenu();
 
+    // the filter is applied when the user stops typing;
+    // every applied filter reselects the model
+    searchTextTimer.setSingleShot(true);
+    searchTextTimer.setInterval(250);
+    connect(&searchTextTimer, &QTimer::timeout, this, &LogbookWidget::filterTable);
+
     connect(ui->countrySelectFilter, &SmartSearchBox::currentTextChanged,
             this, &LogbookWidget::countryFilterChanged);
 
@@ -594,6 +607,14 @@ void LogbookWidget::setIOTASearch()
     ui->searchTextFilter->setPlaceholderText(tr("IOTA"));
 }
 
+void LogbookWidget::setTextSearch()
+{
+    FCT_IDENTIFICATION;
+
+    clearSearchText();
+    ui->searchTextFilter->setPlaceholderText(tr("Name, QTH, Comment, Notes"));
+}
+
 void LogbookWidget::filterCallsign(const QString &call)
 {
     FCT_IDENTIFICATION;
@@ -657,7 +678,7 @@ void LogbookWidget::onSearchTextChanged()
 {
     FCT_IDENTIFICATION;
 
-    filterTable();
+    searchTextTimer.start();
 }
 
 void LogbookWidget::bandFilterChanged()
@@ -1311,19 +1332,22 @@ void LogbookWidget::filterTable()
 {
     FCT_IDENTIFICATION;
 
+    // a pending search text change is applied now
+    searchTextTimer.stop();
+
     QStringList filterString;
     QString searchText = ui->searchTextFilter->text();
 
     // an external request from Callsign search is always used (the request is sent by the NewContact Widget)
     if ( !ui->actionSearchCallsign->isChecked() && !callsignSearchValue.isEmpty() )
-        filterString.append(QString("callsign LIKE '%%1%'").arg(callsignSearchValue.toUpper()));
+        filterString.append(LogbookSearchIndex::whereClause({"callsign"}, callsignSearchValue.toUpper()));
 
     for ( auto it = searchTypeList.cbegin(); it != searchTypeList.cend(); it++)
     {
         const SearchDefinition &def = it.value();
         if ( !def.action ) continue;
         if ( def.action->isChecked() && !searchText.isEmpty() )
-            filterString.append(QString("%1 LIKE '%%2%'").arg(def.dbColumn, searchText.toUpper()));
+            filterString.append(LogbookSearchIndex::whereClause(def.dbColumns, searchText));
     }
 
     const QString &bandFilterValue = ui->bandSelectFilter->currentText();
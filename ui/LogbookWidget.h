@@ -6,6 +6,7 @@
 #include <QComboBox>
 #include <QSqlRecord>
 #include <QActionGroup>
+#include <QTimer>
 
 #include "core/CallbookManager.h"
 #include "component/ShutdownAwareWidget.h"
@@ -37,7 +38,8 @@ public:
         SOTA_SEARCH = 4,
         WWFF_SEARCH = 5,
         IOTA_SEARCH = 6,
-        SIG_SEARCH = 7
+        SIG_SEARCH = 7,
+        TEXT_SEARCH = 8
     };
 
 signals:
@@ -100,6 +102,7 @@ public slots:
     void setWwffSearch();
     void setSigSearch();
     void setIOTASearch();
+    void setTextSearch();
 
 private:
     ClubLogUploader* clublog;
@@ -138,17 +141,18 @@ private:
     QProgressDialog *lookupDialog;
     QString callsignSearchValue;
     QActionGroup *searchTypeGroup;
+    QTimer searchTextTimer;
 
     class SearchDefinition
     {
     public:
-        SearchDefinition(const SearchType searchType, QAction *action, const QString dbColumn) :
-            searchType(searchType), action(action), dbColumn(dbColumn) {action->setData(searchType);};
+        SearchDefinition(const SearchType searchType, QAction *action, const QStringList dbColumns) :
+            searchType(searchType), action(action), dbColumns(dbColumns) {action->setData(searchType);};
         SearchDefinition(): searchType(UNKNOWN_SEARCH), action(nullptr) {};
 
         SearchType searchType;
         QAction *action;
-        QString dbColumn;
+        QStringList dbColumns;
     };
 
     QMap<SearchType, SearchDefinition> searchTypeList;
@@ -30,6 +30,7 @@
 #include "core/LogParam.h"
 #include "core/QSOFilterManager.h"
 #include "data/Data.h"
+#include "data/BandPlan.h"
 #include "data/ActivityProfile.h"
 #include "data/AntProfile.h"
 #include "data/RigProfile.h"
@@ -335,7 +336,10 @@ MainWindow::MainWindow(QWidget* parent) :
 
     connect(ui->rotatorWidget, &RotatorWidget::rotProfileChanged, this, &MainWindow::rotConnect);
 
-    connect(ui->logbookWidget, &LogbookWidget::deletedEntities, Data::instance(), &Data::invalidateSetOfDXCCStatusCache); // must be the first delete signal
+    connect(ui->logbookWidget, &LogbookWidget::deletedEntities, Data::instance(), &Data::refreshDXCCStatusIndex); // must be the first delete signal
+    connect(ui->logbookWidget, &LogbookWidget::contactUpdated, Data::instance(), &Data::prepareDXCCStatusIndexUpdate);
+    connect(ui->logbookWidget, &LogbookWidget::contactUpdated, Data::instance(), &Data::prepareDupeIndexUpdate);
+    connect(ui->logbookWidget, &LogbookWidget::contactDeleted, Data::instance(), &Data::removeContactFromDupeIndex); // must be the first delete signal
     connect(ui->logbookWidget, &LogbookWidget::logbookUpdated, stats, &StatisticsWidget::refreshWidget);
     connect(ui->logbookWidget, &LogbookWidget::contactUpdated, &networknotification, &NetworkNotification::QSOUpdated);
     connect(ui->logbookWidget, &LogbookWidget::clublogContactUpdated, clublogRT, &ClubLogUploader::updateQSOImmediately);
@@ -350,7 +354,8 @@ MainWindow::MainWindow(QWidget* parent) :
     connect(ui->logbookWidget, &LogbookWidget::clublogContactDeleted, clublogRT, &ClubLogUploader::deleteQSOImmediately);
     connect(ui->logbookWidget, &LogbookWidget::sendDXSpotContactReq, ui->dxWidget, &DxWidget::prepareQSOSpot);
 
-    connect(ui->newContactWidget, &NewContactWidget::contactAdded, Data::instance(), &Data::invalidateDXCCStatusCache); // must be the first delete signal
+    connect(ui->newContactWidget, &NewContactWidget::contactAdded, Data::instance(), &Data::addContactToDXCCStatusIndex); // must be the first add signal
+    connect(ui->newContactWidget, &NewContactWidget::contactAdded, Data::instance(), &Data::addContactToDupeIndex);
     connect(ui->newContactWidget, &NewContactWidget::contactAdded, ui->logbookWidget, &LogbookWidget::updateTable);
     connect(ui->newContactWidget, &NewContactWidget::contactAdded, ui->logbookWidget, &LogbookWidget::setDefaultSort);
     connect(ui->newContactWidget, &NewContactWidget::contactAdded, &networknotification, &NetworkNotification::QSOInserted);
@@ -1096,6 +1101,7 @@ void MainWindow::showServiceDownloadQSL()
 
     DownloadQSLDialog dialog(this);
     dialog.exec();
+    Data::instance()->reloadDXCCStatusIndex();
     ui->logbookWidget->updateTable();
 }
 
@@ -1852,7 +1858,9 @@ void MainWindow::showSettings()
 
     if ( sw.exec() == QDialog::Accepted )
     {
-        Data::instance()->clearDXCCStatusCache();
+        BandPlan::invalidateCache();
+        Data::instance()->reloadDXCCStatusIndex();
+        Data::instance()->invalidateDupeIndex();
         rigConnect();
         rotConnect();
         stationProfileChanged();
@@ -1880,6 +1888,8 @@ void MainWindow::importLog() {
 
     ImportDialog dialog(this);
     dialog.exec();
+    Data::instance()->reloadDXCCStatusIndex();
+    Data::instance()->invalidateDupeIndex();
     ui->logbookWidget->updateTable();
 }
 
@@ -5,6 +5,7 @@
 #include <QPainter>
 #include <QVector3D>
 #include <QtMath>
+#include <QRunnable>
 #include "MapWidget.h"
 #include "core/debug.h"
 #include "data/Gridsquare.h"
@@ -12,6 +13,50 @@
 
 MODULE_IDENTIFICATION("qlog.ui.mapwidget");
 
+// Renders a band of night overlay rows. The night lights are copied
+// to the pixels and the alpha channel is set by the sun illumination.
+// The inner loop is branch-free so that the compiler can vectorize it.
+class NightOverlayRowsTask : public QRunnable
+{
+public:
+    void run() override
+    {
+        for ( int y = firstRow; y < lastRow; y++ )
+        {
+            const float rowSin = sinTheta[y];
+            const float rowZ = sunZ * cosTheta[y];
+            const QRgb *lights = reinterpret_cast<const QRgb *>(nightLights->constScanLine(y));
+            QRgb *pixels = reinterpret_cast<QRgb *>(overlay + y * bytesPerLine);
+
+            for ( int x = 0; x < width; x++ )
+            {
+                const float ill = rowSin * sunColumn[x] + rowZ;
+
+                // ill <= -0.1 -> 255; ill >= 0.1 -> 0; otherwise 255 * (1 - (ill + 0.1) * 5)^8
+                float t = 1.0f - (ill + 0.1f) * 5.0f;
+                t = ( t < 0.0f ) ? 0.0f : ( t > 1.0f ) ? 1.0f : t;
+                t *= t;
+                t *= t;
+                t *= t;
+                const quint32 alpha = static_cast<quint32>(255.0f * t);
+
+                pixels[x] = (alpha << 24) | (lights[x] & 0x00FFFFFF);
+            }
+        }
+    }
+
+    int firstRow = 0;
+    int lastRow = 0;
+    int width = 0;
+    float sunZ = 0.0f;
+    const float *sunColumn = nullptr;
+    const float *cosTheta = nullptr;
+    const float *sinTheta = nullptr;
+    const QImage *nightLights = nullptr;
+    uchar *overlay = nullptr;
+    qsizetype bytesPerLine = 0;
+};
+
 MapWidget::MapWidget(QWidget *parent) :
     QGraphicsView(parent)
 {
@@ -186,59 +231,99 @@ void MapWidget::redrawNightOverlay()
     int maxX = static_cast<int>(scene->width());
     int maxY = static_cast<int>(scene->height());
 
-    QImage overlay(maxX, maxY, QImage::Format_ARGB32);
-    uchar* buffer = overlay.bits();
+    if ( maxX <= 1 || maxY <= 1 )
+        return;
 
-    for ( int y = 0; y < maxY; y++ )
+    // subsolar point in scene pixels; the overlay is redrawn only
+    // if the sun has moved at least one pixel since the last redraw
+    const QPointF sunPoint(( atan2(sunY, sunX) + M_PI ) / (2.0 * M_PI) * (maxX - 1.0),
+                           acos(static_cast<double>(sun.z())) / M_PI * (maxY - 1.0));
+
+    if ( overlaySize == QSize(maxX, maxY)
+         && qAbs(sunPoint.x() - lastSunPoint.x()) < 1.0
+         && qAbs(sunPoint.y() - lastSunPoint.y()) < 1.0 )
     {
-        double theta = M_PI * (static_cast<double>(y) / (static_cast<double>(maxY) - 1.0));
-        double posZ = cos(theta);
-        double sinTheta = sin(theta);
+        qCDebug(runtime) << "Sun has not moved; skipping night overlay redraw";
+        return;
+    }
 
-        for ( int x = 0; x < maxX; x++ )
-        {
-            double phi = 2.0 * M_PI * (static_cast<double>(x) / (static_cast<double>(maxX) - 1.0)) - M_PI;
+    prepareNightOverlayTables(maxX, maxY);
 
-            double posX = sinTheta * cos(phi);
-            double posY = sinTheta * sin(phi);
+    // ill = dot(sun, pos) where pos = (sinTheta*cosPhi, sinTheta*sinPhi, cosTheta);
+    // the column part depends on the sun only, so it is computed once per redraw
+    QVector<float> sunColumn(maxX);
 
-            QVector3D pos(static_cast<float>(posX), static_cast<float>(posY), static_cast<float>(posZ));
-            pos.normalize();
+    for ( int x = 0; x < maxX; x++ )
+        sunColumn[x] = sun.x() * cosPhi.at(x) + sun.y() * sinPhi.at(x);
 
-            buffer[0] = 0;
-            buffer[1] = 0;
-            buffer[2] = 0;
+    QImage overlay(maxX, maxY, QImage::Format_ARGB32);
+    // detach the image here; the render tasks write only to the raw buffer
+    uchar *overlayBits = overlay.bits();
 
-            float ill = QVector3D::dotProduct(sun, pos);
-            if ( ill <= -0.1f )
-            {
-                buffer[3] = 255;
-            }
-            else if ( ill < 0.1f )
-            {
-                double illd = 1.0 - (static_cast<double>(ill) + 0.1) * 5.0;
-                illd = pow(illd, 8);
-                buffer[3] = static_cast<uchar>(255.0 * illd);
-            }
-            else
-            {
-                buffer[3] = 0;
-            }
-            buffer += 4;
-        }
+    const int tasks = qMin(maxY, overlayRenderPool.maxThreadCount() * 4);
+    const int rowsPerTask = (maxY + tasks - 1) / tasks;
+
+    for ( int firstRow = 0; firstRow < maxY; firstRow += rowsPerTask )
+    {
+        NightOverlayRowsTask *task = new NightOverlayRowsTask;
+
+        task->firstRow = firstRow;
+        task->lastRow = qMin(firstRow + rowsPerTask, maxY);
+        task->width = maxX;
+        task->sunZ = sun.z();
+        task->sunColumn = sunColumn.constData();
+        task->cosTheta = cosTheta.constData();
+        task->sinTheta = sinTheta.constData();
+        task->nightLights = &nightLights;
+        task->overlay = overlayBits;
+        task->bytesPerLine = overlay.bytesPerLine();
+        overlayRenderPool.start(task);
     }
 
-    QImage night(":/res/map/nasaearthlights.jpg");
+    overlayRenderPool.waitForDone();
 
-    QPainter painter;
-    painter.begin(&overlay);
-    painter.setCompositionMode(QPainter::CompositionMode_SourceAtop);
-    painter.drawImage(0, 0, night);
-    painter.end();
+    overlaySize = QSize(maxX, maxY);
+    lastSunPoint = sunPoint;
 
     nightOverlay->setPixmap(QPixmap::fromImage(overlay));
 }
 
+void MapWidget::prepareNightOverlayTables(int maxX, int maxY)
+{
+    FCT_IDENTIFICATION;
+
+    qCDebug(function_parameters) << maxX << maxY;
+
+    if ( overlaySize == QSize(maxX, maxY) )
+        return;
+
+    cosPhi.resize(maxX);
+    sinPhi.resize(maxX);
+
+    for ( int x = 0; x < maxX; x++ )
+    {
+        double phi = 2.0 * M_PI * (static_cast<double>(x) / (static_cast<double>(maxX) - 1.0)) - M_PI;
+        cosPhi[x] = static_cast<float>(cos(phi));
+        sinPhi[x] = static_cast<float>(sin(phi));
+    }
+
+    cosTheta.resize(maxY);
+    sinTheta.resize(maxY);
+
+    for ( int y = 0; y < maxY; y++ )
+    {
+        double theta = M_PI * (static_cast<double>(y) / (static_cast<double>(maxY) - 1.0));
+        cosTheta[y] = static_cast<float>(cos(theta));
+        sinTheta[y] = static_cast<float>(sin(theta));
+    }
+
+    // the night lights are decoded only once per scene size
+    nightLights = QImage(":/res/map/nasaearthlights.jpg").convertToFormat(QImage::Format_RGB32);
+
+    if ( nightLights.size() != QSize(maxX, maxY) )
+        nightLights = nightLights.scaled(maxX, maxY, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+}
+
 void MapWidget::pointToRad(const QPoint &point, double& lat, double& lon)
 {
     FCT_IDENTIFICATION;
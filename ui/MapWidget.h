@@ -4,6 +4,8 @@
 #include <QWidget>
 #include <QGraphicsView>
 #include <QGraphicsScene>
+#include <QThreadPool>
+#include <QImage>
 
 namespace Ui {
 class MapWidget;
@@ -28,6 +30,7 @@ protected:
 
 private:
     void redrawNightOverlay();
+    void prepareNightOverlayTables(int maxX, int maxY);
     void drawPoint(const QPoint &point);
     void drawLine(const QPoint &pointA, const QPoint &pointB);
 
@@ -43,6 +46,16 @@ private:
     QGraphicsEllipseItem* sunItem;
     QGraphicsPathItem* terminatorItem;
     QGraphicsScene* scene;
+
+    // night overlay cache - trig tables and night lights are valid for overlaySize
+    QSize overlaySize;
+    QVector<float> cosPhi;
+    QVector<float> sinPhi;
+    QVector<float> cosTheta;
+    QVector<float> sinTheta;
+    QImage nightLights;
+    QPointF lastSunPoint;
+    QThreadPool overlayRenderPool;
 };
 
 #endif // QLOG_UI_MAPWIDGET_H
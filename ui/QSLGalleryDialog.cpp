@@ -10,6 +10,8 @@
 #include <QStyledItemDelegate>
 #include <QMenu>
 #include <QFileDialog>
+#include <QHelpEvent>
+#include <QToolTip>
 
 #include "QSLGalleryDialog.h"
 #include "ui_QSLGalleryDialog.h"
@@ -134,6 +136,10 @@ QSLGalleryDialog::QSLGalleryDialog(QWidget *parent) :
     scrollTimer->setInterval(150);
     connect(scrollTimer, &QTimer::timeout, this, &QSLGalleryDialog::loadVisibleThumbnails);
     connect(ui->cardListWidget->verticalScrollBar(), &QScrollBar::valueChanged, this, [this]() { scrollTimer->start(); });
+    connect(&thumbnailService, &QSLThumbnailService::thumbnailReady, this, &QSLGalleryDialog::thumbnailReady);
+
+    // the tooltip contains the full QSL image - it is loaded when it is shown
+    ui->cardListWidget->viewport()->installEventFilter(this);
     connect(ui->exportFilteredButton, &QPushButton::clicked, this, &QSLGalleryDialog::exportFiltered);
 
     ui->sortCombo->addItem(tr("Date (Newest)"), SORT_DATE_DESC);
@@ -378,6 +384,9 @@ void QSLGalleryDialog::populateItems(const QList<QSLGalleryItem> &items)
 {
     FCT_IDENTIFICATION;
 
+    // the thumbnails of the removed items are no longer needed
+    thumbnailService.cancel();
+    pendingThumbnails.clear();
     ui->cardListWidget->clear();
 
     QList<QSLGalleryItem> sorted = items;
@@ -416,6 +425,7 @@ void QSLGalleryDialog::populateItems(const QList<QSLGalleryItem> &items)
         listItem->setData(CallsignRole, item.callsign);
         listItem->setData(DateStringRole, dateStr);
         listItem->setData(FavoriteRole, item.favorite);
+        listItem->setData(DataHashRole, item.dataHash);
 
         ui->cardListWidget->addItem(listItem);
     }
@@ -468,6 +478,7 @@ void QSLGalleryDialog::loadVisibleThumbnails()
     qCDebug(runtime) << "Loading thumbnails" << firstVisible << "-" << lastVisible
                      << "of" << totalCount;
 
+    // the thumbnails are generated in the background and they are set as they are completed
     for ( int i = firstVisible; i <= lastVisible; ++i )
     {
         QListWidgetItem *item = lw->item(i);
@@ -475,40 +486,78 @@ void QSLGalleryDialog::loadVisibleThumbnails()
         if ( item->data(ThumbnailLoadedRole).toBool() )
             continue;
 
-        const qulonglong contactId = item->data(ContactIdRole).toULongLong();
-        const int source = item->data(SourceRole).toInt();
-        const QString name = item->data(NameRole).toString();
-        const QByteArray data = qslStorage.getQSLData(contactId, source, name);
+        QSLThumbnailService::Request request;
+        request.contactId = item->data(ContactIdRole).toULongLong();
+        request.source = item->data(SourceRole).toInt();
+        request.name = item->data(NameRole).toString();
+        request.dataHash = item->data(DataHashRole).toString();
 
-        if ( !data.isEmpty() )
-        {
-            item->setIcon(QIcon(createThumbnail(data, name)));
+        pendingThumbnails.insert(thumbnailService.request(request), item);
+        item->setData(ThumbnailLoadedRole, true);
+    }
+}
+
+void QSLGalleryDialog::thumbnailReady(int requestID, const QImage &thumbnail)
+{
+    FCT_IDENTIFICATION;
 
-            const QMimeType mimeType = mimeDb.mimeTypeForData(data);
+    qCDebug(function_parameters) << requestID;
 
-            if ( mimeType.name().startsWith("image/") )
-                item->setToolTip(QString("<img src='data:%1;base64, %2' width='600'>")
-                                     .arg(mimeType.name(), QString(data.toBase64())));
-            else
-                item->setToolTip(QString("%1 (%2)").arg(name, mimeType.comment()));
-        }
+    QListWidgetItem *item = pendingThumbnails.take(requestID);
 
-        item->setData(ThumbnailLoadedRole, true);
+    if ( !item )
+        return;
+
+    item->setIcon(QIcon(( thumbnail.isNull() ) ? fileThumbnail(item->data(NameRole).toString())
+                                               : QPixmap::fromImage(thumbnail)));
+}
+
+bool QSLGalleryDialog::eventFilter(QObject *watched, QEvent *event)
+{
+    if ( watched == ui->cardListWidget->viewport() && event->type() == QEvent::ToolTip )
+    {
+        const QHelpEvent *helpEvent = static_cast<QHelpEvent *>(event);
+        const QListWidgetItem *item = ui->cardListWidget->itemAt(helpEvent->pos());
+        const QString toolTip = cardToolTip(item);
+
+        if ( toolTip.isEmpty() )
+            QToolTip::hideText();
+        else
+            QToolTip::showText(helpEvent->globalPos(), toolTip, ui->cardListWidget->viewport());
+
+        return true;
     }
+
+    return QDialog::eventFilter(watched, event);
 }
 
-QPixmap QSLGalleryDialog::createThumbnail(const QByteArray &data, const QString &name) const
+QString QSLGalleryDialog::cardToolTip(const QListWidgetItem *item) const
 {
     FCT_IDENTIFICATION;
 
+    if ( !item )
+        return QString();
+
+    const qulonglong contactId = item->data(ContactIdRole).toULongLong();
+    const int source = item->data(SourceRole).toInt();
+    const QString name = item->data(NameRole).toString();
+    const QByteArray data = qslStorage.getQSLData(contactId, source, name);
+
+    if ( data.isEmpty() )
+        return QString();
+
     const QMimeType mimeType = mimeDb.mimeTypeForData(data);
 
     if ( mimeType.name().startsWith("image/") )
-    {
-        QPixmap pixmap;
-        if ( pixmap.loadFromData(data) )
-            return pixmap.scaled(150, 112, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-    }
+        return QString("<img src='data:%1;base64, %2' width='600'>")
+                      .arg(mimeType.name(), QString(data.toBase64()));
+
+    return QString("%1 (%2)").arg(name, mimeType.comment());
+}
+
+QPixmap QSLGalleryDialog::fileThumbnail(const QString &name) const
+{
+    FCT_IDENTIFICATION;
 
     // Non-image file: draw file type label over generic icon
     QPixmap pixmap(150, 112);
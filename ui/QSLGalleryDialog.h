@@ -6,7 +6,9 @@
 #include <QTemporaryDir>
 #include <QListWidget>
 #include <QMimeDatabase>
+#include <QHash>
 #include "core/QSLStorage.h"
+#include "core/QSLThumbnailService.h"
 #include "core/LogLocale.h"
 
 namespace Ui {
@@ -30,7 +32,8 @@ public:
         ThumbnailLoadedRole = Qt::UserRole + 3,
         CallsignRole = Qt::UserRole + 4,
         DateStringRole = Qt::UserRole + 5,
-        FavoriteRole = Qt::UserRole + 6
+        FavoriteRole = Qt::UserRole + 6,
+        DataHashRole = Qt::UserRole + 7
     };
 
 private slots:
@@ -38,6 +41,10 @@ private slots:
     void cardDoubleClicked(QListWidgetItem *item);
     void showContextMenu(const QPoint &pos);
     void loadVisibleThumbnails();
+    void thumbnailReady(int requestID, const QImage &thumbnail);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
 
 private:
     enum FilterType
@@ -63,7 +70,8 @@ private:
     void buildFilterTree();
     void loadGallery();
     void populateItems(const QList<QSLGalleryItem> &items);
-    QPixmap createThumbnail(const QByteArray &data, const QString &name) const;
+    QPixmap fileThumbnail(const QString &name) const;
+    QString cardToolTip(const QListWidgetItem *item) const;
     void openItem(const QListWidgetItem *item);
     void saveItem(const QListWidgetItem *item);
     void toggleFavorite(QListWidgetItem *item);
@@ -76,6 +84,8 @@ private:
     QTemporaryDir *tempDir;
     LogLocale locale;
     QMimeDatabase mimeDb;
+    QSLThumbnailService thumbnailService;
+    QHash<int, QListWidgetItem *> pendingThumbnails; // requestID -> item
 };
 
 #endif // QLOG_UI_QSLGALLERYDIALOG_H
@@ -4,8 +4,8 @@
 #include <QBarCategoryAxis>
 #include <QValueAxis>
 #include <QBarSeries>
-#include <QSqlQuery>
 #include <QDateTime>
+#include <QCryptographicHash>
 #include <QDebug>
 #include <QComboBox>
 #include <QStringListModel>
@@ -17,9 +17,13 @@
 #include "models/SqlListModel.h"
 #include "data/Gridsquare.h"
 #include "core/QSOFilterManager.h"
+#include "core/StatisticsRollup.h"
 
 MODULE_IDENTIFICATION("qlog.ui.statisticswidget");
 
+// maximum number of cached result rows
+#define RESULT_CACHE_MAX_ROWS 100000
+
 void StatisticsWidget::mainStatChanged(int idx)
 {
      FCT_IDENTIFICATION;
@@ -34,6 +38,9 @@ void StatisticsWidget::refreshWidget()
 {
     FCT_IDENTIFICATION;
 
+    // the logbook has been changed - the cached results are not valid
+    resultCache.clear();
+
     if ( !isVisible() )
         return;
 
@@ -48,58 +55,33 @@ void StatisticsWidget::refreshGraph()
      if ( !isVisible() )
          return;
 
-     QStringList genericFilter;
-
-     genericFilter << " 1 = 1 "; //just initialization - use only in case of empty Options
-
-     if ( ui->myCallCombo->currentIndex() != 0 )
-         genericFilter << " (station_callsign = '" + ui->myCallCombo->currentText() + "') ";
-
-     if ( ui->myGridCombo->currentIndex() != 0 )
-     {
-         if ( ui->myGridCombo->currentText().isEmpty() )
-             genericFilter << " (my_gridsquare is NULL) ";
-         else
-             genericFilter << " (my_gridsquare = '" + ui->myGridCombo->currentText() + "') ";
-     }
-
-     if ( ui->myRigCombo->currentIndex() != 0 )
-     {
-         if ( ui->myRigCombo->currentText().isEmpty() )
-             genericFilter << " (my_rig is NULL) ";
-         else
-             genericFilter << " (my_rig = '" + ui->myRigCombo->currentText() + "') ";
-     }
-
-     if ( ui->myAntennaCombo->currentIndex() != 0 )
-     {
-         if ( ui->myAntennaCombo->currentText().isEmpty() )
-             genericFilter << " (my_antenna is NULL) ";
-         else
-             genericFilter << " (my_antenna = '" + ui->myAntennaCombo->currentText() + "') ";
-     }
-
-     if ( ui->bandCombo->currentIndex() != 0 &&  ! ui->bandCombo->currentText().isEmpty() )
-         genericFilter << " (band = '" + ui->bandCombo->currentText() + "') ";
+     const int mainType = ui->statTypeMainCombo->currentIndex();
+     const int subType = ui->statTypeSecCombo->currentIndex();
 
-     if ( ui->useDateRangeCheckBox->isChecked() )
-         genericFilter << " (datetime(start_time) BETWEEN datetime('" + ui->startDateEdit->dateTime().toString("yyyy-MM-dd HH:mm:ss")
-                          + "') AND datetime('" + ui->endDateEdit->dateTime().toString("yyyy-MM-dd HH:mm:ss") + "') ) ";
+     qCDebug(runtime) << "main " << mainType
+                      << " secondary " << subType;
 
-     if ( ui->userFilterCombo->currentIndex() > 0 )
-         genericFilter <<  QSOFilterManager::instance()->getWhereClause(ui->userFilterCombo->currentText());
+     // The common charts aggregate the rollup table. Hours, gridsquares and distances
+     // are not in the rollup; Show on Map needs individual QSOs
+     const bool useRollup = isRollupUsable()
+                            && ( ( mainType == 0 && subType != 3 )
+                                 || mainType == 1
+                                 || ( mainType == 2 && subType == 0 ) );
+     const QString source = ( useRollup ) ? StatisticsRollup::tableName : QStringLiteral("contacts");
+     const QString countExpr = ( useRollup ) ? QStringLiteral("SUM(cnt)") : QStringLiteral("COUNT(1)");
+     const QString timeColumn = ( useRollup ) ? QStringLiteral("day") : QStringLiteral("start_time");
+     const QStringList filter = genericFilter(useRollup);
 
-     qCDebug(runtime) << "main " << ui->statTypeMainCombo->currentIndex()
-                      << " secondary " << ui->statTypeSecCombo->currentIndex();
+     qCDebug(runtime) << "source" << source;
 
      /****************/
      /* QSO Per .... */
      /****************/
-     if ( ui->statTypeMainCombo->currentIndex() == 0 )
+     if ( mainType == 0 )
      {
          QString stmt;
 
-         switch ( ui->statTypeSecCombo->currentIndex() )
+         switch ( subType )
          {
 
          case 0: // Year
@@ -112,7 +94,7 @@ void StatisticsWidget::refreshGraph()
              QString formatGenerator = "%m";
              QString XYMapping = "col1, SUM(cnt)";
 
-             if ( ui->statTypeSecCombo->currentIndex() == 0 )
+             if ( subType == 0 )
              {
                  if ( ui->useDateRangeCheckBox->isChecked() )
                  {
@@ -121,18 +103,18 @@ void StatisticsWidget::refreshGraph()
                  }
                  else
                  {
-                    startGenerator = "CAST(MIN(start_time) as INTEGER) from contacts";
+                    startGenerator = "CAST(MIN(" + timeColumn + ") as INTEGER) from " + source;
                     endGenerator = " (select strftime('%Y', DATE()))";
                  }
                  formatGenerator = "%Y";
              }
-             else if ( ui->statTypeSecCombo->currentIndex() == 1 )
+             else if ( subType == 1 )
              {
                  startGenerator = "1";
                  endGenerator = "12";
                  formatGenerator = "%m";
              }
-             else if ( ui->statTypeSecCombo->currentIndex() == 2 )
+             else if ( subType == 2 )
              {
                  startGenerator = "0";
                  endGenerator = "6";
@@ -146,7 +128,7 @@ void StatisticsWidget::refreshGraph()
                              "ELSE '" + tr("Sat") + "' END, "
                              "SUM(cnt) ";
              }
-             else if ( ui->statTypeSecCombo->currentIndex() == 3 )
+             else if ( subType == 3 )
              {
                  startGenerator = "0";
                  endGenerator = "23";
@@ -165,9 +147,9 @@ void StatisticsWidget::refreshGraph()
                     " ( "
                     "   SELECT  incnt as col1, 0 as cnt from cnt "
                     "   UNION ALL "
-                    "   SELECT CAST(strftime('" + formatGenerator +"', start_time) as INTEGER) as col1, count(1) as cnt "
-                    "   FROM contacts "
-                    "   WHERE " + genericFilter.join(" AND ") + " "
+                    "   SELECT CAST(strftime('" + formatGenerator +"', " + timeColumn + ") as INTEGER) as col1, " + countExpr + " as cnt "
+                    "   FROM " + source + " "
+                    "   WHERE " + filter.join(" AND ") + " "
                     "   GROUP BY col1 "
                     " ) "
                     " GROUP BY col1 "
@@ -175,82 +157,63 @@ void StatisticsWidget::refreshGraph()
          }
              break;
          case 4:  // Mode
-             stmt = "SELECT IFNULL(mode, '" + tr("Not specified") + "'), COUNT(1) FROM contacts WHERE "
-                     + genericFilter.join(" AND ") + " GROUP BY mode ORDER BY mode";
+             stmt = "SELECT IFNULL(mode, '" + tr("Not specified") + "'), " + countExpr + " FROM " + source + " WHERE "
+                     + filter.join(" AND ") + " GROUP BY mode ORDER BY mode";
              break;
          case 5:  // Band
              stmt = "SELECT IFNULL(band, '" + tr("Not specified") + "'), cnt "
-                    " FROM (SELECT c.band, b.start_freq, COUNT(1) AS cnt FROM contacts c LEFT JOIN bands b ON c.band = b.name"
+                    " FROM (SELECT c.band, b.start_freq, " + countExpr + " AS cnt FROM " + source + " c LEFT JOIN bands b ON c.band = b.name"
                     " WHERE "
-                    + genericFilter.join(" AND ")
+                    + filter.join(" AND ")
                     + " GROUP BY band, start_freq) ORDER BY start_freq";
              break;
          case 6:  // Continent
-             stmt = "SELECT IFNULL(cont, '" + tr("Not specified") + "'), COUNT(1) FROM contacts WHERE "
-                    + genericFilter.join(" AND ")
+             stmt = "SELECT IFNULL(cont, '" + tr("Not specified") + "'), " + countExpr + " FROM " + source + " WHERE "
+                    + filter.join(" AND ")
                     + " GROUP BY cont ORDER BY cont";
              break;
          case 7:  // Prop Mode
-             stmt = "SELECT IFNULL(prop_mode, '" + tr("Not specified") + "'), COUNT(1) FROM contacts WHERE "
-                    + genericFilter.join(" AND ") + " GROUP BY prop_mode ORDER BY prop_mode";
+             stmt = "SELECT IFNULL(prop_mode, '" + tr("Not specified") + "'), " + countExpr + " FROM " + source + " WHERE "
+                    + filter.join(" AND ") + " GROUP BY prop_mode ORDER BY prop_mode";
              break;
          }
 
-         qCDebug(runtime) << stmt;
-
-         QSqlQuery query(stmt);
-
-         drawBarGraphs(ui->statTypeMainCombo->currentText()
-                       + " "
-                       + ui->statTypeSecCombo->currentText(),
-                       query);
+         requestGraph(QStringList(stmt));
      }
      /************/
      /* Percents */
      /************/
-     else if ( ui->statTypeMainCombo->currentIndex() == 1 )
+     else if ( mainType == 1 )
      {
          QString stmt;
+         const QString confirmedCond = ( useRollup ) ? QStringLiteral("confirmed = 1")
+                                                     : QStringLiteral("(eqsl_qsl_rcvd = 'Y' OR lotw_qsl_rcvd = 'Y' OR qsl_rcvd = 'Y')");
 
-         switch ( ui->statTypeSecCombo->currentIndex() )
+         switch ( subType )
          {
 
          case 0:  // Confirmed/Not Confirmed
-             stmt = "SELECT (1.0 * COUNT(1)/(SELECT COUNT(1) AS total_cnt FROM contacts WHERE "
-                    + genericFilter.join(" AND ") +")) * 100 FROM contacts WHERE "
-                    + genericFilter.join(" AND ")
-                    + " AND (eqsl_qsl_rcvd = 'Y' OR lotw_qsl_rcvd = 'Y' OR qsl_rcvd = 'Y')";
+             stmt = "SELECT (1.0 * " + countExpr + "/(SELECT " + countExpr + " AS total_cnt FROM " + source + " WHERE "
+                    + filter.join(" AND ") +")) * 100 FROM " + source + " WHERE "
+                    + filter.join(" AND ")
+                    + " AND " + confirmedCond;
              break;
          }
 
-         QSqlQuery query(stmt);
-
-         qCDebug(runtime) << stmt;
-         QPieSeries *series = new QPieSeries();
-
-         query.next();
-
-         float confirmed = query.value(0).toInt();
-         float notConfirmed = 100.0 - confirmed;
-
-         series->append(tr("Confirmed ") + QString::number(confirmed) + "%", confirmed);
-         series->append(tr("Not Confirmed ") + QString::number(notConfirmed) + "%", notConfirmed);
-         series->setLabelsVisible(true);
-
-         drawPieGraph(QString(), series);
+         requestGraph(QStringList(stmt));
      }
      /**********/
      /* TOP 10 */
      /**********/
-     else if ( ui->statTypeMainCombo->currentIndex() == 2 )
+     else if ( mainType == 2 )
      {
          QString stmt;
 
-         switch ( ui->statTypeSecCombo->currentIndex() )
+         switch ( subType )
          {
          case 0:  // Countries
-             stmt = "SELECT translate_to_locale(COALESCE(d.name, c.dxcc)) as dxcc_display, COUNT(1) AS cnt "
-                    "FROM ( SELECT * FROM contacts WHERE " + genericFilter.join(" AND ") + ") c LEFT JOIN dxcc_entities_clublog d ON c.dxcc = d.id "
+             stmt = "SELECT translate_to_locale(COALESCE(d.name, c.dxcc)) as dxcc_display, " + countExpr + " AS cnt "
+                    "FROM ( SELECT * FROM " + source + " WHERE " + filter.join(" AND ") + ") c LEFT JOIN dxcc_entities_clublog d ON c.dxcc = d.id "
                     "GROUP BY dxcc_display ORDER BY cnt DESC LIMIT 10";
              break;
          case 1:  // Big squares
@@ -258,24 +221,16 @@ void StatisticsWidget::refreshGraph()
              break;
          }
 
-         qCDebug(runtime) << stmt;
-
-         QSqlQuery query(stmt);
-
-         drawBarGraphs(ui->statTypeMainCombo->currentText()
-                       + " "
-                       + ui->statTypeSecCombo->currentText(),
-                       query);
-
+         requestGraph(QStringList(stmt));
      }
      /*************/
      /* Histogram */
      /*************/
-     else if ( ui->statTypeMainCombo->currentIndex() == 3 )
+     else if ( mainType == 3 )
      {
          QString stmt;
 
-         switch ( ui->statTypeSecCombo->currentIndex() )
+         switch ( subType )
          {
          case 0:  // Distance
              QString distCoef = QString::number(Gridsquare::localeDistanceCoef(locale));
@@ -283,7 +238,7 @@ void StatisticsWidget::refreshGraph()
                     " SELECT CAST((distance * %1)/500.00 AS INTEGER) * 500 as dist_floor, "
                     " COUNT(1) AS count "
                     " FROM contacts "
-                    " WHERE " + genericFilter.join(" AND ") + " AND distance IS NOT NULL "
+                    " WHERE " + filter.join(" AND ") + " AND distance IS NOT NULL "
                     " GROUP BY 1 "
                     " ORDER BY 1 "
                     " ) "
@@ -294,19 +249,12 @@ void StatisticsWidget::refreshGraph()
              break;
          }
 
-         qCDebug(runtime) << stmt;
-
-         QSqlQuery query(stmt);
-
-         drawBarGraphs(ui->statTypeMainCombo->currentText()
-                       + " "
-                       + ui->statTypeSecCombo->currentText(),
-                       query);
+         requestGraph(QStringList(stmt));
      }
      /***************/
      /* Show on Map */
      /***************/
-     else if ( ui->statTypeMainCombo->currentIndex() == 4 )
+     else if ( mainType == 4 )
      {
          QStringList confirmed("1=2 ");
 
@@ -320,22 +268,17 @@ void StatisticsWidget::refreshGraph()
              confirmed << " qsl_rcvd = 'Y' ";
 
          QString innerCase = " CASE WHEN (" + confirmed.join("or") + ") THEN 1 ELSE 0 END ";
-         QString stmtMyLocations = "SELECT DISTINCT my_gridsquare FROM contacts WHERE " + genericFilter.join(" AND ");
-         QSqlQuery myLocations(stmtMyLocations);
-
-         qCDebug(runtime) << stmtMyLocations;
-
-         drawMyLocationsOnMap(myLocations);
+         QString stmtMyLocations = "SELECT DISTINCT my_gridsquare FROM contacts WHERE " + filter.join(" AND ");
 
          QString stmt;
 
-         switch ( ui->statTypeSecCombo->currentIndex() )
+         switch ( subType )
          {
          case 0: // QSOs
          case 1: // Confirmed & WorkedGrids
              stmt = "SELECT callsign, gridsquare, my_gridsquare, SUM(confirmed) FROM (SELECT callsign, gridsquare, my_gridsquare,"
                         + innerCase +" AS confirmed FROM contacts WHERE gridsquare is not NULL AND "
-                        + genericFilter.join(" AND ") +" ) GROUP BY callsign, gridsquare, my_gridsquare";
+                        + filter.join(" AND ") +" ) GROUP BY callsign, gridsquare, my_gridsquare";
              break;
          case 2: // ODX
              QString unit;
@@ -344,27 +287,202 @@ void StatisticsWidget::refreshGraph()
              QString sel = QString("SELECT callsign || '<br>' || CAST(ROUND(distance * %1,0) AS INT) || ' %2', gridsquare, my_gridsquare, ").arg(distCoef, unit);
 
              stmt = sel + innerCase + " AS confirmed FROM contacts WHERE "
-                        + genericFilter.join(" AND ") + " AND distance = (SELECT MAX(distance) FROM contacts WHERE "
-                        + genericFilter.join(" AND ") + ")";
+                        + filter.join(" AND ") + " AND distance = (SELECT MAX(distance) FROM contacts WHERE "
+                        + filter.join(" AND ") + ")";
              break;
          }
 
-         QSqlQuery query(stmt);
-         qCDebug(runtime) << stmt;
+         requestGraph(QStringList{stmtMyLocations, stmt});
+     }
+}
+
+QStringList StatisticsWidget::genericFilter(bool useRollup) const
+{
+     FCT_IDENTIFICATION;
+
+     QStringList genericFilter;
+
+     genericFilter << " 1 = 1 "; //just initialization - use only in case of empty Options
+
+     if ( ui->myCallCombo->currentIndex() != 0 )
+         genericFilter << " (station_callsign = '" + ui->myCallCombo->currentText() + "') ";
+
+     if ( ui->myGridCombo->currentIndex() != 0 )
+     {
+         if ( ui->myGridCombo->currentText().isEmpty() )
+             genericFilter << " (my_gridsquare is NULL) ";
+         else
+             genericFilter << " (my_gridsquare = '" + ui->myGridCombo->currentText() + "') ";
+     }
+
+     if ( ui->myRigCombo->currentIndex() != 0 )
+     {
+         if ( ui->myRigCombo->currentText().isEmpty() )
+             genericFilter << " (my_rig is NULL) ";
+         else
+             genericFilter << " (my_rig = '" + ui->myRigCombo->currentText() + "') ";
+     }
+
+     if ( ui->myAntennaCombo->currentIndex() != 0 )
+     {
+         if ( ui->myAntennaCombo->currentText().isEmpty() )
+             genericFilter << " (my_antenna is NULL) ";
+         else
+             genericFilter << " (my_antenna = '" + ui->myAntennaCombo->currentText() + "') ";
+     }
+
+     if ( ui->bandCombo->currentIndex() != 0 &&  ! ui->bandCombo->currentText().isEmpty() )
+         genericFilter << " (band = '" + ui->bandCombo->currentText() + "') ";
+
+     if ( ui->useDateRangeCheckBox->isChecked() )
+     {
+         // the rollup is used only for whole-day ranges (see isRollupUsable)
+         if ( useRollup )
+             genericFilter << " (day BETWEEN '" + ui->startDateEdit->date().toString("yyyy-MM-dd")
+                              + "' AND '" + ui->endDateEdit->date().toString("yyyy-MM-dd") + "') ";
+         else
+             genericFilter << " (datetime(start_time) BETWEEN datetime('" + ui->startDateEdit->dateTime().toString("yyyy-MM-dd HH:mm:ss")
+                              + "') AND datetime('" + ui->endDateEdit->dateTime().toString("yyyy-MM-dd HH:mm:ss") + "') ) ";
+     }
+
+     if ( ui->userFilterCombo->currentIndex() > 0 )
+         genericFilter <<  QSOFilterManager::instance()->getWhereClause(ui->userFilterCombo->currentText());
+
+     return genericFilter;
+}
+
+bool StatisticsWidget::isRollupUsable() const
+{
+     FCT_IDENTIFICATION;
+
+     if ( !StatisticsRollup::isAvailable() )
+         return false;
+
+     // user filters can contain any contacts column
+     if ( ui->userFilterCombo->currentIndex() > 0 )
+         return false;
+
+     // the rollup contains days; the range must cover whole days
+     if ( ui->useDateRangeCheckBox->isChecked()
+          && ( QTime(0, 0).secsTo(ui->startDateEdit->time()) != 0
+               || ui->endDateEdit->time().secsTo(QTime(23, 59, 59)) > 0 ) )
+         return false;
+
+     return true;
+}
+
+void StatisticsWidget::requestGraph(const QStringList &statements)
+{
+     FCT_IDENTIFICATION;
+
+     qCDebug(function_parameters) << statements;
+
+     if ( statements.contains(QString()) )
+         return;
+
+     GraphRequest request;
+
+     request.mainType = ui->statTypeMainCombo->currentIndex();
+     request.subType = ui->statTypeSecCombo->currentIndex();
+     request.title = ui->statTypeMainCombo->currentText()
+                     + " "
+                     + ui->statTypeSecCombo->currentText();
+     request.cacheKey = QCryptographicHash::hash(statements.join('\n').toUtf8(), QCryptographicHash::Sha1);
+
+     const QList<StatisticsEngine::Rows> *cached = resultCache.object(request.cacheKey);
+
+     if ( cached )
+     {
+         qCDebug(runtime) << "Statistics cache hit";
+
+         // the running request is not needed anymore
+         statisticsEngine.cancel();
+         pendingGraph = GraphRequest();
+         drawGraph(request, *cached);
+         return;
+     }
+
+     request.generation = statisticsEngine.submit(statements);
+     pendingGraph = request;
+}
+
+void StatisticsWidget::statisticsFinished(StatisticsEngine::Result result)
+{
+     FCT_IDENTIFICATION;
+
+     qCDebug(function_parameters) << result.generation;
+
+     // the result of the superseded request
+     if ( result.generation != pendingGraph.generation )
+         return;
+
+     const GraphRequest request = pendingGraph;
+     pendingGraph = GraphRequest();
+
+     const QList<StatisticsEngine::Rows> &tables = result.tables;
+     int rows = 1;
+
+     for ( const StatisticsEngine::Rows &table : tables )
+         rows += table.size();
+
+     // too big results are not cached
+     resultCache.insert(request.cacheKey, new QList<StatisticsEngine::Rows>(tables), rows);
+
+     if ( isVisible() )
+         drawGraph(request, tables);
+}
+
+void StatisticsWidget::drawGraph(const GraphRequest &request,
+                                 const QList<StatisticsEngine::Rows> &tables)
+{
+     FCT_IDENTIFICATION;
+
+     if ( tables.isEmpty() )
+         return;
+
+     switch ( request.mainType )
+     {
+     case 0: // QSO Per
+     case 2: // TOP 10
+     case 3: // Histogram
+         drawBarGraphs(request.title, tables.at(0));
+         break;
+
+     case 1: // Percents
+     {
+         QPieSeries *series = new QPieSeries();
+
+         float confirmed = ( tables.at(0).isEmpty() ) ? 0 : tables.at(0).at(0).value(0).toInt();
+         float notConfirmed = 100.0 - confirmed;
+
+         series->append(tr("Confirmed ") + QString::number(confirmed) + "%", confirmed);
+         series->append(tr("Not Confirmed ") + QString::number(notConfirmed) + "%", notConfirmed);
+         series->setLabelsVisible(true);
+
+         drawPieGraph(QString(), series);
+     }
+         break;
+
+     case 4: // Show on Map
+         if ( tables.size() < 2 )
+             return;
+
+         drawMyLocationsOnMap(tables.at(0));
 
-         switch ( ui->statTypeSecCombo->currentIndex() )
+         switch ( request.subType )
          {
          case 0:
          case 2:
-             drawPointsOnMap(query);
+             drawPointsOnMap(tables.at(1));
              break;
 
          case 1:
-             drawFilledGridsOnMap(query);
+             drawFilledGridsOnMap(tables.at(1));
              break;
          }
 
          ui->stackedWidget->setCurrentIndex(1);
+         break;
      }
 }
 
@@ -423,12 +541,20 @@ StatisticsWidget::StatisticsWidget(QWidget *parent) :
     ui(new Ui::StatisticsWidget),
     main_page(new WebEnginePage(this)),
     isMainPageLoaded(false),
-    layerControlHandler("statistics", parent)
+    layerControlHandler("statistics", parent),
+    resultCache(RESULT_CACHE_MAX_ROWS)
 {
     FCT_IDENTIFICATION;
 
     ui->setupUi(this);
 
+    statisticsEngine.moveToThread(&statisticsEngineThread);
+    connect(&statisticsEngineThread, &QThread::finished,
+            &statisticsEngine, &StatisticsEngine::closeConnection, Qt::DirectConnection);
+    connect(&statisticsEngine, &StatisticsEngine::finished,
+            this, &StatisticsWidget::statisticsFinished);
+    statisticsEngineThread.start();
+
     ui->myCallCombo->setModel(new QStringListModel(this));
     ui->myGridCombo->setModel(new QStringListModel(this));
     ui->myRigCombo->setModel(new QStringListModel(this));
@@ -458,6 +584,9 @@ StatisticsWidget::StatisticsWidget(QWidget *parent) :
 StatisticsWidget::~StatisticsWidget()
 {
     FCT_IDENTIFICATION;
+    statisticsEngine.cancel();
+    statisticsEngineThread.quit();
+    statisticsEngineThread.wait();
     main_page->deleteLater();
     delete ui;
 }
@@ -470,6 +599,9 @@ bool StatisticsWidget::event(QEvent *event)
         // to do the same thing. The difference is that we want class constructor to be as fast as possible.
         // Therefore, in the constructor, we do not populate the combo boxes. As a result, they are empty
         // when first displayed and need to be loaded and then combos for Rig, Ant, etc., can be set.
+        // The results cached before are dropped because not all logbook changes
+        // (e.g. QSL downloads) are signalled to the widget.
+        resultCache.clear();
         refreshCombos();
         ui->statTypeMainCombo->blockSignals(true);
         ui->statTypeMainCombo->setCurrentIndex(0);
@@ -486,15 +618,19 @@ bool StatisticsWidget::event(QEvent *event)
         ui->userFilterCombo->blockSignals(false);
         refreshGraph();
     }
+    else if ( event->type() == QEvent::Hide )
+    {
+        // the result would not be displayed
+        statisticsEngine.cancel();
+        pendingGraph = GraphRequest();
+    }
     return QWidget::event(event);  // Propagate the event further
 }
 
-void StatisticsWidget::drawBarGraphs(const QString &title, QSqlQuery &query)
+void StatisticsWidget::drawBarGraphs(const QString &title, const StatisticsEngine::Rows &rows)
 {
     FCT_IDENTIFICATION;
 
-    if ( query.lastQuery().isEmpty() ) return;
-
     QChart *chart = ui->graphView->chart();
 
     if ( chart != nullptr )
@@ -506,10 +642,10 @@ void StatisticsWidget::drawBarGraphs(const QString &title, QSqlQuery &query)
     QBarSeries* series = new QBarSeries(chart);
     QValueAxis *axisY = new QValueAxis(chart);
 
-    while ( query.next() )
+    for ( const QVariantList &row : rows )
     {
-        axisX->append(query.value(0).toString());
-        *set << query.value(1).toInt();
+        axisX->append(row.value(0).toString());
+        *set << row.value(1).toInt();
     }
 
     series->append(set);
@@ -556,19 +692,16 @@ void StatisticsWidget::drawPieGraph(const QString &title, QPieSeries *series)
     ui->graphView->setChart(chart);
 }
 
-void StatisticsWidget::drawMyLocationsOnMap(QSqlQuery &query)
+void StatisticsWidget::drawMyLocationsOnMap(const StatisticsEngine::Rows &rows)
 {
     FCT_IDENTIFICATION;
 
-    if ( query.lastQuery().isEmpty() )
-        return;
-
     QStringList locationIcons;
     QStringList rawLocationsPoint;
 
-    while ( query.next() )
+    for ( const QVariantList &row : rows )
     {
-        const QString &loc = query.value(0).toString();
+        const QString &loc = row.value(0).toString();
         const Gridsquare stationGrid(loc);
 
         if ( stationGrid.isValid() )
@@ -594,22 +727,19 @@ void StatisticsWidget::drawMyLocationsOnMap(QSqlQuery &query)
         main_page->runJavaScript(javaScript);
 }
 
-void StatisticsWidget::drawPointsOnMap(QSqlQuery &query)
+void StatisticsWidget::drawPointsOnMap(const StatisticsEngine::Rows &rows)
 {
     FCT_IDENTIFICATION;
 
-    if ( query.lastQuery().isEmpty() )
-        return;
-
     QList<QString> stations;
     QList<QString> shortPaths;
 
     qulonglong count = 0;
 
-    while ( query.next() )
+    for ( const QVariantList &row : rows )
     {
-        const Gridsquare stationGrid(query.value(1).toString());
-        const Gridsquare myStationGrid(query.value(2).toString());
+        const Gridsquare stationGrid(row.value(1).toString());
+        const Gridsquare myStationGrid(row.value(2).toString());
         if ( stationGrid.isValid() )
         {
             count++;
@@ -622,10 +752,10 @@ void StatisticsWidget::drawPointsOnMap(QSqlQuery &query)
                 lon -= 360;
             if ( delta < -180 )
                 lon += 360;
-            stations.append(QString("[\"%1\", %2, %3, %4]").arg(query.value(0).toString())
+            stations.append(QString("[\"%1\", %2, %3, %4]").arg(row.value(0).toString())
                                                            .arg(lat)
                                                            .arg(lon)
-                                                           .arg((query.value(3).toInt()) > 0 ? "greenIconSmall" : "yellowIconSmall"));
+                                                           .arg((row.value(3).toInt()) > 0 ? "greenIconSmall" : "yellowIconSmall"));
             shortPaths.append(QString("[%1, %2, %3, %4]")
                                   .arg(myStationGrid.getLatitude())
                                   .arg(myStationGrid.getLongitude())
@@ -661,22 +791,19 @@ void StatisticsWidget::drawPointsOnMap(QSqlQuery &query)
         main_page->runJavaScript(javaScript);
 }
 
-void StatisticsWidget::drawFilledGridsOnMap(QSqlQuery &query)
+void StatisticsWidget::drawFilledGridsOnMap(const StatisticsEngine::Rows &rows)
 {
     FCT_IDENTIFICATION;
 
-
-    if ( query.lastQuery().isEmpty() ) return;
-
     QList<QString> confirmedGrids;
     QList<QString> workedGrids;
 
-    while ( query.next() )
+    for ( const QVariantList &row : rows )
     {
-        if ( query.value(3).toInt() > 0 && ! confirmedGrids.contains(query.value(1).toString()) )
-            confirmedGrids << QString("\"" + query.value(1).toString() + "\"");
+        if ( row.value(3).toInt() > 0 && ! confirmedGrids.contains(row.value(1).toString()) )
+            confirmedGrids << QString("\"" + row.value(1).toString() + "\"");
         else
-            workedGrids << QString("\"" + query.value(1).toString() + "\"");
+            workedGrids << QString("\"" + row.value(1).toString() + "\"");
     }
 
     QString javaScript = QString("grids_confirmed = [ %1 ]; "
@@ -698,11 +825,14 @@ void StatisticsWidget::refreshCombos()
 {
     FCT_IDENTIFICATION;
 
-    refreshCombo(ui->myCallCombo, QLatin1String("SELECT DISTINCT UPPER(station_callsign) FROM contacts ORDER BY station_callsign"));
-    refreshCombo(ui->myRigCombo, QLatin1String("SELECT DISTINCT my_rig FROM contacts ORDER BY my_rig"));
-    refreshCombo(ui->myAntennaCombo, QLatin1String("SELECT DISTINCT my_antenna FROM contacts ORDER BY my_antenna"));
-    refreshCombo(ui->bandCombo, QLatin1String("SELECT DISTINCT band FROM contacts c, bands b WHERE c.band = b.name ORDER BY b.start_freq;"));
-    refreshCombo(ui->myGridCombo, QLatin1String("SELECT DISTINCT UPPER(my_gridsquare) FROM contacts ORDER BY my_gridsquare"));
+    // the rollup contains the same distinct values as contacts
+    const QString source = ( StatisticsRollup::isAvailable() ) ? StatisticsRollup::tableName : QStringLiteral("contacts");
+
+    refreshCombo(ui->myCallCombo, QString("SELECT DISTINCT UPPER(station_callsign) FROM %1 ORDER BY station_callsign").arg(source));
+    refreshCombo(ui->myRigCombo, QString("SELECT DISTINCT my_rig FROM %1 ORDER BY my_rig").arg(source));
+    refreshCombo(ui->myAntennaCombo, QString("SELECT DISTINCT my_antenna FROM %1 ORDER BY my_antenna").arg(source));
+    refreshCombo(ui->bandCombo, QString("SELECT DISTINCT band FROM %1 c, bands b WHERE c.band = b.name ORDER BY b.start_freq;").arg(source));
+    refreshCombo(ui->myGridCombo, QString("SELECT DISTINCT UPPER(my_gridsquare) FROM %1 ORDER BY my_gridsquare").arg(source));
     SqlListModel *sqlModel = qobject_cast<SqlListModel*>(ui->userFilterCombo->model());
     if ( sqlModel ) sqlModel->refresh();
 }
@@ -2,14 +2,16 @@
 #define QLOG_UI_STATISTICSWIDGET_H
 
 #include <QWidget>
-#include <QSqlQuery>
 #include <QPieSeries>
 #include <QComboBox>
 #include <QWebChannel>
+#include <QThread>
+#include <QCache>
 
 #include "ui/MapWebChannelHandler.h"
 #include "ui/WebEnginePage.h"
 #include "core/LogLocale.h"
+#include "core/StatisticsEngine.h"
 
 namespace Ui {
 class StatisticsWidget;
@@ -32,6 +34,7 @@ public slots:
 
 private slots:
     void refreshGraph();
+    void statisticsFinished(StatisticsEngine::Result result);
 
 public:
     explicit StatisticsWidget(QWidget *parent = nullptr);
@@ -41,12 +44,25 @@ protected:
     bool event(QEvent *event) override;
 
 private:
-
-    void drawBarGraphs(const QString &title, QSqlQuery &query);
+    // the graph which is waiting for its statistics result
+    struct GraphRequest
+    {
+        int generation = 0;
+        QByteArray cacheKey;
+        int mainType = -1;
+        int subType = -1;
+        QString title;
+    };
+
+    QStringList genericFilter(bool useRollup) const;
+    bool isRollupUsable() const;
+    void requestGraph(const QStringList &statements);
+    void drawGraph(const GraphRequest &request, const QList<StatisticsEngine::Rows> &tables);
+    void drawBarGraphs(const QString &title, const StatisticsEngine::Rows &rows);
     void drawPieGraph(const QString &title, QPieSeries* series);
-    void drawMyLocationsOnMap(QSqlQuery &);
-    void drawPointsOnMap(QSqlQuery&);
-    void drawFilledGridsOnMap(QSqlQuery&);
+    void drawMyLocationsOnMap(const StatisticsEngine::Rows &rows);
+    void drawPointsOnMap(const StatisticsEngine::Rows &rows);
+    void drawFilledGridsOnMap(const StatisticsEngine::Rows &rows);
     void refreshCombos();
     void setSubTypesCombo(int mainTypeIdx);
     void refreshCombo(QComboBox * combo, const QString &sqlQeury);
@@ -59,7 +75,10 @@ private:
     QWebChannel channel;
     MapWebChannelHandler layerControlHandler;
     LogLocale locale;
-
+    StatisticsEngine statisticsEngine;
+    QThread statisticsEngineThread;
+    GraphRequest pendingGraph;
+    QCache<QByteArray, QList<StatisticsEngine::Rows>> resultCache;  // cost = rows
 
     // default statistics interval [in days]
     const int DEFAULT_STAT_RANGE = -1;